@@ -29,6 +29,8 @@
 
 #include "a11y/gtkimagecellaccessible.h"
 
+#include "gdk/gdktextureprivate.h"
+
 #include <cairo-gobject.h>
 #include <stdlib.h>
 
@@ -95,10 +97,141 @@ struct _GtkCellRendererPixbufPrivate
 
   GdkPixbuf *pixbuf_expander_open;
   GdkPixbuf *pixbuf_expander_closed;
+  GdkTexture *texture_expander_open;
+  GdkTexture *texture_expander_closed;
+
+  /* Textures for the pixbufs set most recently, see
+   * gtk_cell_renderer_pixbuf_get_texture_for_pixbuf()
+   */
+  GHashTable *textures;         /* GdkPixbuf -> TextureCacheEntry */
+  GQueue texture_lru;
+};
+
+/* The number of pixbufs a renderer keeps textures for. This should cover
+ * the distinct icons shown in one column of a tree view.
+ */
+#define MAX_CACHED_TEXTURES 64
+
+typedef struct _TextureCacheEntry TextureCacheEntry;
+
+struct _TextureCacheEntry
+{
+  GtkCellRendererPixbuf *cellpixbuf;
+  GdkPixbuf *pixbuf;            /* weak */
+  GdkTexture *texture;
+  GList link;                   /* in texture_lru */
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (GtkCellRendererPixbuf, gtk_cell_renderer_pixbuf, GTK_TYPE_CELL_RENDERER)
 
+/* The texture owns the converted surface, so the pixels are only
+ * copied once, and later changes to the pixbuf don't reach it.
+ */
+static GdkTexture *
+texture_new_for_pixbuf (GdkPixbuf *pixbuf)
+{
+  cairo_surface_t *surface;
+  GdkTexture *texture;
+  cairo_t *cr;
+
+  /* Textures need ARGB32, also for pixbufs without alpha */
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                        gdk_pixbuf_get_width (pixbuf),
+                                        gdk_pixbuf_get_height (pixbuf));
+  cr = cairo_create (surface);
+  gdk_cairo_set_source_pixbuf (cr, pixbuf, 0, 0);
+  cairo_paint (cr);
+  cairo_destroy (cr);
+
+  texture = gdk_texture_new_for_surface (surface);
+  cairo_surface_destroy (surface);
+
+  return texture;
+}
+
+static void texture_cache_pixbuf_finalized (gpointer  data,
+                                            GObject  *where_the_pixbuf_was);
+
+static void
+texture_cache_entry_free (TextureCacheEntry *entry,
+                          gboolean           pixbuf_alive)
+{
+  GtkCellRendererPixbufPrivate *priv = entry->cellpixbuf->priv;
+
+  g_hash_table_remove (priv->textures, entry->pixbuf);
+  g_queue_unlink (&priv->texture_lru, &entry->link);
+  if (pixbuf_alive)
+    g_object_weak_unref (G_OBJECT (entry->pixbuf), texture_cache_pixbuf_finalized, entry);
+  g_object_unref (entry->texture);
+  g_slice_free (TextureCacheEntry, entry);
+}
+
+static void
+texture_cache_pixbuf_finalized (gpointer  data,
+                                GObject  *where_the_pixbuf_was)
+{
+  texture_cache_entry_free (data, FALSE);
+}
+
+static void
+gtk_cell_renderer_pixbuf_clear_textures (GtkCellRendererPixbuf *cellpixbuf)
+{
+  GtkCellRendererPixbufPrivate *priv = cellpixbuf->priv;
+
+  while (priv->texture_lru.head)
+    texture_cache_entry_free (priv->texture_lru.head->data, TRUE);
+
+  g_clear_pointer (&priv->textures, g_hash_table_unref);
+}
+
+/* Tree views set the pixbuf again for every row they draw, so converting
+ * it on each set would hand the renderer a new texture (and upload) per
+ * row and frame. The renderer keeps the textures of the pixbufs it was
+ * given most recently, and reuses them while it is given the same
+ * pixbufs again. The cache holds no references to the pixbufs; an entry
+ * is dropped when its pixbuf is finalized, and the least recently used
+ * one once more than MAX_CACHED_TEXTURES pixbufs are cached.
+ *
+ * Like GtkImage, this treats pixbufs as immutable once set: changes made
+ * to the pixels of a pixbuf are not picked up while its texture is in
+ * the cache.
+ */
+static GdkTexture *
+gtk_cell_renderer_pixbuf_get_texture_for_pixbuf (GtkCellRendererPixbuf *cellpixbuf,
+                                                 GdkPixbuf             *pixbuf)
+{
+  GtkCellRendererPixbufPrivate *priv = cellpixbuf->priv;
+  TextureCacheEntry *entry;
+
+  if (pixbuf == NULL)
+    return NULL;
+
+  if (priv->textures == NULL)
+    priv->textures = g_hash_table_new (NULL, NULL);
+
+  entry = g_hash_table_lookup (priv->textures, pixbuf);
+  if (entry != NULL)
+    {
+      g_queue_unlink (&priv->texture_lru, &entry->link);
+      g_queue_push_head_link (&priv->texture_lru, &entry->link);
+      return entry->texture;
+    }
+
+  if (priv->texture_lru.length >= MAX_CACHED_TEXTURES)
+    texture_cache_entry_free (priv->texture_lru.tail->data, TRUE);
+
+  entry = g_slice_new0 (TextureCacheEntry);
+  entry->cellpixbuf = cellpixbuf;
+  entry->pixbuf = pixbuf;
+  entry->texture = texture_new_for_pixbuf (pixbuf);
+  entry->link.data = entry;
+  g_object_weak_ref (G_OBJECT (pixbuf), texture_cache_pixbuf_finalized, entry);
+  g_hash_table_insert (priv->textures, pixbuf, entry);
+  g_queue_push_head_link (&priv->texture_lru, &entry->link);
+
+  return entry->texture;
+}
+
 static void
 gtk_cell_renderer_pixbuf_init (GtkCellRendererPixbuf *cellpixbuf)
 {
@@ -122,6 +255,10 @@ gtk_cell_renderer_pixbuf_finalize (GObject *object)
     g_object_unref (priv->pixbuf_expander_open);
   if (priv->pixbuf_expander_closed)
     g_object_unref (priv->pixbuf_expander_closed);
+  g_clear_object (&priv->texture_expander_open);
+  g_clear_object (&priv->texture_expander_closed);
+
+  gtk_cell_renderer_pixbuf_clear_textures (cellpixbuf);
 
   G_OBJECT_CLASS (gtk_cell_renderer_pixbuf_parent_class)->finalize (object);
 }
@@ -242,13 +379,30 @@ gtk_cell_renderer_pixbuf_get_property (GObject        *object,
   GtkCellRendererPixbuf *cellpixbuf = GTK_CELL_RENDERER_PIXBUF (object);
   GtkCellRendererPixbufPrivate *priv = cellpixbuf->priv;
   cairo_surface_t *surface;
+  GdkTexture *texture;
   GdkPixbuf *pixbuf;
 
   switch (param_id)
     {
     case PROP_PIXBUF:
       pixbuf = NULL;
-      surface = gtk_image_definition_get_surface (priv->image_def);
+      texture = gtk_image_definition_get_texture (priv->image_def);
+      if (texture)
+        {
+          surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                                gdk_texture_get_width (texture),
+                                                gdk_texture_get_height (texture));
+          gdk_texture_download (texture,
+                                cairo_image_surface_get_data (surface),
+                                cairo_image_surface_get_stride (surface));
+          cairo_surface_mark_dirty (surface);
+        }
+      else
+        {
+          surface = gtk_image_definition_get_surface (priv->image_def);
+          if (surface)
+            cairo_surface_reference (surface);
+        }
       if (surface)
         {
           pixbuf = gdk_pixbuf_get_from_surface (surface, 0, 0,
@@ -352,27 +506,26 @@ gtk_cell_renderer_pixbuf_set_property (GObject      *object,
 {
   GtkCellRendererPixbuf *cellpixbuf = GTK_CELL_RENDERER_PIXBUF (object);
   GtkCellRendererPixbufPrivate *priv = cellpixbuf->priv;
-  cairo_surface_t *surface;
   GdkPixbuf *pixbuf;
 
   switch (param_id)
     {
     case PROP_PIXBUF:
-      surface = NULL;
       pixbuf = g_value_get_object (value);
-      if (pixbuf)
-        surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, 1, NULL);
-      take_image_definition (cellpixbuf, gtk_image_definition_new_surface (surface));
+      take_image_definition (cellpixbuf,
+                             gtk_image_definition_new_texture (gtk_cell_renderer_pixbuf_get_texture_for_pixbuf (cellpixbuf, pixbuf)));
       break;
     case PROP_PIXBUF_EXPANDER_OPEN:
       if (priv->pixbuf_expander_open)
         g_object_unref (priv->pixbuf_expander_open);
       priv->pixbuf_expander_open = (GdkPixbuf*) g_value_dup_object (value);
+      g_clear_object (&priv->texture_expander_open);
       break;
     case PROP_PIXBUF_EXPANDER_CLOSED:
       if (priv->pixbuf_expander_closed)
         g_object_unref (priv->pixbuf_expander_closed);
       priv->pixbuf_expander_closed = (GdkPixbuf*) g_value_dup_object (value);
+      g_clear_object (&priv->texture_expander_closed);
       break;
     case PROP_SURFACE:
       take_image_definition (cellpixbuf, gtk_image_definition_new_surface (g_value_get_boxed (value)));
@@ -524,7 +677,6 @@ gtk_cell_renderer_pixbuf_snapshot (GtkCellRenderer      *cell,
   gboolean is_expander;
   gint xpad, ypad;
   GtkIconHelper icon_helper;
-  cairo_surface_t *surface;
 
   gtk_cell_renderer_pixbuf_get_size (cell, widget, (GdkRectangle *) cell_area,
 				     &pix_rect.x, 
@@ -557,16 +709,16 @@ gtk_cell_renderer_pixbuf_snapshot (GtkCellRenderer      *cell,
       if (is_expanded && priv->pixbuf_expander_open != NULL)
         {
           gtk_icon_helper_init (&icon_helper, gtk_style_context_get_node (context), widget);
-          surface = gdk_cairo_surface_create_from_pixbuf (priv->pixbuf_expander_open, 1, NULL);
-          _gtk_icon_helper_set_surface (&icon_helper, surface);
-          cairo_surface_destroy (surface);
+          if (priv->texture_expander_open == NULL)
+            priv->texture_expander_open = texture_new_for_pixbuf (priv->pixbuf_expander_open);
+          _gtk_icon_helper_set_texture (&icon_helper, priv->texture_expander_open);
         }
       else if (!is_expanded && priv->pixbuf_expander_closed != NULL)
         {
           gtk_icon_helper_init (&icon_helper, gtk_style_context_get_node (context), widget);
-          surface = gdk_cairo_surface_create_from_pixbuf (priv->pixbuf_expander_closed, 1, NULL);
-          _gtk_icon_helper_set_surface (&icon_helper, surface);
-          cairo_surface_destroy (surface);
+          if (priv->texture_expander_closed == NULL)
+            priv->texture_expander_closed = texture_new_for_pixbuf (priv->pixbuf_expander_closed);
+          _gtk_icon_helper_set_texture (&icon_helper, priv->texture_expander_closed);
         }
       else
         {
@@ -414,10 +414,11 @@ gtk_cell_renderer_spinner_snapshot (GtkCellRenderer      *cellr,
   if (!gdk_rectangle_intersect (cell_area, &pix_rect, &draw_rect))
     return;
 
+  /* Only the spinner itself needs to be rasterized */
   cr = gtk_snapshot_append_cairo (snapshot,
                                   &GRAPHENE_RECT_INIT (
-                                      cell_area->x, cell_area->y,
-                                      cell_area->width, cell_area->height
+                                      draw_rect.x, draw_rect.y,
+                                      draw_rect.width, draw_rect.height
                                   ),
                                   "CellSpinner");
 
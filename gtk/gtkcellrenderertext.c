@@ -23,6 +23,7 @@
 #include "gtkentry.h"
 #include "gtkintl.h"
 #include "gtkmarshalers.h"
+#include "gtkpangolayoutcacheprivate.h"
 #include "gtkprivate.h"
 #include "gtksizerequest.h"
 #include "gtksnapshot.h"
@@ -1588,7 +1589,26 @@ get_layout (GtkCellRendererText *celltext,
       pango_layout_set_alignment (layout, align);
     }
   
-  return layout;
+  return gtk_pango_layout_cache_share (layout);
+}
+
+/* Layouts from get_layout() are shared, so changing their width
+ * needs a copy.
+ */
+static PangoLayout *
+set_layout_width (PangoLayout *layout,
+                  gint         width)
+{
+  PangoLayout *copy;
+
+  if (pango_layout_get_width (layout) == width)
+    return layout;
+
+  copy = pango_layout_copy (layout);
+  g_object_unref (layout);
+  pango_layout_set_width (copy, width);
+
+  return gtk_pango_layout_cache_share (copy);
 }
 
 
@@ -1737,10 +1757,10 @@ gtk_cell_renderer_text_snapshot (GtkCellRenderer      *cell,
   gtk_cell_renderer_get_padding (cell, &xpad, &ypad);
 
   if (priv->ellipsize_set && priv->ellipsize != PANGO_ELLIPSIZE_NONE)
-    pango_layout_set_width (layout,
-			    (cell_area->width - x_offset - 2 * xpad) * PANGO_SCALE);
+    layout = set_layout_width (layout,
+                               (cell_area->width - x_offset - 2 * xpad) * PANGO_SCALE);
   else if (priv->wrap_width == -1)
-    pango_layout_set_width (layout, -1);
+    layout = set_layout_width (layout, -1);
 
   pango_layout_get_pixel_extents (layout, NULL, &rect);
   x_offset = x_offset - rect.x;
@@ -2013,7 +2033,7 @@ gtk_cell_renderer_text_get_preferred_width (GtkCellRenderer *cell,
   layout = get_layout (celltext, widget, NULL, 0);
 
   /* Fetch the length of the complete unwrapped text */
-  pango_layout_set_width (layout, -1);
+  layout = set_layout_width (layout, -1);
   pango_layout_get_extents (layout, NULL, &rect);
   text_width = rect.width;
 
@@ -2085,7 +2105,7 @@ gtk_cell_renderer_text_get_preferred_height_for_width (GtkCellRenderer *cell,
 
   layout = get_layout (celltext, widget, NULL, 0);
 
-  pango_layout_set_width (layout, (width - xpad * 2) * PANGO_SCALE);
+  layout = set_layout_width (layout, (width - xpad * 2) * PANGO_SCALE);
   pango_layout_get_pixel_size (layout, NULL, &text_height);
 
   if (minimum_height)
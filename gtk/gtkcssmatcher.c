@@ -505,3 +505,20 @@ _gtk_css_matcher_superset_init (GtkCssMatcher       *matcher,
   matcher->superset.relevant = relevant;
 }
 
+/**
+ * _gtk_css_matcher_get_declaration:
+ * @matcher: a matcher
+ *
+ * Gets the declaration of the node that @matcher matches, if
+ * @matcher matches a #GtkCssNode.
+ *
+ * Returns: the declaration or %NULL
+ **/
+const GtkCssNodeDeclaration *
+_gtk_css_matcher_get_declaration (const GtkCssMatcher *matcher)
+{
+  if (matcher->klass != &GTK_CSS_MATCHER_NODE)
+    return NULL;
+
+  return gtk_css_node_get_declaration (matcher->node.node);
+}
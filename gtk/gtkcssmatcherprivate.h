@@ -85,6 +85,9 @@ void              _gtk_css_matcher_superset_init  (GtkCssMatcher          *match
                                                    const GtkCssMatcher    *subset,
                                                    GtkCssChange            relevant);
 
+const GtkCssNodeDeclaration *
+                  _gtk_css_matcher_get_declaration (const GtkCssMatcher   *matcher);
+
 
 static inline gboolean
 _gtk_css_matcher_get_parent (GtkCssMatcher       *matcher,
@@ -1280,6 +1280,35 @@ gtk_css_node_invalidate_style_provider (GtkCssNode *cssnode)
     }
 }
 
+void
+gtk_css_node_invalidate_style_provider_selectors (GtkCssNode               *cssnode,
+                                                  const GtkCssSelectorKeys *keys)
+{
+  GtkCssNode *child;
+
+  if (keys == NULL)
+    {
+      gtk_css_node_invalidate_style_provider (cssnode);
+      return;
+    }
+
+  /* The style caches are shared between nodes with the same declaration,
+   * so they may hold styles computed from rules that are gone now.
+   */
+  g_clear_pointer (&cssnode->cache, gtk_css_node_style_cache_unref);
+
+  if (_gtk_css_selector_keys_match (keys, cssnode->decl))
+    gtk_css_node_invalidate (cssnode, GTK_CSS_CHANGE_SOURCE);
+
+  for (child = cssnode->first_child;
+       child;
+       child = child->next_sibling)
+    {
+      if (gtk_css_node_get_style_provider_or_null (child) == NULL)
+        gtk_css_node_invalidate_style_provider_selectors (child, keys);
+    }
+}
+
 static void
 gtk_css_node_invalidate_timestamp (GtkCssNode *cssnode)
 {
@@ -20,6 +20,7 @@
 
 #include "gtkcssnodedeclarationprivate.h"
 #include "gtkcssnodestylecacheprivate.h"
+#include "gtkcssselectorprivate.h"
 #include "gtkcssstylechangeprivate.h"
 #include "gtkbitmaskprivate.h"
 #include "gtkcsstypesprivate.h"
@@ -148,6 +149,9 @@ GtkCssStyle *           gtk_css_node_get_style          (GtkCssNode            *
 
 void                    gtk_css_node_invalidate_style_provider
                                                         (GtkCssNode            *cssnode);
+void                    gtk_css_node_invalidate_style_provider_selectors
+                                                        (GtkCssNode            *cssnode,
+                                                         const GtkCssSelectorKeys *keys);
 void                    gtk_css_node_invalidate_frame_clock
                                                         (GtkCssNode            *cssnode,
                                                          gboolean               just_timestamp);
@@ -29,6 +29,7 @@
 #include "gtkcssarrayvalueprivate.h"
 #include "gtkcsscolorvalueprivate.h"
 #include "gtkcsskeyframesprivate.h"
+#include "gtkcssnodedeclarationprivate.h"
 #include "gtkcssparserprivate.h"
 #include "gtkcsssectionprivate.h"
 #include "gtkcssselectorprivate.h"
@@ -95,6 +96,7 @@ struct GtkCssRuleset
   GtkCssSelectorTree *selector_match;
   PropertyValue *styles;
   GtkBitmask *set_styles;
+  char *digest;
   guint n_styles;
   guint owns_styles : 1;
 };
@@ -119,6 +121,11 @@ struct _GtkCssProviderPrivate
   GtkCssSelectorTree *tree;
   GResource *resource;
   gchar *path;
+
+  GPtrArray *matches;     /* scratch buffer for lookups */
+  GHashTable *changes;    /* GtkCssNodeDeclaration => GtkCssChange */
+
+  guint incremental_reload : 1;
 };
 
 enum {
@@ -126,6 +133,8 @@ enum {
   LAST_SIGNAL
 };
 
+#define MAX_CACHED_CHANGES 1024
+
 static gboolean gtk_keep_css_sections = FALSE;
 
 static guint css_provider_signals[LAST_SIGNAL] = { 0 };
@@ -141,6 +150,10 @@ gtk_css_provider_load_internal (GtkCssProvider *css_provider,
                                 GtkCssScanner  *scanner,
                                 GFile          *file,
                                 const char     *data);
+static char *
+gtk_css_ruleset_get_digest (const GtkCssRuleset *ruleset);
+static char *
+gtk_css_provider_get_definitions (GtkCssProvider *provider);
 
 GQuark
 gtk_css_provider_error_quark (void)
@@ -263,6 +276,7 @@ gtk_css_ruleset_clear (GtkCssRuleset *ruleset)
     _gtk_bitmask_free (ruleset->set_styles);
   if (ruleset->selector)
     _gtk_css_selector_free (ruleset->selector);
+  g_free (ruleset->digest);
 
   memset (ruleset, 0, sizeof (GtkCssRuleset));
 }
@@ -433,6 +447,11 @@ gtk_css_provider_init (GtkCssProvider *css_provider)
   priv = css_provider->priv = gtk_css_provider_get_instance_private (css_provider);
 
   priv->rulesets = g_array_new (FALSE, FALSE, sizeof (GtkCssRuleset));
+  priv->matches = g_ptr_array_sized_new (32);
+  priv->changes = g_hash_table_new_full (gtk_css_node_declaration_hash,
+                                         gtk_css_node_declaration_equal,
+                                         (GDestroyNotify) gtk_css_node_declaration_unref,
+                                         NULL);
 
   priv->symbolic_colors = g_hash_table_new_full (g_str_hash, g_str_equal,
                                                  (GDestroyNotify) g_free,
@@ -490,23 +509,21 @@ verify_tree_get_change_results (GtkCssProvider *provider,
     GPtrArray *tree_rules;
     int i;
 
-    tree_rules = _gtk_css_selector_tree_match_all (provider->priv->tree, matcher);
-    if (tree_rules)
-      {
-        verify_tree_match_results (provider, matcher, tree_rules);
-
-        for (i = tree_rules->len - 1; i >= 0; i--)
-          {
-	    GtkCssRuleset *ruleset;
+    tree_rules = g_ptr_array_new ();
+    _gtk_css_selector_tree_match_all (provider->priv->tree, matcher, tree_rules);
+    verify_tree_match_results (provider, matcher, tree_rules);
 
-            ruleset = tree_rules->pdata[i];
+    for (i = tree_rules->len - 1; i >= 0; i--)
+      {
+        GtkCssRuleset *ruleset;
 
-            verify_change |= _gtk_css_selector_get_change (ruleset->selector);
-          }
+        ruleset = tree_rules->pdata[i];
 
-        g_ptr_array_free (tree_rules, TRUE);
+        verify_change |= _gtk_css_selector_get_change (ruleset->selector);
       }
 
+    g_ptr_array_free (tree_rules, TRUE);
+
     if (change != verify_change)
       {
 	GString *s;
@@ -552,6 +569,42 @@ gtk_css_style_provider_get_keyframes (GtkStyleProvider *provider,
   return g_hash_table_lookup (css_provider->priv->keyframes, name);
 }
 
+static GtkCssChange
+gtk_css_style_provider_get_change (GtkCssProvider      *css_provider,
+                                   const GtkCssMatcher *matcher)
+{
+  GtkCssProviderPrivate *priv = css_provider->priv;
+  const GtkCssNodeDeclaration *decl;
+  GtkCssMatcher change_matcher;
+  GtkCssChange change;
+  gpointer cached;
+
+  /* The superset matcher only looks at the name, id and classes of
+   * the node itself, so the change is the same for every node with
+   * the same declaration, no matter where it is in the tree. */
+  decl = _gtk_css_matcher_get_declaration (matcher);
+  if (decl && g_hash_table_lookup_extended (priv->changes, decl, NULL, &cached))
+    return GPOINTER_TO_UINT (cached);
+
+  _gtk_css_matcher_superset_init (&change_matcher, matcher, GTK_CSS_CHANGE_NAME | GTK_CSS_CHANGE_CLASS);
+
+  change = _gtk_css_selector_tree_get_change_all (priv->tree, &change_matcher);
+  verify_tree_get_change_results (css_provider, &change_matcher, change);
+
+  if (decl)
+    {
+      /* Declarations also differ by state, so don't let this grow forever */
+      if (g_hash_table_size (priv->changes) >= MAX_CACHED_CHANGES)
+        g_hash_table_remove_all (priv->changes);
+
+      g_hash_table_insert (priv->changes,
+                           gtk_css_node_declaration_ref ((GtkCssNodeDeclaration *) decl),
+                           GUINT_TO_POINTER (change));
+    }
+
+  return change;
+}
+
 static void
 gtk_css_style_provider_lookup (GtkStyleProvider    *provider,
                                const GtkCssMatcher *matcher,
@@ -561,59 +614,50 @@ gtk_css_style_provider_lookup (GtkStyleProvider    *provider,
   GtkCssProvider *css_provider;
   GtkCssProviderPrivate *priv;
   GtkCssRuleset *ruleset;
+  GPtrArray *tree_rules;
   guint j;
   int i;
-  GPtrArray *tree_rules;
 
   css_provider = GTK_CSS_PROVIDER (provider);
   priv = css_provider->priv;
 
-  tree_rules = _gtk_css_selector_tree_match_all (priv->tree, matcher);
-  if (tree_rules)
-    {
-      verify_tree_match_results (css_provider, matcher, tree_rules);
-
-      for (i = tree_rules->len - 1; i >= 0; i--)
-        {
-          ruleset = tree_rules->pdata[i];
+  tree_rules = priv->matches;
+  _gtk_css_selector_tree_match_all (priv->tree, matcher, tree_rules);
+  verify_tree_match_results (css_provider, matcher, tree_rules);
 
-          if (ruleset->styles == NULL)
-            continue;
+  for (i = tree_rules->len - 1; i >= 0; i--)
+    {
+      ruleset = tree_rules->pdata[i];
 
-          if (!_gtk_bitmask_intersects (_gtk_css_lookup_get_missing (lookup),
-                                        ruleset->set_styles))
-          continue;
+      if (ruleset->styles == NULL)
+        continue;
 
-          for (j = 0; j < ruleset->n_styles; j++)
-            {
-              GtkCssStyleProperty *prop = ruleset->styles[j].property;
-              guint id = _gtk_css_style_property_get_id (prop);
+      if (!_gtk_bitmask_intersects (_gtk_css_lookup_get_missing (lookup),
+                                    ruleset->set_styles))
+        continue;
 
-              if (!_gtk_css_lookup_is_missing (lookup, id))
-                continue;
+      for (j = 0; j < ruleset->n_styles; j++)
+        {
+          GtkCssStyleProperty *prop = ruleset->styles[j].property;
+          guint id = _gtk_css_style_property_get_id (prop);
 
-              _gtk_css_lookup_set (lookup,
-                                   id,
-                                   ruleset->styles[j].section,
-                                  ruleset->styles[j].value);
-            }
+          if (!_gtk_css_lookup_is_missing (lookup, id))
+            continue;
 
-          if (_gtk_bitmask_is_empty (_gtk_css_lookup_get_missing (lookup)))
-            break;
+          _gtk_css_lookup_set (lookup,
+                               id,
+                               ruleset->styles[j].section,
+                               ruleset->styles[j].value);
         }
 
-      g_ptr_array_free (tree_rules, TRUE);
+      if (_gtk_bitmask_is_empty (_gtk_css_lookup_get_missing (lookup)))
+        break;
     }
 
-  if (change)
-    {
-      GtkCssMatcher change_matcher;
-
-      _gtk_css_matcher_superset_init (&change_matcher, matcher, GTK_CSS_CHANGE_NAME | GTK_CSS_CHANGE_CLASS);
+  g_ptr_array_set_size (tree_rules, 0);
 
-      *change = _gtk_css_selector_tree_get_change_all (priv->tree, &change_matcher);
-      verify_tree_get_change_results (css_provider, &change_matcher, *change);
-    }
+  if (change)
+    *change = gtk_css_style_provider_get_change (css_provider, matcher);
 }
 
 static void
@@ -640,6 +684,8 @@ gtk_css_provider_finalize (GObject *object)
 
   g_array_free (priv->rulesets, TRUE);
   _gtk_css_selector_tree_free (priv->tree);
+  g_ptr_array_free (priv->matches, TRUE);
+  g_hash_table_destroy (priv->changes);
 
   g_hash_table_destroy (priv->symbolic_colors);
   g_hash_table_destroy (priv->keyframes);
@@ -781,6 +827,7 @@ gtk_css_provider_reset (GtkCssProvider *css_provider)
   g_array_set_size (priv->rulesets, 0);
   _gtk_css_selector_tree_free (priv->tree);
   priv->tree = NULL;
+  g_hash_table_remove_all (priv->changes);
 
 }
 
@@ -1350,6 +1397,20 @@ gtk_css_provider_postprocess (GtkCssProvider *css_provider)
 
   g_array_sort (priv->rulesets, gtk_css_provider_compare_rule);
 
+  /* Digests are computed before building the tree, as that reorders
+   * the selectors. */
+  if (priv->incremental_reload)
+    {
+      for (i = 0; i < priv->rulesets->len; i++)
+        {
+          GtkCssRuleset *ruleset;
+
+          ruleset = &g_array_index (priv->rulesets, GtkCssRuleset, i);
+
+          ruleset->digest = gtk_css_ruleset_get_digest (ruleset);
+        }
+    }
+
   builder = _gtk_css_selector_tree_builder_new ();
   for (i = 0; i < priv->rulesets->len; i++)
     {
@@ -1367,14 +1428,18 @@ gtk_css_provider_postprocess (GtkCssProvider *css_provider)
   _gtk_css_selector_tree_builder_free (builder);
 
 #ifndef VERIFY_TREE
-  for (i = 0; i < priv->rulesets->len; i++)
+  /* Incremental reloads need the selectors to compute the affected keys */
+  if (!priv->incremental_reload)
     {
-      GtkCssRuleset *ruleset;
+      for (i = 0; i < priv->rulesets->len; i++)
+        {
+          GtkCssRuleset *ruleset;
 
-      ruleset = &g_array_index (priv->rulesets, GtkCssRuleset, i);
+          ruleset = &g_array_index (priv->rulesets, GtkCssRuleset, i);
 
-      _gtk_css_selector_free (ruleset->selector);
-      ruleset->selector = NULL;
+          _gtk_css_selector_free (ruleset->selector);
+          ruleset->selector = NULL;
+        }
     }
 #endif
 }
@@ -1453,6 +1518,169 @@ gtk_css_provider_load_internal (GtkCssProvider *css_provider,
     g_bytes_unref (bytes);
 }
 
+/* Marks the rulesets in @rulesets that also exist in @other as unchanged.
+ * Identical rulesets are matched up in order. */
+static void
+gtk_css_provider_mark_changed_rulesets (GArray   *rulesets,
+                                        GArray   *other,
+                                        gboolean *changed)
+{
+  GHashTable *counts;
+  guint i;
+
+  counts = g_hash_table_new (g_str_hash, g_str_equal);
+
+  for (i = 0; i < other->len; i++)
+    {
+      const char *digest = g_array_index (other, GtkCssRuleset, i).digest;
+      guint count = GPOINTER_TO_UINT (g_hash_table_lookup (counts, digest));
+
+      g_hash_table_insert (counts, (gpointer) digest, GUINT_TO_POINTER (count + 1));
+    }
+
+  for (i = 0; i < rulesets->len; i++)
+    {
+      const char *digest = g_array_index (rulesets, GtkCssRuleset, i).digest;
+      guint count = GPOINTER_TO_UINT (g_hash_table_lookup (counts, digest));
+
+      changed[i] = count == 0;
+      if (count > 0)
+        g_hash_table_insert (counts, (gpointer) digest, GUINT_TO_POINTER (count - 1));
+    }
+
+  g_hash_table_unref (counts);
+}
+
+static gboolean
+gtk_css_provider_add_changed_rulesets (GArray             *rulesets,
+                                       const gboolean     *changed,
+                                       GtkCssSelectorKeys *keys)
+{
+  guint i;
+
+  for (i = 0; i < rulesets->len; i++)
+    {
+      if (!changed[i])
+        continue;
+
+      if (!_gtk_css_selector_keys_add (keys, g_array_index (rulesets, GtkCssRuleset, i).selector))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+/* Computes the keys of all selectors whose rulesets were added, removed
+ * or changed their relative order between @old_rulesets and the current
+ * rulesets. Returns %NULL if every node may be affected.
+ */
+static GtkCssSelectorKeys *
+gtk_css_provider_diff_rulesets (GtkCssProvider *css_provider,
+                                GArray         *old_rulesets)
+{
+  GArray *new_rulesets = css_provider->priv->rulesets;
+  GtkCssSelectorKeys *keys;
+  gboolean *old_changed, *new_changed;
+  guint i, o, n;
+
+  for (i = 0; i < old_rulesets->len; i++)
+    {
+      if (g_array_index (old_rulesets, GtkCssRuleset, i).digest == NULL)
+        return NULL;
+    }
+
+  old_changed = g_new (gboolean, old_rulesets->len + 1);
+  new_changed = g_new (gboolean, new_rulesets->len + 1);
+
+  gtk_css_provider_mark_changed_rulesets (old_rulesets, new_rulesets, old_changed);
+  gtk_css_provider_mark_changed_rulesets (new_rulesets, old_rulesets, new_changed);
+
+  /* Both arrays are sorted by specificity and keep the source order
+   * otherwise, so the common rulesets must appear in the same order.
+   * Where they don't, both rulesets get marked. Of any two rulesets
+   * that swapped places, at least one ends up at a different index
+   * and is marked that way.
+   */
+  o = n = 0;
+  while (TRUE)
+    {
+      while (o < old_rulesets->len && old_changed[o])
+        o++;
+      while (n < new_rulesets->len && new_changed[n])
+        n++;
+
+      if (o >= old_rulesets->len || n >= new_rulesets->len)
+        break;
+
+      if (!g_str_equal (g_array_index (old_rulesets, GtkCssRuleset, o).digest,
+                        g_array_index (new_rulesets, GtkCssRuleset, n).digest))
+        {
+          old_changed[o] = TRUE;
+          new_changed[n] = TRUE;
+        }
+
+      o++;
+      n++;
+    }
+
+  keys = _gtk_css_selector_keys_new ();
+
+  if (!gtk_css_provider_add_changed_rulesets (old_rulesets, old_changed, keys) ||
+      !gtk_css_provider_add_changed_rulesets (new_rulesets, new_changed, keys))
+    g_clear_pointer (&keys, _gtk_css_selector_keys_free);
+
+  g_free (old_changed);
+  g_free (new_changed);
+
+  return keys;
+}
+
+static void
+gtk_css_provider_reload (GtkCssProvider *css_provider,
+                         GFile          *file,
+                         const char     *data)
+{
+  GtkCssProviderPrivate *priv = css_provider->priv;
+  GtkCssSelectorKeys *keys;
+  GArray *old_rulesets;
+  char *old_definitions, *new_definitions;
+  guint i;
+
+  if (!priv->incremental_reload)
+    {
+      gtk_css_provider_reset (css_provider);
+      gtk_css_provider_load_internal (css_provider, NULL, file, data);
+      gtk_style_provider_changed (GTK_STYLE_PROVIDER (css_provider));
+      return;
+    }
+
+  old_rulesets = priv->rulesets;
+  old_definitions = gtk_css_provider_get_definitions (css_provider);
+  priv->rulesets = g_array_new (FALSE, FALSE, sizeof (GtkCssRuleset));
+
+  gtk_css_provider_reset (css_provider);
+  gtk_css_provider_load_internal (css_provider, NULL, file, data);
+
+  /* Colors and keyframes can be referenced from anywhere */
+  new_definitions = gtk_css_provider_get_definitions (css_provider);
+  if (g_str_equal (old_definitions, new_definitions))
+    keys = gtk_css_provider_diff_rulesets (css_provider, old_rulesets);
+  else
+    keys = NULL;
+
+  if (keys == NULL)
+    gtk_style_provider_changed (GTK_STYLE_PROVIDER (css_provider));
+  else if (!_gtk_css_selector_keys_is_empty (keys))
+    gtk_style_provider_changed_selectors (GTK_STYLE_PROVIDER (css_provider), keys);
+
+  g_clear_pointer (&keys, _gtk_css_selector_keys_free);
+  g_free (old_definitions);
+  g_free (new_definitions);
+  for (i = 0; i < old_rulesets->len; i++)
+    gtk_css_ruleset_clear (&g_array_index (old_rulesets, GtkCssRuleset, i));
+  g_array_free (old_rulesets, TRUE);
+}
+
 /**
  * gtk_css_provider_load_from_data:
  * @css_provider: a #GtkCssProvider
@@ -1485,13 +1713,9 @@ gtk_css_provider_load_from_data (GtkCssProvider  *css_provider,
       data = free_data;
     }
 
-  gtk_css_provider_reset (css_provider);
-
-  gtk_css_provider_load_internal (css_provider, NULL, NULL, data);
+  gtk_css_provider_reload (css_provider, NULL, data);
 
   g_free (free_data);
-
-  gtk_style_provider_changed (GTK_STYLE_PROVIDER (css_provider));
 }
 
 /**
@@ -1509,11 +1733,7 @@ gtk_css_provider_load_from_file (GtkCssProvider  *css_provider,
   g_return_if_fail (GTK_IS_CSS_PROVIDER (css_provider));
   g_return_if_fail (G_IS_FILE (file));
 
-  gtk_css_provider_reset (css_provider);
-
-  gtk_css_provider_load_internal (css_provider, NULL, file, NULL);
-
-  gtk_style_provider_changed (GTK_STYLE_PROVIDER (css_provider));
+  gtk_css_provider_reload (css_provider, file, NULL);
 }
 
 /**
@@ -1574,6 +1794,49 @@ gtk_css_provider_load_from_resource (GtkCssProvider *css_provider,
   g_object_unref (file);
 }
 
+/**
+ * gtk_css_provider_set_incremental_reload:
+ * @css_provider: a #GtkCssProvider
+ * @incremental_reload: %TRUE to only restyle what changed when reloading
+ *
+ * Sets whether loading new data into @css_provider compares the new
+ * rules with the previously loaded ones. If it does, only the style
+ * of nodes that can be affected by rules that were added, removed or
+ * changed gets recomputed, instead of the style of every node.
+ *
+ * This makes loading somewhat slower and uses more memory, but is
+ * useful for providers that are frequently reloaded with mostly
+ * unchanged data.
+ *
+ * The setting takes effect for data loaded after this call, so the
+ * first reload after enabling it still restyles every node.
+ */
+void
+gtk_css_provider_set_incremental_reload (GtkCssProvider *css_provider,
+                                         gboolean        incremental_reload)
+{
+  g_return_if_fail (GTK_IS_CSS_PROVIDER (css_provider));
+
+  css_provider->priv->incremental_reload = incremental_reload;
+}
+
+/**
+ * gtk_css_provider_get_incremental_reload:
+ * @css_provider: a #GtkCssProvider
+ *
+ * Returns whether @css_provider only restyles affected nodes when
+ * reloading. See gtk_css_provider_set_incremental_reload().
+ *
+ * Returns: %TRUE if reloading is incremental
+ */
+gboolean
+gtk_css_provider_get_incremental_reload (GtkCssProvider *css_provider)
+{
+  g_return_val_if_fail (GTK_IS_CSS_PROVIDER (css_provider), FALSE);
+
+  return css_provider->priv->incremental_reload;
+}
+
 /**
  * gtk_css_provider_get_default:
  *
@@ -1846,13 +2109,11 @@ compare_properties (gconstpointer a, gconstpointer b, gpointer style)
 }
 
 static void
-gtk_css_ruleset_print (const GtkCssRuleset *ruleset,
-                       GString             *str)
+gtk_css_ruleset_print_declarations (const GtkCssRuleset *ruleset,
+                                    GString             *str)
 {
   guint i;
 
-  _gtk_css_selector_tree_match_print (ruleset->selector_match, str);
-
   g_string_append (str, " {\n");
 
   if (ruleset->styles)
@@ -1881,6 +2142,29 @@ gtk_css_ruleset_print (const GtkCssRuleset *ruleset,
   g_string_append (str, "}\n");
 }
 
+static void
+gtk_css_ruleset_print (const GtkCssRuleset *ruleset,
+                       GString             *str)
+{
+  _gtk_css_selector_tree_match_print (ruleset->selector_match, str);
+  gtk_css_ruleset_print_declarations (ruleset, str);
+}
+
+/* Returns a string that is identical for rulesets that have
+ * the same selector and the same declarations. */
+static char *
+gtk_css_ruleset_get_digest (const GtkCssRuleset *ruleset)
+{
+  GString *str;
+
+  str = g_string_new (NULL);
+
+  _gtk_css_selector_print (ruleset->selector, str);
+  gtk_css_ruleset_print_declarations (ruleset, str);
+
+  return g_string_free (str, FALSE);
+}
+
 static void
 gtk_css_provider_print_colors (GHashTable *colors,
                                GString    *str)
@@ -1933,6 +2217,21 @@ gtk_css_provider_print_keyframes (GHashTable *keyframes,
   g_list_free (keys);
 }
 
+/* Returns the color and keyframes definitions, as they would
+ * be printed by gtk_css_provider_to_string(). */
+static char *
+gtk_css_provider_get_definitions (GtkCssProvider *provider)
+{
+  GString *str;
+
+  str = g_string_new ("");
+
+  gtk_css_provider_print_colors (provider->priv->symbolic_colors, str);
+  gtk_css_provider_print_keyframes (provider->priv->keyframes, str);
+
+  return g_string_free (str, FALSE);
+}
+
 /**
  * gtk_css_provider_to_string:
  * @provider: the provider to write to a string
@@ -109,6 +109,12 @@ GDK_AVAILABLE_IN_ALL
 void             gtk_css_provider_load_from_resource (GtkCssProvider *css_provider,
                                                       const gchar    *resource_path);
 
+GDK_AVAILABLE_IN_ALL
+void             gtk_css_provider_set_incremental_reload (GtkCssProvider *css_provider,
+                                                          gboolean        incremental_reload);
+GDK_AVAILABLE_IN_ALL
+gboolean         gtk_css_provider_get_incremental_reload (GtkCssProvider *css_provider);
+
 GDK_AVAILABLE_IN_ALL
 GtkCssProvider * gtk_css_provider_get_default (void);
 
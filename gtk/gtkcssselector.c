@@ -134,26 +134,8 @@ gtk_css_selector_tree_get_matches (const GtkCssSelectorTree *tree)
 }
 
 static void
-g_ptr_array_insert_sorted (GPtrArray *array,
-                           gpointer   data)
-{
-  gint i;
-
-  for (i = 0; i < array->len; i++)
-    {
-      if (data == array->pdata[i])
-        return;
-
-      if (data < array->pdata[i])
-        break;
-    }
-
-  g_ptr_array_insert (array, i, data);
-}
-
-static void
-gtk_css_selector_tree_found_match (const GtkCssSelectorTree  *tree,
-				   GPtrArray                **array)
+gtk_css_selector_tree_found_match (const GtkCssSelectorTree *tree,
+				   GPtrArray                *array)
 {
   int i;
   gpointer *matches;
@@ -161,14 +143,21 @@ gtk_css_selector_tree_found_match (const GtkCssSelectorTree  *tree,
   matches = gtk_css_selector_tree_get_matches (tree);
   if (matches)
     {
-      if (!*array)
-        *array = g_ptr_array_sized_new (16);
-
       for (i = 0; matches[i] != NULL; i++)
-        g_ptr_array_insert_sorted (*array, matches[i]);
+        g_ptr_array_add (array, matches[i]);
     }
 }
 
+static int
+compare_matches (gconstpointer a,
+                 gconstpointer b)
+{
+  gpointer pa = *(gpointer *) a;
+  gpointer pb = *(gpointer *) b;
+
+  return pa < pb ? -1 : pa > pb;
+}
+
 static gboolean
 gtk_css_selector_match (const GtkCssSelector *selector,
                         const GtkCssMatcher  *matcher)
@@ -1406,6 +1395,122 @@ _gtk_css_selector_get_change (const GtkCssSelector *selector)
   return selector->class->get_change (selector, _gtk_css_selector_get_change (gtk_css_selector_previous (selector)));
 }
 
+/******************** Selector keys *****************/
+
+/* A set of the names, ids and classes that the rightmost compound
+ * selectors of a number of selectors require. Any node matched by
+ * one of those selectors must carry at least one of the keys, so
+ * this can be used to limit invalidation after a stylesheet only
+ * changed a few rules.
+ */
+struct _GtkCssSelectorKeys {
+  GHashTable *names;    /* interned */
+  GHashTable *ids;      /* interned */
+  GHashTable *classes;  /* GQuark */
+};
+
+GtkCssSelectorKeys *
+_gtk_css_selector_keys_new (void)
+{
+  GtkCssSelectorKeys *keys;
+
+  keys = g_slice_new (GtkCssSelectorKeys);
+  keys->names = g_hash_table_new (NULL, NULL);
+  keys->ids = g_hash_table_new (NULL, NULL);
+  keys->classes = g_hash_table_new (NULL, NULL);
+
+  return keys;
+}
+
+void
+_gtk_css_selector_keys_free (GtkCssSelectorKeys *keys)
+{
+  g_hash_table_unref (keys->names);
+  g_hash_table_unref (keys->ids);
+  g_hash_table_unref (keys->classes);
+
+  g_slice_free (GtkCssSelectorKeys, keys);
+}
+
+/**
+ * _gtk_css_selector_keys_add:
+ * @keys: the keys to add to
+ * @selector: the selector to add
+ *
+ * Adds the most specific key of the rightmost compound selector
+ * of @selector to @keys. States and positions are not considered,
+ * as nodes compute their change mask independent of them.
+ *
+ * Returns: %FALSE if @selector does not require any name, id or
+ *   class, in which case it may match any node.
+ **/
+gboolean
+_gtk_css_selector_keys_add (GtkCssSelectorKeys   *keys,
+                            const GtkCssSelector *selector)
+{
+  const GtkCssSelector *name = NULL, *style_class = NULL;
+
+  for (;
+       selector && selector->class->is_simple;
+       selector = gtk_css_selector_previous (selector))
+    {
+      if (selector->class == &GTK_CSS_SELECTOR_ID)
+        {
+          g_hash_table_add (keys->ids, (gpointer) selector->id.name);
+          return TRUE;
+        }
+      else if (selector->class == &GTK_CSS_SELECTOR_CLASS)
+        style_class = selector;
+      else if (selector->class == &GTK_CSS_SELECTOR_NAME)
+        name = selector;
+    }
+
+  if (style_class)
+    g_hash_table_add (keys->classes, GUINT_TO_POINTER (style_class->style_class.style_class));
+  else if (name)
+    g_hash_table_add (keys->names, (gpointer) name->name.name);
+  else
+    return FALSE;
+
+  return TRUE;
+}
+
+gboolean
+_gtk_css_selector_keys_is_empty (const GtkCssSelectorKeys *keys)
+{
+  return g_hash_table_size (keys->names) == 0 &&
+         g_hash_table_size (keys->ids) == 0 &&
+         g_hash_table_size (keys->classes) == 0;
+}
+
+gboolean
+_gtk_css_selector_keys_match (const GtkCssSelectorKeys    *keys,
+                              const GtkCssNodeDeclaration *decl)
+{
+  const GQuark *classes;
+  const char *id;
+  guint i, n_classes;
+
+  if (g_hash_table_contains (keys->names, gtk_css_node_declaration_get_name (decl)))
+    return TRUE;
+
+  id = gtk_css_node_declaration_get_id (decl);
+  if (id && g_hash_table_contains (keys->ids, id))
+    return TRUE;
+
+  if (g_hash_table_size (keys->classes) == 0)
+    return FALSE;
+
+  classes = gtk_css_node_declaration_get_classes (decl, &n_classes);
+  for (i = 0; i < n_classes; i++)
+    {
+      if (g_hash_table_contains (keys->classes, GUINT_TO_POINTER (classes[i])))
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
 /******************** SelectorTree handling *****************/
 
 static GHashTable *
@@ -1497,17 +1602,41 @@ gtk_css_selector_tree_match_foreach (const GtkCssSelector *selector,
   return FALSE;
 }
 
-GPtrArray *
+/**
+ * _gtk_css_selector_tree_match_all:
+ * @tree: the tree to match
+ * @matcher: the matcher to match against
+ * @results: array to append the matches to
+ *
+ * Finds all matches of @tree for @matcher and appends them to
+ * @results, sorted by address and without duplicates. @results
+ * is expected to be empty and can be reused between calls to
+ * avoid allocations.
+ **/
+void
 _gtk_css_selector_tree_match_all (const GtkCssSelectorTree *tree,
-				  const GtkCssMatcher *matcher)
+				  const GtkCssMatcher      *matcher,
+				  GPtrArray                *results)
 {
-  GPtrArray *array = NULL;
+  guint i, j;
 
   for (; tree != NULL;
        tree = gtk_css_selector_tree_get_sibling (tree))
-    gtk_css_selector_foreach (&tree->selector, matcher, gtk_css_selector_tree_match_foreach, &array);
+    gtk_css_selector_foreach (&tree->selector, matcher, gtk_css_selector_tree_match_foreach, results);
 
-  return array;
+  if (results->len < 2)
+    return;
+
+  /* Descendant and sibling selectors may find the same match
+   * multiple times, so sort once and drop the duplicates. */
+  g_ptr_array_sort (results, compare_matches);
+
+  for (i = 1, j = 1; i < results->len; i++)
+    {
+      if (results->pdata[i] != results->pdata[j - 1])
+        results->pdata[j++] = results->pdata[i];
+    }
+  g_ptr_array_set_size (results, j);
 }
 
 /* When checking for changes via the tree we need to know if a rule further
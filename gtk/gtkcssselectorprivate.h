@@ -19,6 +19,7 @@
 #define __GTK_CSS_SELECTOR_PRIVATE_H__
 
 #include "gtk/gtkcssmatcherprivate.h"
+#include "gtk/gtkcssnodedeclarationprivate.h"
 #include "gtk/gtkcssparserprivate.h"
 
 G_BEGIN_DECLS
@@ -26,6 +27,7 @@ G_BEGIN_DECLS
 typedef union _GtkCssSelector GtkCssSelector;
 typedef struct _GtkCssSelectorTree GtkCssSelectorTree;
 typedef struct _GtkCssSelectorTreeBuilder GtkCssSelectorTreeBuilder;
+typedef struct _GtkCssSelectorKeys GtkCssSelectorKeys;
 
 GtkCssSelector *  _gtk_css_selector_parse           (GtkCssParser           *parser);
 void              _gtk_css_selector_free            (GtkCssSelector         *selector);
@@ -41,8 +43,9 @@ int               _gtk_css_selector_compare         (const GtkCssSelector   *a,
                                                      const GtkCssSelector   *b);
 
 void         _gtk_css_selector_tree_free             (GtkCssSelectorTree       *tree);
-GPtrArray *  _gtk_css_selector_tree_match_all        (const GtkCssSelectorTree *tree,
-						      const GtkCssMatcher      *matcher);
+void         _gtk_css_selector_tree_match_all        (const GtkCssSelectorTree *tree,
+						      const GtkCssMatcher      *matcher,
+						      GPtrArray                *results);
 GtkCssChange _gtk_css_selector_tree_get_change_all   (const GtkCssSelectorTree *tree,
 						      const GtkCssMatcher *matcher);
 void         _gtk_css_selector_tree_match_print      (const GtkCssSelectorTree *tree,
@@ -57,6 +60,14 @@ void                       _gtk_css_selector_tree_builder_add   (GtkCssSelectorT
 GtkCssSelectorTree *       _gtk_css_selector_tree_builder_build (GtkCssSelectorTreeBuilder *builder);
 void                       _gtk_css_selector_tree_builder_free  (GtkCssSelectorTreeBuilder *builder);
 
+GtkCssSelectorKeys *       _gtk_css_selector_keys_new           (void);
+void                       _gtk_css_selector_keys_free          (GtkCssSelectorKeys        *keys);
+gboolean                   _gtk_css_selector_keys_add           (GtkCssSelectorKeys        *keys,
+                                                                 const GtkCssSelector      *selector);
+gboolean                   _gtk_css_selector_keys_is_empty      (const GtkCssSelectorKeys  *keys);
+gboolean                   _gtk_css_selector_keys_match         (const GtkCssSelectorKeys  *keys,
+                                                                 const GtkCssNodeDeclaration *decl);
+
 const char *gtk_css_pseudoclass_name (GtkStateFlags flags);
 
 G_END_DECLS
@@ -110,6 +110,26 @@ gtk_css_style_change_changes_property (GtkCssStyleChange *change,
   return _gtk_bitmask_get (change->changes, id);
 }
 
+gboolean
+gtk_css_style_change_changes_only_property (GtkCssStyleChange *change,
+                                            guint              id)
+{
+  GtkBitmask *others;
+  gboolean result;
+
+  while (gtk_css_style_compare_next_value (change))
+    ;
+
+  if (!_gtk_bitmask_get (change->changes, id))
+    return FALSE;
+
+  others = _gtk_bitmask_set (_gtk_bitmask_copy (change->changes), id, FALSE);
+  result = _gtk_bitmask_is_empty (others);
+  _gtk_bitmask_free (others);
+
+  return result;
+}
+
 void
 gtk_css_style_change_print (GtkCssStyleChange *change,
                             GString           *string)
@@ -0,0 +1,1587 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkgridview.h"
+
+#include "gtkadjustment.h"
+#include "gtkcssnodeprivate.h"
+#include "gtkgesturedrag.h"
+#include "gtkintl.h"
+#include "gtkmain.h"
+#include "gtkprivate.h"
+#include "gtkscrollable.h"
+#include "gtksnapshot.h"
+#include "gtkstylecontextprivate.h"
+#include "gtkwidgetprivate.h"
+
+#include <math.h>
+
+/**
+ * SECTION:gtkgridview
+ * @Short_description: A scrollable grid for large models
+ * @Title: GtkGridView
+ * @See_also: #GListModel, #GtkListView, #GtkFlowBox
+ *
+ * GtkGridView displays the items of a #GListModel in a grid of equally
+ * sized cells. The number of columns is computed from the available
+ * width, between #GtkGridView:min-columns and #GtkGridView:max-columns.
+ *
+ * Like #GtkListView, it only creates as many cell widgets as are needed
+ * to fill the visible area and reuses them for other items while
+ * scrolling, so it can be used for models with a very large number of
+ * items where #GtkFlowBox or #GtkIconView would be too slow.
+ *
+ * Cells are created with a #GtkGridViewCreateWidgetFunc and made to
+ * display an item with a #GtkGridViewBindWidgetFunc, see
+ * gtk_grid_view_bind_model(). All cells get the size of the first item
+ * of the model. Measuring every item would need a widget for each of
+ * them, which is what GtkGridView avoids, so the first item should be
+ * representative of the others.
+ *
+ * The selection is kept by position in the model, not in the cell
+ * widgets, so items can be selected while they are not displayed, for
+ * example with rubberband selection or gtk_grid_view_select_all().
+ * Cell widgets that display a selected item have the
+ * %GTK_STATE_FLAG_SELECTED state.
+ *
+ * GtkGridView implements #GtkScrollable and is meant to be put directly
+ * into a #GtkScrolledWindow.
+ *
+ * # CSS nodes
+ *
+ * |[<!-- language="plain" -->
+ * gridview
+ * ├── <cell widgets>
+ * ╰── [rubberband]
+ * ]|
+ *
+ * GtkGridView uses a single CSS node named gridview. The cell widgets
+ * are its children. For rubberband selection, a subnode with name
+ * rubberband is used.
+ */
+
+/* Extra rows above and below the visible area, in pages */
+#define OVERSCAN 0.5
+
+#define RUBBERBAND_START_DISTANCE 32
+
+struct _GtkGridView
+{
+  GtkWidget parent_instance;
+
+  GListModel *model;
+  GtkGridViewCreateWidgetFunc create_widget_func;
+  GtkGridViewBindWidgetFunc bind_widget_func;
+  gpointer user_data;
+  GDestroyNotify user_data_free_func;
+
+  GtkAdjustment *adjustment[2];
+  guint scroll_policy[2];
+
+  guint min_columns;
+  guint max_columns;
+
+  /* Displays the first item, whose size is used for all cells. It is
+   * only rebound when the first item changes, so measuring never needs
+   * to create a widget.
+   */
+  GtkWidget *sizing_cell;
+
+  /* Layout from the last allocation */
+  guint n_columns;
+  int cell_width;
+  int cell_height;
+
+  /* cells->pdata[i] displays the item at position first + i */
+  GPtrArray *cells;
+  guint first;
+  /* Size and scroll offset the cells were chosen for */
+  int cells_width;
+  int cells_height;
+  int cells_value;
+  /* cells that are not displaying any item */
+  GPtrArray *pool;
+
+  /* Sorted, disjoint and non-adjacent ranges of selected positions */
+  GArray *selected;
+
+  GtkGesture *drag_gesture;
+  GtkCssNode *rubberband_node;
+  double rubberband_x1, rubberband_y1;
+  double rubberband_x2, rubberband_y2;
+  guint rubberband_select : 1;
+  guint rubberband_modify : 1;
+  guint rubberband_extend : 1;
+};
+
+struct _GtkGridViewClass
+{
+  GtkWidgetClass parent_class;
+
+  void (* selection_changed) (GtkGridView *self);
+};
+
+enum {
+  PROP_0,
+  PROP_MODEL,
+  PROP_MIN_COLUMNS,
+  PROP_MAX_COLUMNS,
+  PROP_HADJUSTMENT,
+  PROP_VADJUSTMENT,
+  PROP_HSCROLL_POLICY,
+  PROP_VSCROLL_POLICY,
+  N_PROPS = PROP_HADJUSTMENT
+};
+
+enum {
+  SELECTION_CHANGED,
+  LAST_SIGNAL
+};
+
+static GParamSpec *properties[N_PROPS] = { NULL, };
+static guint signals[LAST_SIGNAL] = { 0 };
+
+typedef struct {
+  guint start;
+  guint n_items;
+} SelectionRange;
+
+G_DEFINE_TYPE_WITH_CODE (GtkGridView, gtk_grid_view, GTK_TYPE_WIDGET,
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_SCROLLABLE, NULL))
+
+/* The selection is kept as a list of ranges, so that selecting all items
+ * and moving the selection when items are added or removed don't depend
+ * on the number of items.
+ */
+
+/* Returns the index of the first range that ends at or after @position */
+static guint
+selection_find (GArray *ranges,
+                guint   position)
+{
+  guint lo = 0, hi = ranges->len;
+
+  while (lo < hi)
+    {
+      guint mid = (lo + hi) / 2;
+      SelectionRange *range = &g_array_index (ranges, SelectionRange, mid);
+
+      if (range->start + range->n_items < position)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
+static gboolean
+selection_contains (GArray *ranges,
+                    guint   position)
+{
+  guint i = selection_find (ranges, position);
+  SelectionRange *range;
+
+  if (i >= ranges->len)
+    return FALSE;
+
+  range = &g_array_index (ranges, SelectionRange, i);
+
+  return range->start <= position && position < range->start + range->n_items;
+}
+
+static gboolean
+selection_intersects (GArray *ranges,
+                      guint   start,
+                      guint   end)
+{
+  guint i = selection_find (ranges, start);
+  SelectionRange *range;
+
+  if (start >= end)
+    return FALSE;
+
+  for (; i < ranges->len; i++)
+    {
+      range = &g_array_index (ranges, SelectionRange, i);
+      if (range->start >= end)
+        break;
+      if (range->start + range->n_items > start)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+/* Selects or unselects the positions from @start to @end */
+static void
+selection_set (GArray   *ranges,
+               guint     start,
+               guint     end,
+               gboolean  selected)
+{
+  SelectionRange left = { 0, 0 }, right = { 0, 0 };
+  guint i, j;
+
+  if (start >= end)
+    return;
+
+  /* Find the ranges that overlap or touch the new range */
+  i = selection_find (ranges, start);
+  for (j = i; j < ranges->len; j++)
+    {
+      SelectionRange *range = &g_array_index (ranges, SelectionRange, j);
+      guint range_end = range->start + range->n_items;
+
+      if (range->start > end)
+        break;
+
+      if (selected)
+        {
+          start = MIN (start, range->start);
+          end = MAX (end, range_end);
+        }
+      else
+        {
+          if (range->start < start)
+            left = (SelectionRange) { range->start, start - range->start };
+          if (range_end > end)
+            right = (SelectionRange) { end, range_end - end };
+        }
+    }
+
+  g_array_remove_range (ranges, i, j - i);
+
+  if (selected)
+    {
+      SelectionRange range = { start, end - start };
+      g_array_insert_val (ranges, i, range);
+    }
+  else
+    {
+      if (right.n_items > 0)
+        g_array_insert_val (ranges, i, right);
+      if (left.n_items > 0)
+        g_array_insert_val (ranges, i, left);
+    }
+}
+
+/* Selects the unselected positions from @start to @end and unselects
+ * the selected ones.
+ */
+static void
+selection_toggle (GArray *ranges,
+                  guint   start,
+                  guint   end)
+{
+  GArray *unselect;
+  guint i;
+
+  unselect = g_array_new (FALSE, FALSE, sizeof (SelectionRange));
+  for (i = selection_find (ranges, start); i < ranges->len; i++)
+    {
+      SelectionRange range = g_array_index (ranges, SelectionRange, i);
+      guint range_end = range.start + range.n_items;
+
+      if (range.start >= end)
+        break;
+      if (range_end <= start)
+        continue;
+
+      range.start = MAX (range.start, start);
+      range.n_items = MIN (range_end, end) - range.start;
+      g_array_append_val (unselect, range);
+    }
+
+  selection_set (ranges, start, end, TRUE);
+  for (i = 0; i < unselect->len; i++)
+    {
+      SelectionRange *range = &g_array_index (unselect, SelectionRange, i);
+      selection_set (ranges, range->start, range->start + range->n_items, FALSE);
+    }
+
+  g_array_free (unselect, TRUE);
+}
+
+/* Moves the ranges after @position for an items-changed signal.
+ * Only the ranges after the change are touched.
+ */
+static void
+selection_shift (GArray *ranges,
+                 guint   position,
+                 guint   removed,
+                 guint   added)
+{
+  SelectionRange *range;
+  guint i;
+
+  selection_set (ranges, position, position + removed, FALSE);
+
+  i = selection_find (ranges, position);
+  if (i >= ranges->len)
+    return;
+
+  /* Split a range that the new items are inserted into */
+  range = &g_array_index (ranges, SelectionRange, i);
+  if (range->start < position && position < range->start + range->n_items)
+    {
+      SelectionRange after = { position, range->start + range->n_items - position };
+
+      range->n_items = position - range->start;
+      g_array_insert_val (ranges, i + 1, after);
+    }
+
+  /* Ranges ending at @position stay where they are */
+  range = &g_array_index (ranges, SelectionRange, i);
+  if (range->start < position)
+    i++;
+
+  for (; i < ranges->len; i++)
+    {
+      range = &g_array_index (ranges, SelectionRange, i);
+      range->start = range->start - removed + added;
+    }
+
+  /* Removing items can make two ranges adjacent */
+  i = selection_find (ranges, position);
+  if (i + 1 < ranges->len)
+    {
+      SelectionRange *next = &g_array_index (ranges, SelectionRange, i + 1);
+
+      range = &g_array_index (ranges, SelectionRange, i);
+      if (range->start + range->n_items == next->start)
+        {
+          range->n_items += next->n_items;
+          g_array_remove_index (ranges, i + 1);
+        }
+    }
+}
+
+static guint
+gtk_grid_view_get_n_items (GtkGridView *self)
+{
+  if (self->model == NULL)
+    return 0;
+
+  return g_list_model_get_n_items (self->model);
+}
+
+static void
+gtk_grid_view_clear_selection (GtkGridView *self)
+{
+  g_array_set_size (self->selected, 0);
+}
+
+static void
+gtk_grid_view_update_cell_state (GtkGridView *self,
+                                 GtkWidget   *cell,
+                                 guint        position)
+{
+  if (selection_contains (self->selected, position))
+    gtk_widget_set_state_flags (cell, GTK_STATE_FLAG_SELECTED, FALSE);
+  else
+    gtk_widget_unset_state_flags (cell, GTK_STATE_FLAG_SELECTED);
+}
+
+static void
+gtk_grid_view_update_cell_states (GtkGridView *self)
+{
+  guint i;
+
+  for (i = 0; i < self->cells->len; i++)
+    gtk_grid_view_update_cell_state (self, g_ptr_array_index (self->cells, i), self->first + i);
+}
+
+static void
+gtk_grid_view_release_cell (GtkGridView *self,
+                            GtkWidget   *cell)
+{
+  gtk_widget_set_child_visible (cell, FALSE);
+  g_ptr_array_add (self->pool, cell);
+}
+
+static void
+gtk_grid_view_release_cells (GtkGridView *self,
+                             guint        position)
+{
+  guint i;
+
+  if (position < self->first)
+    position = self->first;
+
+  for (i = position - self->first; i < self->cells->len; i++)
+    gtk_grid_view_release_cell (self, g_ptr_array_index (self->cells, i));
+
+  if (position - self->first < self->cells->len)
+    g_ptr_array_set_size (self->cells, position - self->first);
+}
+
+static GtkWidget *
+gtk_grid_view_acquire_cell (GtkGridView *self,
+                            guint        position)
+{
+  GtkWidget *cell;
+  gpointer item;
+
+  if (self->pool->len > 0)
+    {
+      cell = g_ptr_array_index (self->pool, self->pool->len - 1);
+      g_ptr_array_remove_index_fast (self->pool, self->pool->len - 1);
+      gtk_widget_set_child_visible (cell, TRUE);
+    }
+  else
+    {
+      cell = self->create_widget_func (self->user_data);
+      gtk_widget_set_parent (cell, GTK_WIDGET (self));
+    }
+
+  item = g_list_model_get_item (self->model, position);
+  self->bind_widget_func (cell, item, self->user_data);
+  g_object_unref (item);
+
+  gtk_grid_view_update_cell_state (self, cell, position);
+
+  return cell;
+}
+
+static void
+gtk_grid_view_clear_cells (GtkGridView *self)
+{
+  guint i;
+
+  for (i = 0; i < self->cells->len; i++)
+    gtk_widget_unparent (g_ptr_array_index (self->cells, i));
+  g_ptr_array_set_size (self->cells, 0);
+
+  for (i = 0; i < self->pool->len; i++)
+    gtk_widget_unparent (g_ptr_array_index (self->pool, i));
+  g_ptr_array_set_size (self->pool, 0);
+
+  if (self->sizing_cell)
+    {
+      gtk_widget_unparent (self->sizing_cell);
+      self->sizing_cell = NULL;
+    }
+
+  self->first = 0;
+  self->cells_width = 0;
+  self->cells_height = 0;
+  self->cells_value = 0;
+}
+
+/* Binds the sizing cell to the first item. This is done whenever the
+ * first item changes, so that measuring doesn't create widgets.
+ */
+static void
+gtk_grid_view_update_sizing_cell (GtkGridView *self)
+{
+  gpointer item;
+
+  if (gtk_grid_view_get_n_items (self) == 0)
+    {
+      if (self->sizing_cell)
+        {
+          gtk_widget_unparent (self->sizing_cell);
+          self->sizing_cell = NULL;
+        }
+      return;
+    }
+
+  if (self->sizing_cell == NULL)
+    {
+      self->sizing_cell = self->create_widget_func (self->user_data);
+      gtk_widget_set_parent (self->sizing_cell, GTK_WIDGET (self));
+      gtk_widget_set_child_visible (self->sizing_cell, FALSE);
+    }
+
+  item = g_list_model_get_item (self->model, 0);
+  self->bind_widget_func (self->sizing_cell, item, self->user_data);
+  g_object_unref (item);
+}
+
+static void
+gtk_grid_view_measure_cell (GtkGridView *self,
+                            int         *min_width,
+                            int         *nat_width)
+{
+  gtk_widget_measure (self->sizing_cell, GTK_ORIENTATION_HORIZONTAL, -1,
+                      min_width, nat_width,
+                      NULL, NULL);
+  *min_width = MAX (*min_width, 1);
+  *nat_width = MAX (*nat_width, *min_width);
+}
+
+static int
+gtk_grid_view_measure_cell_height (GtkGridView *self,
+                                   int          width)
+{
+  int min, nat;
+
+  gtk_widget_measure (self->sizing_cell, GTK_ORIENTATION_VERTICAL, width,
+                      &min, &nat, NULL, NULL);
+
+  return MAX (nat, 1);
+}
+
+static guint
+gtk_grid_view_compute_n_columns (GtkGridView *self,
+                                 int          width,
+                                 int          cell_width)
+{
+  guint n_columns;
+
+  n_columns = width / MAX (cell_width, 1);
+  n_columns = CLAMP (n_columns, self->min_columns, self->max_columns);
+
+  return n_columns;
+}
+
+static int
+gtk_grid_view_get_grid_height (guint n_items,
+                               guint n_columns,
+                               int   cell_height)
+{
+  guint n_rows;
+  gint64 height;
+
+  n_rows = n_items / n_columns + (n_items % n_columns ? 1 : 0);
+  height = (gint64) n_rows * cell_height;
+
+  return MIN (height, G_MAXINT);
+}
+
+static void
+gtk_grid_view_measure (GtkWidget      *widget,
+                       GtkOrientation  orientation,
+                       int             for_size,
+                       int            *minimum,
+                       int            *natural,
+                       int            *minimum_baseline,
+                       int            *natural_baseline)
+{
+  GtkGridView *self = GTK_GRID_VIEW (widget);
+  int min_width, nat_width;
+  guint n_items;
+
+  *minimum = *natural = 0;
+
+  n_items = gtk_grid_view_get_n_items (self);
+  if (n_items == 0)
+    return;
+
+  gtk_grid_view_measure_cell (self, &min_width, &nat_width);
+
+  if (orientation == GTK_ORIENTATION_HORIZONTAL)
+    {
+      *minimum = self->min_columns * min_width;
+      *natural = MIN (self->max_columns, n_items) * nat_width;
+    }
+  else
+    {
+      guint n_columns;
+      int cell_width;
+
+      if (for_size < 0)
+        for_size = MIN (self->max_columns, n_items) * nat_width;
+
+      n_columns = gtk_grid_view_compute_n_columns (self, for_size, min_width);
+      cell_width = MAX (for_size / n_columns, min_width);
+
+      *natural = gtk_grid_view_get_grid_height (n_items, n_columns,
+                                                gtk_grid_view_measure_cell_height (self, cell_width));
+    }
+}
+
+/* Computes the columns and the cell size for @width */
+static void
+gtk_grid_view_update_layout (GtkGridView *self,
+                             int          width)
+{
+  int min_width, nat_width;
+
+  if (gtk_grid_view_get_n_items (self) == 0)
+    {
+      self->n_columns = 1;
+      self->cell_width = width;
+      self->cell_height = 0;
+      return;
+    }
+
+  gtk_grid_view_measure_cell (self, &min_width, &nat_width);
+  self->n_columns = gtk_grid_view_compute_n_columns (self, width, min_width);
+  self->cell_width = MAX (width / self->n_columns, min_width);
+  self->cell_height = gtk_grid_view_measure_cell_height (self, self->cell_width);
+}
+
+/* Binds cells to the items that are visible at the current scroll
+ * offset for a view of @width x @height.
+ */
+static void
+gtk_grid_view_update_cells (GtkGridView *self,
+                            int          width,
+                            int          height)
+{
+  GPtrArray *old_cells;
+  guint old_first, n_items, first_row, end, position, i;
+  int overscan, value;
+
+  n_items = gtk_grid_view_get_n_items (self);
+  value = gtk_adjustment_get_value (self->adjustment[GTK_ORIENTATION_VERTICAL]);
+
+  self->cells_width = width;
+  self->cells_height = height;
+  self->cells_value = value;
+
+  gtk_grid_view_update_layout (self, width);
+
+  if (n_items == 0)
+    {
+      gtk_grid_view_release_cells (self, 0);
+      position = end = 0;
+    }
+  else
+    {
+      /* All cells have the same size, so the visible range follows
+       * directly from the scroll offset.
+       */
+      overscan = height * OVERSCAN;
+      first_row = MAX (value - overscan, 0) / self->cell_height;
+      position = MIN ((guint64) first_row * self->n_columns, n_items);
+      end = ((gint64) value + height + overscan + self->cell_height - 1) / self->cell_height;
+      end = MIN ((guint64) end * self->n_columns, n_items);
+    }
+
+  /* Give up cells outside of the new range first, so they can be
+   * reused for the new cells instead of creating more.
+   */
+  old_cells = self->cells;
+  old_first = self->first;
+  self->cells = g_ptr_array_new ();
+  self->first = position;
+  for (i = 0; i < old_cells->len; i++)
+    {
+      if (old_first + i < position || old_first + i >= end)
+        {
+          gtk_grid_view_release_cell (self, g_ptr_array_index (old_cells, i));
+          g_ptr_array_index (old_cells, i) = NULL;
+        }
+    }
+
+  for (; position < end; position++)
+    {
+      GtkWidget *cell = NULL;
+
+      if (position >= old_first && position - old_first < old_cells->len)
+        {
+          cell = g_ptr_array_index (old_cells, position - old_first);
+          g_ptr_array_index (old_cells, position - old_first) = NULL;
+        }
+
+      if (cell == NULL)
+        cell = gtk_grid_view_acquire_cell (self, position);
+
+      g_ptr_array_add (self->cells, cell);
+    }
+
+  for (i = 0; i < old_cells->len; i++)
+    {
+      if (g_ptr_array_index (old_cells, i))
+        gtk_grid_view_release_cell (self, g_ptr_array_index (old_cells, i));
+    }
+  g_ptr_array_free (old_cells, TRUE);
+
+  /* Don't keep more spare cells around than we need to fill the view */
+  while (self->pool->len > MAX (self->cells->len, 1))
+    {
+      gtk_widget_unparent (g_ptr_array_index (self->pool, self->pool->len - 1));
+      g_ptr_array_remove_index_fast (self->pool, self->pool->len - 1);
+    }
+}
+
+/* Updates the cells for the size of the last allocation */
+static void
+gtk_grid_view_update_cells_for_allocation (GtkGridView *self)
+{
+  if (self->cells_width == 0 && self->cells_height == 0)
+    return;
+
+  gtk_grid_view_update_cells (self, self->cells_width, self->cells_height);
+}
+
+static void
+gtk_grid_view_size_allocate (GtkWidget           *widget,
+                             const GtkAllocation *allocation,
+                             int                  baseline,
+                             GtkAllocation       *out_clip)
+{
+  GtkGridView *self = GTK_GRID_VIEW (widget);
+  GtkAdjustment *vadjustment = self->adjustment[GTK_ORIENTATION_VERTICAL];
+  guint i;
+  int value;
+
+  gtk_grid_view_update_layout (self, allocation->width);
+
+  g_signal_handlers_block_matched (vadjustment, G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, self);
+  gtk_adjustment_configure (self->adjustment[GTK_ORIENTATION_HORIZONTAL],
+                            0, 0, allocation->width,
+                            allocation->width * 0.1, allocation->width * 0.9,
+                            allocation->width);
+  gtk_adjustment_configure (vadjustment,
+                            gtk_adjustment_get_value (vadjustment),
+                            0,
+                            MAX (gtk_grid_view_get_grid_height (gtk_grid_view_get_n_items (self),
+                                                                self->n_columns,
+                                                                self->cell_height),
+                                 allocation->height),
+                            self->cell_height,
+                            allocation->height * 0.9,
+                            allocation->height);
+  g_signal_handlers_unblock_matched (vadjustment, G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, self);
+
+  /* Scrolling and model changes update the cells before we get here.
+   * Only a new size, or a scroll offset that was clamped to it, needs
+   * different cells now.
+   */
+  value = gtk_adjustment_get_value (vadjustment);
+  if (allocation->width != self->cells_width ||
+      allocation->height != self->cells_height ||
+      value != self->cells_value)
+    gtk_grid_view_update_cells (self, allocation->width, allocation->height);
+
+  for (i = 0; i < self->cells->len; i++)
+    {
+      GtkAllocation child_allocation, child_clip;
+      guint position = self->first + i;
+
+      child_allocation.x = (position % self->n_columns) * self->cell_width;
+      child_allocation.y = (gint64) (position / self->n_columns) * self->cell_height - value;
+      child_allocation.width = self->cell_width;
+      child_allocation.height = self->cell_height;
+      gtk_widget_size_allocate (g_ptr_array_index (self->cells, i),
+                                &child_allocation, -1, &child_clip);
+    }
+}
+
+static void
+gtk_grid_view_get_rubberband (GtkGridView  *self,
+                              GdkRectangle *rect)
+{
+  double value = gtk_adjustment_get_value (self->adjustment[GTK_ORIENTATION_VERTICAL]);
+
+  rect->x = floor (MIN (self->rubberband_x1, self->rubberband_x2));
+  rect->y = floor (MIN (self->rubberband_y1, self->rubberband_y2) - value);
+  rect->width = ceil (ABS (self->rubberband_x2 - self->rubberband_x1));
+  rect->height = ceil (ABS (self->rubberband_y2 - self->rubberband_y1));
+}
+
+static void
+gtk_grid_view_snapshot (GtkWidget   *widget,
+                        GtkSnapshot *snapshot)
+{
+  GtkGridView *self = GTK_GRID_VIEW (widget);
+
+  gtk_snapshot_push_clip (snapshot,
+                          &GRAPHENE_RECT_INIT (
+                            0, 0,
+                            gtk_widget_get_width (widget),
+                            gtk_widget_get_height (widget)),
+                          "GridView");
+
+  GTK_WIDGET_CLASS (gtk_grid_view_parent_class)->snapshot (widget, snapshot);
+
+  if (self->rubberband_select)
+    {
+      GtkStyleContext *context;
+      GdkRectangle rect;
+
+      gtk_grid_view_get_rubberband (self, &rect);
+
+      context = gtk_widget_get_style_context (widget);
+      gtk_style_context_save_to_node (context, self->rubberband_node);
+      gtk_snapshot_render_background (snapshot, context, rect.x, rect.y, rect.width, rect.height);
+      gtk_snapshot_render_frame (snapshot, context, rect.x, rect.y, rect.width, rect.height);
+      gtk_style_context_restore (context);
+    }
+
+  gtk_snapshot_pop (snapshot);
+}
+
+static void
+gtk_grid_view_selection_changed (GtkGridView *self)
+{
+  gtk_grid_view_update_cell_states (self);
+  g_signal_emit (self, signals[SELECTION_CHANGED], 0);
+}
+
+/* Selects all items in the cells that intersect @rect, which is
+ * in list coordinates. None of those items need to be displayed.
+ */
+static void
+gtk_grid_view_select_rect (GtkGridView        *self,
+                           const GdkRectangle *rect,
+                           gboolean            modify)
+{
+  guint n_items, n_rows, first_col, last_col, first_row, last_row, row;
+
+  n_items = gtk_grid_view_get_n_items (self);
+  if (n_items == 0 || self->cell_width <= 0 || self->cell_height <= 0)
+    return;
+
+  n_rows = (n_items + self->n_columns - 1) / self->n_columns;
+
+  first_col = MAX (rect->x, 0) / self->cell_width;
+  last_col = MAX (rect->x + rect->width, 0) / self->cell_width;
+  first_row = MAX (rect->y, 0) / self->cell_height;
+  last_row = MAX (rect->y + rect->height, 0) / self->cell_height;
+
+  if (first_col >= self->n_columns || first_row >= n_rows)
+    return;
+
+  last_col = MIN (last_col, self->n_columns - 1);
+  last_row = MIN (last_row, n_rows - 1);
+
+  for (row = first_row; row <= last_row; row++)
+    {
+      guint start = row * self->n_columns + first_col;
+      guint end = MIN (row * self->n_columns + last_col + 1, n_items);
+
+      if (modify)
+        selection_toggle (self->selected, start, end);
+      else
+        selection_set (self->selected, start, end, TRUE);
+    }
+}
+
+static void
+gtk_grid_view_stop_rubberband (GtkGridView *self)
+{
+  self->rubberband_select = FALSE;
+
+  gtk_css_node_set_parent (self->rubberband_node, NULL);
+  self->rubberband_node = NULL;
+
+  gtk_widget_queue_draw (GTK_WIDGET (self));
+}
+
+static void
+gtk_grid_view_drag_gesture_begin (GtkGestureDrag *gesture,
+                                  double          start_x,
+                                  double          start_y,
+                                  GtkGridView    *self)
+{
+  GdkModifierType state = 0;
+  GdkModifierType mask;
+
+  self->rubberband_select = FALSE;
+  self->rubberband_modify = FALSE;
+  self->rubberband_extend = FALSE;
+
+  if (gtk_get_current_event_state (&state))
+    {
+      mask = gtk_widget_get_modifier_mask (GTK_WIDGET (self), GDK_MODIFIER_INTENT_MODIFY_SELECTION);
+      if ((state & mask) == mask)
+        self->rubberband_modify = TRUE;
+      mask = gtk_widget_get_modifier_mask (GTK_WIDGET (self), GDK_MODIFIER_INTENT_EXTEND_SELECTION);
+      if ((state & mask) == mask)
+        self->rubberband_extend = TRUE;
+    }
+}
+
+static void
+gtk_grid_view_drag_gesture_update (GtkGestureDrag *gesture,
+                                   double          offset_x,
+                                   double          offset_y,
+                                   GtkGridView    *self)
+{
+  double start_x, start_y, value;
+
+  gtk_gesture_drag_get_start_point (gesture, &start_x, &start_y);
+  value = gtk_adjustment_get_value (self->adjustment[GTK_ORIENTATION_VERTICAL]);
+
+  if (!self->rubberband_select &&
+      (offset_x * offset_x) + (offset_y * offset_y) > RUBBERBAND_START_DISTANCE * RUBBERBAND_START_DISTANCE)
+    {
+      GtkCssNode *widget_node;
+
+      self->rubberband_select = TRUE;
+      /* The rubberband is kept in list coordinates, so it stays
+       * attached to the items when the view scrolls.
+       */
+      self->rubberband_x1 = start_x;
+      self->rubberband_y1 = start_y + value;
+
+      widget_node = gtk_widget_get_css_node (GTK_WIDGET (self));
+      self->rubberband_node = gtk_css_node_new ();
+      gtk_css_node_set_name (self->rubberband_node, I_("rubberband"));
+      gtk_css_node_set_parent (self->rubberband_node, widget_node);
+      gtk_css_node_set_state (self->rubberband_node, gtk_css_node_get_state (widget_node));
+      g_object_unref (self->rubberband_node);
+
+      gtk_gesture_set_state (GTK_GESTURE (gesture), GTK_EVENT_SEQUENCE_CLAIMED);
+    }
+
+  if (self->rubberband_select)
+    {
+      self->rubberband_x2 = start_x + offset_x;
+      self->rubberband_y2 = start_y + offset_y + value;
+      gtk_widget_queue_draw (GTK_WIDGET (self));
+    }
+}
+
+static void
+gtk_grid_view_drag_gesture_end (GtkGestureDrag *gesture,
+                                double          offset_x,
+                                double          offset_y,
+                                GtkGridView    *self)
+{
+  GdkEventSequence *sequence;
+  GdkRectangle rect;
+
+  if (!self->rubberband_select)
+    return;
+
+  sequence = gtk_gesture_single_get_current_sequence (GTK_GESTURE_SINGLE (gesture));
+
+  if (gtk_gesture_handles_sequence (GTK_GESTURE (gesture), sequence))
+    {
+      if (!self->rubberband_extend && !self->rubberband_modify)
+        gtk_grid_view_clear_selection (self);
+
+      rect.x = floor (MIN (self->rubberband_x1, self->rubberband_x2));
+      rect.y = floor (MIN (self->rubberband_y1, self->rubberband_y2));
+      rect.width = ceil (ABS (self->rubberband_x2 - self->rubberband_x1));
+      rect.height = ceil (ABS (self->rubberband_y2 - self->rubberband_y1));
+      gtk_grid_view_select_rect (self, &rect, self->rubberband_modify);
+
+      gtk_grid_view_stop_rubberband (self);
+      gtk_grid_view_selection_changed (self);
+    }
+  else
+    gtk_grid_view_stop_rubberband (self);
+}
+
+static void
+gtk_grid_view_adjustment_value_changed (GtkAdjustment *adjustment,
+                                        GtkGridView   *self)
+{
+  gtk_grid_view_update_cells_for_allocation (self);
+  gtk_widget_queue_allocate (GTK_WIDGET (self));
+}
+
+static void
+gtk_grid_view_clear_adjustment (GtkGridView    *self,
+                                GtkOrientation  orientation)
+{
+  if (self->adjustment[orientation] == NULL)
+    return;
+
+  g_signal_handlers_disconnect_by_func (self->adjustment[orientation],
+                                        gtk_grid_view_adjustment_value_changed,
+                                        self);
+  g_clear_object (&self->adjustment[orientation]);
+}
+
+static void
+gtk_grid_view_set_adjustment (GtkGridView    *self,
+                              GtkOrientation  orientation,
+                              GtkAdjustment  *adjustment)
+{
+  if (self->adjustment[orientation] == adjustment && adjustment != NULL)
+    return;
+
+  if (adjustment == NULL)
+    adjustment = gtk_adjustment_new (0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+
+  g_object_ref_sink (adjustment);
+  gtk_grid_view_clear_adjustment (self, orientation);
+  self->adjustment[orientation] = adjustment;
+
+  g_signal_connect (adjustment, "value-changed",
+                    G_CALLBACK (gtk_grid_view_adjustment_value_changed),
+                    self);
+
+  gtk_widget_queue_allocate (GTK_WIDGET (self));
+}
+
+/* Moves the selection along with the items */
+static void
+gtk_grid_view_shift_selection (GtkGridView *self,
+                               guint        position,
+                               guint        removed,
+                               guint        added)
+{
+  gboolean changed;
+
+  if (self->selected->len == 0)
+    return;
+
+  changed = selection_intersects (self->selected, position, position + removed);
+  selection_shift (self->selected, position, removed, added);
+
+  if (changed)
+    g_signal_emit (self, signals[SELECTION_CHANGED], 0);
+}
+
+static void
+gtk_grid_view_items_changed (GListModel  *model,
+                             guint        position,
+                             guint        removed,
+                             guint        added,
+                             GtkGridView *self)
+{
+  if (removed != added)
+    {
+      /* Items change columns, so all cells after the change need to
+       * be rebound.
+       */
+      gtk_grid_view_release_cells (self, position);
+    }
+  else if (position < self->first + self->cells->len &&
+           position + removed > self->first)
+    {
+      gtk_grid_view_release_cells (self, position);
+    }
+
+  gtk_grid_view_shift_selection (self, position, removed, added);
+
+  if (position == 0)
+    gtk_grid_view_update_sizing_cell (self);
+
+  gtk_grid_view_update_cells_for_allocation (self);
+
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+}
+
+static void
+gtk_grid_view_clear_model (GtkGridView *self)
+{
+  if (self->model)
+    {
+      g_signal_handlers_disconnect_by_func (self->model,
+                                            gtk_grid_view_items_changed,
+                                            self);
+      g_clear_object (&self->model);
+    }
+
+  gtk_grid_view_clear_cells (self);
+  gtk_grid_view_clear_selection (self);
+
+  if (self->user_data_free_func)
+    self->user_data_free_func (self->user_data);
+
+  self->create_widget_func = NULL;
+  self->bind_widget_func = NULL;
+  self->user_data = NULL;
+  self->user_data_free_func = NULL;
+}
+
+static void
+gtk_grid_view_dispose (GObject *object)
+{
+  GtkGridView *self = GTK_GRID_VIEW (object);
+
+  gtk_grid_view_clear_model (self);
+  gtk_grid_view_clear_adjustment (self, GTK_ORIENTATION_HORIZONTAL);
+  gtk_grid_view_clear_adjustment (self, GTK_ORIENTATION_VERTICAL);
+  g_clear_object (&self->drag_gesture);
+
+  G_OBJECT_CLASS (gtk_grid_view_parent_class)->dispose (object);
+}
+
+static void
+gtk_grid_view_finalize (GObject *object)
+{
+  GtkGridView *self = GTK_GRID_VIEW (object);
+
+  g_ptr_array_free (self->cells, TRUE);
+  g_ptr_array_free (self->pool, TRUE);
+  g_array_free (self->selected, TRUE);
+
+  G_OBJECT_CLASS (gtk_grid_view_parent_class)->finalize (object);
+}
+
+static void
+gtk_grid_view_get_property (GObject    *object,
+                            guint       property_id,
+                            GValue     *value,
+                            GParamSpec *pspec)
+{
+  GtkGridView *self = GTK_GRID_VIEW (object);
+
+  switch (property_id)
+    {
+    case PROP_MODEL:
+      g_value_set_object (value, self->model);
+      break;
+
+    case PROP_MIN_COLUMNS:
+      g_value_set_uint (value, self->min_columns);
+      break;
+
+    case PROP_MAX_COLUMNS:
+      g_value_set_uint (value, self->max_columns);
+      break;
+
+    case PROP_HADJUSTMENT:
+      g_value_set_object (value, self->adjustment[GTK_ORIENTATION_HORIZONTAL]);
+      break;
+
+    case PROP_VADJUSTMENT:
+      g_value_set_object (value, self->adjustment[GTK_ORIENTATION_VERTICAL]);
+      break;
+
+    case PROP_HSCROLL_POLICY:
+      g_value_set_enum (value, self->scroll_policy[GTK_ORIENTATION_HORIZONTAL]);
+      break;
+
+    case PROP_VSCROLL_POLICY:
+      g_value_set_enum (value, self->scroll_policy[GTK_ORIENTATION_VERTICAL]);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+    }
+}
+
+static void
+gtk_grid_view_set_scroll_policy (GtkGridView         *self,
+                                 GtkOrientation       orientation,
+                                 GtkScrollablePolicy  scroll_policy)
+{
+  if (self->scroll_policy[orientation] == scroll_policy)
+    return;
+
+  self->scroll_policy[orientation] = scroll_policy;
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+  g_object_notify (G_OBJECT (self),
+                   orientation == GTK_ORIENTATION_HORIZONTAL ? "hscroll-policy" : "vscroll-policy");
+}
+
+static void
+gtk_grid_view_set_property (GObject      *object,
+                            guint         property_id,
+                            const GValue *value,
+                            GParamSpec   *pspec)
+{
+  GtkGridView *self = GTK_GRID_VIEW (object);
+
+  switch (property_id)
+    {
+    case PROP_MIN_COLUMNS:
+      gtk_grid_view_set_min_columns (self, g_value_get_uint (value));
+      break;
+
+    case PROP_MAX_COLUMNS:
+      gtk_grid_view_set_max_columns (self, g_value_get_uint (value));
+      break;
+
+    case PROP_HADJUSTMENT:
+      gtk_grid_view_set_adjustment (self, GTK_ORIENTATION_HORIZONTAL, g_value_get_object (value));
+      break;
+
+    case PROP_VADJUSTMENT:
+      gtk_grid_view_set_adjustment (self, GTK_ORIENTATION_VERTICAL, g_value_get_object (value));
+      break;
+
+    case PROP_HSCROLL_POLICY:
+      gtk_grid_view_set_scroll_policy (self, GTK_ORIENTATION_HORIZONTAL, g_value_get_enum (value));
+      break;
+
+    case PROP_VSCROLL_POLICY:
+      gtk_grid_view_set_scroll_policy (self, GTK_ORIENTATION_VERTICAL, g_value_get_enum (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+    }
+}
+
+static void
+gtk_grid_view_class_init (GtkGridViewClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+
+  gobject_class->dispose = gtk_grid_view_dispose;
+  gobject_class->finalize = gtk_grid_view_finalize;
+  gobject_class->get_property = gtk_grid_view_get_property;
+  gobject_class->set_property = gtk_grid_view_set_property;
+
+  widget_class->measure = gtk_grid_view_measure;
+  widget_class->size_allocate = gtk_grid_view_size_allocate;
+  widget_class->snapshot = gtk_grid_view_snapshot;
+
+  /**
+   * GtkGridView:model:
+   *
+   * The model displayed by the grid view.
+   */
+  properties[PROP_MODEL] =
+    g_param_spec_object ("model",
+                         P_("Model"),
+                         P_("The model displayed by the grid"),
+                         G_TYPE_LIST_MODEL,
+                         GTK_PARAM_READABLE);
+
+  /**
+   * GtkGridView:min-columns:
+   *
+   * The minimum number of columns to use.
+   */
+  properties[PROP_MIN_COLUMNS] =
+    g_param_spec_uint ("min-columns",
+                       P_("Minimum columns"),
+                       P_("The minimum number of columns"),
+                       1, G_MAXUINT, 1,
+                       GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
+  /**
+   * GtkGridView:max-columns:
+   *
+   * The maximum number of columns to use.
+   */
+  properties[PROP_MAX_COLUMNS] =
+    g_param_spec_uint ("max-columns",
+                       P_("Maximum columns"),
+                       P_("The maximum number of columns"),
+                       1, G_MAXUINT, 7,
+                       GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
+  g_object_class_install_properties (gobject_class, N_PROPS, properties);
+
+  /* GtkScrollable implementation */
+  g_object_class_override_property (gobject_class, PROP_HADJUSTMENT,    "hadjustment");
+  g_object_class_override_property (gobject_class, PROP_VADJUSTMENT,    "vadjustment");
+  g_object_class_override_property (gobject_class, PROP_HSCROLL_POLICY, "hscroll-policy");
+  g_object_class_override_property (gobject_class, PROP_VSCROLL_POLICY, "vscroll-policy");
+
+  /**
+   * GtkGridView::selection-changed:
+   * @self: the #GtkGridView on which the signal is emitted
+   *
+   * Emitted when the set of selected items changes.
+   */
+  signals[SELECTION_CHANGED] = g_signal_new (I_("selection-changed"),
+                                             GTK_TYPE_GRID_VIEW,
+                                             G_SIGNAL_RUN_FIRST,
+                                             G_STRUCT_OFFSET (GtkGridViewClass, selection_changed),
+                                             NULL, NULL,
+                                             g_cclosure_marshal_VOID__VOID,
+                                             G_TYPE_NONE, 0);
+
+  gtk_widget_class_set_accessible_role (widget_class, ATK_ROLE_LAYERED_PANE);
+  gtk_widget_class_set_css_name (widget_class, I_("gridview"));
+}
+
+static void
+gtk_grid_view_init (GtkGridView *self)
+{
+  gtk_widget_set_has_window (GTK_WIDGET (self), FALSE);
+
+  self->min_columns = 1;
+  self->max_columns = 7;
+  self->n_columns = 1;
+
+  self->cells = g_ptr_array_new ();
+  self->pool = g_ptr_array_new ();
+  self->selected = g_array_new (FALSE, FALSE, sizeof (SelectionRange));
+
+  gtk_grid_view_set_adjustment (self, GTK_ORIENTATION_HORIZONTAL, NULL);
+  gtk_grid_view_set_adjustment (self, GTK_ORIENTATION_VERTICAL, NULL);
+
+  self->drag_gesture = gtk_gesture_drag_new (GTK_WIDGET (self));
+  gtk_gesture_single_set_button (GTK_GESTURE_SINGLE (self->drag_gesture),
+                                 GDK_BUTTON_PRIMARY);
+  g_signal_connect (self->drag_gesture, "drag-begin",
+                    G_CALLBACK (gtk_grid_view_drag_gesture_begin), self);
+  g_signal_connect (self->drag_gesture, "drag-update",
+                    G_CALLBACK (gtk_grid_view_drag_gesture_update), self);
+  g_signal_connect (self->drag_gesture, "drag-end",
+                    G_CALLBACK (gtk_grid_view_drag_gesture_end), self);
+}
+
+/**
+ * gtk_grid_view_new:
+ *
+ * Creates a new #GtkGridView without a model.
+ *
+ * Returns: a new #GtkGridView
+ */
+GtkWidget *
+gtk_grid_view_new (void)
+{
+  return g_object_new (GTK_TYPE_GRID_VIEW, NULL);
+}
+
+/**
+ * gtk_grid_view_bind_model:
+ * @self: a #GtkGridView
+ * @model: (nullable): the #GListModel to display, or %NULL
+ * @create_widget_func: (nullable): a function that creates cell widgets
+ * @bind_widget_func: (nullable): a function that makes a cell widget
+ *     display an item of @model
+ * @user_data: (closure): user data passed to the functions
+ * @user_data_free_func: function for freeing @user_data
+ *
+ * Binds @model to @self.
+ *
+ * Cell widgets are created with @create_widget_func as needed to fill
+ * the visible area of @self, and @bind_widget_func is called whenever
+ * a cell starts displaying a different item. The number of cells does
+ * not depend on the number of items in @model.
+ *
+ * If @self was already bound to a model, that previous binding is
+ * destroyed and the selection is cleared.
+ */
+void
+gtk_grid_view_bind_model (GtkGridView                 *self,
+                          GListModel                  *model,
+                          GtkGridViewCreateWidgetFunc  create_widget_func,
+                          GtkGridViewBindWidgetFunc    bind_widget_func,
+                          gpointer                     user_data,
+                          GDestroyNotify               user_data_free_func)
+{
+  g_return_if_fail (GTK_IS_GRID_VIEW (self));
+  g_return_if_fail (model == NULL || G_IS_LIST_MODEL (model));
+  g_return_if_fail (model == NULL || create_widget_func != NULL);
+  g_return_if_fail (model == NULL || bind_widget_func != NULL);
+
+  gtk_grid_view_clear_model (self);
+
+  if (model)
+    {
+      self->model = g_object_ref (model);
+      self->create_widget_func = create_widget_func;
+      self->bind_widget_func = bind_widget_func;
+      self->user_data = user_data;
+      self->user_data_free_func = user_data_free_func;
+
+      g_signal_connect (model, "items-changed",
+                        G_CALLBACK (gtk_grid_view_items_changed), self);
+
+      gtk_grid_view_update_sizing_cell (self);
+    }
+
+  gtk_adjustment_set_value (self->adjustment[GTK_ORIENTATION_VERTICAL], 0);
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_MODEL]);
+}
+
+/**
+ * gtk_grid_view_get_model:
+ * @self: a #GtkGridView
+ *
+ * Gets the model that is currently displayed by @self.
+ *
+ * Returns: (nullable) (transfer none): the model in use
+ */
+GListModel *
+gtk_grid_view_get_model (GtkGridView *self)
+{
+  g_return_val_if_fail (GTK_IS_GRID_VIEW (self), NULL);
+
+  return self->model;
+}
+
+/**
+ * gtk_grid_view_set_min_columns:
+ * @self: a #GtkGridView
+ * @min_columns: the minimum number of columns
+ *
+ * Sets the minimum number of columns that @self uses, even if the
+ * cells do not fit into the available width.
+ */
+void
+gtk_grid_view_set_min_columns (GtkGridView *self,
+                               guint        min_columns)
+{
+  g_return_if_fail (GTK_IS_GRID_VIEW (self));
+  g_return_if_fail (min_columns > 0);
+
+  if (self->min_columns == min_columns)
+    return;
+
+  self->min_columns = min_columns;
+  if (self->max_columns < min_columns)
+    gtk_grid_view_set_max_columns (self, min_columns);
+
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_MIN_COLUMNS]);
+}
+
+/**
+ * gtk_grid_view_get_min_columns:
+ * @self: a #GtkGridView
+ *
+ * Gets the value set with gtk_grid_view_set_min_columns().
+ *
+ * Returns: the minimum number of columns
+ */
+guint
+gtk_grid_view_get_min_columns (GtkGridView *self)
+{
+  g_return_val_if_fail (GTK_IS_GRID_VIEW (self), 1);
+
+  return self->min_columns;
+}
+
+/**
+ * gtk_grid_view_set_max_columns:
+ * @self: a #GtkGridView
+ * @max_columns: the maximum number of columns
+ *
+ * Sets the maximum number of columns that @self uses. The cells get
+ * wider if there is more space available.
+ */
+void
+gtk_grid_view_set_max_columns (GtkGridView *self,
+                               guint        max_columns)
+{
+  g_return_if_fail (GTK_IS_GRID_VIEW (self));
+  g_return_if_fail (max_columns > 0);
+
+  if (self->max_columns == max_columns)
+    return;
+
+  self->max_columns = max_columns;
+  if (self->min_columns > max_columns)
+    gtk_grid_view_set_min_columns (self, max_columns);
+
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_MAX_COLUMNS]);
+}
+
+/**
+ * gtk_grid_view_get_max_columns:
+ * @self: a #GtkGridView
+ *
+ * Gets the value set with gtk_grid_view_set_max_columns().
+ *
+ * Returns: the maximum number of columns
+ */
+guint
+gtk_grid_view_get_max_columns (GtkGridView *self)
+{
+  g_return_val_if_fail (GTK_IS_GRID_VIEW (self), 1);
+
+  return self->max_columns;
+}
+
+/**
+ * gtk_grid_view_select_item:
+ * @self: a #GtkGridView
+ * @position: the position of the item to select
+ *
+ * Adds the item at @position to the selection.
+ */
+void
+gtk_grid_view_select_item (GtkGridView *self,
+                           guint        position)
+{
+  g_return_if_fail (GTK_IS_GRID_VIEW (self));
+  g_return_if_fail (position < gtk_grid_view_get_n_items (self));
+
+  if (selection_contains (self->selected, position))
+    return;
+
+  selection_set (self->selected, position, position + 1, TRUE);
+  gtk_grid_view_selection_changed (self);
+}
+
+/**
+ * gtk_grid_view_unselect_item:
+ * @self: a #GtkGridView
+ * @position: the position of the item to unselect
+ *
+ * Removes the item at @position from the selection.
+ */
+void
+gtk_grid_view_unselect_item (GtkGridView *self,
+                             guint        position)
+{
+  g_return_if_fail (GTK_IS_GRID_VIEW (self));
+
+  if (!selection_contains (self->selected, position))
+    return;
+
+  selection_set (self->selected, position, position + 1, FALSE);
+  gtk_grid_view_selection_changed (self);
+}
+
+/**
+ * gtk_grid_view_select_all:
+ * @self: a #GtkGridView
+ *
+ * Selects all items of the model. This does not create any widgets.
+ */
+void
+gtk_grid_view_select_all (GtkGridView *self)
+{
+  guint n_items;
+
+  g_return_if_fail (GTK_IS_GRID_VIEW (self));
+
+  n_items = gtk_grid_view_get_n_items (self);
+  if (n_items == 0)
+    return;
+
+  gtk_grid_view_clear_selection (self);
+  selection_set (self->selected, 0, n_items, TRUE);
+  gtk_grid_view_selection_changed (self);
+}
+
+/**
+ * gtk_grid_view_unselect_all:
+ * @self: a #GtkGridView
+ *
+ * Unselects all items.
+ */
+void
+gtk_grid_view_unselect_all (GtkGridView *self)
+{
+  g_return_if_fail (GTK_IS_GRID_VIEW (self));
+
+  if (self->selected->len == 0)
+    return;
+
+  gtk_grid_view_clear_selection (self);
+  gtk_grid_view_selection_changed (self);
+}
+
+/**
+ * gtk_grid_view_is_selected:
+ * @self: a #GtkGridView
+ * @position: the position of an item
+ *
+ * Checks if the item at @position is selected. This works for all
+ * items, not only the ones that are currently displayed.
+ *
+ * Returns: %TRUE if the item is selected
+ */
+gboolean
+gtk_grid_view_is_selected (GtkGridView *self,
+                           guint        position)
+{
+  g_return_val_if_fail (GTK_IS_GRID_VIEW (self), FALSE);
+
+  return selection_contains (self->selected, position);
+}
@@ -0,0 +1,106 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_GRID_VIEW_H__
+#define __GTK_GRID_VIEW_H__
+
+#if !defined (__GTK_H_INSIDE__) && !defined (GTK_COMPILATION)
+#error "Only <gtk/gtk.h> can be included directly."
+#endif
+
+#include <gtk/gtkwidget.h>
+
+G_BEGIN_DECLS
+
+#define GTK_TYPE_GRID_VIEW                 (gtk_grid_view_get_type ())
+#define GTK_GRID_VIEW(obj)                 (G_TYPE_CHECK_INSTANCE_CAST ((obj), GTK_TYPE_GRID_VIEW, GtkGridView))
+#define GTK_GRID_VIEW_CLASS(klass)         (G_TYPE_CHECK_CLASS_CAST ((klass), GTK_TYPE_GRID_VIEW, GtkGridViewClass))
+#define GTK_IS_GRID_VIEW(obj)              (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GTK_TYPE_GRID_VIEW))
+#define GTK_IS_GRID_VIEW_CLASS(klass)      (G_TYPE_CHECK_CLASS_TYPE ((klass), GTK_TYPE_GRID_VIEW))
+#define GTK_GRID_VIEW_GET_CLASS(obj)       (G_TYPE_INSTANCE_GET_CLASS ((obj), GTK_TYPE_GRID_VIEW, GtkGridViewClass))
+
+typedef struct _GtkGridView             GtkGridView;
+typedef struct _GtkGridViewClass        GtkGridViewClass;
+
+/**
+ * GtkGridViewCreateWidgetFunc:
+ * @user_data: (closure): user data passed to gtk_grid_view_bind_model()
+ *
+ * Called to create a new cell widget for a #GtkGridView. The widget
+ * does not show any item yet, it will be passed to a
+ * #GtkGridViewBindWidgetFunc before it is displayed.
+ *
+ * Returns: (transfer full): a new #GtkWidget
+ */
+typedef GtkWidget * (*GtkGridViewCreateWidgetFunc) (gpointer user_data);
+
+/**
+ * GtkGridViewBindWidgetFunc:
+ * @widget: a cell widget created by a #GtkGridViewCreateWidgetFunc
+ * @item: (type GObject): the item from the model to display
+ * @user_data: (closure): user data passed to gtk_grid_view_bind_model()
+ *
+ * Called to make @widget display @item. Cell widgets are reused for
+ * different items while scrolling, so this function must update all
+ * of the widget's state that depends on the item.
+ */
+typedef void (*GtkGridViewBindWidgetFunc) (GtkWidget *widget,
+                                           gpointer   item,
+                                           gpointer   user_data);
+
+GDK_AVAILABLE_IN_ALL
+GType           gtk_grid_view_get_type          (void) G_GNUC_CONST;
+
+GDK_AVAILABLE_IN_ALL
+GtkWidget *     gtk_grid_view_new               (void);
+
+GDK_AVAILABLE_IN_ALL
+void            gtk_grid_view_bind_model        (GtkGridView                 *self,
+                                                 GListModel                  *model,
+                                                 GtkGridViewCreateWidgetFunc  create_widget_func,
+                                                 GtkGridViewBindWidgetFunc    bind_widget_func,
+                                                 gpointer                     user_data,
+                                                 GDestroyNotify               user_data_free_func);
+GDK_AVAILABLE_IN_ALL
+GListModel *    gtk_grid_view_get_model         (GtkGridView                 *self);
+
+GDK_AVAILABLE_IN_ALL
+void            gtk_grid_view_set_min_columns   (GtkGridView                 *self,
+                                                 guint                        min_columns);
+GDK_AVAILABLE_IN_ALL
+guint           gtk_grid_view_get_min_columns   (GtkGridView                 *self);
+GDK_AVAILABLE_IN_ALL
+void            gtk_grid_view_set_max_columns   (GtkGridView                 *self,
+                                                 guint                        max_columns);
+GDK_AVAILABLE_IN_ALL
+guint           gtk_grid_view_get_max_columns   (GtkGridView                 *self);
+
+GDK_AVAILABLE_IN_ALL
+void            gtk_grid_view_select_item       (GtkGridView                 *self,
+                                                 guint                        position);
+GDK_AVAILABLE_IN_ALL
+void            gtk_grid_view_unselect_item     (GtkGridView                 *self,
+                                                 guint                        position);
+GDK_AVAILABLE_IN_ALL
+void            gtk_grid_view_select_all        (GtkGridView                 *self);
+GDK_AVAILABLE_IN_ALL
+void            gtk_grid_view_unselect_all      (GtkGridView                 *self);
+GDK_AVAILABLE_IN_ALL
+gboolean        gtk_grid_view_is_selected       (GtkGridView                 *self,
+                                                 guint                        position);
+
+G_END_DECLS
+
+#endif /* __GTK_GRID_VIEW_H__ */
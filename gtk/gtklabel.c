@@ -45,6 +45,7 @@
 #include "gtkmenushellprivate.h"
 #include "gtknotebook.h"
 #include "gtkpango.h"
+#include "gtkpangolayoutcacheprivate.h"
 #include "gtkprivate.h"
 #include "gtkseparatormenuitem.h"
 #include "gtkshow.h"
@@ -3222,11 +3223,10 @@ gtk_label_get_measuring_layout (GtkLabel *   label,
 
   if (existing_layout != NULL)
     {
-      if (existing_layout != priv->layout)
-        {
-          pango_layout_set_width (existing_layout, width);
-          return existing_layout;
-        }
+      /* Copies are shared, so we can only keep them unchanged */
+      if (existing_layout != priv->layout &&
+          pango_layout_get_width (existing_layout) == width)
+        return existing_layout;
 
       g_object_unref (existing_layout);
     }
@@ -3266,7 +3266,9 @@ gtk_label_get_measuring_layout (GtkLabel *   label,
 
   copy = pango_layout_copy (priv->layout);
   pango_layout_set_width (copy, width);
-  return copy;
+
+  /* Labels often measure the same texts, so share the copies */
+  return gtk_pango_layout_cache_share (copy);
 }
 
 static void
@@ -3402,13 +3404,25 @@ get_height_for_width (GtkLabel *label,
                       gint     *minimum_baseline,
                       gint     *natural_baseline)
 {
+  GtkLabelPrivate *priv = gtk_label_get_instance_private (label);
   PangoLayout *layout;
+  PangoRectangle logical;
   gint text_height, baseline;
 
   layout = gtk_label_get_measuring_layout (label, NULL, width * PANGO_SCALE);
 
   pango_layout_get_pixel_size (layout, NULL, &text_height);
 
+  /* Lines are broken as late as possible, so any width that still
+   * fits the widest line breaks the text the same way.
+   */
+  if (priv->ellipsize == PANGO_ELLIPSIZE_NONE)
+    {
+      pango_layout_get_extents (layout, NULL, &logical);
+      gtk_widget_set_measure_valid_from (GTK_WIDGET (label),
+                                         PANGO_PIXELS_CEIL (logical.width));
+    }
+
   *minimum_height = text_height;
   *natural_height = text_height;
 
@@ -189,11 +189,17 @@ struct _GtkListStorePrivate
   GtkSortType order;
 
   guint columns_dirty : 1;
+  guint columnar      : 1;
 
   gpointer default_sort_data;
   gpointer seq;         /* head of the list */
+
+  /* in columnar mode, the rows in seq are indexes into this */
+  GtkTreeDataColumns *columns;
 };
 
+#define ROW_INDEX(siter) (GPOINTER_TO_UINT (g_sequence_get (siter)) - 1)
+
 #define GTK_LIST_STORE_IS_SORTED(list) (((GtkListStore*)(list))->priv->sort_column_id != GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID)
 static void         gtk_list_store_tree_model_init (GtkTreeModelIface *iface);
 static void         gtk_list_store_drag_source_init(GtkTreeDragSourceIface *iface);
@@ -520,6 +526,58 @@ gtk_list_store_set_column_types (GtkListStore *list_store,
     }
 }
 
+/**
+ * gtk_list_store_set_columnar:
+ * @list_store: A #GtkListStore
+ * @columnar: %TRUE to store the values of each column together
+ *
+ * Switches @list_store to a storage mode where every column is kept
+ * in one contiguous array instead of allocating every cell separately.
+ * Strings are shared between all rows that hold the same string.
+ *
+ * This makes filling a store with many rows much cheaper and
+ * speeds up operations that look at one column of every row,
+ * such as sorting. It is only useful for large stores.
+ *
+ * This function can only be called while @list_store is empty.
+ */
+void
+gtk_list_store_set_columnar (GtkListStore *list_store,
+                             gboolean      columnar)
+{
+  GtkListStorePrivate *priv;
+
+  g_return_if_fail (GTK_IS_LIST_STORE (list_store));
+
+  priv = list_store->priv;
+
+  g_return_if_fail (priv->length == 0);
+
+  columnar = columnar != FALSE;
+  if (priv->columnar == columnar)
+    return;
+
+  g_clear_pointer (&priv->columns, _gtk_tree_data_columns_free);
+  priv->columnar = columnar;
+}
+
+/**
+ * gtk_list_store_get_columnar:
+ * @list_store: A #GtkListStore
+ *
+ * Returns whether @list_store keeps its values in columns.
+ * See gtk_list_store_set_columnar().
+ *
+ * Returns: %TRUE if @list_store uses columnar storage
+ */
+gboolean
+gtk_list_store_get_columnar (GtkListStore *list_store)
+{
+  g_return_val_if_fail (GTK_IS_LIST_STORE (list_store), FALSE);
+
+  return list_store->priv->columnar;
+}
+
 static void
 gtk_list_store_set_n_columns (GtkListStore *list_store,
 			      gint          n_columns)
@@ -562,8 +620,11 @@ gtk_list_store_finalize (GObject *object)
   GtkListStore *list_store = GTK_LIST_STORE (object);
   GtkListStorePrivate *priv = list_store->priv;
 
-  g_sequence_foreach (priv->seq,
-		      (GFunc) _gtk_tree_data_list_free, priv->column_headers);
+  if (priv->columns)
+    _gtk_tree_data_columns_free (priv->columns);
+  else
+    g_sequence_foreach (priv->seq,
+                        (GFunc) _gtk_tree_data_list_free, priv->column_headers);
 
   g_sequence_free (priv->seq);
 
@@ -674,7 +735,14 @@ gtk_list_store_get_value (GtkTreeModel *tree_model,
 
   g_return_if_fail (column < priv->n_columns);
   g_return_if_fail (iter_is_valid (iter, list_store));
-		    
+
+  if (priv->columnar)
+    {
+      _gtk_tree_data_columns_get_value (priv->columns, ROW_INDEX (iter->user_data),
+                                        column, value);
+      return;
+    }
+
   list = g_sequence_get (iter->user_data);
 
   while (tmp_column-- > 0 && list)
@@ -850,6 +918,17 @@ gtk_list_store_real_set_value (GtkListStore *list_store,
       converted = TRUE;
     }
 
+  if (priv->columnar)
+    {
+      _gtk_tree_data_columns_set_value (priv->columns, ROW_INDEX (iter->user_data),
+                                        column, converted ? &real_value : value);
+      if (converted)
+        g_value_unset (&real_value);
+      if (sort && GTK_LIST_STORE_IS_SORTED (list_store))
+        gtk_list_store_sort_iter_changed (list_store, iter, old_column);
+      return TRUE;
+    }
+
   prev = list = g_sequence_get (iter->user_data);
 
   while (list != NULL)
@@ -1207,7 +1286,10 @@ gtk_list_store_remove (GtkListStore *list_store,
   ptr = iter->user_data;
   next = g_sequence_iter_next (ptr);
   
-  _gtk_tree_data_list_free (g_sequence_get (ptr), priv->column_headers);
+  if (priv->columnar)
+    _gtk_tree_data_columns_remove_row (priv->columns, ROW_INDEX (ptr));
+  else
+    _gtk_tree_data_list_free (g_sequence_get (ptr), priv->column_headers);
   g_sequence_remove (iter->user_data);
 
   priv->length--;
@@ -1228,6 +1310,23 @@ gtk_list_store_remove (GtkListStore *list_store,
     }
 }
 
+/* Returns the data for a new row in the sequence: the row index
+ * plus one in columnar mode, and an empty GtkTreeDataList otherwise.
+ */
+static gpointer
+gtk_list_store_new_row (GtkListStore *list_store)
+{
+  GtkListStorePrivate *priv = list_store->priv;
+
+  if (!priv->columnar)
+    return NULL;
+
+  if (priv->columns == NULL)
+    priv->columns = _gtk_tree_data_columns_new (priv->n_columns, priv->column_headers);
+
+  return GUINT_TO_POINTER (_gtk_tree_data_columns_add_row (priv->columns) + 1);
+}
+
 /**
  * gtk_list_store_insert:
  * @list_store: A #GtkListStore
@@ -1266,7 +1365,7 @@ gtk_list_store_insert (GtkListStore *list_store,
     position = length;
 
   ptr = g_sequence_get_iter_at_pos (seq, position);
-  ptr = g_sequence_insert_before (ptr, NULL);
+  ptr = g_sequence_insert_before (ptr, gtk_list_store_new_row (list_store));
 
   iter->stamp = priv->stamp;
   iter->user_data = ptr;
@@ -1558,7 +1657,20 @@ gtk_list_store_drag_data_received (GtkTreeDragDest   *drag_dest,
 
       /* If we succeeded in creating dest_iter, copy data from src
        */
-      if (retval)
+      if (retval && priv->columnar)
+        {
+          GtkTreePath *path;
+
+          _gtk_tree_data_columns_copy_row (priv->columns,
+                                           ROW_INDEX (src_iter.user_data),
+                                           ROW_INDEX (dest_iter.user_data));
+
+          dest_iter.stamp = priv->stamp;
+	  path = gtk_list_store_get_path (tree_model, &dest_iter);
+	  gtk_tree_model_row_changed (tree_model, path, &dest_iter);
+	  gtk_tree_path_free (path);
+        }
+      else if (retval)
         {
           GtkTreeDataList *dl = g_sequence_get (src_iter.user_data);
           GtkTreeDataList *copy_head = NULL;
@@ -1942,6 +2054,93 @@ gtk_list_store_compare_func (GSequenceIter *a,
   return retval;
 }
 
+/* Sorts with _gtk_tree_data_list_sort_by_key() if the builtin
+ * compare function is used, which is a lot faster than calling it
+ * for every comparison. In columnar mode the keys are read from
+ * the column arrays directly.
+ */
+static gboolean
+gtk_list_store_sort_by_key (GtkListStore *list_store)
+{
+  GtkListStorePrivate *priv = list_store->priv;
+  GtkTreeDataSortHeader *header;
+  GSequenceIter **siters;
+  GSequenceIter *ptr, *end;
+  GtkTreePath *path;
+  gint *new_order;
+  gint n, i;
+
+  if (priv->sort_column_id == GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID)
+    return FALSE;
+
+  header = _gtk_tree_data_list_get_header (priv->sort_list, priv->sort_column_id);
+  if (header == NULL || header->func != _gtk_tree_data_list_compare_func)
+    return FALSE;
+
+  n = g_sequence_get_length (priv->seq);
+  siters = g_new (GSequenceIter *, n);
+
+  if (priv->columnar)
+    {
+      guint *rows = g_new (guint, n);
+
+      for (ptr = g_sequence_get_begin_iter (priv->seq), i = 0;
+           !g_sequence_iter_is_end (ptr);
+           ptr = g_sequence_iter_next (ptr), i++)
+        {
+          siters[i] = ptr;
+          rows[i] = ROW_INDEX (ptr);
+        }
+
+      new_order = _gtk_tree_data_columns_sort_by_key (priv->columns,
+                                                      GPOINTER_TO_INT (header->data),
+                                                      priv->order,
+                                                      rows, n);
+      g_free (rows);
+    }
+  else
+    {
+      GtkTreeIter *iters = g_new (GtkTreeIter, n);
+
+      for (ptr = g_sequence_get_begin_iter (priv->seq), i = 0;
+           !g_sequence_iter_is_end (ptr);
+           ptr = g_sequence_iter_next (ptr), i++)
+        {
+          siters[i] = ptr;
+          iters[i].stamp = priv->stamp;
+          iters[i].user_data = ptr;
+        }
+
+      new_order = _gtk_tree_data_list_sort_by_key (GTK_TREE_MODEL (list_store),
+                                                   GPOINTER_TO_INT (header->data),
+                                                   priv->order,
+                                                   iters, n);
+      g_free (iters);
+    }
+
+  if (new_order == NULL)
+    {
+      g_free (siters);
+      return FALSE;
+    }
+
+  /* Rebuild the sequence in one pass. The rows keep their
+   * GSequenceIters, so iters stay valid.
+   */
+  end = g_sequence_get_end_iter (priv->seq);
+  for (i = 0; i < n; i++)
+    g_sequence_move (siters[new_order[i]], end);
+  g_free (siters);
+
+  path = gtk_tree_path_new ();
+  gtk_tree_model_rows_reordered (GTK_TREE_MODEL (list_store),
+				 path, NULL, new_order);
+  gtk_tree_path_free (path);
+  g_free (new_order);
+
+  return TRUE;
+}
+
 static void
 gtk_list_store_sort (GtkListStore *list_store)
 {
@@ -1954,6 +2153,9 @@ gtk_list_store_sort (GtkListStore *list_store)
       g_sequence_get_length (priv->seq) <= 1)
     return;
 
+  if (gtk_list_store_sort_by_key (list_store))
+    return;
+
   old_positions = save_positions (priv->seq);
 
   g_sequence_sort_iter (priv->seq, gtk_list_store_compare_func, list_store);
@@ -2204,7 +2406,7 @@ gtk_list_store_insert_with_values (GtkListStore *list_store,
     position = length;
 
   ptr = g_sequence_get_iter_at_pos (seq, position);
-  ptr = g_sequence_insert_before (ptr, NULL);
+  ptr = g_sequence_insert_before (ptr, gtk_list_store_new_row (list_store));
 
   iter->stamp = priv->stamp;
   iter->user_data = ptr;
@@ -2282,7 +2484,7 @@ gtk_list_store_insert_with_valuesv (GtkListStore *list_store,
     position = length;
 
   ptr = g_sequence_get_iter_at_pos (seq, position);
-  ptr = g_sequence_insert_before (ptr, NULL);
+  ptr = g_sequence_insert_before (ptr, gtk_list_store_new_row (list_store));
 
   iter->stamp = priv->stamp;
   iter->user_data = ptr;
@@ -2307,6 +2509,82 @@ gtk_list_store_insert_with_valuesv (GtkListStore *list_store,
   gtk_tree_path_free (path);
 }
 
+/**
+ * gtk_list_store_insert_rows_with_valuesv:
+ * @list_store: A #GtkListStore
+ * @position: position to insert the new rows, or -1 to append them
+ * @n_rows: the number of rows to insert
+ * @columns: (array length=n_values): an array of column numbers
+ * @values: (array): an array of @n_rows times @n_values GValues,
+ *     holding the values of the first row, followed by those of the
+ *     second row, and so on
+ * @n_values: the length of the @columns array
+ *
+ * Inserts @n_rows rows at @position, like calling
+ * gtk_list_store_insert_with_valuesv() for every row, but emits a single
+ * #GtkTreeModel::rows-inserted signal for all of them. Views and models
+ * that know about that signal update themselves for all rows at once,
+ * which makes filling a store that is already displayed much faster.
+ *
+ * If @list_store is sorted, the rows are appended and then sorted into
+ * place, which emits #GtkTreeModel::rows-reordered.
+ */
+void
+gtk_list_store_insert_rows_with_valuesv (GtkListStore *list_store,
+                                         gint          position,
+                                         gint          n_rows,
+                                         gint         *columns,
+                                         GValue       *values,
+                                         gint          n_values)
+{
+  GtkListStorePrivate *priv;
+  GtkTreePath *path;
+  GSequenceIter *ptr;
+  GtkTreeIter iter, first = { 0, };
+  gint length, i;
+  gboolean changed = FALSE;
+  gboolean maybe_need_sort = FALSE;
+
+  g_return_if_fail (GTK_IS_LIST_STORE (list_store));
+  g_return_if_fail (n_rows >= 0);
+  g_return_if_fail (n_values == 0 || (columns != NULL && values != NULL));
+
+  if (n_rows == 0)
+    return;
+
+  priv = list_store->priv;
+
+  priv->columns_dirty = TRUE;
+
+  length = g_sequence_get_length (priv->seq);
+  if (position > length || position < 0 || GTK_LIST_STORE_IS_SORTED (list_store))
+    position = length;
+
+  ptr = g_sequence_get_iter_at_pos (priv->seq, position);
+
+  iter.stamp = priv->stamp;
+  for (i = 0; i < n_rows; i++)
+    {
+      iter.user_data = g_sequence_insert_before (ptr, gtk_list_store_new_row (list_store));
+      if (i == 0)
+        first = iter;
+
+      gtk_list_store_set_vector_internal (list_store, &iter,
+                                          &changed, &maybe_need_sort,
+                                          columns, values + i * n_values,
+                                          n_values);
+    }
+
+  priv->length += n_rows;
+
+  path = gtk_tree_path_new_from_indices (position, -1);
+  gtk_tree_model_rows_inserted (GTK_TREE_MODEL (list_store), path, &first, n_rows);
+  gtk_tree_path_free (path);
+
+  if (GTK_LIST_STORE_IS_SORTED (list_store))
+    gtk_list_store_sort (list_store);
+}
+
 /* GtkBuildable custom tag implementation
  *
  * <columns>
@@ -73,6 +73,11 @@ GDK_AVAILABLE_IN_ALL
 void          gtk_list_store_set_column_types (GtkListStore *list_store,
 					       gint          n_columns,
 					       GType        *types);
+GDK_AVAILABLE_IN_ALL
+void          gtk_list_store_set_columnar     (GtkListStore *list_store,
+                                               gboolean      columnar);
+GDK_AVAILABLE_IN_ALL
+gboolean      gtk_list_store_get_columnar     (GtkListStore *list_store);
 
 /* NOTE: use gtk_tree_model_get to get values from a GtkListStore */
 
@@ -123,6 +128,13 @@ void          gtk_list_store_insert_with_valuesv (GtkListStore *list_store,
 						  GValue       *values,
 						  gint          n_values);
 GDK_AVAILABLE_IN_ALL
+void          gtk_list_store_insert_rows_with_valuesv (GtkListStore *list_store,
+                                                       gint          position,
+                                                       gint          n_rows,
+                                                       gint         *columns,
+                                                       GValue       *values,
+                                                       gint          n_values);
+GDK_AVAILABLE_IN_ALL
 void          gtk_list_store_prepend          (GtkListStore *list_store,
 					       GtkTreeIter  *iter);
 GDK_AVAILABLE_IN_ALL
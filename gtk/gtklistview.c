@@ -0,0 +1,769 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtklistview.h"
+
+#include "gtkadjustment.h"
+#include "gtkintl.h"
+#include "gtkprivate.h"
+#include "gtkscrollable.h"
+#include "gtksnapshot.h"
+#include "gtkwidgetprivate.h"
+
+/**
+ * SECTION:gtklistview
+ * @Short_description: A scrollable list for large models
+ * @Title: GtkListView
+ * @See_also: #GListModel, #GtkListBox
+ *
+ * GtkListView displays the items of a #GListModel as a vertical list
+ * of rows. Unlike #GtkListBox, it only creates as many row widgets as
+ * are needed to fill the visible area. When scrolling, rows that leave
+ * the visible area are reused for the items that come into view.
+ *
+ * This makes creating a GtkListView and scrolling it independent of
+ * the number of items in the model, so it can be used for models with
+ * millions of items.
+ *
+ * Rows are created with a #GtkListViewCreateWidgetFunc and made to
+ * display an item with a #GtkListViewBindWidgetFunc, see
+ * gtk_list_view_bind_model().
+ *
+ * The size of the list is estimated from the rows that have been
+ * displayed so far, so it is best if all rows have a similar height.
+ *
+ * GtkListView implements #GtkScrollable and is meant to be put directly
+ * into a #GtkScrolledWindow.
+ *
+ * # CSS nodes
+ *
+ * GtkListView uses a single CSS node named listview. The row widgets
+ * are its children.
+ */
+
+/* Extra rows above and below the visible area, in pages */
+#define OVERSCAN 0.5
+
+/* Height used for rows until the first one has been measured */
+#define DEFAULT_ROW_HEIGHT 20
+
+struct _GtkListView
+{
+  GtkWidget parent_instance;
+
+  GListModel *model;
+  GtkListViewCreateWidgetFunc create_widget_func;
+  GtkListViewBindWidgetFunc bind_widget_func;
+  gpointer user_data;
+  GDestroyNotify user_data_free_func;
+
+  GtkAdjustment *adjustment[2];
+  guint scroll_policy[2];
+
+  /* rows->pdata[i] displays the item at position first + i */
+  GPtrArray *rows;
+  guint first;
+  /* rows that are not displaying any item */
+  GPtrArray *pool;
+
+  /* Sum and number of the heights of all rows that were bound so far */
+  guint64 measured_height;
+  guint n_measured;
+
+  /* The size and scroll offset that the rows were chosen for, and
+   * where the first row goes at that offset
+   */
+  int rows_width;
+  int rows_height;
+  int rows_value;
+  int rows_y;
+};
+
+struct _GtkListViewClass
+{
+  GtkWidgetClass parent_class;
+};
+
+enum {
+  PROP_0,
+  PROP_MODEL,
+  PROP_HADJUSTMENT,
+  PROP_VADJUSTMENT,
+  PROP_HSCROLL_POLICY,
+  PROP_VSCROLL_POLICY,
+  N_PROPS = PROP_HADJUSTMENT
+};
+
+static GParamSpec *properties[N_PROPS] = { NULL, };
+
+G_DEFINE_TYPE_WITH_CODE (GtkListView, gtk_list_view, GTK_TYPE_WIDGET,
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_SCROLLABLE, NULL))
+
+static int
+gtk_list_view_get_row_height (GtkListView *self)
+{
+  if (self->n_measured == 0)
+    return DEFAULT_ROW_HEIGHT;
+
+  return MAX (1, self->measured_height / self->n_measured);
+}
+
+static int
+gtk_list_view_get_list_height (GtkListView *self)
+{
+  gint64 height;
+
+  if (self->model == NULL)
+    return 0;
+
+  height = (gint64) g_list_model_get_n_items (self->model) * gtk_list_view_get_row_height (self);
+
+  return MIN (height, G_MAXINT);
+}
+
+static void
+gtk_list_view_release_row (GtkListView *self,
+                           GtkWidget   *row)
+{
+  gtk_widget_set_child_visible (row, FALSE);
+  g_ptr_array_add (self->pool, row);
+}
+
+static void
+gtk_list_view_release_rows (GtkListView *self,
+                            guint        position)
+{
+  guint i;
+
+  if (position < self->first)
+    position = self->first;
+
+  for (i = position - self->first; i < self->rows->len; i++)
+    gtk_list_view_release_row (self, g_ptr_array_index (self->rows, i));
+
+  if (position - self->first < self->rows->len)
+    g_ptr_array_set_size (self->rows, position - self->first);
+}
+
+static GtkWidget *
+gtk_list_view_acquire_row (GtkListView *self,
+                           guint        position)
+{
+  GtkWidget *row;
+  gpointer item;
+
+  if (self->pool->len > 0)
+    {
+      row = g_ptr_array_index (self->pool, self->pool->len - 1);
+      g_ptr_array_remove_index_fast (self->pool, self->pool->len - 1);
+      gtk_widget_set_child_visible (row, TRUE);
+    }
+  else
+    {
+      row = self->create_widget_func (self->user_data);
+      gtk_widget_set_parent (row, GTK_WIDGET (self));
+    }
+
+  item = g_list_model_get_item (self->model, position);
+  self->bind_widget_func (row, item, self->user_data);
+  g_object_unref (item);
+
+  return row;
+}
+
+static void
+gtk_list_view_clear_rows (GtkListView *self)
+{
+  guint i;
+
+  for (i = 0; i < self->rows->len; i++)
+    gtk_widget_unparent (g_ptr_array_index (self->rows, i));
+  g_ptr_array_set_size (self->rows, 0);
+
+  for (i = 0; i < self->pool->len; i++)
+    gtk_widget_unparent (g_ptr_array_index (self->pool, i));
+  g_ptr_array_set_size (self->pool, 0);
+
+  self->first = 0;
+  self->measured_height = 0;
+  self->n_measured = 0;
+  self->rows_width = 0;
+  self->rows_height = 0;
+  self->rows_value = 0;
+  self->rows_y = 0;
+}
+
+static void
+gtk_list_view_measure (GtkWidget      *widget,
+                       GtkOrientation  orientation,
+                       int             for_size,
+                       int            *minimum,
+                       int            *natural,
+                       int            *minimum_baseline,
+                       int            *natural_baseline)
+{
+  GtkListView *self = GTK_LIST_VIEW (widget);
+  guint i;
+
+  *minimum = *natural = 0;
+
+  if (self->model == NULL)
+    return;
+
+  if (orientation == GTK_ORIENTATION_HORIZONTAL)
+    {
+      /* Only the rows we have are taken into account, measuring all
+       * items would defeat the purpose of this widget.
+       */
+      for (i = 0; i < self->rows->len; i++)
+        {
+          int child_min, child_nat;
+
+          gtk_widget_measure (g_ptr_array_index (self->rows, i),
+                              GTK_ORIENTATION_HORIZONTAL, -1,
+                              &child_min, &child_nat,
+                              NULL, NULL);
+          *minimum = MAX (*minimum, child_min);
+          *natural = MAX (*natural, child_nat);
+        }
+    }
+  else
+    {
+      *natural = gtk_list_view_get_list_height (self);
+    }
+}
+
+static void
+gtk_list_view_update_adjustments (GtkListView *self,
+                                  int          width,
+                                  int          height,
+                                  int          list_height)
+{
+  GtkAdjustment *hadjustment = self->adjustment[GTK_ORIENTATION_HORIZONTAL];
+  GtkAdjustment *vadjustment = self->adjustment[GTK_ORIENTATION_VERTICAL];
+
+  gtk_adjustment_configure (hadjustment,
+                            0, 0, width,
+                            width * 0.1, width * 0.9, width);
+
+  gtk_adjustment_configure (vadjustment,
+                            gtk_adjustment_get_value (vadjustment),
+                            0,
+                            MAX (list_height, height),
+                            gtk_list_view_get_row_height (self),
+                            height * 0.9,
+                            height);
+}
+
+/* Makes the rows display the items that are in, or close to, a view of
+ * the given size at the current scroll offset. Rows that still show an
+ * item in that range are kept, the others are reused for new items.
+ *
+ * Binding rows and adding them to the view queues resizes, so this must
+ * not be called while allocating if it can be avoided.
+ */
+static void
+gtk_list_view_update_rows (GtkListView *self,
+                           int          width,
+                           int          height)
+{
+  GPtrArray *old_rows;
+  guint old_first, n_items, position, i;
+  int row_height, overscan, value, y;
+
+  if (self->model)
+    n_items = g_list_model_get_n_items (self->model);
+  else
+    n_items = 0;
+
+  /* The position of the first row is estimated from the scroll offset,
+   * the rows after it are laid out with their real heights.
+   */
+  row_height = gtk_list_view_get_row_height (self);
+  overscan = height * OVERSCAN;
+  value = gtk_adjustment_get_value (self->adjustment[GTK_ORIENTATION_VERTICAL]);
+  position = MIN (MAX (value - overscan, 0) / row_height, n_items);
+  y = position * row_height - value;
+
+  self->rows_width = width;
+  self->rows_height = height;
+  self->rows_value = value;
+  self->rows_y = y;
+
+  /* Give up rows outside of the new range right away, so they can be
+   * reused for the new rows instead of creating more.
+   */
+  old_rows = self->rows;
+  old_first = self->first;
+  self->rows = g_ptr_array_new ();
+  self->first = position;
+  for (i = 0; i < old_rows->len; i++)
+    {
+      if (old_first + i < position || old_first + i >= position + old_rows->len)
+        {
+          gtk_list_view_release_row (self, g_ptr_array_index (old_rows, i));
+          g_ptr_array_index (old_rows, i) = NULL;
+        }
+    }
+
+  for (; position < n_items && y < height + overscan; position++)
+    {
+      GtkWidget *row = NULL;
+      int min, nat;
+
+      if (position >= old_first && position - old_first < old_rows->len)
+        {
+          row = g_ptr_array_index (old_rows, position - old_first);
+          g_ptr_array_index (old_rows, position - old_first) = NULL;
+        }
+
+      if (row == NULL)
+        {
+          row = gtk_list_view_acquire_row (self, position);
+          gtk_widget_measure (row, GTK_ORIENTATION_VERTICAL, width,
+                              &min, &nat, NULL, NULL);
+          self->measured_height += nat;
+          self->n_measured++;
+        }
+      else
+        {
+          gtk_widget_measure (row, GTK_ORIENTATION_VERTICAL, width,
+                              &min, &nat, NULL, NULL);
+        }
+
+      g_ptr_array_add (self->rows, row);
+
+      y += nat;
+    }
+
+  for (i = 0; i < old_rows->len; i++)
+    {
+      if (g_ptr_array_index (old_rows, i))
+        gtk_list_view_release_row (self, g_ptr_array_index (old_rows, i));
+    }
+  g_ptr_array_free (old_rows, TRUE);
+
+  /* Don't keep more spare rows around than we need to fill the view */
+  while (self->pool->len > MAX (self->rows->len, 1))
+    {
+      gtk_widget_unparent (g_ptr_array_index (self->pool, self->pool->len - 1));
+      g_ptr_array_remove_index_fast (self->pool, self->pool->len - 1);
+    }
+}
+
+/* Updates the rows for the size they were last chosen for, before the
+ * next allocation. Does nothing until the view has been allocated.
+ */
+static void
+gtk_list_view_update_rows_for_allocation (GtkListView *self)
+{
+  if (self->rows_width == 0 && self->rows_height == 0)
+    return;
+
+  gtk_list_view_update_rows (self, self->rows_width, self->rows_height);
+}
+
+static void
+gtk_list_view_size_allocate (GtkWidget           *widget,
+                             const GtkAllocation *allocation,
+                             int                  baseline,
+                             GtkAllocation       *out_clip)
+{
+  GtkListView *self = GTK_LIST_VIEW (widget);
+  guint i;
+  int value, y;
+
+  g_signal_handlers_block_matched (self->adjustment[GTK_ORIENTATION_VERTICAL],
+                                   G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, self);
+  gtk_list_view_update_adjustments (self,
+                                    allocation->width,
+                                    allocation->height,
+                                    gtk_list_view_get_list_height (self));
+  g_signal_handlers_unblock_matched (self->adjustment[GTK_ORIENTATION_VERTICAL],
+                                     G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, self);
+
+  /* Scrolling and model changes update the rows before we get here.
+   * Only a new size, or a scroll offset that was clamped to it, needs
+   * different rows now.
+   */
+  value = gtk_adjustment_get_value (self->adjustment[GTK_ORIENTATION_VERTICAL]);
+  if (allocation->width != self->rows_width ||
+      allocation->height != self->rows_height ||
+      value != self->rows_value)
+    gtk_list_view_update_rows (self, allocation->width, allocation->height);
+
+  y = self->rows_y;
+
+  for (i = 0; i < self->rows->len; i++)
+    {
+      GtkWidget *row = g_ptr_array_index (self->rows, i);
+      GtkAllocation child_allocation, child_clip;
+      int min, nat;
+
+      gtk_widget_measure (row, GTK_ORIENTATION_VERTICAL, allocation->width,
+                          &min, &nat, NULL, NULL);
+
+      child_allocation.x = 0;
+      child_allocation.y = y;
+      child_allocation.width = allocation->width;
+      child_allocation.height = nat;
+      gtk_widget_size_allocate (row, &child_allocation, -1, &child_clip);
+
+      y += nat;
+    }
+}
+
+static void
+gtk_list_view_snapshot (GtkWidget   *widget,
+                        GtkSnapshot *snapshot)
+{
+  gtk_snapshot_push_clip (snapshot,
+                          &GRAPHENE_RECT_INIT (
+                            0, 0,
+                            gtk_widget_get_width (widget),
+                            gtk_widget_get_height (widget)),
+                          "ListView");
+
+  GTK_WIDGET_CLASS (gtk_list_view_parent_class)->snapshot (widget, snapshot);
+
+  gtk_snapshot_pop (snapshot);
+}
+
+static void
+gtk_list_view_adjustment_value_changed (GtkAdjustment *adjustment,
+                                        GtkListView   *self)
+{
+  gtk_list_view_update_rows_for_allocation (self);
+  gtk_widget_queue_allocate (GTK_WIDGET (self));
+}
+
+static void
+gtk_list_view_clear_adjustment (GtkListView    *self,
+                                GtkOrientation  orientation)
+{
+  if (self->adjustment[orientation] == NULL)
+    return;
+
+  g_signal_handlers_disconnect_by_func (self->adjustment[orientation],
+                                        gtk_list_view_adjustment_value_changed,
+                                        self);
+  g_clear_object (&self->adjustment[orientation]);
+}
+
+static void
+gtk_list_view_set_adjustment (GtkListView    *self,
+                              GtkOrientation  orientation,
+                              GtkAdjustment  *adjustment)
+{
+  if (self->adjustment[orientation] == adjustment && adjustment != NULL)
+    return;
+
+  if (adjustment == NULL)
+    adjustment = gtk_adjustment_new (0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+
+  g_object_ref_sink (adjustment);
+  gtk_list_view_clear_adjustment (self, orientation);
+  self->adjustment[orientation] = adjustment;
+
+  g_signal_connect (adjustment, "value-changed",
+                    G_CALLBACK (gtk_list_view_adjustment_value_changed),
+                    self);
+
+  gtk_widget_queue_allocate (GTK_WIDGET (self));
+}
+
+static void
+gtk_list_view_items_changed (GListModel  *model,
+                             guint        position,
+                             guint        removed,
+                             guint        added,
+                             GtkListView *self)
+{
+  if (position + removed <= self->first)
+    {
+      /* Everything we display just moved */
+      self->first = self->first + added - removed;
+    }
+  else
+    {
+      /* Rows at or after the change need to be rebound */
+      gtk_list_view_release_rows (self, position);
+    }
+
+  gtk_list_view_update_rows_for_allocation (self);
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+}
+
+static void
+gtk_list_view_clear_model (GtkListView *self)
+{
+  if (self->model)
+    {
+      g_signal_handlers_disconnect_by_func (self->model,
+                                            gtk_list_view_items_changed,
+                                            self);
+      g_clear_object (&self->model);
+    }
+
+  gtk_list_view_clear_rows (self);
+
+  if (self->user_data_free_func)
+    self->user_data_free_func (self->user_data);
+
+  self->create_widget_func = NULL;
+  self->bind_widget_func = NULL;
+  self->user_data = NULL;
+  self->user_data_free_func = NULL;
+}
+
+static void
+gtk_list_view_dispose (GObject *object)
+{
+  GtkListView *self = GTK_LIST_VIEW (object);
+
+  gtk_list_view_clear_model (self);
+  gtk_list_view_clear_adjustment (self, GTK_ORIENTATION_HORIZONTAL);
+  gtk_list_view_clear_adjustment (self, GTK_ORIENTATION_VERTICAL);
+
+  G_OBJECT_CLASS (gtk_list_view_parent_class)->dispose (object);
+}
+
+static void
+gtk_list_view_finalize (GObject *object)
+{
+  GtkListView *self = GTK_LIST_VIEW (object);
+
+  g_ptr_array_free (self->rows, TRUE);
+  g_ptr_array_free (self->pool, TRUE);
+
+  G_OBJECT_CLASS (gtk_list_view_parent_class)->finalize (object);
+}
+
+static void
+gtk_list_view_get_property (GObject    *object,
+                            guint       property_id,
+                            GValue     *value,
+                            GParamSpec *pspec)
+{
+  GtkListView *self = GTK_LIST_VIEW (object);
+
+  switch (property_id)
+    {
+    case PROP_MODEL:
+      g_value_set_object (value, self->model);
+      break;
+
+    case PROP_HADJUSTMENT:
+      g_value_set_object (value, self->adjustment[GTK_ORIENTATION_HORIZONTAL]);
+      break;
+
+    case PROP_VADJUSTMENT:
+      g_value_set_object (value, self->adjustment[GTK_ORIENTATION_VERTICAL]);
+      break;
+
+    case PROP_HSCROLL_POLICY:
+      g_value_set_enum (value, self->scroll_policy[GTK_ORIENTATION_HORIZONTAL]);
+      break;
+
+    case PROP_VSCROLL_POLICY:
+      g_value_set_enum (value, self->scroll_policy[GTK_ORIENTATION_VERTICAL]);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+    }
+}
+
+static void
+gtk_list_view_set_scroll_policy (GtkListView         *self,
+                                 GtkOrientation       orientation,
+                                 GtkScrollablePolicy  scroll_policy)
+{
+  if (self->scroll_policy[orientation] == scroll_policy)
+    return;
+
+  self->scroll_policy[orientation] = scroll_policy;
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+  g_object_notify (G_OBJECT (self),
+                   orientation == GTK_ORIENTATION_HORIZONTAL ? "hscroll-policy" : "vscroll-policy");
+}
+
+static void
+gtk_list_view_set_property (GObject      *object,
+                            guint         property_id,
+                            const GValue *value,
+                            GParamSpec   *pspec)
+{
+  GtkListView *self = GTK_LIST_VIEW (object);
+
+  switch (property_id)
+    {
+    case PROP_HADJUSTMENT:
+      gtk_list_view_set_adjustment (self, GTK_ORIENTATION_HORIZONTAL, g_value_get_object (value));
+      break;
+
+    case PROP_VADJUSTMENT:
+      gtk_list_view_set_adjustment (self, GTK_ORIENTATION_VERTICAL, g_value_get_object (value));
+      break;
+
+    case PROP_HSCROLL_POLICY:
+      gtk_list_view_set_scroll_policy (self, GTK_ORIENTATION_HORIZONTAL, g_value_get_enum (value));
+      break;
+
+    case PROP_VSCROLL_POLICY:
+      gtk_list_view_set_scroll_policy (self, GTK_ORIENTATION_VERTICAL, g_value_get_enum (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+    }
+}
+
+static void
+gtk_list_view_class_init (GtkListViewClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+
+  gobject_class->dispose = gtk_list_view_dispose;
+  gobject_class->finalize = gtk_list_view_finalize;
+  gobject_class->get_property = gtk_list_view_get_property;
+  gobject_class->set_property = gtk_list_view_set_property;
+
+  widget_class->measure = gtk_list_view_measure;
+  widget_class->size_allocate = gtk_list_view_size_allocate;
+  widget_class->snapshot = gtk_list_view_snapshot;
+
+  /**
+   * GtkListView:model:
+   *
+   * The model displayed by the list view.
+   */
+  properties[PROP_MODEL] =
+    g_param_spec_object ("model",
+                         P_("Model"),
+                         P_("The model displayed by the list"),
+                         G_TYPE_LIST_MODEL,
+                         GTK_PARAM_READABLE);
+
+  g_object_class_install_properties (gobject_class, N_PROPS, properties);
+
+  /* GtkScrollable implementation */
+  g_object_class_override_property (gobject_class, PROP_HADJUSTMENT,    "hadjustment");
+  g_object_class_override_property (gobject_class, PROP_VADJUSTMENT,    "vadjustment");
+  g_object_class_override_property (gobject_class, PROP_HSCROLL_POLICY, "hscroll-policy");
+  g_object_class_override_property (gobject_class, PROP_VSCROLL_POLICY, "vscroll-policy");
+
+  gtk_widget_class_set_accessible_role (widget_class, ATK_ROLE_LIST);
+  gtk_widget_class_set_css_name (widget_class, I_("listview"));
+}
+
+static void
+gtk_list_view_init (GtkListView *self)
+{
+  gtk_widget_set_has_window (GTK_WIDGET (self), FALSE);
+
+  self->rows = g_ptr_array_new ();
+  self->pool = g_ptr_array_new ();
+
+  gtk_list_view_set_adjustment (self, GTK_ORIENTATION_HORIZONTAL, NULL);
+  gtk_list_view_set_adjustment (self, GTK_ORIENTATION_VERTICAL, NULL);
+}
+
+/**
+ * gtk_list_view_new:
+ *
+ * Creates a new #GtkListView without a model.
+ *
+ * Returns: a new #GtkListView
+ */
+GtkWidget *
+gtk_list_view_new (void)
+{
+  return g_object_new (GTK_TYPE_LIST_VIEW, NULL);
+}
+
+/**
+ * gtk_list_view_bind_model:
+ * @self: a #GtkListView
+ * @model: (nullable): the #GListModel to display, or %NULL
+ * @create_widget_func: (nullable): a function that creates row widgets
+ * @bind_widget_func: (nullable): a function that makes a row widget
+ *     display an item of @model
+ * @user_data: (closure): user data passed to the functions
+ * @user_data_free_func: function for freeing @user_data
+ *
+ * Binds @model to @self.
+ *
+ * Row widgets are created with @create_widget_func as needed to fill
+ * the visible area of @self, and @bind_widget_func is called whenever
+ * a row starts displaying a different item. The number of rows does
+ * not depend on the number of items in @model.
+ *
+ * If @self was already bound to a model, that previous binding is
+ * destroyed.
+ */
+void
+gtk_list_view_bind_model (GtkListView                 *self,
+                          GListModel                  *model,
+                          GtkListViewCreateWidgetFunc  create_widget_func,
+                          GtkListViewBindWidgetFunc    bind_widget_func,
+                          gpointer                     user_data,
+                          GDestroyNotify               user_data_free_func)
+{
+  g_return_if_fail (GTK_IS_LIST_VIEW (self));
+  g_return_if_fail (model == NULL || G_IS_LIST_MODEL (model));
+  g_return_if_fail (model == NULL || create_widget_func != NULL);
+  g_return_if_fail (model == NULL || bind_widget_func != NULL);
+
+  gtk_list_view_clear_model (self);
+
+  if (model)
+    {
+      self->model = g_object_ref (model);
+      self->create_widget_func = create_widget_func;
+      self->bind_widget_func = bind_widget_func;
+      self->user_data = user_data;
+      self->user_data_free_func = user_data_free_func;
+
+      g_signal_connect (model, "items-changed",
+                        G_CALLBACK (gtk_list_view_items_changed), self);
+    }
+
+  gtk_adjustment_set_value (self->adjustment[GTK_ORIENTATION_VERTICAL], 0);
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_MODEL]);
+}
+
+/**
+ * gtk_list_view_get_model:
+ * @self: a #GtkListView
+ *
+ * Gets the model that is currently displayed by @self.
+ *
+ * Returns: (nullable) (transfer none): the model in use
+ */
+GListModel *
+gtk_list_view_get_model (GtkListView *self)
+{
+  g_return_val_if_fail (GTK_IS_LIST_VIEW (self), NULL);
+
+  return self->model;
+}
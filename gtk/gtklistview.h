@@ -0,0 +1,81 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_LIST_VIEW_H__
+#define __GTK_LIST_VIEW_H__
+
+#if !defined (__GTK_H_INSIDE__) && !defined (GTK_COMPILATION)
+#error "Only <gtk/gtk.h> can be included directly."
+#endif
+
+#include <gtk/gtkwidget.h>
+
+G_BEGIN_DECLS
+
+#define GTK_TYPE_LIST_VIEW                 (gtk_list_view_get_type ())
+#define GTK_LIST_VIEW(obj)                 (G_TYPE_CHECK_INSTANCE_CAST ((obj), GTK_TYPE_LIST_VIEW, GtkListView))
+#define GTK_LIST_VIEW_CLASS(klass)         (G_TYPE_CHECK_CLASS_CAST ((klass), GTK_TYPE_LIST_VIEW, GtkListViewClass))
+#define GTK_IS_LIST_VIEW(obj)              (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GTK_TYPE_LIST_VIEW))
+#define GTK_IS_LIST_VIEW_CLASS(klass)      (G_TYPE_CHECK_CLASS_TYPE ((klass), GTK_TYPE_LIST_VIEW))
+#define GTK_LIST_VIEW_GET_CLASS(obj)       (G_TYPE_INSTANCE_GET_CLASS ((obj), GTK_TYPE_LIST_VIEW, GtkListViewClass))
+
+typedef struct _GtkListView             GtkListView;
+typedef struct _GtkListViewClass        GtkListViewClass;
+
+/**
+ * GtkListViewCreateWidgetFunc:
+ * @user_data: (closure): user data passed to gtk_list_view_bind_model()
+ *
+ * Called to create a new row widget for a #GtkListView. The widget
+ * does not show any item yet, it will be passed to a
+ * #GtkListViewBindWidgetFunc before it is displayed.
+ *
+ * Returns: (transfer full): a new #GtkWidget
+ */
+typedef GtkWidget * (*GtkListViewCreateWidgetFunc) (gpointer user_data);
+
+/**
+ * GtkListViewBindWidgetFunc:
+ * @widget: a row widget created by a #GtkListViewCreateWidgetFunc
+ * @item: (type GObject): the item from the model to display
+ * @user_data: (closure): user data passed to gtk_list_view_bind_model()
+ *
+ * Called to make @widget display @item. Row widgets are reused for
+ * different items while scrolling, so this function must update all
+ * of the widget's state that depends on the item.
+ */
+typedef void (*GtkListViewBindWidgetFunc) (GtkWidget *widget,
+                                           gpointer   item,
+                                           gpointer   user_data);
+
+GDK_AVAILABLE_IN_ALL
+GType           gtk_list_view_get_type          (void) G_GNUC_CONST;
+
+GDK_AVAILABLE_IN_ALL
+GtkWidget *     gtk_list_view_new               (void);
+
+GDK_AVAILABLE_IN_ALL
+void            gtk_list_view_bind_model        (GtkListView                 *self,
+                                                 GListModel                  *model,
+                                                 GtkListViewCreateWidgetFunc  create_widget_func,
+                                                 GtkListViewBindWidgetFunc    bind_widget_func,
+                                                 gpointer                     user_data,
+                                                 GDestroyNotify               user_data_free_func);
+GDK_AVAILABLE_IN_ALL
+GListModel *    gtk_list_view_get_model         (GtkListView                 *self);
+
+G_END_DECLS
+
+#endif /* __GTK_LIST_VIEW_H__ */
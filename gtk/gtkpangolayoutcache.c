@@ -0,0 +1,333 @@
+/* GTK - The GIMP Toolkit
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkpangolayoutcacheprivate.h"
+
+#include <pango/pangocairo.h>
+#include <string.h>
+
+/*
+ * A process-wide cache of PangoLayouts that are used read-only.
+ *
+ * Cell renderers and label measurements create layouts for the same
+ * short strings over and over, and shaping them is the expensive part.
+ * gtk_pango_layout_cache_share() takes a freshly set up layout and
+ * returns an equal layout from the cache if there is one, which has
+ * most likely been shaped already. Layouts are equal if their text,
+ * attributes, layout properties and the relevant parts of their
+ * contexts are.
+ *
+ * Layouts returned by the cache are shared and must not be modified;
+ * to change one, copy it with pango_layout_copy() and share the copy.
+ * The least recently used entry is dropped once the cache is full.
+ */
+
+#define MAX_ENTRIES     1024
+#define MAX_TEXT_LENGTH 256
+
+typedef struct _CacheEntry CacheEntry;
+
+struct _CacheEntry
+{
+  PangoLayout *layout;
+  guint hash;
+  guint context_serial;
+  GList link;                   /* in lru */
+};
+
+static GHashTable *entries;
+static GQueue lru = G_QUEUE_INIT;
+static guint64 hits;
+static guint64 misses;
+
+static gboolean
+font_descriptions_equal (const PangoFontDescription *a,
+                         const PangoFontDescription *b)
+{
+  if (a == b)
+    return TRUE;
+
+  if (a == NULL || b == NULL)
+    return FALSE;
+
+  return pango_font_description_equal (a, b);
+}
+
+static gboolean
+contexts_equal (PangoContext *a,
+                PangoContext *b)
+{
+  const cairo_font_options_t *options_a, *options_b;
+  const PangoMatrix *matrix_a, *matrix_b;
+
+  if (a == b)
+    return TRUE;
+
+  if (pango_context_get_font_map (a) != pango_context_get_font_map (b) ||
+      pango_context_get_language (a) != pango_context_get_language (b) ||
+      pango_context_get_base_dir (a) != pango_context_get_base_dir (b) ||
+      pango_context_get_base_gravity (a) != pango_context_get_base_gravity (b) ||
+      pango_context_get_gravity_hint (a) != pango_context_get_gravity_hint (b) ||
+      pango_cairo_context_get_resolution (a) != pango_cairo_context_get_resolution (b) ||
+      !font_descriptions_equal (pango_context_get_font_description (a),
+                                pango_context_get_font_description (b)))
+    return FALSE;
+
+  matrix_a = pango_context_get_matrix (a);
+  matrix_b = pango_context_get_matrix (b);
+  if (matrix_a != matrix_b &&
+      (matrix_a == NULL || matrix_b == NULL ||
+       memcmp (matrix_a, matrix_b, sizeof (PangoMatrix)) != 0))
+    return FALSE;
+
+  options_a = pango_cairo_context_get_font_options (a);
+  options_b = pango_cairo_context_get_font_options (b);
+  if (options_a != options_b &&
+      (options_a == NULL || options_b == NULL ||
+       !cairo_font_options_equal (options_a, options_b)))
+    return FALSE;
+
+  return TRUE;
+}
+
+static gboolean
+attribute_lists_equal (GSList *a,
+                       GSList *b)
+{
+  GSList *l, *k;
+
+  if (g_slist_length (a) != g_slist_length (b))
+    return FALSE;
+
+  for (l = a; l; l = l->next)
+    {
+      for (k = b; k; k = k->next)
+        {
+          if (pango_attribute_equal (l->data, k->data))
+            break;
+        }
+
+      if (k == NULL)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+static gboolean
+attr_lists_equal (PangoAttrList *a,
+                  PangoAttrList *b)
+{
+  PangoAttrIterator *iter_a, *iter_b;
+  gboolean equal = TRUE;
+
+  if (a == b)
+    return TRUE;
+
+  if (a == NULL || b == NULL)
+    return FALSE;
+
+  iter_a = pango_attr_list_get_iterator (a);
+  iter_b = pango_attr_list_get_iterator (b);
+
+  while (equal)
+    {
+      gint start_a, end_a, start_b, end_b;
+      GSList *attrs_a, *attrs_b;
+      gboolean more_a, more_b;
+
+      pango_attr_iterator_range (iter_a, &start_a, &end_a);
+      pango_attr_iterator_range (iter_b, &start_b, &end_b);
+
+      if (start_a != start_b || end_a != end_b)
+        {
+          equal = FALSE;
+          break;
+        }
+
+      attrs_a = pango_attr_iterator_get_attrs (iter_a);
+      attrs_b = pango_attr_iterator_get_attrs (iter_b);
+      equal = attribute_lists_equal (attrs_a, attrs_b);
+      g_slist_free_full (attrs_a, (GDestroyNotify) pango_attribute_destroy);
+      g_slist_free_full (attrs_b, (GDestroyNotify) pango_attribute_destroy);
+
+      more_a = pango_attr_iterator_next (iter_a);
+      more_b = pango_attr_iterator_next (iter_b);
+      if (more_a != more_b)
+        equal = FALSE;
+      if (!more_a)
+        break;
+    }
+
+  pango_attr_iterator_destroy (iter_a);
+  pango_attr_iterator_destroy (iter_b);
+
+  return equal;
+}
+
+static guint
+cache_entry_hash (gconstpointer data)
+{
+  const CacheEntry *entry = data;
+
+  return entry->hash;
+}
+
+static gboolean
+cache_entry_equal (gconstpointer data_a,
+                   gconstpointer data_b)
+{
+  const CacheEntry *entry_a = data_a;
+  const CacheEntry *entry_b = data_b;
+  PangoLayout *a = entry_a->layout;
+  PangoLayout *b = entry_b->layout;
+
+  return entry_a->hash == entry_b->hash &&
+         pango_layout_get_width (a) == pango_layout_get_width (b) &&
+         pango_layout_get_height (a) == pango_layout_get_height (b) &&
+         pango_layout_get_wrap (a) == pango_layout_get_wrap (b) &&
+         pango_layout_get_ellipsize (a) == pango_layout_get_ellipsize (b) &&
+         pango_layout_get_alignment (a) == pango_layout_get_alignment (b) &&
+         pango_layout_get_justify (a) == pango_layout_get_justify (b) &&
+         pango_layout_get_indent (a) == pango_layout_get_indent (b) &&
+         pango_layout_get_spacing (a) == pango_layout_get_spacing (b) &&
+         pango_layout_get_single_paragraph_mode (a) == pango_layout_get_single_paragraph_mode (b) &&
+         pango_layout_get_auto_dir (a) == pango_layout_get_auto_dir (b) &&
+         strcmp (pango_layout_get_text (a), pango_layout_get_text (b)) == 0 &&
+         font_descriptions_equal (pango_layout_get_font_description (a),
+                                  pango_layout_get_font_description (b)) &&
+         attr_lists_equal (pango_layout_get_attributes (a),
+                           pango_layout_get_attributes (b)) &&
+         contexts_equal (pango_layout_get_context (a),
+                         pango_layout_get_context (b));
+}
+
+static guint
+compute_hash (PangoLayout *layout)
+{
+  const PangoFontDescription *desc;
+  guint hash;
+
+  hash = g_str_hash (pango_layout_get_text (layout));
+  hash = hash * 31 + pango_layout_get_width (layout);
+  hash = hash * 31 + pango_layout_get_wrap (layout);
+  hash = hash * 31 + pango_layout_get_ellipsize (layout);
+
+  desc = pango_context_get_font_description (pango_layout_get_context (layout));
+  if (desc)
+    hash = hash * 31 + pango_font_description_hash (desc);
+
+  return hash;
+}
+
+static void
+cache_entry_free (gpointer data)
+{
+  CacheEntry *entry = data;
+
+  g_queue_unlink (&lru, &entry->link);
+  g_object_unref (entry->layout);
+  g_slice_free (CacheEntry, entry);
+}
+
+/*
+ * gtk_pango_layout_cache_share:
+ * @layout: (transfer full): a layout that has been set up completely
+ *
+ * Looks for a layout equal to @layout in the cache. If there is one,
+ * @layout is dropped and the cached layout is returned, otherwise
+ * @layout is added to the cache and returned.
+ *
+ * The returned layout is shared with other users and must not be
+ * modified.
+ *
+ * Returns: (transfer full): a layout equal to @layout
+ */
+PangoLayout *
+gtk_pango_layout_cache_share (PangoLayout *layout)
+{
+  PangoTabArray *tabs;
+  CacheEntry key;
+  CacheEntry *entry;
+
+  g_return_val_if_fail (PANGO_IS_LAYOUT (layout), layout);
+
+  /* Long texts are unlikely to repeat, and tab arrays can't be
+   * compared without copying them.
+   */
+  if (strlen (pango_layout_get_text (layout)) > MAX_TEXT_LENGTH)
+    return layout;
+
+  tabs = pango_layout_get_tabs (layout);
+  if (tabs)
+    {
+      pango_tab_array_free (tabs);
+      return layout;
+    }
+
+  if (entries == NULL)
+    entries = g_hash_table_new_full (cache_entry_hash, cache_entry_equal, NULL, cache_entry_free);
+
+  key.layout = layout;
+  key.hash = compute_hash (layout);
+
+  entry = g_hash_table_lookup (entries, &key);
+
+  /* The context of the cached layout has changed since */
+  if (entry &&
+      entry->context_serial != pango_context_get_serial (pango_layout_get_context (entry->layout)))
+    {
+      g_hash_table_remove (entries, entry);
+      entry = NULL;
+    }
+
+  if (entry)
+    {
+      hits++;
+
+      g_queue_unlink (&lru, &entry->link);
+      g_queue_push_head_link (&lru, &entry->link);
+
+      g_object_unref (layout);
+      return g_object_ref (entry->layout);
+    }
+
+  misses++;
+
+  entry = g_slice_new0 (CacheEntry);
+  entry->layout = g_object_ref (layout);
+  entry->hash = key.hash;
+  entry->context_serial = pango_context_get_serial (pango_layout_get_context (layout));
+  entry->link.data = entry;
+  g_queue_push_head_link (&lru, &entry->link);
+  g_hash_table_add (entries, entry);
+
+  if (g_hash_table_size (entries) > MAX_ENTRIES)
+    g_hash_table_remove (entries, g_queue_peek_tail (&lru));
+
+  return layout;
+}
+
+void
+gtk_pango_layout_cache_get_stats (GtkPangoLayoutCacheStats *stats)
+{
+  stats->n_entries = entries ? g_hash_table_size (entries) : 0;
+  stats->max_entries = MAX_ENTRIES;
+  stats->hits = hits;
+  stats->misses = misses;
+}
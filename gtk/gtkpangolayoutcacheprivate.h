@@ -0,0 +1,39 @@
+/* GTK - The GIMP Toolkit
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_PANGO_LAYOUT_CACHE_PRIVATE_H__
+#define __GTK_PANGO_LAYOUT_CACHE_PRIVATE_H__
+
+#include <pango/pango.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GtkPangoLayoutCacheStats GtkPangoLayoutCacheStats;
+
+struct _GtkPangoLayoutCacheStats
+{
+  guint   n_entries;
+  guint   max_entries;
+  guint64 hits;
+  guint64 misses;
+};
+
+PangoLayout *gtk_pango_layout_cache_share     (PangoLayout              *layout);
+void         gtk_pango_layout_cache_get_stats (GtkPangoLayoutCacheStats *stats);
+
+G_END_DECLS
+
+#endif /* __GTK_PANGO_LAYOUT_CACHE_PRIVATE_H__ */
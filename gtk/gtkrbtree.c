@@ -21,7 +21,8 @@
 
 static GtkRBNode * _gtk_rbnode_new                (GtkRBTree  *tree,
 						   gint        height);
-static void        _gtk_rbnode_free               (GtkRBNode  *node);
+static void        _gtk_rbnode_free               (GtkRBTree  *tree,
+                                                   GtkRBNode  *node);
 static void        _gtk_rbnode_rotate_left        (GtkRBTree  *tree,
 						   GtkRBNode  *node);
 static void        _gtk_rbnode_rotate_right       (GtkRBTree  *tree,
@@ -58,12 +59,26 @@ static GtkRBNode *
 _gtk_rbnode_new (GtkRBTree *tree,
 		 gint       height)
 {
-  GtkRBNode *node = g_slice_new (GtkRBNode);
+  GtkRBNode *node;
+
+  /* Reuse nodes that were removed from a block first, so that
+   * inserting and removing rows doesn't grow the tree's memory.
+   */
+  if (tree->free_nodes)
+    {
+      node = tree->free_nodes;
+      tree->free_nodes = node->parent;
+      node->flags = GTK_RBNODE_RED | GTK_RBNODE_IN_BLOCK;
+    }
+  else
+    {
+      node = g_slice_new (GtkRBNode);
+      node->flags = GTK_RBNODE_RED;
+    }
 
   node->left = (GtkRBNode *) &nil;
   node->right = (GtkRBNode *) &nil;
   node->parent = (GtkRBNode *) &nil;
-  node->flags = GTK_RBNODE_RED;
   node->total_count = 1;
   node->count = 1;
   node->children = NULL;
@@ -72,8 +87,11 @@ _gtk_rbnode_new (GtkRBTree *tree,
 }
 
 static void
-_gtk_rbnode_free (GtkRBNode *node)
+_gtk_rbnode_free (GtkRBTree *tree,
+                  GtkRBNode *node)
 {
+  gboolean in_block = GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_IN_BLOCK);
+
 #ifdef G_ENABLE_DEBUG
   if (GTK_DEBUG_CHECK (TREE))
     {
@@ -86,7 +104,17 @@ _gtk_rbnode_free (GtkRBNode *node)
       node->flags = 0;
     }
 #endif
-  g_slice_free (GtkRBNode, node);
+
+  /* Nodes from _gtk_rbtree_insert_n() are freed with their block
+   * in _gtk_rbtree_free(). Until then, they are reused for new nodes.
+   */
+  if (in_block)
+    {
+      node->parent = tree->free_nodes;
+      tree->free_nodes = node;
+    }
+  else
+    g_slice_free (GtkRBNode, node);
 }
 
 static void
@@ -333,6 +361,8 @@ _gtk_rbtree_new (void)
   retval = g_new (GtkRBTree, 1);
   retval->parent_tree = NULL;
   retval->parent_node = NULL;
+  retval->blocks = NULL;
+  retval->free_nodes = NULL;
 
   retval->root = (GtkRBNode *) &nil;
 
@@ -347,7 +377,7 @@ _gtk_rbtree_free_helper (GtkRBTree  *tree,
   if (node->children)
     _gtk_rbtree_free (node->children);
 
-  _gtk_rbnode_free (node);
+  _gtk_rbnode_free (tree, node);
 }
 
 void
@@ -362,6 +392,7 @@ _gtk_rbtree_free (GtkRBTree *tree)
   if (tree->parent_node &&
       tree->parent_node->children == tree)
     tree->parent_node->children = NULL;
+  g_slist_free_full (tree->blocks, g_free);
   g_free (tree);
 }
 
@@ -422,6 +453,113 @@ _gtk_rbtree_remove (GtkRBTree *tree)
 }
 
 
+static GtkRBNode *
+_gtk_rbtree_build_balanced (GtkRBNode *nodes,
+                            guint      n_nodes,
+                            guint      depth,
+                            guint      red_depth,
+                            gint       height,
+                            guint      flags)
+{
+  GtkRBNode *node;
+  guint mid;
+
+  if (n_nodes == 0)
+    return (GtkRBNode *) &nil;
+
+  mid = n_nodes / 2;
+  node = &nodes[mid];
+
+  node->left = _gtk_rbtree_build_balanced (nodes, mid,
+                                           depth + 1, red_depth, height, flags);
+  node->right = _gtk_rbtree_build_balanced (nodes + mid + 1, n_nodes - mid - 1,
+                                            depth + 1, red_depth, height, flags);
+  if (!_gtk_rbtree_is_nil (node->left))
+    node->left->parent = node;
+  if (!_gtk_rbtree_is_nil (node->right))
+    node->right->parent = node;
+
+  node->flags = flags | (depth == red_depth ? GTK_RBNODE_RED : GTK_RBNODE_BLACK);
+  node->count = n_nodes;
+  node->total_count = n_nodes;
+  node->offset = n_nodes * height;
+  node->children = NULL;
+
+  return node;
+}
+
+/**
+ * _gtk_rbtree_insert_n:
+ * @tree: an empty tree
+ * @n_nodes: the number of nodes to insert
+ * @height: the height of each node
+ * @valid: whether the nodes are valid
+ *
+ * Fills an empty @tree with @n_nodes nodes. This is a lot faster than
+ * inserting them one by one: the nodes are allocated in one array and
+ * linked into a balanced tree without any rotations, and walking them
+ * in order touches consecutive memory.
+ *
+ * Returns: the first node of @tree, or %NULL if @n_nodes is 0
+ */
+GtkRBNode *
+_gtk_rbtree_insert_n (GtkRBTree *tree,
+                      guint      n_nodes,
+                      gint       height,
+                      gboolean   valid)
+{
+  GtkRBNode *nodes, *node;
+  GtkRBTree *parent_tree;
+  guint flags;
+
+  g_return_val_if_fail (_gtk_rbtree_is_nil (tree->root), NULL);
+
+  if (n_nodes == 0)
+    return NULL;
+
+  nodes = g_new (GtkRBNode, n_nodes);
+  tree->blocks = g_slist_prepend (tree->blocks, nodes);
+
+  flags = GTK_RBNODE_IN_BLOCK;
+  if (!valid)
+    flags |= GTK_RBNODE_INVALID | GTK_RBNODE_DESCENDANTS_INVALID;
+
+  /* All levels but the deepest one are full, so making all nodes on
+   * the deepest level red and all others black gives every path the
+   * same number of black nodes.
+   */
+  tree->root = _gtk_rbtree_build_balanced (nodes, n_nodes,
+                                           0, g_bit_storage (n_nodes + 1) - 1,
+                                           height, flags);
+  tree->root->parent = (GtkRBNode *) &nil;
+
+  gtk_rbnode_adjust (tree->parent_tree, tree->parent_node,
+                     0, n_nodes, n_nodes * height);
+
+  if (!valid)
+    {
+      parent_tree = tree->parent_tree;
+      node = tree->parent_node;
+      while (node && !GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_DESCENDANTS_INVALID))
+        {
+          GTK_RBNODE_SET_FLAG (node, GTK_RBNODE_DESCENDANTS_INVALID);
+          node = node->parent;
+          if (_gtk_rbtree_is_nil (node))
+            {
+              node = parent_tree->parent_node;
+              parent_tree = parent_tree->parent_tree;
+            }
+        }
+    }
+
+#ifdef G_ENABLE_DEBUG
+  if (GTK_DEBUG_CHECK (TREE))
+    _gtk_rbtree_test (G_STRLOC, tree);
+#endif
+
+  return &nodes[0];
+}
+
 GtkRBNode *
 _gtk_rbtree_insert_after (GtkRBTree *tree,
 			  GtkRBNode *current,
@@ -1246,7 +1384,7 @@ _gtk_rbtree_remove_node (GtkRBTree *tree,
                          y_height - node_height);
     }
 
-  _gtk_rbnode_free (node);
+  _gtk_rbnode_free (tree, node);
 
 #ifdef G_ENABLE_DEBUG
   if (GTK_DEBUG_CHECK (TREE))
@@ -36,12 +36,14 @@ typedef enum
   GTK_RBNODE_INVALID = 1 << 7,
   GTK_RBNODE_COLUMN_INVALID = 1 << 8,
   GTK_RBNODE_DESCENDANTS_INVALID = 1 << 9,
+  GTK_RBNODE_IN_BLOCK = 1 << 10,
   GTK_RBNODE_NON_COLORS = GTK_RBNODE_IS_PARENT |
   			  GTK_RBNODE_IS_SELECTED |
   			  GTK_RBNODE_IS_PRELIT |
                           GTK_RBNODE_INVALID |
                           GTK_RBNODE_COLUMN_INVALID |
-                          GTK_RBNODE_DESCENDANTS_INVALID
+                          GTK_RBNODE_DESCENDANTS_INVALID |
+                          GTK_RBNODE_IN_BLOCK
 } GtkRBNodeColor;
 
 typedef struct _GtkRBTree GtkRBTree;
@@ -57,6 +59,11 @@ struct _GtkRBTree
   GtkRBNode *root;
   GtkRBTree *parent_tree;
   GtkRBNode *parent_node;
+
+  /* Arrays of nodes allocated by _gtk_rbtree_insert_n() */
+  GSList *blocks;
+  /* Removed nodes of those arrays, linked by their parent pointer */
+  GtkRBNode *free_nodes;
 };
 
 struct _GtkRBNode
@@ -110,6 +117,10 @@ GtkRBNode *_gtk_rbtree_insert_after     (GtkRBTree              *tree,
 					 GtkRBNode              *node,
 					 gint                    height,
 					 gboolean                valid);
+GtkRBNode *_gtk_rbtree_insert_n         (GtkRBTree              *tree,
+                                         guint                   n_nodes,
+                                         gint                    height,
+                                         gboolean                valid);
 void       _gtk_rbtree_remove_node      (GtkRBTree              *tree,
 					 GtkRBNode              *node);
 gboolean   _gtk_rbtree_is_nil           (GtkRBNode              *node);
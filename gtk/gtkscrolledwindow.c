@@ -838,6 +838,22 @@ policy_may_be_visible (GtkPolicyType policy)
   return policy == GTK_POLICY_ALWAYS || policy == GTK_POLICY_AUTOMATIC;
 }
 
+/* Unless the size of the child is used for the scrolled window's own
+ * size request, resizes of the child only need the scrolled window's
+ * contents to be allocated again.
+ */
+static void
+gtk_scrolled_window_update_layout_boundary (GtkScrolledWindow *scrolled_window)
+{
+  GtkScrolledWindowPrivate *priv = scrolled_window->priv;
+
+  gtk_widget_set_layout_boundary (GTK_WIDGET (scrolled_window),
+                                  priv->hscrollbar_policy != GTK_POLICY_NEVER &&
+                                  priv->vscrollbar_policy != GTK_POLICY_NEVER &&
+                                  !priv->propagate_natural_width &&
+                                  !priv->propagate_natural_height);
+}
+
 static void
 scrolled_window_drag_begin_cb (GtkScrolledWindow *scrolled_window,
                                gdouble            start_x,
@@ -1933,6 +1949,8 @@ gtk_scrolled_window_init (GtkScrolledWindow *scrolled_window)
   priv->max_content_width = -1;
   priv->max_content_height = -1;
 
+  gtk_scrolled_window_update_layout_boundary (scrolled_window);
+
   priv->overlay_scrolling = TRUE;
 
   priv->drag_gesture = gtk_gesture_drag_new (widget);
@@ -2302,6 +2320,7 @@ gtk_scrolled_window_set_policy (GtkScrolledWindow *scrolled_window,
       priv->hscrollbar_policy = hscrollbar_policy;
       priv->vscrollbar_policy = vscrollbar_policy;
 
+      gtk_scrolled_window_update_layout_boundary (scrolled_window);
       gtk_widget_queue_resize (GTK_WIDGET (scrolled_window));
 
       g_object_notify_by_pspec (object, properties[PROP_HSCROLLBAR_POLICY]);
@@ -4205,6 +4224,7 @@ gtk_scrolled_window_set_propagate_natural_width (GtkScrolledWindow *scrolled_win
     {
       priv->propagate_natural_width = propagate;
       g_object_notify_by_pspec (G_OBJECT (scrolled_window), properties [PROP_PROPAGATE_NATURAL_WIDTH]);
+      gtk_scrolled_window_update_layout_boundary (scrolled_window);
       gtk_widget_queue_resize (GTK_WIDGET (scrolled_window));
     }
 }
@@ -4250,6 +4270,7 @@ gtk_scrolled_window_set_propagate_natural_height (GtkScrolledWindow *scrolled_wi
     {
       priv->propagate_natural_height = propagate;
       g_object_notify_by_pspec (G_OBJECT (scrolled_window), properties [PROP_PROPAGATE_NATURAL_HEIGHT]);
+      gtk_scrolled_window_update_layout_boundary (scrolled_window);
       gtk_widget_queue_resize (GTK_WIDGET (scrolled_window));
     }
 }
@@ -70,6 +70,17 @@ pop_recursion_check (GtkWidget       *widget,
 #define pop_recursion_check(widget, orientation)
 #endif /* G_ENABLE_CONSISTENCY_CHECKS */
 
+/* The for_size measurement currently running, see
+ * gtk_widget_set_measure_valid_from().
+ */
+typedef struct {
+  GtkWidget *widget;
+  int        for_size;
+  int        valid_from;
+} MeasureRange;
+
+static MeasureRange *current_measure = NULL;
+
 static gint
 get_number (GtkCssStyle *style,
             guint        property)
@@ -134,6 +145,7 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
   int css_min_for_size;
   int css_extra_for_size;
   int css_extra_size;
+  int lower_for_size;
 
   gtk_widget_ensure_resize (widget);
 
@@ -177,6 +189,8 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
           css_min_for_size = get_number (style, GTK_CSS_PROPERTY_MIN_WIDTH);
         }
 
+      lower_for_size = for_size;
+
       if (for_size < 0)
         {
           push_recursion_check (widget, orientation);
@@ -187,10 +201,12 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
         }
       else
         {
+          int outer_for_size;
           int adjusted_for_size;
           int minimum_for_size = 0;
           int natural_for_size = 0;
           int dummy = 0;
+          MeasureRange range, *outer_range;
 
           /* Pull the minimum for_size from the cache as it's needed to adjust
            * the proposed 'for_size' */
@@ -201,6 +217,8 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
           if (for_size < MAX (minimum_for_size, css_min_for_size))
             for_size = MAX (minimum_for_size, css_min_for_size);
 
+          /* for_size loses the margins below */
+          outer_for_size = for_size;
           adjusted_for_size = for_size;
           gtk_widget_adjust_size_allocation (widget, OPPOSITE_ORIENTATION (orientation),
                                              &for_size, &natural_for_size,
@@ -208,6 +226,12 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
 
           adjusted_for_size -= css_extra_for_size;
 
+          range.widget = widget;
+          range.for_size = adjusted_for_size;
+          range.valid_from = adjusted_for_size;
+          outer_range = current_measure;
+          current_measure = &range;
+
           push_recursion_check (widget, orientation);
           widget_class->measure (widget,
                                  orientation,
@@ -216,6 +240,14 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
                                  &min_baseline, &nat_baseline);
           pop_recursion_check (widget, orientation);
 
+          current_measure = outer_range;
+
+          /* Margins, alignment and CSS never shrink the for_size by more
+           * than they shrink the size given to measure(), so the range
+           * reported by the widget carries over to our own for_size.
+           */
+          lower_for_size = outer_for_size - (adjusted_for_size - range.valid_from);
+          for_size = outer_for_size;
         }
 
       min_size = MAX (0, MAX (reported_min_size, css_min_size)) + css_extra_size;
@@ -329,6 +361,7 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
 
       _gtk_size_request_cache_commit (cache,
                                       orientation,
+                                      lower_for_size,
                                       for_size,
                                       min_size,
                                       nat_size,
@@ -372,6 +405,26 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
 	    });
 }
 
+/*
+ * gtk_widget_set_measure_valid_from:
+ * @widget: a #GtkWidget
+ * @for_size: the smallest for_size the current result holds for
+ *
+ * Called from a #GtkWidgetClass.measure() implementation that knows its
+ * result does not change for smaller values of for_size down to @for_size,
+ * such as a wrapping label whose lines still fit. The size request cache
+ * then reuses the result for those sizes instead of measuring again.
+ */
+void
+gtk_widget_set_measure_valid_from (GtkWidget *widget,
+                                   int        for_size)
+{
+  if (current_measure == NULL || current_measure->widget != widget)
+    return;
+
+  current_measure->valid_from = CLAMP (for_size, 0, current_measure->for_size);
+}
+
 /**
  * gtk_widget_measure:
  * @widget: A #GtkWidget instance
@@ -69,9 +69,14 @@ _gtk_size_request_cache_clear (SizeRequestCache *cache)
   _gtk_size_request_cache_init (cache);
 }
 
+/* Stores the result of a measurement at @for_size. The result
+ * is known to also hold for all sizes from @lower_for_size up
+ * to @for_size, so later lookups in that range hit the cache.
+ */
 void
 _gtk_size_request_cache_commit (SizeRequestCache *cache,
                                 GtkOrientation    orientation,
+                                gint              lower_for_size,
                                 gint              for_size,
                                 gint              minimum_size,
                                 gint              natural_size,
@@ -124,7 +129,7 @@ _gtk_size_request_cache_commit (SizeRequestCache *cache,
 	  if (cached_sizes[i]->cached_size.minimum_size == minimum_size &&
 	      cached_sizes[i]->cached_size.natural_size == natural_size)
 	    {
-	      cached_sizes[i]->lower_for_size = MIN (cached_sizes[i]->lower_for_size, for_size);
+	      cached_sizes[i]->lower_for_size = MIN (cached_sizes[i]->lower_for_size, lower_for_size);
 	      cached_sizes[i]->upper_for_size = MAX (cached_sizes[i]->upper_for_size, for_size);
 	      return;
 	    }
@@ -151,7 +156,7 @@ _gtk_size_request_cache_commit (SizeRequestCache *cache,
 	cache->requests_x[cache->flags[orientation].last_cached_request] = g_slice_new (SizeRequestX);
 
       cached_size = cache->requests_x[cache->flags[orientation].last_cached_request];
-      cached_size->lower_for_size = for_size;
+      cached_size->lower_for_size = lower_for_size;
       cached_size->upper_for_size = for_size;
       cached_size->cached_size.minimum_size = minimum_size;
       cached_size->cached_size.natural_size = natural_size;
@@ -169,7 +174,7 @@ _gtk_size_request_cache_commit (SizeRequestCache *cache,
 	      cached_sizes[i]->cached_size.minimum_baseline == minimum_baseline &&
 	      cached_sizes[i]->cached_size.natural_baseline == natural_baseline)
 	    {
-	      cached_sizes[i]->lower_for_size = MIN (cached_sizes[i]->lower_for_size, for_size);
+	      cached_sizes[i]->lower_for_size = MIN (cached_sizes[i]->lower_for_size, lower_for_size);
 	      cached_sizes[i]->upper_for_size = MAX (cached_sizes[i]->upper_for_size, for_size);
 	      return;
 	    }
@@ -196,7 +201,7 @@ _gtk_size_request_cache_commit (SizeRequestCache *cache,
 	cache->requests_y[cache->flags[orientation].last_cached_request] = g_slice_new (SizeRequestY);
 
       cached_size = cache->requests_y[cache->flags[orientation].last_cached_request];
-      cached_size->lower_for_size = for_size;
+      cached_size->lower_for_size = lower_for_size;
       cached_size->upper_for_size = for_size;
       cached_size->cached_size.minimum_size = minimum_size;
       cached_size->cached_size.natural_size = natural_size;
@@ -35,8 +35,12 @@ G_BEGIN_DECLS
  * for a said widget to have, if a label can
  * only wrap to 3 lines, only 3 caches will
  * ever be allocated for it.
+ *
+ * The cache survives reallocations, so it is
+ * large enough to keep the results a widget
+ * sees while its toplevel is being resized.
  */
-#define GTK_SIZE_REQUEST_CACHED_SIZES   (5)
+#define GTK_SIZE_REQUEST_CACHED_SIZES   (16)
 
 typedef struct {
   gint minimum_size;
@@ -74,8 +78,8 @@ typedef struct {
   GtkSizeRequestMode request_mode   : 3;
   guint       request_mode_valid    : 1;
   struct {
-    guint       n_cached_requests   : 3;
-    guint       last_cached_request : 3;
+    guint       n_cached_requests   : 5;
+    guint       last_cached_request : 5;
     guint       cached_size_valid   : 1;
   }           flags[2];
 } SizeRequestCache;
@@ -86,6 +90,7 @@ void            _gtk_size_request_cache_free                    (SizeRequestCach
 void            _gtk_size_request_cache_clear                   (SizeRequestCache       *cache);
 void            _gtk_size_request_cache_commit                  (SizeRequestCache       *cache,
                                                                  GtkOrientation          orientation,
+                                                                 gint                    lower_for_size,
                                                                  gint                    for_size,
                                                                  gint                    minimum_size,
                                                                  gint                    natural_size,
@@ -1031,8 +1031,17 @@ gtk_snapshot_push_cross_fade (GtkSnapshot *snapshot,
                            gtk_snapshot_collect_cross_fade_start);
 }
 
-static GskRenderNode *
-gtk_snapshot_pop_internal (GtkSnapshot *snapshot)
+/*
+ * gtk_snapshot_pop_collect:
+ * @snapshot: a #GtkSnapshot
+ *
+ * Like gtk_snapshot_pop(), but instead of appending the resulting
+ * node to the parent state, returns it to the caller.
+ *
+ * Returns: (nullable) (transfer full): the node that was collected
+ */
+GskRenderNode *
+gtk_snapshot_pop_collect (GtkSnapshot *snapshot)
 {
   GtkSnapshotState *state;
   guint state_index;
@@ -1086,7 +1095,7 @@ gtk_snapshot_finish (GtkSnapshot *snapshot)
         }
     }
   
-  result = gtk_snapshot_pop_internal (snapshot);
+  result = gtk_snapshot_pop_collect (snapshot);
 
   g_array_free (snapshot->state_stack, TRUE);
   g_ptr_array_free (snapshot->nodes, TRUE);
@@ -1105,7 +1114,7 @@ gtk_snapshot_pop (GtkSnapshot *snapshot)
 {
   GskRenderNode *node;
 
-  node = gtk_snapshot_pop_internal (snapshot);
+  node = gtk_snapshot_pop_collect (snapshot);
   if (node)
     {
       gtk_snapshot_append_node (snapshot, node);
@@ -1403,6 +1412,34 @@ gtk_snapshot_clips_rect (GtkSnapshot                 *snapshot,
   return cairo_region_contains_rectangle (current_state->clip_region, &offset_rect) == CAIRO_REGION_OVERLAP_OUT;
 }
 
+/*
+ * gtk_snapshot_contains_rect:
+ * @snapshot: a #GtkSnapshot
+ * @rect: a rectangle
+ *
+ * Tests whether the rectangle is entirely inside the clip region of @snapshot,
+ * so that nothing drawn inside it would be culled.
+ *
+ * Returns: %TRUE if @rect is entirely inside the clip region
+ */
+gboolean
+gtk_snapshot_contains_rect (GtkSnapshot                 *snapshot,
+                            const cairo_rectangle_int_t *rect)
+{
+  const GtkSnapshotState *current_state = gtk_snapshot_get_current_state (snapshot);
+  cairo_rectangle_int_t offset_rect;
+
+  if (current_state->clip_region == NULL)
+    return TRUE;
+
+  offset_rect.x = rect->x + current_state->translate_x;
+  offset_rect.y = rect->y + current_state->translate_y;
+  offset_rect.width = rect->width;
+  offset_rect.height = rect->height;
+
+  return cairo_region_contains_rectangle (current_state->clip_region, &offset_rect) == CAIRO_REGION_OVERLAP_IN;
+}
+
 /**
  * gtk_snapshot_render_background:
  * @snapshot: a #GtkSnapshot
@@ -94,8 +94,11 @@ void            gtk_snapshot_init               (GtkSnapshot             *state,
                                                  const char              *name,
                                                  ...) G_GNUC_PRINTF (5, 6);
 GskRenderNode * gtk_snapshot_finish             (GtkSnapshot             *state);
+GskRenderNode * gtk_snapshot_pop_collect        (GtkSnapshot             *snapshot);
 
 GskRenderer *   gtk_snapshot_get_renderer       (const GtkSnapshot       *snapshot);
+gboolean        gtk_snapshot_contains_rect      (GtkSnapshot             *snapshot,
+                                                 const cairo_rectangle_int_t *rect);
 
 G_END_DECLS
 
@@ -295,14 +295,14 @@ _gtk_style_cascade_set_parent (GtkStyleCascade *cascade,
       g_object_ref (parent);
       g_signal_connect_swapped (parent,
                                 "-gtk-private-changed",
-                                G_CALLBACK (gtk_style_provider_changed),
+                                G_CALLBACK (gtk_style_provider_changed_selectors),
                                 cascade);
     }
 
   if (cascade->parent)
     {
       g_signal_handlers_disconnect_by_func (cascade->parent, 
-                                            gtk_style_provider_changed,
+                                            gtk_style_provider_changed_selectors,
                                             cascade);
       g_object_unref (cascade->parent);
     }
@@ -326,7 +326,7 @@ _gtk_style_cascade_add_provider (GtkStyleCascade  *cascade,
   data.priority = priority;
   data.changed_signal_id = g_signal_connect_swapped (provider,
                                                      "-gtk-private-changed",
-                                                     G_CALLBACK (gtk_style_provider_changed),
+                                                     G_CALLBACK (gtk_style_provider_changed_selectors),
                                                      cascade);
 
   /* ensure it gets removed first */
@@ -249,10 +249,11 @@ gtk_style_context_pop_style_node (GtkStyleContext *context)
 }
 
 static void
-gtk_style_context_cascade_changed (GtkStyleCascade *cascade,
-                                   GtkStyleContext *context)
+gtk_style_context_cascade_changed (GtkStyleCascade          *cascade,
+                                   const GtkCssSelectorKeys *keys,
+                                   GtkStyleContext          *context)
 {
-  gtk_css_node_invalidate_style_provider (gtk_style_context_get_root (context));
+  gtk_css_node_invalidate_style_provider_selectors (gtk_style_context_get_root (context), keys);
 }
 
 static void
@@ -283,7 +284,7 @@ gtk_style_context_set_cascade (GtkStyleContext *context,
   priv->cascade = cascade;
 
   if (cascade && priv->cssnode != NULL)
-    gtk_style_context_cascade_changed (cascade, context);
+    gtk_style_context_cascade_changed (cascade, NULL, context);
 }
 
 static void
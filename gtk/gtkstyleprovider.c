@@ -50,8 +50,8 @@ gtk_style_provider_default_init (GtkStyleProviderInterface *iface)
                                    G_SIGNAL_RUN_LAST,
                                    G_STRUCT_OFFSET (GtkStyleProviderInterface, changed),
                                    NULL, NULL,
-                                   g_cclosure_marshal_VOID__VOID,
-                                   G_TYPE_NONE, 0);
+                                   g_cclosure_marshal_VOID__POINTER,
+                                   G_TYPE_NONE, 1, G_TYPE_POINTER);
 
 }
 
@@ -120,7 +120,20 @@ gtk_style_provider_changed (GtkStyleProvider *provider)
 {
   gtk_internal_return_if_fail (GTK_IS_STYLE_PROVIDER (provider));
 
-  g_signal_emit (provider, signals[CHANGED], 0);
+  g_signal_emit (provider, signals[CHANGED], 0, NULL);
+}
+
+/* Like gtk_style_provider_changed(), but only nodes matching one of
+ * @keys can have changed their style. Passing %NULL for @keys means
+ * every node is affected.
+ */
+void
+gtk_style_provider_changed_selectors (GtkStyleProvider         *provider,
+                                      const GtkCssSelectorKeys *keys)
+{
+  gtk_internal_return_if_fail (GTK_IS_STYLE_PROVIDER (provider));
+
+  g_signal_emit (provider, signals[CHANGED], 0, keys);
 }
 
 GtkSettings *
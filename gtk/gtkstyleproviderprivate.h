@@ -22,6 +22,7 @@
 #include "gtk/gtkcsskeyframesprivate.h"
 #include "gtk/gtkcsslookupprivate.h"
 #include "gtk/gtkcssmatcherprivate.h"
+#include "gtk/gtkcssselectorprivate.h"
 #include "gtk/gtkcssvalueprivate.h"
 #include <gtk/gtktypes.h>
 
@@ -49,7 +50,8 @@ struct _GtkStyleProviderInterface
                                                  GtkCssSection           *section,
                                                  const GError            *error);
   /* signal */
-  void                  (* changed)             (GtkStyleProvider *provider);
+  void                  (* changed)             (GtkStyleProvider *provider,
+                                                 const GtkCssSelectorKeys *keys);
 };
 
 GtkSettings *           gtk_style_provider_get_settings          (GtkStyleProvider *provider);
@@ -64,6 +66,8 @@ void                    gtk_style_provider_lookup                (GtkStyleProvid
                                                                   GtkCssChange            *out_change);
 
 void                    gtk_style_provider_changed               (GtkStyleProvider *provider);
+void                    gtk_style_provider_changed_selectors     (GtkStyleProvider *provider,
+                                                                  const GtkCssSelectorKeys *keys);
 
 void                    gtk_style_provider_emit_error            (GtkStyleProvider *provider,
                                                                   GtkCssSection           *section,
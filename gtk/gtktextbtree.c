@@ -114,6 +114,19 @@ struct _NodeData {
 };
 
 
+/*
+ * A set of tags, indexed by GtkTextTagInfo::bit. Every node keeps one
+ * with the tags that have a Summary in that node, so looking for a tag
+ * does not need to walk the summary list.
+ */
+
+#define TAG_BITS_PER_WORD (sizeof (guint) * 8)
+
+typedef struct {
+  guint *words;
+  guint n_words;
+} TagBits;
+
 /*
  * The data structure below keeps summary information about one tag as part
  * of the tag information in a node.
@@ -141,6 +154,7 @@ struct _GtkTextBTreeNode {
   Summary *summary;             /* First in malloc-ed list of info
                                  * about tags in this subtree (NULL if
                                  * no tag info in the subtree). */
+  TagBits tag_bits;             /* The tags that have a summary above */
   int level;                            /* Level of this node in the B-tree.
                                          * 0 refers to the bottom of the tree
                                          * (children are lines, not nodes). */
@@ -184,6 +198,8 @@ struct _GtkTextBTree {
   GtkTextBuffer *buffer;
   BTreeView *views;
   GSList *tag_infos;
+  GHashTable *tag_info_table;   /* GtkTextTag -> GtkTextTagInfo */
+  TagBits used_tag_bits;        /* GtkTextTagInfo::bit of tag_infos */
   gulong tag_changed_handler;
 
   /* Incremented when a segment with a byte size > 0
@@ -261,7 +277,7 @@ static void              gtk_text_btree_node_adjust_toggle_count (GtkTextBTreeNo
                                                                   GtkTextTagInfo   *info,
                                                                   gint              adjust);
 static gboolean          gtk_text_btree_node_has_tag             (GtkTextBTreeNode *node,
-                                                                  GtkTextTag       *tag);
+                                                                  GtkTextTagInfo   *info);
 
 static void             segments_changed                (GtkTextBTree     *tree);
 static void             chars_changed                   (GtkTextBTree     *tree);
@@ -323,7 +339,11 @@ static void inc_count             (GtkTextTag       *tag,
                                    int               inc,
                                    TagInfo          *tagInfoPtr);
 
-static void summary_destroy       (Summary          *summary);
+static Summary *summary_new       (GtkTextBTreeNode *node,
+                                   GtkTextTagInfo   *info,
+                                   gint              toggle_count);
+static void summary_destroy       (GtkTextBTreeNode *node,
+                                   Summary          *summary);
 
 static void gtk_text_btree_link_segment   (GtkTextLineSegment *seg,
                                            const GtkTextIter  *iter);
@@ -358,6 +378,61 @@ chars_changed (GtkTextBTree *tree)
   tree->chars_changed_stamp += 1;
 }
 
+static inline gboolean
+tag_bits_get (const TagBits *bits,
+              guint          bit)
+{
+  guint word = bit / TAG_BITS_PER_WORD;
+
+  return word < bits->n_words &&
+         (bits->words[word] & (1u << (bit % TAG_BITS_PER_WORD))) != 0;
+}
+
+static void
+tag_bits_set (TagBits *bits,
+              guint    bit)
+{
+  guint word = bit / TAG_BITS_PER_WORD;
+
+  if (word >= bits->n_words)
+    {
+      bits->words = g_renew (guint, bits->words, word + 1);
+      memset (bits->words + bits->n_words, 0, (word + 1 - bits->n_words) * sizeof (guint));
+      bits->n_words = word + 1;
+    }
+
+  bits->words[word] |= 1u << (bit % TAG_BITS_PER_WORD);
+}
+
+static void
+tag_bits_clear (TagBits *bits,
+                guint    bit)
+{
+  guint word = bit / TAG_BITS_PER_WORD;
+
+  if (word < bits->n_words)
+    bits->words[word] &= ~(1u << (bit % TAG_BITS_PER_WORD));
+}
+
+static guint
+tag_bits_first_unset (const TagBits *bits)
+{
+  guint word, bit;
+
+  for (word = 0; word < bits->n_words; word++)
+    {
+      if (bits->words[word] == G_MAXUINT)
+        continue;
+
+      for (bit = 0; bits->words[word] & (1u << bit); bit++)
+        ;
+
+      return word * TAG_BITS_PER_WORD + bit;
+    }
+
+  return bits->n_words * TAG_BITS_PER_WORD;
+}
+
 /*
  * BTree operations
  */
@@ -437,6 +512,8 @@ _gtk_text_btree_new (GtkTextTagTable *table,
 
   tree->mark_table = g_hash_table_new (g_str_hash, g_str_equal);
   tree->child_anchor_table = NULL;
+
+  tree->tag_info_table = g_hash_table_new (NULL, NULL);
   
   /* We don't ref the buffer, since the buffer owns us;
    * we'd have some circularity issues. The buffer always
@@ -525,6 +602,9 @@ _gtk_text_btree_unref (GtkTextBTree *tree)
       g_object_unref (tree->selection_bound_mark);
       tree->selection_bound_mark = NULL;
 
+      g_hash_table_destroy (tree->tag_info_table);
+      g_free (tree->used_tag_bits.words);
+
       g_slice_free (GtkTextBTree, tree);
     }
 }
@@ -1762,61 +1842,46 @@ queue_tag_redisplay (GtkTextBTree      *tree,
   /* We don't need to do anything if the tag doesn't affect display */
 }
 
-void
-_gtk_text_btree_tag (const GtkTextIter *start_orig,
-                     const GtkTextIter *end_orig,
-                     GtkTextTag        *tag,
-                     gboolean           add)
+/* Changes the toggles of @info in the ordered range [start, end).
+ * Lines are cleaned up once we are done with them, except for the
+ * last one, which is left in *cleanupline for the caller; a following
+ * range in the same line can then share the cleanup.
+ */
+static void
+gtk_text_btree_tag_range (GtkTextBTree      *tree,
+                          GtkTextTagInfo    *info,
+                          const GtkTextIter *start,
+                          const GtkTextIter *end,
+                          gboolean           add,
+                          GtkTextLine      **cleanupline)
 {
   GtkTextLineSegment *seg, *prev;
-  GtkTextLine *cleanupline;
+  GtkTextTag *tag = info->tag;
   gboolean toggled_on;
   GtkTextLine *start_line;
   GtkTextLine *end_line;
   GtkTextIter iter;
-  GtkTextIter start, end;
-  GtkTextBTree *tree;
   IterStack *stack;
-  GtkTextTagInfo *info;
-
-  g_return_if_fail (start_orig != NULL);
-  g_return_if_fail (end_orig != NULL);
-  g_return_if_fail (GTK_IS_TEXT_TAG (tag));
-  g_return_if_fail (_gtk_text_iter_get_btree (start_orig) ==
-                    _gtk_text_iter_get_btree (end_orig));
-  g_return_if_fail (tag->priv->table == _gtk_text_iter_get_btree (start_orig)->table);
-  
-#if 0
-  printf ("%s tag %s from %d to %d\n",
-          add ? "Adding" : "Removing",
-          tag->name,
-          gtk_text_buffer_get_offset (start_orig),
-          gtk_text_buffer_get_offset (end_orig));
-#endif
-
-  if (gtk_text_iter_equal (start_orig, end_orig))
-    return;
-
-  start = *start_orig;
-  end = *end_orig;
-
-  gtk_text_iter_order (&start, &end);
 
-  tree = _gtk_text_iter_get_btree (&start);
-
-  queue_tag_redisplay (tree, tag, &start, &end);
-
-  info = gtk_text_btree_get_tag_info (tree, tag);
+  start_line = _gtk_text_iter_get_text_line (start);
+  end_line = _gtk_text_iter_get_text_line (end);
 
-  start_line = _gtk_text_iter_get_text_line (&start);
-  end_line = _gtk_text_iter_get_text_line (&end);
+  /* The toggles of earlier lines must be in the node counts before
+   * looking at the tag state at the start.
+   */
+  if (*cleanupline != start_line)
+    {
+      if (*cleanupline != NULL)
+        cleanup_line (*cleanupline);
+      *cleanupline = start_line;
+    }
 
   /* Find all tag toggles in the region; we are going to delete them.
      We need to find them in advance, because
      forward_find_tag_toggle () won't work once we start playing around
      with the tree. */
   stack = iter_stack_new ();
-  iter = start;
+  iter = *start;
 
   /* forward_to_tag_toggle() skips a toggle at the start iterator,
    * which is deliberate - we don't want to delete a toggle at the
@@ -1824,7 +1889,7 @@ _gtk_text_btree_tag (const GtkTextIter *start_orig,
    */
   while (gtk_text_iter_forward_to_tag_toggle (&iter, tag))
     {
-      if (gtk_text_iter_compare (&iter, &end) >= 0)
+      if (gtk_text_iter_compare (&iter, end) >= 0)
         break;
       else
         iter_stack_push (stack, &iter);
@@ -1839,7 +1904,7 @@ _gtk_text_btree_tag (const GtkTextIter *start_orig,
    * there.
    */
 
-  toggled_on = gtk_text_iter_has_tag (&start, tag);
+  toggled_on = gtk_text_iter_has_tag (start, tag);
   if ( (add && !toggled_on) ||
        (!add && toggled_on) )
     {
@@ -1847,7 +1912,7 @@ _gtk_text_btree_tag (const GtkTextIter *start_orig,
          cleanup_line () will remove it if so. */
       seg = _gtk_toggle_segment_new (info, add);
 
-      prev = gtk_text_line_segment_split (&start);
+      prev = gtk_text_line_segment_split (start);
       if (prev == NULL)
         {
           seg->next = start_line->segments;
@@ -1877,7 +1942,6 @@ _gtk_text_btree_tag (const GtkTextIter *start_orig,
    *
    */
 
-  cleanupline = start_line;
   while (iter_stack_pop (stack, &iter))
     {
       GtkTextLineSegment *indexable_seg;
@@ -1962,10 +2026,10 @@ _gtk_text_btree_tag (const GtkTextIter *start_orig,
       /* We only clean up lines when we're done with them, saves some
          gratuitous line-segment-traversals */
 
-      if (cleanupline != line)
+      if (*cleanupline != line)
         {
-          cleanup_line (cleanupline);
-          cleanupline = line;
+          cleanup_line (*cleanupline);
+          *cleanupline = line;
         }
     }
 
@@ -1982,7 +2046,7 @@ _gtk_text_btree_tag (const GtkTextIter *start_orig,
 
       seg = _gtk_toggle_segment_new (info, !add);
 
-      prev = gtk_text_line_segment_split (&end);
+      prev = gtk_text_line_segment_split (end);
       if (prev == NULL)
         {
           seg->next = end_line->segments;
@@ -2001,15 +2065,60 @@ _gtk_text_btree_tag (const GtkTextIter *start_orig,
     }
 
   /*
-   * Cleanup cleanupline and the last line of the range, if
-   * these are different.
+   * Cleanup cleanupline if it is not the last line of the range,
+   * which is left to the caller.
    */
 
-  cleanup_line (cleanupline);
-  if (cleanupline != end_line)
+  if (*cleanupline != end_line)
     {
-      cleanup_line (end_line);
+      cleanup_line (*cleanupline);
+      *cleanupline = end_line;
     }
+}
+
+void
+_gtk_text_btree_tag (const GtkTextIter *start_orig,
+                     const GtkTextIter *end_orig,
+                     GtkTextTag        *tag,
+                     gboolean           add)
+{
+  GtkTextLine *cleanupline;
+  GtkTextIter start, end;
+  GtkTextBTree *tree;
+  GtkTextTagInfo *info;
+
+  g_return_if_fail (start_orig != NULL);
+  g_return_if_fail (end_orig != NULL);
+  g_return_if_fail (GTK_IS_TEXT_TAG (tag));
+  g_return_if_fail (_gtk_text_iter_get_btree (start_orig) ==
+                    _gtk_text_iter_get_btree (end_orig));
+  g_return_if_fail (tag->priv->table == _gtk_text_iter_get_btree (start_orig)->table);
+  
+#if 0
+  printf ("%s tag %s from %d to %d\n",
+          add ? "Adding" : "Removing",
+          tag->name,
+          gtk_text_buffer_get_offset (start_orig),
+          gtk_text_buffer_get_offset (end_orig));
+#endif
+
+  if (gtk_text_iter_equal (start_orig, end_orig))
+    return;
+
+  start = *start_orig;
+  end = *end_orig;
+
+  gtk_text_iter_order (&start, &end);
+
+  tree = _gtk_text_iter_get_btree (&start);
+
+  queue_tag_redisplay (tree, tag, &start, &end);
+
+  info = gtk_text_btree_get_tag_info (tree, tag);
+
+  cleanupline = NULL;
+  gtk_text_btree_tag_range (tree, info, &start, &end, add, &cleanupline);
+  cleanup_line (cleanupline);
 
   segments_changed (tree);
 
@@ -2021,6 +2130,61 @@ _gtk_text_btree_tag (const GtkTextIter *start_orig,
 #endif
 }
 
+/*
+ * Tags or untags n_ranges ranges at once. The ranges are given as pairs
+ * of iterators in @bounds; they must be ordered, non-empty, and must not
+ * overlap or touch each other.
+ *
+ * Compared to calling _gtk_text_btree_tag() for each range, the tag info
+ * is looked up once, a line holding several ranges is cleaned up once,
+ * and redisplay is queued once per line.
+ */
+void
+_gtk_text_btree_tag_ranges (GtkTextBTree      *tree,
+                            GtkTextTag        *tag,
+                            const GtkTextIter *bounds,
+                            guint              n_ranges,
+                            gboolean           add)
+{
+  GtkTextLine *cleanupline;
+  GtkTextTagInfo *info;
+  GtkTextIter start, end;
+  guint i;
+
+  g_return_if_fail (GTK_IS_TEXT_TAG (tag));
+  g_return_if_fail (tag->priv->table == tree->table);
+
+  if (n_ranges == 0)
+    return;
+
+  info = gtk_text_btree_get_tag_info (tree, tag);
+
+  cleanupline = NULL;
+  for (i = 0; i < n_ranges; i++)
+    gtk_text_btree_tag_range (tree, info, &bounds[2 * i], &bounds[2 * i + 1], add, &cleanupline);
+  cleanup_line (cleanupline);
+
+  segments_changed (tree);
+
+  start = bounds[0];
+  end = bounds[1];
+  for (i = 1; i < n_ranges; i++)
+    {
+      if (_gtk_text_iter_get_text_line (&bounds[2 * i]) != _gtk_text_iter_get_text_line (&end))
+        {
+          queue_tag_redisplay (tree, tag, &start, &end);
+          start = bounds[2 * i];
+        }
+      end = bounds[2 * i + 1];
+    }
+  queue_tag_redisplay (tree, tag, &start, &end);
+
+#ifdef G_ENABLE_DEBUG
+  if (GTK_DEBUG_CHECK (TEXT))
+    _gtk_text_btree_check (tree);
+#endif
+}
+
 
 /*
  * "Getters"
@@ -3084,7 +3248,7 @@ _gtk_text_btree_first_could_contain_tag (GtkTextBTree *tree,
           node = node->children.node;
           while (node != NULL)
             {
-              if (gtk_text_btree_node_has_tag (node, tag))
+              if (gtk_text_btree_node_has_tag (node, info))
                 goto continue_outer_loop;
 
               node = node->next;
@@ -3138,7 +3302,7 @@ _gtk_text_btree_last_could_contain_tag (GtkTextBTree *tree,
           node = node->children.node;
           while (node != NULL)
             {
-              if (gtk_text_btree_node_has_tag (node, tag))
+              if (gtk_text_btree_node_has_tag (node, info))
                 last_node = node;
               node = node->next;
             }
@@ -4414,7 +4578,7 @@ _gtk_text_line_next_could_contain_tag (GtkTextLine  *line,
             {
               node = node->next;
 
-              if (gtk_text_btree_node_has_tag (node, tag))
+              if (gtk_text_btree_node_has_tag (node, info))
                 goto found;
             }
         }
@@ -4460,7 +4624,7 @@ _gtk_text_line_next_could_contain_tag (GtkTextLine  *line,
       node = node->children.node;
       while (node != NULL)
         {
-          if (gtk_text_btree_node_has_tag (node, tag))
+          if (gtk_text_btree_node_has_tag (node, info))
             break;
           node = node->next;
         }
@@ -4597,7 +4761,7 @@ _gtk_text_line_previous_could_contain_tag (GtkTextLine  *line,
 
               g_assert (this_node != line_ancestor);
 
-              if (gtk_text_btree_node_has_tag (this_node, tag))
+              if (gtk_text_btree_node_has_tag (this_node, info))
                 {
                   found_node = this_node;
                   g_slist_free (child_nodes);
@@ -4672,7 +4836,7 @@ _gtk_text_line_previous_could_contain_tag (GtkTextLine  *line,
       iter = child_nodes;
       while (iter != NULL)
         {
-          if (gtk_text_btree_node_has_tag (iter->data, tag))
+          if (gtk_text_btree_node_has_tag (iter->data, info))
             {
               /* recurse into this node. */
               node = iter->data;
@@ -4870,9 +5034,31 @@ node_data_find (NodeData *nd,
   return nd;
 }
 
+static Summary *
+summary_new (GtkTextBTreeNode *node,
+             GtkTextTagInfo   *info,
+             gint              toggle_count)
+{
+  Summary *summary;
+
+  summary = g_slice_new (Summary);
+  summary->info = info;
+  summary->toggle_count = toggle_count;
+  summary->next = node->summary;
+  node->summary = summary;
+
+  tag_bits_set (&node->tag_bits, info->bit);
+
+  return summary;
+}
+
+/* The caller unlinks the summary from the node */
 static void
-summary_destroy (Summary *summary)
+summary_destroy (GtkTextBTreeNode *node,
+                 Summary          *summary)
 {
+  tag_bits_clear (&node->tag_bits, summary->info->bit);
+
   /* Fill with error-triggering garbage */
   summary->info = (void*)0x1;
   summary->toggle_count = 567;
@@ -4888,6 +5074,8 @@ gtk_text_btree_node_new (void)
   node = g_slice_new (GtkTextBTreeNode);
 
   node->node_data = NULL;
+  node->tag_bits.words = NULL;
+  node->tag_bits.n_words = 0;
 
   return node;
 }
@@ -4899,49 +5087,28 @@ gtk_text_btree_node_adjust_toggle_count (GtkTextBTreeNode  *node,
 {
   Summary *summary;
 
-  summary = node->summary;
-  while (summary != NULL)
-    {
-      if (summary->info == info)
-        {
-          summary->toggle_count += adjust;
-          break;
-        }
-
-      summary = summary->next;
-    }
-
-  if (summary == NULL)
+  if (!tag_bits_get (&node->tag_bits, info->bit))
     {
       /* didn't find a summary for our tag. */
       g_return_if_fail (adjust > 0);
-      summary = g_slice_new (Summary);
-      summary->info = info;
-      summary->toggle_count = adjust;
-      summary->next = node->summary;
-      node->summary = summary;
+      summary_new (node, info, adjust);
+      return;
     }
+
+  summary = node->summary;
+  while (summary->info != info)
+    summary = summary->next;
+
+  summary->toggle_count += adjust;
 }
 
 /* Note that the tag root and above do not have summaries
    for the tag; only nodes below the tag root have
    the summaries. */
 static gboolean
-gtk_text_btree_node_has_tag (GtkTextBTreeNode *node, GtkTextTag *tag)
+gtk_text_btree_node_has_tag (GtkTextBTreeNode *node, GtkTextTagInfo *info)
 {
-  Summary *summary;
-
-  summary = node->summary;
-  while (summary != NULL)
-    {
-      if (tag == NULL ||
-          summary->info->tag == tag)
-        return TRUE;
-
-      summary = summary->next;
-    }
-
-  return FALSE;
+  return tag_bits_get (&node->tag_bits, info->bit);
 }
 
 /* Add node and all children to the damage region. */
@@ -5454,6 +5621,110 @@ _gtk_text_btree_validate_line (GtkTextBTree     *tree,
     }
 }
 
+/**
+ * _gtk_text_btree_estimate_lines:
+ * @tree: a #GtkTextBTree
+ * @view_id: view ID for the view
+ * @first_line: number of the first line
+ * @n_lines: number of lines
+ * @widths: estimated widths of the lines
+ * @heights: estimated heights of the lines
+ * @y: location to store starting y coordinate of changed region
+ * @old_height: location to store old height of changed region
+ * @new_height: location to store new height of changed region
+ *
+ * Gives the lines that have no line data for the view yet an estimated
+ * size, so the size of the whole view is closer to its final value
+ * before these lines get validated. The lines stay invalid; lines that
+ * already have line data are not touched.
+ *
+ * Returns: %TRUE if the size of any line has been set
+ **/
+gboolean
+_gtk_text_btree_estimate_lines (GtkTextBTree *tree,
+                                gpointer      view_id,
+                                gint          first_line,
+                                gint          n_lines,
+                                const gint   *widths,
+                                const gint   *heights,
+                                gint         *y,
+                                gint         *old_height,
+                                gint         *new_height)
+{
+  GtkTextLine *line;
+  GtkTextLine *first_changed = NULL;
+  GtkTextBTreeNode *parent = NULL;
+  BTreeView *view;
+  gint old_sum = 0, new_sum = 0;
+  gint pending_height = 0;
+  gint i;
+
+  g_return_val_if_fail (tree != NULL, FALSE);
+
+  view = gtk_text_btree_get_view (tree, view_id);
+  g_return_val_if_fail (view != NULL, FALSE);
+
+  line = _gtk_text_btree_get_line_no_last (tree, first_line, NULL);
+
+  for (i = 0; i < n_lines && line != NULL; i++)
+    {
+      GtkTextLineData *ld = _gtk_text_line_get_data (line, view_id);
+
+      if (ld != NULL)
+        {
+          /* Only counts if more estimated lines follow */
+          pending_height += ld->height;
+        }
+      else
+        {
+          ld = _gtk_text_line_data_new (view->layout, line);
+          ld->width = widths[i];
+          ld->height = heights[i];
+          _gtk_text_line_add_data (line, ld);
+
+          if (first_changed == NULL)
+            {
+              first_changed = line;
+              pending_height = 0;
+            }
+
+          old_sum += pending_height;
+          new_sum += pending_height + ld->height;
+          pending_height = 0;
+
+          /* Recompute the aggregates once per leaf node */
+          if (parent != line->parent)
+            {
+              if (parent != NULL)
+                gtk_text_btree_node_check_valid_upward (parent, view_id);
+              parent = line->parent;
+            }
+        }
+
+      line = _gtk_text_line_next_excluding_last (line);
+    }
+
+  if (parent != NULL)
+    gtk_text_btree_node_check_valid_upward (parent, view_id);
+
+  if (first_changed == NULL)
+    return FALSE;
+
+  if (y)
+    *y = _gtk_text_btree_find_line_top (tree, first_changed, view_id);
+  if (old_height)
+    *old_height = old_sum;
+  if (new_height)
+    *new_height = new_sum;
+
+#ifdef G_ENABLE_DEBUG
+  if (GTK_DEBUG_CHECK (TEXT))
+    _gtk_text_btree_check (tree);
+#endif
+
+  return TRUE;
+}
+
 static void
 gtk_text_btree_node_remove_view (BTreeView *view, GtkTextBTreeNode *node, gpointer view_id)
 {
@@ -5537,6 +5808,7 @@ gtk_text_btree_node_free_empty (GtkTextBTree *tree,
                     (node->level == 0 && node->children.line == NULL));
 
   summary_list_destroy (node->summary);
+  g_free (node->tag_bits.words);
   node_data_list_destroy (node->node_data);
   g_slice_free (GtkTextBTreeNode, node);
 }
@@ -5741,19 +6013,27 @@ gtk_text_btree_rebalance (GtkTextBTree *tree,
     {
       GtkTextBTreeNode *new_node, *child;
       GtkTextLine *line;
-      int i;
+      int i, keep;
 
       /*
        * Check to see if the GtkTextBTreeNode has too many children.  If it does,
-       * then split off all but the first MIN_CHILDREN into a separate
+       * then split off all but the first few into a separate
        * GtkTextBTreeNode following the original one.  Then repeat until the
        * GtkTextBTreeNode has a decent size.
+       *
+       * A node that overflowed by a single insertion keeps about
+       * MIN_CHILDREN, while a node that received many lines at once is
+       * cut into mostly full nodes from left to right, so that large
+       * insertions build a shallow tree in one pass.
        */
 
       if (node->num_children > MAX_CHILDREN)
         {
           while (1)
             {
+              keep = MIN ((MIN_CHILDREN + MAX_CHILDREN) / 2,
+                          node->num_children - MIN_CHILDREN);
+
               /*
                * If the GtkTextBTreeNode being split is the root
                * GtkTextBTreeNode, then make a new root GtkTextBTreeNode above
@@ -5777,10 +6057,10 @@ gtk_text_btree_rebalance (GtkTextBTree *tree,
               node->next = new_node;
               new_node->summary = NULL;
               new_node->level = node->level;
-              new_node->num_children = node->num_children - MIN_CHILDREN;
+              new_node->num_children = node->num_children - keep;
               if (node->level == 0)
                 {
-                  for (i = MIN_CHILDREN-1,
+                  for (i = keep - 1,
                          line = node->children.line;
                        i > 0; i--, line = line->next)
                     {
@@ -5791,7 +6071,7 @@ gtk_text_btree_rebalance (GtkTextBTree *tree,
                 }
               else
                 {
-                  for (i = MIN_CHILDREN-1,
+                  for (i = keep - 1,
                          child = node->children.node;
                        i > 0; i--, child = child->next)
                     {
@@ -6007,21 +6287,7 @@ static GtkTextTagInfo*
 gtk_text_btree_get_existing_tag_info (GtkTextBTree *tree,
                                       GtkTextTag   *tag)
 {
-  GtkTextTagInfo *info;
-  GSList *list;
-
-
-  list = tree->tag_infos;
-  while (list != NULL)
-    {
-      info = list->data;
-      if (info->tag == tag)
-        return info;
-
-      list = list->next;
-    }
-
-  return NULL;
+  return g_hash_table_lookup (tree->tag_info_table, tag);
 }
 
 static GtkTextTagInfo*
@@ -6042,8 +6308,11 @@ gtk_text_btree_get_tag_info (GtkTextBTree *tree,
       g_object_ref (tag);
       info->tag_root = NULL;
       info->toggle_count = 0;
+      info->bit = tag_bits_first_unset (&tree->used_tag_bits);
+      tag_bits_set (&tree->used_tag_bits, info->bit);
 
       tree->tag_infos = g_slist_prepend (tree->tag_infos, info);
+      g_hash_table_insert (tree->tag_info_table, tag, info);
     }
 
   return info;
@@ -6075,6 +6344,9 @@ gtk_text_btree_remove_tag_info (GtkTextBTree *tree,
           list->next = NULL;
           g_slist_free (list);
 
+          g_hash_table_remove (tree->tag_info_table, tag);
+          tag_bits_clear (&tree->used_tag_bits, info->bit);
+
           g_object_unref (info->tag);
 
           g_slice_free (GtkTextTagInfo, info);
@@ -6264,13 +6536,13 @@ recompute_node_counts (GtkTextBTree *tree, GtkTextBTreeNode *node)
       if (summary2 != NULL)
         {
           summary2->next = summary->next;
-          summary_destroy (summary);
+          summary_destroy (node, summary);
           summary = summary2->next;
         }
       else
         {
           node->summary = summary->next;
-          summary_destroy (summary);
+          summary_destroy (node, summary);
           summary = node->summary;
         }
     }
@@ -6313,13 +6585,15 @@ _gtk_change_node_toggle_count (GtkTextBTreeNode *node,
        * perhaps all we have to do is adjust its count.
        */
 
-      for (prevPtr = NULL, summary = node->summary;
-           summary != NULL;
-           prevPtr = summary, summary = summary->next)
+      prevPtr = NULL;
+      summary = NULL;
+      if (tag_bits_get (&node->tag_bits, info->bit))
         {
-          if (summary->info == info)
+          for (summary = node->summary;
+               summary->info != info;
+               prevPtr = summary, summary = summary->next)
             {
-              break;
+              /* Empty loop body. */
             }
         }
       if (summary != NULL)
@@ -6354,7 +6628,7 @@ _gtk_change_node_toggle_count (GtkTextBTreeNode *node,
             {
               prevPtr->next = summary->next;
             }
-          summary_destroy (summary);
+          summary_destroy (node, summary);
         }
       else
         {
@@ -6377,20 +6651,12 @@ _gtk_change_node_toggle_count (GtkTextBTreeNode *node,
                */
 
               GtkTextBTreeNode *rootnode = info->tag_root;
-              summary = g_slice_new (Summary);
-              summary->info = info;
-              summary->toggle_count = info->toggle_count - delta;
-              summary->next = rootnode->summary;
-              rootnode->summary = summary;
+              summary_new (rootnode, info, info->toggle_count - delta);
               rootnode = rootnode->parent;
               rootLevel = rootnode->level;
               info->tag_root = rootnode;
             }
-          summary = g_slice_new (Summary);
-          summary->info = info;
-          summary->toggle_count = delta;
-          summary->next = node->summary;
-          node->summary = summary;
+          summary_new (node, info, delta);
         }
     }
 
@@ -6420,18 +6686,15 @@ _gtk_change_node_toggle_count (GtkTextBTreeNode *node,
            node2Ptr != (GtkTextBTreeNode *)NULL ;
            node2Ptr = node2Ptr->next)
         {
-          for (prevPtr = NULL, summary = node2Ptr->summary;
-               summary != NULL;
-               prevPtr = summary, summary = summary->next)
+          if (!tag_bits_get (&node2Ptr->tag_bits, info->bit))
             {
-              if (summary->info == info)
-                {
-                  break;
-                }
+              continue;
             }
-          if (summary == NULL)
+          for (prevPtr = NULL, summary = node2Ptr->summary;
+               summary->info != info;
+               prevPtr = summary, summary = summary->next)
             {
-              continue;
+              /* Empty loop body. */
             }
           if (summary->toggle_count != info->toggle_count)
             {
@@ -6454,7 +6717,7 @@ _gtk_change_node_toggle_count (GtkTextBTreeNode *node,
             {
               prevPtr->next = summary->next;
             }
-          summary_destroy (summary);
+          summary_destroy (node2Ptr, summary);
           info->tag_root = node2Ptr;
           break;
         }
@@ -6709,6 +6972,8 @@ gtk_text_btree_node_check_consistency (GtkTextBTree     *tree,
   GtkTextLine *line;
   GtkTextLineSegment *segPtr;
   int num_children, num_lines, num_chars, toggle_count, min_children;
+  int n_summaries, n_bits;
+  guint i;
   GtkTextLineData *ld;
   NodeData *nd;
 
@@ -6846,6 +7111,29 @@ gtk_text_btree_node_check_consistency (GtkTextBTree     *tree,
                num_chars, node->num_chars);
     }
 
+  n_summaries = 0;
+  for (summary = node->summary; summary != NULL;
+       summary = summary->next)
+    {
+      if (!tag_bits_get (&node->tag_bits, summary->info->bit))
+        {
+          g_error ("gtk_text_btree_node_check_consistency: tag \"%s\" missing from tag bits",
+                   summary->info->tag->priv->name);
+        }
+      n_summaries++;
+    }
+  n_bits = 0;
+  for (i = 0; i < node->tag_bits.n_words * TAG_BITS_PER_WORD; i++)
+    {
+      if (tag_bits_get (&node->tag_bits, i))
+        n_bits++;
+    }
+  if (n_bits != n_summaries)
+    {
+      g_error ("gtk_text_btree_node_check_consistency: mismatch in tag bits (%d %d)",
+               n_bits, n_summaries);
+    }
+
   for (summary = node->summary; summary != NULL;
        summary = summary->next)
     {
@@ -107,6 +107,15 @@ gboolean     _gtk_text_btree_validate          (GtkTextBTree      *tree,
 void         _gtk_text_btree_validate_line     (GtkTextBTree      *tree,
                                                 GtkTextLine       *line,
                                                 gpointer           view_id);
+gboolean     _gtk_text_btree_estimate_lines    (GtkTextBTree      *tree,
+                                                gpointer           view_id,
+                                                gint               first_line,
+                                                gint               n_lines,
+                                                const gint        *widths,
+                                                const gint        *heights,
+                                                gint              *y,
+                                                gint              *old_height,
+                                                gint              *new_height);
 
 /* Tag */
 
@@ -114,6 +123,11 @@ void _gtk_text_btree_tag (const GtkTextIter *start,
                           const GtkTextIter *end,
                           GtkTextTag        *tag,
                           gboolean           apply);
+void _gtk_text_btree_tag_ranges (GtkTextBTree      *tree,
+                                 GtkTextTag        *tag,
+                                 const GtkTextIter *bounds,
+                                 guint              n_ranges,
+                                 gboolean           apply);
 
 /* "Getters" */
 
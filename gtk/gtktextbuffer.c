@@ -24,6 +24,7 @@
  */
 
 #include "config.h"
+#include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
 
@@ -32,6 +33,7 @@
 #include "gtkmarshalers.h"
 #include "gtktextbuffer.h"
 #include "gtktextbufferprivate.h"
+#include "gtktextbuffersnapshotprivate.h"
 #include "gtktextbtree.h"
 #include "gtktextiterprivate.h"
 #include "gtktexttagprivate.h"
@@ -62,6 +64,8 @@ struct _GtkTextBufferPrivate
 
   GtkTextLogAttrCache *log_attr_cache;
 
+  GtkTextSnapshotCache *snapshot_cache;
+
   guint user_action_count;
 
   /* Whether the buffer has been modified since last save */
@@ -999,6 +1003,8 @@ gtk_text_buffer_finalize (GObject *object)
 
   priv->log_attr_cache = NULL;
 
+  g_clear_pointer (&priv->snapshot_cache, _gtk_text_snapshot_cache_free);
+
   G_OBJECT_CLASS (gtk_text_buffer_parent_class)->finalize (object);
 }
 
@@ -1081,11 +1087,25 @@ gtk_text_buffer_real_insert_text (GtkTextBuffer *buffer,
                                   const gchar   *text,
                                   gint           len)
 {
+  GtkTextSnapshotCache *snapshot_cache;
+  gint line = 0, n_lines = 0;
+
   g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
   g_return_if_fail (iter != NULL);
-  
+
+  snapshot_cache = buffer->priv->snapshot_cache;
+  if (snapshot_cache)
+    {
+      line = gtk_text_iter_get_line (iter);
+      n_lines = gtk_text_buffer_get_line_count (buffer);
+    }
+
   _gtk_text_btree_insert (iter, text, len);
 
+  if (snapshot_cache)
+    _gtk_text_snapshot_cache_lines_changed (snapshot_cache, get_btree (buffer), line, 1,
+                                            1 + gtk_text_buffer_get_line_count (buffer) - n_lines);
+
   g_signal_emit (buffer, signals[CHANGED], 0);
   g_object_notify_by_pspec (G_OBJECT (buffer), text_buffer_props[PROP_CURSOR_POSITION]);
 }
@@ -1141,6 +1161,239 @@ gtk_text_buffer_insert (GtkTextBuffer *buffer,
   gtk_text_buffer_emit_insert (buffer, iter, text, len);
 }
 
+/* Streamed insertion */
+
+#define INSERT_STREAM_CHUNK_SIZE (256 * 1024)
+
+typedef struct
+{
+  GtkTextMark *mark;
+  GInputStream *stream;
+  int io_priority;
+  GByteArray *pending;
+  goffset n_read;
+  goffset total;
+  GFileProgressCallback progress_callback;
+  gpointer progress_data;
+  GDestroyNotify progress_data_free;
+} InsertStreamData;
+
+static void
+insert_stream_data_free (gpointer data)
+{
+  InsertStreamData *insert = data;
+
+  if (!gtk_text_mark_get_deleted (insert->mark))
+    gtk_text_buffer_delete_mark (gtk_text_mark_get_buffer (insert->mark), insert->mark);
+  g_object_unref (insert->mark);
+  g_object_unref (insert->stream);
+  g_byte_array_unref (insert->pending);
+  if (insert->progress_data_free)
+    insert->progress_data_free (insert->progress_data);
+  g_slice_free (InsertStreamData, insert);
+}
+
+/* Inserts the pending bytes up to the last complete character. A
+ * trailing \r is kept back as well, so that a \r\n pair split between
+ * two reads still ends up as a single line break.
+ */
+static gboolean
+insert_stream_flush (GtkTextBuffer     *buffer,
+                     InsertStreamData  *insert,
+                     gboolean           at_end,
+                     GError           **error)
+{
+  const gchar *data = (const gchar *) insert->pending->data;
+  const gchar *end;
+  gsize len = insert->pending->len;
+  GtkTextIter iter;
+
+  if (!g_utf8_validate (data, len, &end) &&
+      (at_end || len - (end - data) >= 4))
+    {
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                           _("Text is not valid UTF-8"));
+      return FALSE;
+    }
+
+  len = end - data;
+  if (!at_end && len > 0 && data[len - 1] == '\r')
+    len--;
+
+  if (len > 0)
+    {
+      gtk_text_buffer_get_iter_at_mark (buffer, &iter, insert->mark);
+      gtk_text_buffer_insert (buffer, &iter, data, len);
+      g_byte_array_remove_range (insert->pending, 0, len);
+    }
+
+  return TRUE;
+}
+
+static void
+insert_stream_read_cb (GObject      *source,
+                       GAsyncResult *result,
+                       gpointer      user_data)
+{
+  GTask *task = user_data;
+  GtkTextBuffer *buffer = g_task_get_source_object (task);
+  InsertStreamData *insert = g_task_get_task_data (task);
+  GError *error = NULL;
+  GBytes *bytes;
+  gsize size;
+
+  bytes = g_input_stream_read_bytes_finish (insert->stream, result, &error);
+  if (bytes == NULL)
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  size = g_bytes_get_size (bytes);
+  g_byte_array_append (insert->pending, g_bytes_get_data (bytes, NULL), size);
+  g_bytes_unref (bytes);
+
+  if (!insert_stream_flush (buffer, insert, size == 0, &error))
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+
+  if (size == 0)
+    {
+      g_task_return_boolean (task, TRUE);
+      g_object_unref (task);
+      return;
+    }
+
+  insert->n_read += size;
+  if (insert->progress_callback)
+    insert->progress_callback (insert->n_read, insert->total, insert->progress_data);
+
+  if (g_task_return_error_if_cancelled (task))
+    {
+      g_object_unref (task);
+      return;
+    }
+
+  /* Every chunk is inserted from its own main loop iteration, so the
+   * views stay responsive and can be scrolled while the rest loads.
+   */
+  g_input_stream_read_bytes_async (insert->stream,
+                                   INSERT_STREAM_CHUNK_SIZE,
+                                   insert->io_priority,
+                                   g_task_get_cancellable (task),
+                                   insert_stream_read_cb,
+                                   task);
+}
+
+/**
+ * gtk_text_buffer_insert_stream_async:
+ * @buffer: a #GtkTextBuffer
+ * @iter: a position in the buffer
+ * @stream: a #GInputStream providing UTF-8 text
+ * @io_priority: the I/O priority of the reads
+ * @cancellable: (allow-none): optional #GCancellable object, %NULL to ignore
+ * @progress_callback: (allow-none) (scope notified) (closure progress_data):
+ *   function to call with the number of bytes read so far
+ * @progress_data: data to pass to @progress_callback
+ * @progress_data_free: (allow-none): function to free @progress_data
+ *   once @progress_callback is no longer called
+ * @callback: (scope async): a #GAsyncReadyCallback to call when
+ *   all of @stream has been inserted
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Reads all of @stream and inserts its contents at @iter, without
+ * blocking the main loop. This is meant for loading large documents:
+ * the text is read and inserted in chunks, each of them emitting
+ * #GtkTextBuffer::insert-text, and the buffer can be shown and edited
+ * while the remaining text is still loading.
+ *
+ * The text is inserted at the position @iter had when this function
+ * was called, tracked by a mark while the insertion is in progress.
+ * @progress_callback is called after every chunk, with a total of the
+ * size of @stream if it is seekable, or -1 otherwise.
+ *
+ * When the insertion is finished, @callback is called and you should
+ * call gtk_text_buffer_insert_stream_finish() to get the result.
+ */
+void
+gtk_text_buffer_insert_stream_async (GtkTextBuffer         *buffer,
+                                     GtkTextIter           *iter,
+                                     GInputStream          *stream,
+                                     int                    io_priority,
+                                     GCancellable          *cancellable,
+                                     GFileProgressCallback  progress_callback,
+                                     gpointer               progress_data,
+                                     GDestroyNotify         progress_data_free,
+                                     GAsyncReadyCallback    callback,
+                                     gpointer               user_data)
+{
+  InsertStreamData *insert;
+  GTask *task;
+
+  g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
+  g_return_if_fail (iter != NULL);
+  g_return_if_fail (gtk_text_iter_get_buffer (iter) == buffer);
+  g_return_if_fail (G_IS_INPUT_STREAM (stream));
+
+  insert = g_slice_new0 (InsertStreamData);
+  insert->mark = g_object_ref (gtk_text_buffer_create_mark (buffer, NULL, iter, FALSE));
+  insert->stream = g_object_ref (stream);
+  insert->io_priority = io_priority;
+  insert->pending = g_byte_array_new ();
+  insert->total = -1;
+  insert->progress_callback = progress_callback;
+  insert->progress_data = progress_data;
+  insert->progress_data_free = progress_data_free;
+
+  if (G_IS_SEEKABLE (stream) && g_seekable_can_seek (G_SEEKABLE (stream)))
+    {
+      goffset position = g_seekable_tell (G_SEEKABLE (stream));
+
+      if (g_seekable_seek (G_SEEKABLE (stream), 0, G_SEEK_END, NULL, NULL))
+        {
+          insert->total = g_seekable_tell (G_SEEKABLE (stream)) - position;
+          g_seekable_seek (G_SEEKABLE (stream), position, G_SEEK_SET, NULL, NULL);
+        }
+    }
+
+  task = g_task_new (buffer, cancellable, callback, user_data);
+  g_task_set_source_tag (task, gtk_text_buffer_insert_stream_async);
+  g_task_set_task_data (task, insert, insert_stream_data_free);
+
+  g_input_stream_read_bytes_async (stream,
+                                   INSERT_STREAM_CHUNK_SIZE,
+                                   io_priority,
+                                   cancellable,
+                                   insert_stream_read_cb,
+                                   task);
+}
+
+/**
+ * gtk_text_buffer_insert_stream_finish:
+ * @buffer: a #GtkTextBuffer
+ * @result: a #GAsyncResult
+ * @error: return location for a #GError, or %NULL
+ *
+ * Finishes an insertion started with gtk_text_buffer_insert_stream_async().
+ * If an error occurred, the text read before the error stays in the buffer.
+ *
+ * Returns: %TRUE if all of the stream was inserted
+ */
+gboolean
+gtk_text_buffer_insert_stream_finish (GtkTextBuffer  *buffer,
+                                      GAsyncResult   *result,
+                                      GError        **error)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_BUFFER (buffer), FALSE);
+  g_return_val_if_fail (g_task_is_valid (result, buffer), FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
 /**
  * gtk_text_buffer_insert_at_cursor:
  * @buffer: a #GtkTextBuffer
@@ -1792,14 +2045,26 @@ gtk_text_buffer_real_delete_range (GtkTextBuffer *buffer,
                                    GtkTextIter   *start,
                                    GtkTextIter   *end)
 {
+  GtkTextSnapshotCache *snapshot_cache;
+  gint line = 0, n_lines = 0;
   gboolean has_selection;
 
   g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
   g_return_if_fail (start != NULL);
   g_return_if_fail (end != NULL);
 
+  snapshot_cache = buffer->priv->snapshot_cache;
+  if (snapshot_cache)
+    {
+      line = gtk_text_iter_get_line (start);
+      n_lines = gtk_text_iter_get_line (end) - line + 1;
+    }
+
   _gtk_text_btree_delete (start, end);
 
+  if (snapshot_cache)
+    _gtk_text_snapshot_cache_lines_changed (snapshot_cache, get_btree (buffer), line, n_lines, 1);
+
   /* may have deleted the selection... */
   update_selection_clipboards (buffer);
 
@@ -2087,9 +2352,14 @@ static void
 gtk_text_buffer_real_insert_texture (GtkTextBuffer *buffer,
                                      GtkTextIter   *iter,
                                      GdkTexture    *texture)
-{ 
+{
+  gint line = gtk_text_iter_get_line (iter);
+
   _gtk_text_btree_insert_texture (iter, texture);
 
+  if (buffer->priv->snapshot_cache)
+    _gtk_text_snapshot_cache_lines_changed (buffer->priv->snapshot_cache, get_btree (buffer), line, 1, 1);
+
   g_signal_emit (buffer, signals[CHANGED], 0);
 }
 
@@ -2131,8 +2401,13 @@ gtk_text_buffer_real_insert_anchor (GtkTextBuffer      *buffer,
                                     GtkTextIter        *iter,
                                     GtkTextChildAnchor *anchor)
 {
+  gint line = gtk_text_iter_get_line (iter);
+
   _gtk_text_btree_insert_child_anchor (iter, anchor);
 
+  if (buffer->priv->snapshot_cache)
+    _gtk_text_snapshot_cache_lines_changed (buffer->priv->snapshot_cache, get_btree (buffer), line, 1, 1);
+
   g_signal_emit (buffer, signals[CHANGED], 0);
 }
 
@@ -2841,6 +3116,166 @@ gtk_text_buffer_remove_tag (GtkTextBuffer     *buffer,
   gtk_text_buffer_emit_tag (buffer, tag, FALSE, start, end);
 }
 
+static int
+compare_tag_ranges (gconstpointer a,
+                    gconstpointer b)
+{
+  const GtkTextTagRange *ra = a;
+  const GtkTextTagRange *rb = b;
+
+  if (ra->tag != rb->tag)
+    return ra->tag < rb->tag ? -1 : 1;
+
+  return ra->start < rb->start ? -1 : (ra->start > rb->start ? 1 : 0);
+}
+
+static void
+gtk_text_buffer_tag_ranges (GtkTextBuffer         *buffer,
+                            const GtkTextTagRange *ranges,
+                            guint                  n_ranges,
+                            gboolean               apply)
+{
+  GtkTextBufferClass *klass = GTK_TEXT_BUFFER_GET_CLASS (buffer);
+  GtkTextTagRange *sorted;
+  GtkTextIter *bounds;
+  gboolean direct;
+  gint n_chars;
+  guint i, n;
+
+  for (i = 0; i < n_ranges; i++)
+    {
+      g_return_if_fail (GTK_IS_TEXT_TAG (ranges[i].tag));
+      g_return_if_fail (ranges[i].tag->priv->table == buffer->priv->tag_table);
+    }
+
+  /* Without anyone watching the signals, we can skip the per-range
+   * emissions and let the btree process all ranges of a tag at once.
+   */
+  if (apply)
+    direct = klass->apply_tag == gtk_text_buffer_real_apply_tag &&
+             !g_signal_has_handler_pending (buffer, signals[APPLY_TAG], 0, FALSE);
+  else
+    direct = klass->remove_tag == gtk_text_buffer_real_remove_tag &&
+             !g_signal_has_handler_pending (buffer, signals[REMOVE_TAG], 0, FALSE);
+
+  n_chars = gtk_text_buffer_get_char_count (buffer);
+
+  sorted = g_new (GtkTextTagRange, MAX (n_ranges, 1));
+  n = 0;
+  for (i = 0; i < n_ranges; i++)
+    {
+      gint start = CLAMP (ranges[i].start, 0, n_chars);
+      gint end = CLAMP (ranges[i].end, 0, n_chars);
+
+      if (start == end)
+        continue;
+
+      sorted[n].tag = ranges[i].tag;
+      sorted[n].start = MIN (start, end);
+      sorted[n].end = MAX (start, end);
+      n++;
+    }
+
+  qsort (sorted, n, sizeof (GtkTextTagRange), compare_tag_ranges);
+
+  bounds = g_new (GtkTextIter, 2 * MAX (n, 1));
+
+  i = 0;
+  while (i < n)
+    {
+      GtkTextTag *tag = sorted[i].tag;
+      guint first = i;
+      guint n_merged = 0;
+      guint j;
+
+      /* Merge overlapping and adjacent ranges of the tag in place. */
+      for (i = first + 1; i < n && sorted[i].tag == tag; i++)
+        {
+          GtkTextTagRange *last = &sorted[first + n_merged];
+
+          if (sorted[i].start <= last->end)
+            last->end = MAX (last->end, sorted[i].end);
+          else
+            sorted[first + ++n_merged] = sorted[i];
+        }
+      n_merged++;
+
+      if (direct)
+        {
+          for (j = 0; j < n_merged; j++)
+            {
+              gtk_text_buffer_get_iter_at_offset (buffer, &bounds[2 * j], sorted[first + j].start);
+              gtk_text_buffer_get_iter_at_offset (buffer, &bounds[2 * j + 1], sorted[first + j].end);
+            }
+
+          _gtk_text_btree_tag_ranges (get_btree (buffer), tag, bounds, n_merged, apply);
+        }
+      else
+        {
+          /* Handlers may change the buffer, so don't keep iters
+           * around across emissions.
+           */
+          for (j = 0; j < n_merged; j++)
+            {
+              gtk_text_buffer_get_iter_at_offset (buffer, &bounds[0], sorted[first + j].start);
+              gtk_text_buffer_get_iter_at_offset (buffer, &bounds[1], sorted[first + j].end);
+              gtk_text_buffer_emit_tag (buffer, tag, apply, &bounds[0], &bounds[1]);
+            }
+        }
+    }
+
+  g_free (bounds);
+  g_free (sorted);
+}
+
+/**
+ * gtk_text_buffer_apply_tag_ranges:
+ * @buffer: a #GtkTextBuffer
+ * @ranges: (array length=n_ranges): the ranges to tag
+ * @n_ranges: the number of elements in @ranges
+ *
+ * Applies the tags of all @ranges in one go. This has the same
+ * result as calling gtk_text_buffer_apply_tag() for each element
+ * of @ranges, but is considerably faster when tagging many ranges,
+ * such as when highlighting syntax or search results.
+ *
+ * The ranges may be given in any order and may overlap; offsets
+ * outside of the buffer are clamped to it. The “apply-tag” signal
+ * is emitted once for each range of a tag after overlapping and
+ * adjacent ranges have been merged.
+ **/
+void
+gtk_text_buffer_apply_tag_ranges (GtkTextBuffer         *buffer,
+                                  const GtkTextTagRange *ranges,
+                                  guint                  n_ranges)
+{
+  g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
+  g_return_if_fail (ranges != NULL || n_ranges == 0);
+
+  gtk_text_buffer_tag_ranges (buffer, ranges, n_ranges, TRUE);
+}
+
+/**
+ * gtk_text_buffer_remove_tag_ranges:
+ * @buffer: a #GtkTextBuffer
+ * @ranges: (array length=n_ranges): the ranges to untag
+ * @n_ranges: the number of elements in @ranges
+ *
+ * Removes the tags of all @ranges in one go, like calling
+ * gtk_text_buffer_remove_tag() for each element of @ranges.
+ * See gtk_text_buffer_apply_tag_ranges() for details.
+ **/
+void
+gtk_text_buffer_remove_tag_ranges (GtkTextBuffer         *buffer,
+                                   const GtkTextTagRange *ranges,
+                                   guint                  n_ranges)
+{
+  g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
+  g_return_if_fail (ranges != NULL || n_ranges == 0);
+
+  gtk_text_buffer_tag_ranges (buffer, ranges, n_ranges, FALSE);
+}
+
 /**
  * gtk_text_buffer_apply_tag_by_name:
  * @buffer: a #GtkTextBuffer
@@ -3348,6 +3783,56 @@ gtk_text_buffer_get_char_count (GtkTextBuffer *buffer)
   return _gtk_text_btree_char_count (get_btree (buffer));
 }
 
+/**
+ * gtk_text_buffer_get_version:
+ * @buffer: a #GtkTextBuffer
+ *
+ * Gets a number that changes whenever the text of @buffer changes.
+ * Changes to tags and marks do not affect it.
+ *
+ * Returns: the version of the buffer text
+ **/
+guint
+gtk_text_buffer_get_version (GtkTextBuffer *buffer)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_BUFFER (buffer), 0);
+
+  return _gtk_text_btree_get_chars_changed_stamp (get_btree (buffer));
+}
+
+/**
+ * gtk_text_buffer_create_snapshot:
+ * @buffer: a #GtkTextBuffer
+ *
+ * Creates a read-only copy of the text in @buffer, which can be
+ * passed to other threads. See #GtkTextBufferSnapshot.
+ *
+ * The first snapshot copies all of the text. After that, the buffer
+ * keeps track of the lines that are edited, and later snapshots share
+ * the unchanged lines with the previous one. Creating a snapshot of an
+ * unchanged buffer returns the previous snapshot.
+ *
+ * This only works while the previous snapshot is still around. Once it
+ * is released, the buffer forgets about it, and the next snapshot
+ * copies all of the text again.
+ *
+ * Returns: (transfer full): a new #GtkTextBufferSnapshot
+ **/
+GtkTextBufferSnapshot *
+gtk_text_buffer_create_snapshot (GtkTextBuffer *buffer)
+{
+  GtkTextBufferPrivate *priv;
+
+  g_return_val_if_fail (GTK_IS_TEXT_BUFFER (buffer), NULL);
+
+  priv = buffer->priv;
+
+  if (priv->snapshot_cache == NULL)
+    priv->snapshot_cache = _gtk_text_snapshot_cache_new ();
+
+  return _gtk_text_snapshot_cache_get (priv->snapshot_cache, buffer);
+}
+
 static GtkTextBuffer *
 create_clipboard_contents_buffer (GtkTextBuffer *buffer,
                                   GtkTextIter   *start_iter,
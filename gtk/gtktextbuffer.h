@@ -34,6 +34,7 @@
 #include <gtk/gtktextiter.h>
 #include <gtk/gtktextmark.h>
 #include <gtk/gtktextchild.h>
+#include <gtk/gtktextbuffersnapshot.h>
 
 G_BEGIN_DECLS
 
@@ -73,6 +74,7 @@ typedef struct _GtkTextBTree GtkTextBTree;
 
 typedef struct _GtkTextBufferPrivate GtkTextBufferPrivate;
 typedef struct _GtkTextBufferClass GtkTextBufferClass;
+typedef struct _GtkTextTagRange GtkTextTagRange;
 
 struct _GtkTextBuffer
 {
@@ -81,6 +83,23 @@ struct _GtkTextBuffer
   GtkTextBufferPrivate *priv;
 };
 
+/**
+ * GtkTextTagRange:
+ * @tag: a #GtkTextTag
+ * @start: character offset of one bound of the range
+ * @end: character offset of the other bound of the range
+ *
+ * A range of characters to apply a tag to or remove it from, used
+ * with gtk_text_buffer_apply_tag_ranges() and
+ * gtk_text_buffer_remove_tag_ranges().
+ */
+struct _GtkTextTagRange
+{
+  GtkTextTag *tag;
+  gint        start;
+  gint        end;
+};
+
 /**
  * GtkTextBufferClass:
  * @parent_class: The object class structure needs to be the first.
@@ -168,6 +187,11 @@ GDK_AVAILABLE_IN_ALL
 gint           gtk_text_buffer_get_line_count (GtkTextBuffer   *buffer);
 GDK_AVAILABLE_IN_ALL
 gint           gtk_text_buffer_get_char_count (GtkTextBuffer   *buffer);
+GDK_AVAILABLE_IN_ALL
+guint          gtk_text_buffer_get_version    (GtkTextBuffer   *buffer);
+
+GDK_AVAILABLE_IN_ALL
+GtkTextBufferSnapshot *gtk_text_buffer_create_snapshot (GtkTextBuffer *buffer);
 
 
 GDK_AVAILABLE_IN_ALL
@@ -236,6 +260,22 @@ void     gtk_text_buffer_insert_markup            (GtkTextBuffer     *buffer,
                                                    const gchar       *markup,
                                                    gint               len);
 
+GDK_AVAILABLE_IN_ALL
+void     gtk_text_buffer_insert_stream_async      (GtkTextBuffer         *buffer,
+                                                   GtkTextIter           *iter,
+                                                   GInputStream          *stream,
+                                                   int                    io_priority,
+                                                   GCancellable          *cancellable,
+                                                   GFileProgressCallback  progress_callback,
+                                                   gpointer               progress_data,
+                                                   GDestroyNotify         progress_data_free,
+                                                   GAsyncReadyCallback    callback,
+                                                   gpointer               user_data);
+GDK_AVAILABLE_IN_ALL
+gboolean gtk_text_buffer_insert_stream_finish     (GtkTextBuffer         *buffer,
+                                                   GAsyncResult          *result,
+                                                   GError               **error);
+
 /* Delete from the buffer */
 GDK_AVAILABLE_IN_ALL
 void     gtk_text_buffer_delete             (GtkTextBuffer *buffer,
@@ -339,6 +379,14 @@ void gtk_text_buffer_remove_tag            (GtkTextBuffer     *buffer,
                                             const GtkTextIter *start,
                                             const GtkTextIter *end);
 GDK_AVAILABLE_IN_ALL
+void gtk_text_buffer_apply_tag_ranges      (GtkTextBuffer         *buffer,
+                                            const GtkTextTagRange *ranges,
+                                            guint                  n_ranges);
+GDK_AVAILABLE_IN_ALL
+void gtk_text_buffer_remove_tag_ranges     (GtkTextBuffer         *buffer,
+                                            const GtkTextTagRange *ranges,
+                                            guint                  n_ranges);
+GDK_AVAILABLE_IN_ALL
 void gtk_text_buffer_apply_tag_by_name     (GtkTextBuffer     *buffer,
                                             const gchar       *name,
                                             const GtkTextIter *start,
@@ -0,0 +1,578 @@
+/* GTK - The GIMP Toolkit
+ * gtktextbuffersnapshot.c: Read-only copies of a GtkTextBuffer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtktextbuffersnapshotprivate.h"
+
+#include <string.h>
+
+#include "gtktextbtree.h"
+#include "gtktextbufferprivate.h"
+
+/**
+ * SECTION:gtktextbuffersnapshot
+ * @Short_description: Read-only copies of a GtkTextBuffer
+ * @Title: GtkTextBufferSnapshot
+ * @See_also: #GtkTextBuffer
+ *
+ * A #GtkTextBufferSnapshot is an immutable copy of the text of a
+ * #GtkTextBuffer, as returned by gtk_text_buffer_create_snapshot().
+ * Unlike the buffer, a snapshot may be used from any thread, which
+ * allows syntax highlighters, spell checkers and indexers to do their
+ * work in a worker thread while the buffer keeps being edited.
+ *
+ * Snapshots only contain the text; tags and marks are not included.
+ * Images and child anchors appear as the 0xFFFC character, so byte
+ * indexes into a line of the snapshot are the same as the line indexes
+ * of #GtkTextIter.
+ *
+ * The text is stored in chunks of lines which are shared between
+ * snapshots. Taking a snapshot after an edit only copies the lines
+ * that were changed since the previous one.
+ *
+ * Every change to the text of the buffer changes its version, see
+ * gtk_text_buffer_get_version(). Work done on a snapshot can be
+ * tagged with gtk_text_buffer_snapshot_get_version() and dropped
+ * when it no longer matches the buffer.
+ */
+
+/* Maximum number of lines in a chunk */
+#define CHUNK_LINES 256
+
+typedef struct
+{
+  gint ref_count;
+  gint n_lines;
+  gchar *text;       /* the lines, including delimiters */
+  gsize offsets[1];  /* n_lines + 1 offsets of the lines in text */
+} TextChunk;
+
+typedef struct
+{
+  TextChunk *chunk;  /* NULL if the lines changed since the last snapshot */
+  gint n_lines;
+} CacheEntry;
+
+struct _GtkTextBufferSnapshot
+{
+  gint ref_count;
+  guint version;
+  gint n_lines;
+
+  guint n_chunks;
+  TextChunk **chunks;
+  gint *chunk_starts;  /* first line of each chunk */
+
+  GtkTextSnapshotCache *cache;  /* set on the last snapshot of a buffer */
+};
+
+/* The cache does not own the chunks in its entries, they are borrowed
+ * from the last snapshot it handed out. When that snapshot is released,
+ * the cache is cleared, so the buffer does not hold on to a copy of its
+ * text that nobody uses. As snapshots may be released in any thread,
+ * the link between a cache and its last snapshot and the entries are
+ * protected by snapshot_cache_lock.
+ */
+struct _GtkTextSnapshotCache
+{
+  GArray *entries;                  /* CacheEntry, covering all lines */
+  guint stamp;                      /* chars_changed_stamp of entries */
+  GtkTextBufferSnapshot *snapshot;  /* the last snapshot, not referenced */
+  guint valid   : 1;
+  guint current : 1;                /* snapshot matches the buffer */
+};
+
+G_LOCK_DEFINE_STATIC (snapshot_cache);
+
+static TextChunk *
+text_chunk_new (GtkTextIter *iter,
+                gint         n_lines)
+{
+  GtkTextIter start;
+  TextChunk *chunk;
+  gsize offset;
+  gint i;
+
+  chunk = g_malloc (sizeof (TextChunk) + n_lines * sizeof (gsize));
+  chunk->ref_count = 1;
+  chunk->n_lines = n_lines;
+
+  start = *iter;
+  offset = 0;
+  for (i = 0; i < n_lines; i++)
+    {
+      chunk->offsets[i] = offset;
+      offset += gtk_text_iter_get_bytes_in_line (iter);
+      gtk_text_iter_forward_line (iter);
+    }
+  chunk->offsets[n_lines] = offset;
+
+  chunk->text = gtk_text_iter_get_slice (&start, iter);
+
+  return chunk;
+}
+
+static TextChunk *
+text_chunk_ref (TextChunk *chunk)
+{
+  g_atomic_int_inc (&chunk->ref_count);
+
+  return chunk;
+}
+
+static void
+text_chunk_unref (TextChunk *chunk)
+{
+  if (!g_atomic_int_dec_and_test (&chunk->ref_count))
+    return;
+
+  g_free (chunk->text);
+  g_free (chunk);
+}
+
+GtkTextSnapshotCache *
+_gtk_text_snapshot_cache_new (void)
+{
+  GtkTextSnapshotCache *cache;
+
+  cache = g_slice_new0 (GtkTextSnapshotCache);
+  cache->entries = g_array_new (FALSE, FALSE, sizeof (CacheEntry));
+
+  return cache;
+}
+
+/* Called with the lock held */
+static void
+gtk_text_snapshot_cache_clear (GtkTextSnapshotCache *cache)
+{
+  g_array_set_size (cache->entries, 0);
+
+  if (cache->snapshot)
+    {
+      cache->snapshot->cache = NULL;
+      cache->snapshot = NULL;
+    }
+  cache->valid = FALSE;
+  cache->current = FALSE;
+}
+
+/* Takes a reference on the last snapshot of a cache, unless it is
+ * being released in another thread. Called with the lock held, which
+ * keeps the snapshot from being freed.
+ */
+static gboolean
+gtk_text_buffer_snapshot_try_ref (GtkTextBufferSnapshot *snapshot)
+{
+  gint ref_count;
+
+  do
+    {
+      ref_count = g_atomic_int_get (&snapshot->ref_count);
+      if (ref_count == 0)
+        return FALSE;
+    }
+  while (!g_atomic_int_compare_and_exchange (&snapshot->ref_count, ref_count, ref_count + 1));
+
+  return TRUE;
+}
+
+void
+_gtk_text_snapshot_cache_free (GtkTextSnapshotCache *cache)
+{
+  G_LOCK (snapshot_cache);
+  gtk_text_snapshot_cache_clear (cache);
+  G_UNLOCK (snapshot_cache);
+
+  g_array_unref (cache->entries);
+
+  g_slice_free (GtkTextSnapshotCache, cache);
+}
+
+/* Called after lines [first_line, first_line + old_n_lines) of the
+ * buffer have been replaced by new_n_lines lines. The chunks holding
+ * those lines are dropped; all other chunks stay shared.
+ */
+void
+_gtk_text_snapshot_cache_lines_changed (GtkTextSnapshotCache *cache,
+                                        GtkTextBTree         *tree,
+                                        gint                  first_line,
+                                        gint                  old_n_lines,
+                                        gint                  new_n_lines)
+{
+  CacheEntry dirty;
+  guint stamp, i, j;
+  gint line, end;
+
+  G_LOCK (snapshot_cache);
+
+  stamp = _gtk_text_btree_get_chars_changed_stamp (tree);
+  if (!cache->valid || stamp == cache->stamp)
+    goto out;
+
+  /* An edit we were not told about; start over on the next snapshot */
+  if (stamp != cache->stamp + 1)
+    {
+      gtk_text_snapshot_cache_clear (cache);
+      goto out;
+    }
+
+  cache->stamp = stamp;
+  cache->current = FALSE;
+
+  /* Find the entries holding the old lines */
+  line = 0;
+  i = 0;
+  while (i < cache->entries->len &&
+         line + g_array_index (cache->entries, CacheEntry, i).n_lines <= first_line)
+    {
+      line += g_array_index (cache->entries, CacheEntry, i).n_lines;
+      i++;
+    }
+
+  end = line;
+  j = i;
+  while (j < cache->entries->len && end < first_line + old_n_lines)
+    {
+      end += g_array_index (cache->entries, CacheEntry, j).n_lines;
+      j++;
+    }
+
+  if (end < first_line + old_n_lines)
+    {
+      gtk_text_snapshot_cache_clear (cache);
+      goto out;
+    }
+
+  dirty.chunk = NULL;
+  dirty.n_lines = end - line + new_n_lines - old_n_lines;
+
+  /* Merge with changed neighbours, so they are copied in one go */
+  if (i > 0 && g_array_index (cache->entries, CacheEntry, i - 1).chunk == NULL)
+    {
+      i--;
+      dirty.n_lines += g_array_index (cache->entries, CacheEntry, i).n_lines;
+    }
+  if (j < cache->entries->len && g_array_index (cache->entries, CacheEntry, j).chunk == NULL)
+    {
+      dirty.n_lines += g_array_index (cache->entries, CacheEntry, j).n_lines;
+      j++;
+    }
+
+  g_array_remove_range (cache->entries, i, j - i);
+  g_array_insert_val (cache->entries, i, dirty);
+
+out:
+  G_UNLOCK (snapshot_cache);
+}
+
+GtkTextBufferSnapshot *
+_gtk_text_snapshot_cache_get (GtkTextSnapshotCache *cache,
+                              GtkTextBuffer        *buffer)
+{
+  GtkTextBufferSnapshot *snapshot;
+  GtkTextIter iter;
+  GArray *entries;
+  GPtrArray *chunks;
+  guint stamp, i;
+  gint line;
+
+  G_LOCK (snapshot_cache);
+
+  stamp = _gtk_text_btree_get_chars_changed_stamp (_gtk_text_buffer_get_btree (buffer));
+
+  if (!cache->valid || cache->stamp != stamp)
+    {
+      CacheEntry all;
+
+      gtk_text_snapshot_cache_clear (cache);
+
+      all.chunk = NULL;
+      all.n_lines = gtk_text_buffer_get_line_count (buffer);
+      g_array_append_val (cache->entries, all);
+
+      cache->stamp = stamp;
+      cache->valid = TRUE;
+    }
+
+  if (cache->current && gtk_text_buffer_snapshot_try_ref (cache->snapshot))
+    {
+      snapshot = cache->snapshot;
+      G_UNLOCK (snapshot_cache);
+
+      return snapshot;
+    }
+
+  /* Copy the lines that changed since the last snapshot, and share
+   * the chunks of the others with it
+   */
+  entries = g_array_sized_new (FALSE, FALSE, sizeof (CacheEntry), cache->entries->len);
+  chunks = g_ptr_array_sized_new (cache->entries->len);
+  line = 0;
+  for (i = 0; i < cache->entries->len; i++)
+    {
+      CacheEntry entry = g_array_index (cache->entries, CacheEntry, i);
+      gint remaining;
+
+      if (entry.chunk)
+        {
+          g_array_append_val (entries, entry);
+          g_ptr_array_add (chunks, text_chunk_ref (entry.chunk));
+          line += entry.n_lines;
+          continue;
+        }
+
+      gtk_text_buffer_get_iter_at_line (buffer, &iter, line);
+      for (remaining = entry.n_lines; remaining > 0; remaining -= entry.n_lines)
+        {
+          entry.n_lines = MIN (remaining, CHUNK_LINES);
+          entry.chunk = text_chunk_new (&iter, entry.n_lines);
+          g_array_append_val (entries, entry);
+          g_ptr_array_add (chunks, entry.chunk);
+          line += entry.n_lines;
+        }
+    }
+  g_array_unref (cache->entries);
+  cache->entries = entries;
+
+  snapshot = g_slice_new (GtkTextBufferSnapshot);
+  snapshot->ref_count = 1;
+  snapshot->version = stamp;
+  snapshot->n_lines = line;
+  snapshot->n_chunks = chunks->len;
+  snapshot->chunks = (TextChunk **) g_ptr_array_free (chunks, FALSE);
+  snapshot->chunk_starts = g_new (gint, entries->len);
+
+  line = 0;
+  for (i = 0; i < entries->len; i++)
+    {
+      snapshot->chunk_starts[i] = line;
+      line += g_array_index (entries, CacheEntry, i).n_lines;
+    }
+
+  /* The new snapshot now lends its chunks to the cache */
+  if (cache->snapshot)
+    cache->snapshot->cache = NULL;
+  cache->snapshot = snapshot;
+  cache->current = TRUE;
+  snapshot->cache = cache;
+
+  G_UNLOCK (snapshot_cache);
+
+  return snapshot;
+}
+
+/**
+ * gtk_text_buffer_snapshot_ref:
+ * @snapshot: a #GtkTextBufferSnapshot
+ *
+ * Acquires a reference on @snapshot. This function is thread-safe.
+ *
+ * Returns: (transfer full): @snapshot
+ */
+GtkTextBufferSnapshot *
+gtk_text_buffer_snapshot_ref (GtkTextBufferSnapshot *snapshot)
+{
+  g_return_val_if_fail (snapshot != NULL, NULL);
+
+  g_atomic_int_inc (&snapshot->ref_count);
+
+  return snapshot;
+}
+
+/**
+ * gtk_text_buffer_snapshot_unref:
+ * @snapshot: (transfer full): a #GtkTextBufferSnapshot
+ *
+ * Releases a reference on @snapshot. This function is thread-safe.
+ */
+void
+gtk_text_buffer_snapshot_unref (GtkTextBufferSnapshot *snapshot)
+{
+  guint i;
+
+  g_return_if_fail (snapshot != NULL);
+
+  if (!g_atomic_int_dec_and_test (&snapshot->ref_count))
+    return;
+
+  /* The cache of the buffer borrows the chunks of its last snapshot */
+  G_LOCK (snapshot_cache);
+  if (snapshot->cache)
+    gtk_text_snapshot_cache_clear (snapshot->cache);
+  G_UNLOCK (snapshot_cache);
+
+  for (i = 0; i < snapshot->n_chunks; i++)
+    text_chunk_unref (snapshot->chunks[i]);
+  g_free (snapshot->chunks);
+  g_free (snapshot->chunk_starts);
+
+  g_slice_free (GtkTextBufferSnapshot, snapshot);
+}
+
+G_DEFINE_BOXED_TYPE (GtkTextBufferSnapshot, gtk_text_buffer_snapshot,
+                     gtk_text_buffer_snapshot_ref,
+                     gtk_text_buffer_snapshot_unref)
+
+/**
+ * gtk_text_buffer_snapshot_get_version:
+ * @snapshot: a #GtkTextBufferSnapshot
+ *
+ * Gets the version of the buffer text that @snapshot is a copy of.
+ * The snapshot is up to date as long as this is equal to
+ * gtk_text_buffer_get_version().
+ *
+ * Returns: the version of @snapshot
+ */
+guint
+gtk_text_buffer_snapshot_get_version (GtkTextBufferSnapshot *snapshot)
+{
+  g_return_val_if_fail (snapshot != NULL, 0);
+
+  return snapshot->version;
+}
+
+/**
+ * gtk_text_buffer_snapshot_get_line_count:
+ * @snapshot: a #GtkTextBufferSnapshot
+ *
+ * Gets the number of lines in @snapshot.
+ *
+ * Returns: number of lines
+ */
+gint
+gtk_text_buffer_snapshot_get_line_count (GtkTextBufferSnapshot *snapshot)
+{
+  g_return_val_if_fail (snapshot != NULL, 0);
+
+  return snapshot->n_lines;
+}
+
+static TextChunk *
+gtk_text_buffer_snapshot_find_line (GtkTextBufferSnapshot *snapshot,
+                                    gint                   line,
+                                    gint                  *chunk_line)
+{
+  guint lo, hi, mid;
+
+  /* Find the last chunk starting at or before @line */
+  lo = 0;
+  hi = snapshot->n_chunks;
+  while (hi - lo > 1)
+    {
+      mid = (lo + hi) / 2;
+      if (snapshot->chunk_starts[mid] <= line)
+        lo = mid;
+      else
+        hi = mid;
+    }
+
+  *chunk_line = line - snapshot->chunk_starts[lo];
+
+  return snapshot->chunks[lo];
+}
+
+/**
+ * gtk_text_buffer_snapshot_get_line:
+ * @snapshot: a #GtkTextBufferSnapshot
+ * @line: a line number, counting from 0
+ * @length: (out) (optional): return location for the length of the line
+ *
+ * Gets the text of a line in @snapshot. The text is not nul-terminated
+ * and does not include the line delimiter; @length is the number of
+ * bytes up to the delimiter.
+ *
+ * Returns: (transfer none): the text of @line, valid as long as
+ *   @snapshot is alive
+ */
+const gchar *
+gtk_text_buffer_snapshot_get_line (GtkTextBufferSnapshot *snapshot,
+                                   gint                   line,
+                                   gsize                 *length)
+{
+  TextChunk *chunk;
+  const gchar *text;
+  gsize len;
+  gint i;
+
+  g_return_val_if_fail (snapshot != NULL, NULL);
+  g_return_val_if_fail (line >= 0 && line < snapshot->n_lines, NULL);
+
+  chunk = gtk_text_buffer_snapshot_find_line (snapshot, line, &i);
+  text = chunk->text + chunk->offsets[i];
+  len = chunk->offsets[i + 1] - chunk->offsets[i];
+
+  if (length)
+    {
+      if (len >= 3 && memcmp (text + len - 3, "\342\200\251", 3) == 0)
+        len -= 3;
+      else if (len >= 2 && text[len - 2] == '\r' && text[len - 1] == '\n')
+        len -= 2;
+      else if (len >= 1 && (text[len - 1] == '\r' || text[len - 1] == '\n'))
+        len -= 1;
+
+      *length = len;
+    }
+
+  return text;
+}
+
+/**
+ * gtk_text_buffer_snapshot_get_text:
+ * @snapshot: a #GtkTextBufferSnapshot
+ * @start_line: the first line
+ * @end_line: the line after the last line, or -1 for the end
+ *
+ * Gets the text of the lines [@start_line, @end_line) of @snapshot,
+ * including line delimiters.
+ *
+ * Returns: (transfer full): an allocated UTF-8 string
+ */
+gchar *
+gtk_text_buffer_snapshot_get_text (GtkTextBufferSnapshot *snapshot,
+                                   gint                   start_line,
+                                   gint                   end_line)
+{
+  GString *text;
+  gint line;
+
+  g_return_val_if_fail (snapshot != NULL, NULL);
+  g_return_val_if_fail (start_line >= 0 && start_line <= snapshot->n_lines, NULL);
+
+  if (end_line < 0 || end_line > snapshot->n_lines)
+    end_line = snapshot->n_lines;
+
+  text = g_string_new (NULL);
+
+  line = start_line;
+  while (line < end_line)
+    {
+      TextChunk *chunk;
+      gint first, last;
+
+      chunk = gtk_text_buffer_snapshot_find_line (snapshot, line, &first);
+      last = MIN (chunk->n_lines, first + end_line - line);
+
+      g_string_append_len (text,
+                           chunk->text + chunk->offsets[first],
+                           chunk->offsets[last] - chunk->offsets[first]);
+
+      line += last - first;
+    }
+
+  return g_string_free (text, FALSE);
+}
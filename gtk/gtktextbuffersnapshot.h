@@ -0,0 +1,58 @@
+/* GTK - The GIMP Toolkit
+ * gtktextbuffersnapshot.h: Read-only copies of a GtkTextBuffer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_TEXT_BUFFER_SNAPSHOT_H__
+#define __GTK_TEXT_BUFFER_SNAPSHOT_H__
+
+#if !defined (__GTK_H_INSIDE__) && !defined (GTK_COMPILATION)
+#error "Only <gtk/gtk.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <gdk/gdk.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GtkTextBufferSnapshot GtkTextBufferSnapshot;
+
+#define GTK_TYPE_TEXT_BUFFER_SNAPSHOT (gtk_text_buffer_snapshot_get_type ())
+
+GDK_AVAILABLE_IN_ALL
+GType                  gtk_text_buffer_snapshot_get_type       (void) G_GNUC_CONST;
+GDK_AVAILABLE_IN_ALL
+GtkTextBufferSnapshot *gtk_text_buffer_snapshot_ref            (GtkTextBufferSnapshot *snapshot);
+GDK_AVAILABLE_IN_ALL
+void                   gtk_text_buffer_snapshot_unref          (GtkTextBufferSnapshot *snapshot);
+
+GDK_AVAILABLE_IN_ALL
+guint                  gtk_text_buffer_snapshot_get_version    (GtkTextBufferSnapshot *snapshot);
+GDK_AVAILABLE_IN_ALL
+gint                   gtk_text_buffer_snapshot_get_line_count (GtkTextBufferSnapshot *snapshot);
+GDK_AVAILABLE_IN_ALL
+const gchar           *gtk_text_buffer_snapshot_get_line       (GtkTextBufferSnapshot *snapshot,
+                                                                gint                   line,
+                                                                gsize                 *length);
+GDK_AVAILABLE_IN_ALL
+gchar                 *gtk_text_buffer_snapshot_get_text       (GtkTextBufferSnapshot *snapshot,
+                                                                gint                   start_line,
+                                                                gint                   end_line);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GtkTextBufferSnapshot, gtk_text_buffer_snapshot_unref)
+
+G_END_DECLS
+
+#endif /* __GTK_TEXT_BUFFER_SNAPSHOT_H__ */
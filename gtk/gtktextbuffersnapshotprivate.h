@@ -0,0 +1,39 @@
+/* GTK - The GIMP Toolkit
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_TEXT_BUFFER_SNAPSHOT_PRIVATE_H__
+#define __GTK_TEXT_BUFFER_SNAPSHOT_PRIVATE_H__
+
+#include <gtk/gtktextbuffer.h>
+#include <gtk/gtktextbuffersnapshot.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GtkTextSnapshotCache GtkTextSnapshotCache;
+
+GtkTextSnapshotCache  *_gtk_text_snapshot_cache_new           (void);
+void                   _gtk_text_snapshot_cache_free          (GtkTextSnapshotCache *cache);
+void                   _gtk_text_snapshot_cache_lines_changed (GtkTextSnapshotCache *cache,
+                                                               GtkTextBTree         *tree,
+                                                               gint                  first_line,
+                                                               gint                  old_n_lines,
+                                                               gint                  new_n_lines);
+GtkTextBufferSnapshot *_gtk_text_snapshot_cache_get           (GtkTextSnapshotCache *cache,
+                                                               GtkTextBuffer        *buffer);
+
+G_END_DECLS
+
+#endif /* __GTK_TEXT_BUFFER_SNAPSHOT_PRIVATE_H__ */
@@ -97,6 +97,13 @@ struct _GtkTextLayoutPrivate
      direction only influences the direction of the cursor line.
   */
   GtkTextLine *cursor_line;
+
+  /* Estimation of line sizes in threads, see gtk_text_layout_estimate() */
+  GCancellable *estimate_cancellable;
+  guint estimate_generation;
+  guint estimate_jobs;
+  gint estimate_line;
+  guint estimate_restart : 1;
 };
 
 static GtkTextLineData *gtk_text_layout_real_wrap (GtkTextLayout *layout,
@@ -126,6 +133,7 @@ static void gtk_text_layout_emit_changed           (GtkTextLayout     *layout,
 						    gint               new_height);
 
 static void gtk_text_layout_invalidate_all (GtkTextLayout *layout);
+static void gtk_text_layout_cancel_estimate (GtkTextLayout *layout);
 
 static PangoAttribute *gtk_text_attr_appearance_new (const GtkTextAppearance *appearance);
 
@@ -310,6 +318,7 @@ gtk_text_layout_set_buffer (GtkTextLayout *layout,
     return;
 
   free_style_cache (layout);
+  gtk_text_layout_cancel_estimate (layout);
 
   if (layout->buffer)
     {
@@ -808,6 +817,8 @@ gtk_text_layout_invalidate_all (GtkTextLayout *layout)
   if (layout->buffer == NULL)
     return;
 
+  gtk_text_layout_cancel_estimate (layout);
+
   gtk_text_buffer_get_bounds (layout->buffer, &start, &end);
 
   gtk_text_layout_invalidate (layout, &start, &end);
@@ -1159,6 +1170,311 @@ gtk_text_layout_validate (GtkTextLayout *layout,
     }
 }
 
+/* Lines that have never been validated don't count towards the size
+ * of the layout, so for a big buffer the scrollbars take a long time
+ * to settle. To speed this up, the sizes of such lines are estimated
+ * in threads, from a snapshot of the buffer and the default style
+ * (tags are ignored). The estimates are stored as invalid line data,
+ * so the lines still get validated properly later.
+ */
+#define ESTIMATE_CHUNK_LINES 1000
+#define MAX_ESTIMATE_JOBS    4
+
+typedef struct _EstimateJob EstimateJob;
+
+struct _EstimateJob
+{
+  GtkTextBufferSnapshot *snapshot;
+  guint generation;
+  gint first_line;
+  gint n_lines;
+
+  PangoFontDescription *font;
+  PangoLanguage *language;
+  PangoDirection base_dir;
+  cairo_font_options_t *font_options;
+  double resolution;
+  PangoTabArray *tabs;
+  PangoWrapMode wrap;
+  gint wrap_width;              /* -1 if not wrapping */
+  gint spacing;
+  gint indent;
+  gint extra_width;             /* margins and padding */
+  gint extra_height;            /* pixels above and below lines */
+
+  gint *widths;
+  gint *heights;
+};
+
+static void
+estimate_job_free (gpointer data)
+{
+  EstimateJob *job = data;
+
+  gtk_text_buffer_snapshot_unref (job->snapshot);
+  pango_font_description_free (job->font);
+  if (job->font_options)
+    cairo_font_options_destroy (job->font_options);
+  if (job->tabs)
+    pango_tab_array_free (job->tabs);
+  g_free (job->widths);
+  g_free (job->heights);
+
+  g_slice_free (EstimateJob, job);
+}
+
+static void
+estimate_thread (GTask        *task,
+                 gpointer      source_object,
+                 gpointer      task_data,
+                 GCancellable *cancellable)
+{
+  EstimateJob *job = task_data;
+  PangoContext *context;
+  PangoLayout *layout;
+  gint i;
+
+  /* Pango objects can't be shared between threads, so we use the
+   * default font map of this thread.
+   */
+  context = pango_font_map_create_context (pango_cairo_font_map_get_default ());
+  pango_cairo_context_set_resolution (context, job->resolution);
+  pango_cairo_context_set_font_options (context, job->font_options);
+  pango_context_set_font_description (context, job->font);
+  pango_context_set_language (context, job->language);
+  pango_context_set_base_dir (context, job->base_dir);
+
+  layout = pango_layout_new (context);
+  pango_layout_set_spacing (layout, job->spacing * PANGO_SCALE);
+  pango_layout_set_indent (layout, job->indent * PANGO_SCALE);
+  if (job->tabs)
+    pango_layout_set_tabs (layout, job->tabs);
+  if (job->wrap_width >= 0)
+    {
+      pango_layout_set_width (layout, job->wrap_width * PANGO_SCALE);
+      pango_layout_set_wrap (layout, job->wrap);
+    }
+
+  for (i = 0; i < job->n_lines; i++)
+    {
+      PangoRectangle extents;
+      const gchar *text;
+      gsize length;
+
+      if (i % 64 == 0 && g_cancellable_is_cancelled (cancellable))
+        break;
+
+      text = gtk_text_buffer_snapshot_get_line (job->snapshot, job->first_line + i, &length);
+      pango_layout_set_text (layout, text, length);
+      pango_layout_get_extents (layout, NULL, &extents);
+
+      job->widths[i] = PIXEL_BOUND (extents.width) + job->extra_width;
+      job->heights[i] = PANGO_PIXELS (extents.height) + job->extra_height;
+    }
+
+  g_object_unref (layout);
+  g_object_unref (context);
+
+  if (!g_task_return_error_if_cancelled (task))
+    g_task_return_boolean (task, TRUE);
+}
+
+static void
+estimate_done (GObject      *source,
+               GAsyncResult *result,
+               gpointer      user_data)
+{
+  GtkTextLayout *layout = GTK_TEXT_LAYOUT (source);
+  GtkTextLayoutPrivate *priv = GTK_TEXT_LAYOUT_GET_PRIVATE (layout);
+  EstimateJob *job = g_task_get_task_data (G_TASK (result));
+  gint y, old_height, new_height;
+
+  /* Results from before the last invalidation are useless */
+  if (job->generation != priv->estimate_generation)
+    return;
+
+  priv->estimate_jobs--;
+
+  if (!g_task_propagate_boolean (G_TASK (result), NULL))
+    return;
+
+  if (layout->buffer == NULL)
+    return;
+
+  if (gtk_text_buffer_snapshot_get_version (job->snapshot) !=
+      gtk_text_buffer_get_version (layout->buffer))
+    {
+      /* The lines may have moved; do another pass later */
+      priv->estimate_restart = TRUE;
+    }
+  else if (_gtk_text_btree_estimate_lines (_gtk_text_buffer_get_btree (layout->buffer),
+                                           layout,
+                                           job->first_line, job->n_lines,
+                                           job->widths, job->heights,
+                                           &y, &old_height, &new_height))
+    {
+      update_layout_size (layout);
+      gtk_text_layout_emit_changed (layout, y, old_height, new_height);
+    }
+
+  gtk_text_layout_estimate (layout);
+}
+
+static gboolean
+gtk_text_layout_start_estimate_job (GtkTextLayout *layout)
+{
+  GtkTextLayoutPrivate *priv = GTK_TEXT_LAYOUT_GET_PRIVATE (layout);
+  GtkTextAttributes *style = layout->default_style;
+  const cairo_font_options_t *font_options;
+  GtkTextLine *line;
+  EstimateJob *job;
+  GTask *task;
+  gint n_lines;
+  gint first, count;
+  gint h_margin, h_padding;
+
+  n_lines = gtk_text_buffer_get_line_count (layout->buffer);
+
+  if (priv->estimate_line >= n_lines)
+    {
+      if (!priv->estimate_restart)
+        return FALSE;
+
+      priv->estimate_line = 0;
+      priv->estimate_restart = FALSE;
+    }
+
+  /* Find the next run of lines without line data */
+  first = priv->estimate_line;
+  line = _gtk_text_btree_get_line_no_last (_gtk_text_buffer_get_btree (layout->buffer), first, NULL);
+  while (line != NULL && _gtk_text_line_get_data (line, layout) != NULL)
+    {
+      line = _gtk_text_line_next_excluding_last (line);
+      first++;
+    }
+
+  count = 0;
+  while (line != NULL && count < ESTIMATE_CHUNK_LINES &&
+         _gtk_text_line_get_data (line, layout) == NULL)
+    {
+      line = _gtk_text_line_next_excluding_last (line);
+      count++;
+    }
+
+  priv->estimate_line = first + count;
+
+  if (count == 0)
+    return FALSE;
+
+  h_margin = style->left_margin + style->right_margin;
+  h_padding = layout->left_padding + layout->right_padding;
+
+  job = g_slice_new0 (EstimateJob);
+  job->snapshot = gtk_text_buffer_create_snapshot (layout->buffer);
+  job->generation = priv->estimate_generation;
+  job->first_line = first;
+  job->n_lines = count;
+
+  job->font = pango_font_description_copy (style->font);
+  job->language = style->language;
+  job->base_dir = style->direction == GTK_TEXT_DIR_RTL ? PANGO_DIRECTION_RTL : PANGO_DIRECTION_LTR;
+  job->resolution = pango_cairo_context_get_resolution (layout->ltr_context);
+  font_options = pango_cairo_context_get_font_options (layout->ltr_context);
+  if (font_options)
+    job->font_options = cairo_font_options_copy (font_options);
+  if (style->tabs)
+    job->tabs = pango_tab_array_copy (style->tabs);
+
+  switch (style->wrap_mode)
+    {
+    case GTK_WRAP_CHAR:
+      job->wrap = PANGO_WRAP_CHAR;
+      break;
+    case GTK_WRAP_WORD:
+      job->wrap = PANGO_WRAP_WORD;
+      break;
+    case GTK_WRAP_WORD_CHAR:
+      job->wrap = PANGO_WRAP_WORD_CHAR;
+      break;
+    case GTK_WRAP_NONE:
+    default:
+      break;
+    }
+
+  if (style->wrap_mode != GTK_WRAP_NONE)
+    job->wrap_width = MAX (0, layout->screen_width - h_margin - h_padding);
+  else
+    job->wrap_width = -1;
+
+  job->spacing = style->pixels_inside_wrap;
+  job->indent = style->indent;
+  job->extra_width = h_margin + h_padding;
+  job->extra_height = style->pixels_above_lines + style->pixels_below_lines;
+
+  job->widths = g_new0 (gint, count);
+  job->heights = g_new0 (gint, count);
+
+  if (priv->estimate_cancellable == NULL)
+    priv->estimate_cancellable = g_cancellable_new ();
+
+  task = g_task_new (layout, priv->estimate_cancellable, estimate_done, NULL);
+  g_task_set_source_tag (task, gtk_text_layout_estimate);
+  g_task_set_task_data (task, job, estimate_job_free);
+  g_task_run_in_thread (task, estimate_thread);
+  g_object_unref (task);
+
+  priv->estimate_jobs++;
+
+  return TRUE;
+}
+
+/**
+ * gtk_text_layout_estimate:
+ * @layout: a #GtkTextLayout
+ *
+ * Starts estimating the sizes of lines that have not been validated
+ * yet in other threads, unless this is already in progress. The
+ * ::changed signal will be emitted as estimates arrive.
+ **/
+void
+gtk_text_layout_estimate (GtkTextLayout *layout)
+{
+  GtkTextLayoutPrivate *priv;
+  guint max_jobs;
+
+  g_return_if_fail (GTK_IS_TEXT_LAYOUT (layout));
+
+  priv = GTK_TEXT_LAYOUT_GET_PRIVATE (layout);
+
+  if (layout->buffer == NULL ||
+      layout->default_style == NULL ||
+      layout->ltr_context == NULL)
+    return;
+
+  max_jobs = CLAMP (g_get_num_processors () - 1, 1, MAX_ESTIMATE_JOBS);
+
+  while (priv->estimate_jobs < max_jobs &&
+         gtk_text_layout_start_estimate_job (layout))
+    ;
+}
+
+static void
+gtk_text_layout_cancel_estimate (GtkTextLayout *layout)
+{
+  GtkTextLayoutPrivate *priv = GTK_TEXT_LAYOUT_GET_PRIVATE (layout);
+
+  if (priv->estimate_cancellable)
+    {
+      g_cancellable_cancel (priv->estimate_cancellable);
+      g_clear_object (&priv->estimate_cancellable);
+    }
+
+  priv->estimate_generation++;
+  priv->estimate_jobs = 0;
+  priv->estimate_line = 0;
+  priv->estimate_restart = TRUE;
+}
+
 static GtkTextLineData*
 gtk_text_layout_real_wrap (GtkTextLayout   *layout,
                            GtkTextLine     *line,
@@ -3770,8 +4086,12 @@ gtk_text_layout_buffer_insert_text (GtkTextBuffer *textbuffer,
 				    gpointer       data)
 {
   GtkTextLayout *layout = GTK_TEXT_LAYOUT (data);
+  GtkTextLayoutPrivate *priv = GTK_TEXT_LAYOUT_GET_PRIVATE (layout);
 
   gtk_text_layout_update_cursor_line (layout);
+
+  /* The new lines need an estimate, wherever they are */
+  priv->estimate_restart = TRUE;
 }
 
 static void
@@ -367,6 +367,8 @@ void     gtk_text_layout_validate_yrange (GtkTextLayout *layout,
 GDK_AVAILABLE_IN_ALL
 void     gtk_text_layout_validate        (GtkTextLayout *layout,
                                           gint           max_pixels);
+GDK_AVAILABLE_IN_ALL
+void     gtk_text_layout_estimate        (GtkTextLayout *layout);
 
 /* This function should return the passed-in line data,
  * OR remove the existing line data from the line, and
@@ -0,0 +1,1091 @@
+/* GTK - The GIMP Toolkit
+ * gtktextsearch.c: Incremental search in a GtkTextBuffer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtktextsearch.h"
+
+#include <string.h>
+
+#include "gtkintl.h"
+#include "gtkmarshalers.h"
+#include "gtkprivate.h"
+#include "gtktypebuiltins.h"
+
+/**
+ * SECTION:gtktextsearch
+ * @Short_description: Finds all matches of a pattern in a GtkTextBuffer
+ * @Title: GtkTextSearch
+ * @See_also: #GtkTextBuffer, gtk_text_iter_forward_search()
+ *
+ * A #GtkTextSearch keeps the positions of all matches of a search
+ * text or regular expression in a #GtkTextBuffer. It is meant for
+ * “find all” style highlighting and for stepping through matches in
+ * large buffers, where calling gtk_text_iter_forward_search() over and
+ * over again is too slow.
+ *
+ * The buffer is scanned in the background, in chunks of lines that are
+ * matched against a #GtkTextBufferSnapshot in a worker thread, so the
+ * user interface stays responsive. Matches become available chunk by
+ * chunk; the #GtkTextSearch::changed signal tells which lines got new
+ * results, and the #GtkTextSearch:scanning property is %FALSE once all
+ * of the buffer has been searched.
+ *
+ * When the buffer is edited, only the changed lines are scanned again;
+ * matches in other lines are kept and moved along with the text.
+ *
+ * Matches never span multiple lines. Of the #GtkTextSearchFlags, only
+ * %GTK_TEXT_SEARCH_CASE_INSENSITIVE is taken into account; images and
+ * child anchors are matched as the 0xFFFC character.
+ */
+
+/* Number of lines that are scanned in one go */
+#define SCAN_CHUNK_LINES 4096
+
+typedef struct
+{
+  gint line;
+  gint start;  /* byte indexes into the line */
+  gint end;
+} TextSearchMatch;
+
+typedef struct
+{
+  gint start;
+  gint end;    /* exclusive */
+} LineRange;
+
+typedef struct
+{
+  GtkTextBufferSnapshot *snapshot;
+  gint first_line;
+  gint n_lines;
+
+  GRegex *regex;
+  gchar *needle;
+  gsize needle_len;
+
+  GArray *matches;
+} ScanJob;
+
+struct _GtkTextSearch
+{
+  GObject parent_instance;
+
+  GtkTextBuffer *buffer;
+  gint n_lines;
+
+  gchar *text;
+  GtkTextSearchFlags flags;
+  GRegex *pattern;            /* NULL when matching plain text */
+
+  GArray *matches;            /* TextSearchMatch, in buffer order */
+  GArray *pending;            /* sorted, disjoint LineRanges to scan */
+
+  GCancellable *cancellable;  /* set while a chunk is scanned */
+  LineRange in_flight;
+
+  guint regex    : 1;
+  guint valid    : 1;
+  guint scanning : 1;
+};
+
+enum {
+  PROP_0,
+  PROP_BUFFER,
+  PROP_TEXT,
+  PROP_FLAGS,
+  PROP_REGEX,
+  PROP_SCANNING,
+  PROP_N_MATCHES,
+  LAST_PROP
+};
+
+enum {
+  CHANGED,
+  LAST_SIGNAL
+};
+
+static GParamSpec *search_props[LAST_PROP] = { NULL, };
+static guint search_signals[LAST_SIGNAL] = { 0 };
+
+static void gtk_text_search_queue_scan (GtkTextSearch *search);
+
+G_DEFINE_TYPE (GtkTextSearch, gtk_text_search, G_TYPE_OBJECT)
+
+static void
+scan_job_free (ScanJob *job)
+{
+  gtk_text_buffer_snapshot_unref (job->snapshot);
+  g_clear_pointer (&job->regex, g_regex_unref);
+  g_free (job->needle);
+  g_array_unref (job->matches);
+
+  g_slice_free (ScanJob, job);
+}
+
+static ScanJob *
+scan_job_new (GtkTextSearch *search,
+              gint           first_line,
+              gint           n_lines)
+{
+  ScanJob *job;
+
+  job = g_slice_new0 (ScanJob);
+  job->snapshot = gtk_text_buffer_create_snapshot (search->buffer);
+  job->first_line = first_line;
+  job->n_lines = n_lines;
+  job->matches = g_array_new (FALSE, FALSE, sizeof (TextSearchMatch));
+
+  if (search->pattern)
+    job->regex = g_regex_ref (search->pattern);
+  else
+    {
+      job->needle = g_strdup (search->text);
+      job->needle_len = strlen (search->text);
+    }
+
+  return job;
+}
+
+static void
+scan_job_add_match (ScanJob *job,
+                    gint     line,
+                    gint     start,
+                    gint     end)
+{
+  TextSearchMatch match;
+
+  match.line = job->first_line + line;
+  match.start = start;
+  match.end = end;
+  g_array_append_val (job->matches, match);
+}
+
+static void
+scan_line_plain (ScanJob     *job,
+                 gint         line,
+                 const gchar *text,
+                 gsize        len)
+{
+  const gchar *p, *end;
+
+  if (len < job->needle_len)
+    return;
+
+  /* Both the needle and the text are valid UTF-8, so a byte match
+   * always starts and ends on character boundaries.
+   */
+  p = text;
+  end = text + len - job->needle_len + 1;
+  while (p < end)
+    {
+      p = memchr (p, job->needle[0], end - p);
+      if (p == NULL)
+        break;
+
+      if (memcmp (p + 1, job->needle + 1, job->needle_len - 1) == 0)
+        {
+          scan_job_add_match (job, line, p - text, p - text + job->needle_len);
+          p += job->needle_len;
+        }
+      else
+        p++;
+    }
+}
+
+static void
+scan_line_regex (ScanJob     *job,
+                 gint         line,
+                 const gchar *text,
+                 gsize        len)
+{
+  GMatchInfo *info;
+  gint start, end;
+
+  g_regex_match_full (job->regex, text, len, 0, 0, &info, NULL);
+  while (g_match_info_matches (info))
+    {
+      if (g_match_info_fetch_pos (info, 0, &start, &end) && end > start)
+        scan_job_add_match (job, line, start, end);
+
+      g_match_info_next (info, NULL);
+    }
+  g_match_info_free (info);
+}
+
+static void
+gtk_text_search_scan_thread (GTask        *task,
+                             gpointer      source_object,
+                             gpointer      task_data,
+                             GCancellable *cancellable)
+{
+  ScanJob *job = task_data;
+  gint i;
+
+  for (i = 0; i < job->n_lines; i++)
+    {
+      const gchar *text;
+      gsize len;
+
+      if (i % 256 == 0 && g_task_return_error_if_cancelled (task))
+        return;
+
+      text = gtk_text_buffer_snapshot_get_line (job->snapshot, job->first_line + i, &len);
+
+      if (job->regex)
+        scan_line_regex (job, i, text, len);
+      else
+        scan_line_plain (job, i, text, len);
+    }
+
+  g_task_return_boolean (task, TRUE);
+}
+
+/* Returns the index of the first match in @line or a later line */
+static guint
+gtk_text_search_find_line (GtkTextSearch *search,
+                           gint           line)
+{
+  guint lo, hi, mid;
+
+  lo = 0;
+  hi = search->matches->len;
+  while (lo < hi)
+    {
+      mid = (lo + hi) / 2;
+      if (g_array_index (search->matches, TextSearchMatch, mid).line < line)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
+static void
+gtk_text_search_add_pending (GtkTextSearch *search,
+                             gint           start,
+                             gint           end)
+{
+  LineRange range;
+  guint i;
+
+  range.start = MAX (start, 0);
+  range.end = MIN (end, search->n_lines);
+  if (range.start >= range.end)
+    return;
+
+  i = 0;
+  while (i < search->pending->len &&
+         g_array_index (search->pending, LineRange, i).end < range.start)
+    i++;
+
+  while (i < search->pending->len &&
+         g_array_index (search->pending, LineRange, i).start <= range.end)
+    {
+      LineRange *other = &g_array_index (search->pending, LineRange, i);
+
+      range.start = MIN (range.start, other->start);
+      range.end = MAX (range.end, other->end);
+      g_array_remove_index (search->pending, i);
+    }
+
+  g_array_insert_val (search->pending, i, range);
+}
+
+static void
+gtk_text_search_update_scanning (GtkTextSearch *search)
+{
+  gboolean scanning;
+
+  scanning = search->cancellable != NULL || search->pending->len > 0;
+  if (search->scanning == scanning)
+    return;
+
+  search->scanning = scanning;
+  g_object_notify_by_pspec (G_OBJECT (search), search_props[PROP_SCANNING]);
+}
+
+static void
+gtk_text_search_matches_changed (GtkTextSearch *search,
+                                 gint           first_line,
+                                 gint           n_lines,
+                                 guint          old_n_matches)
+{
+  g_signal_emit (search, search_signals[CHANGED], 0, first_line, n_lines);
+
+  if (search->matches->len != old_n_matches)
+    g_object_notify_by_pspec (G_OBJECT (search), search_props[PROP_N_MATCHES]);
+}
+
+static void
+gtk_text_search_scan_done (GObject      *source,
+                           GAsyncResult *result,
+                           gpointer      user_data)
+{
+  GtkTextSearch *search = GTK_TEXT_SEARCH (source);
+  GTask *task = G_TASK (result);
+  ScanJob *job = g_task_get_task_data (task);
+  gint first_line, last_line;
+  guint old_n_matches, lo, hi;
+
+  /* A cancelled scan has been superseded by a restart or dispose */
+  if (!g_task_propagate_boolean (task, NULL) ||
+      g_task_get_cancellable (task) != search->cancellable)
+    return;
+
+  g_clear_object (&search->cancellable);
+  first_line = search->in_flight.start;
+  last_line = search->in_flight.end;
+
+  if (gtk_text_buffer_snapshot_get_version (job->snapshot) != gtk_text_buffer_get_version (search->buffer))
+    {
+      /* The buffer was edited while the snapshot was scanned. The edited
+       * lines have been queued already and in_flight was moved along
+       * with the edits, so scan what remains of the chunk again.
+       */
+      gtk_text_search_add_pending (search, first_line, last_line);
+    }
+  else
+    {
+      old_n_matches = search->matches->len;
+      lo = gtk_text_search_find_line (search, first_line);
+      hi = gtk_text_search_find_line (search, last_line);
+
+      if (hi > lo)
+        g_array_remove_range (search->matches, lo, hi - lo);
+      g_array_insert_vals (search->matches, lo, job->matches->data, job->matches->len);
+
+      if (hi > lo || job->matches->len > 0)
+        gtk_text_search_matches_changed (search, first_line, last_line - first_line, old_n_matches);
+    }
+
+  gtk_text_search_queue_scan (search);
+  gtk_text_search_update_scanning (search);
+}
+
+static void
+gtk_text_search_queue_scan (GtkTextSearch *search)
+{
+  LineRange *range;
+  ScanJob *job;
+  GTask *task;
+  gint first_line, n_lines;
+
+  /* Only one chunk is scanned at a time */
+  if (search->cancellable != NULL || search->pending->len == 0)
+    return;
+
+  range = &g_array_index (search->pending, LineRange, 0);
+  first_line = range->start;
+  n_lines = MIN (range->end - range->start, SCAN_CHUNK_LINES);
+  range->start += n_lines;
+  if (range->start == range->end)
+    g_array_remove_index (search->pending, 0);
+
+  job = scan_job_new (search, first_line, n_lines);
+
+  search->cancellable = g_cancellable_new ();
+  search->in_flight.start = first_line;
+  search->in_flight.end = first_line + n_lines;
+
+  task = g_task_new (search, search->cancellable, gtk_text_search_scan_done, NULL);
+  g_task_set_source_tag (task, gtk_text_search_queue_scan);
+  g_task_set_task_data (task, job, (GDestroyNotify) scan_job_free);
+  g_task_run_in_thread (task, gtk_text_search_scan_thread);
+  g_object_unref (task);
+}
+
+static gboolean
+gtk_text_search_compile (GtkTextSearch *search)
+{
+  GRegexCompileFlags compile_flags;
+  gchar *escaped = NULL;
+
+  if (search->text == NULL || search->text[0] == '\0')
+    return FALSE;
+
+  compile_flags = G_REGEX_OPTIMIZE;
+  if (search->flags & GTK_TEXT_SEARCH_CASE_INSENSITIVE)
+    compile_flags |= G_REGEX_CASELESS;
+  else if (!search->regex)
+    return TRUE; /* plain text is matched with memchr() */
+
+  if (!search->regex)
+    escaped = g_regex_escape_string (search->text, -1);
+
+  search->pattern = g_regex_new (escaped ? escaped : search->text, compile_flags, 0, NULL);
+  g_free (escaped);
+
+  /* An incomplete expression, as typed so far, has no matches */
+  return search->pattern != NULL;
+}
+
+static void
+gtk_text_search_restart (GtkTextSearch *search)
+{
+  guint old_n_matches;
+
+  if (search->cancellable)
+    {
+      g_cancellable_cancel (search->cancellable);
+      g_clear_object (&search->cancellable);
+    }
+
+  g_clear_pointer (&search->pattern, g_regex_unref);
+
+  old_n_matches = search->matches->len;
+  g_array_set_size (search->matches, 0);
+  g_array_set_size (search->pending, 0);
+
+  search->valid = gtk_text_search_compile (search);
+  if (search->valid)
+    gtk_text_search_add_pending (search, 0, search->n_lines);
+
+  if (old_n_matches > 0)
+    gtk_text_search_matches_changed (search, 0, search->n_lines, old_n_matches);
+
+  gtk_text_search_queue_scan (search);
+  gtk_text_search_update_scanning (search);
+}
+
+static gint
+map_line (gint line,
+          gint first_line,
+          gint old_n_lines,
+          gint new_n_lines)
+{
+  if (line <= first_line)
+    return line;
+  else if (line >= first_line + old_n_lines)
+    return line + new_n_lines - old_n_lines;
+  else
+    return first_line + new_n_lines;
+}
+
+/* Lines [first_line, first_line + old_n_lines) of the buffer have been
+ * replaced by new_n_lines lines.
+ */
+static void
+gtk_text_search_lines_changed (GtkTextSearch *search,
+                               gint           first_line,
+                               gint           old_n_lines,
+                               gint           new_n_lines)
+{
+  GArray *old_pending;
+  guint old_n_matches, lo, hi, i;
+  gint delta;
+
+  delta = new_n_lines - old_n_lines;
+  search->n_lines += delta;
+
+  old_n_matches = search->matches->len;
+  lo = gtk_text_search_find_line (search, first_line);
+  hi = gtk_text_search_find_line (search, first_line + old_n_lines);
+  if (hi > lo)
+    g_array_remove_range (search->matches, lo, hi - lo);
+  if (delta != 0)
+    {
+      for (i = lo; i < search->matches->len; i++)
+        g_array_index (search->matches, TextSearchMatch, i).line += delta;
+    }
+
+  if (search->cancellable)
+    {
+      search->in_flight.start = map_line (search->in_flight.start, first_line, old_n_lines, new_n_lines);
+      search->in_flight.end = map_line (search->in_flight.end, first_line, old_n_lines, new_n_lines);
+    }
+
+  if (search->valid)
+    {
+      old_pending = search->pending;
+      search->pending = g_array_new (FALSE, FALSE, sizeof (LineRange));
+      for (i = 0; i < old_pending->len; i++)
+        {
+          LineRange *range = &g_array_index (old_pending, LineRange, i);
+
+          gtk_text_search_add_pending (search,
+                                       map_line (range->start, first_line, old_n_lines, new_n_lines),
+                                       map_line (range->end, first_line, old_n_lines, new_n_lines));
+        }
+      g_array_unref (old_pending);
+
+      gtk_text_search_add_pending (search, first_line, first_line + new_n_lines);
+    }
+
+  if (hi > lo)
+    gtk_text_search_matches_changed (search, first_line, new_n_lines, old_n_matches);
+
+  gtk_text_search_queue_scan (search);
+  gtk_text_search_update_scanning (search);
+}
+
+static void
+gtk_text_search_insert_text (GtkTextBuffer *buffer,
+                             GtkTextIter   *location,
+                             gchar         *text,
+                             gint           len,
+                             GtkTextSearch *search)
+{
+  gint added;
+
+  /* @location has been moved to the end of the inserted text */
+  added = gtk_text_buffer_get_line_count (buffer) - search->n_lines;
+  gtk_text_search_lines_changed (search, gtk_text_iter_get_line (location) - added, 1, added + 1);
+}
+
+static void
+gtk_text_search_insert_object (GtkTextBuffer *buffer,
+                               GtkTextIter   *location,
+                               gpointer       object,
+                               GtkTextSearch *search)
+{
+  gtk_text_search_lines_changed (search, gtk_text_iter_get_line (location), 1, 1);
+}
+
+static void
+gtk_text_search_delete_range (GtkTextBuffer *buffer,
+                              GtkTextIter   *start,
+                              GtkTextIter   *end,
+                              GtkTextSearch *search)
+{
+  gint removed;
+
+  removed = search->n_lines - gtk_text_buffer_get_line_count (buffer);
+  gtk_text_search_lines_changed (search, gtk_text_iter_get_line (start), removed + 1, 1);
+}
+
+static void
+gtk_text_search_init (GtkTextSearch *search)
+{
+  search->matches = g_array_new (FALSE, FALSE, sizeof (TextSearchMatch));
+  search->pending = g_array_new (FALSE, FALSE, sizeof (LineRange));
+}
+
+static void
+gtk_text_search_constructed (GObject *object)
+{
+  GtkTextSearch *search = GTK_TEXT_SEARCH (object);
+
+  G_OBJECT_CLASS (gtk_text_search_parent_class)->constructed (object);
+
+  g_assert (search->buffer != NULL);
+
+  search->n_lines = gtk_text_buffer_get_line_count (search->buffer);
+
+  /* Connect after the default handlers, so the buffer has been
+   * changed and the iters point at the edit.
+   */
+  g_signal_connect_after (search->buffer, "insert-text",
+                          G_CALLBACK (gtk_text_search_insert_text), search);
+  g_signal_connect_after (search->buffer, "insert-texture",
+                          G_CALLBACK (gtk_text_search_insert_object), search);
+  g_signal_connect_after (search->buffer, "insert-child-anchor",
+                          G_CALLBACK (gtk_text_search_insert_object), search);
+  g_signal_connect_after (search->buffer, "delete-range",
+                          G_CALLBACK (gtk_text_search_delete_range), search);
+}
+
+static void
+gtk_text_search_dispose (GObject *object)
+{
+  GtkTextSearch *search = GTK_TEXT_SEARCH (object);
+
+  if (search->cancellable)
+    {
+      g_cancellable_cancel (search->cancellable);
+      g_clear_object (&search->cancellable);
+    }
+
+  if (search->buffer)
+    {
+      g_signal_handlers_disconnect_by_data (search->buffer, search);
+      g_clear_object (&search->buffer);
+    }
+
+  G_OBJECT_CLASS (gtk_text_search_parent_class)->dispose (object);
+}
+
+static void
+gtk_text_search_finalize (GObject *object)
+{
+  GtkTextSearch *search = GTK_TEXT_SEARCH (object);
+
+  g_free (search->text);
+  g_clear_pointer (&search->pattern, g_regex_unref);
+  g_array_unref (search->matches);
+  g_array_unref (search->pending);
+
+  G_OBJECT_CLASS (gtk_text_search_parent_class)->finalize (object);
+}
+
+static void
+gtk_text_search_set_property (GObject      *object,
+                              guint         prop_id,
+                              const GValue *value,
+                              GParamSpec   *pspec)
+{
+  GtkTextSearch *search = GTK_TEXT_SEARCH (object);
+
+  switch (prop_id)
+    {
+    case PROP_BUFFER:
+      search->buffer = g_value_dup_object (value);
+      break;
+
+    case PROP_TEXT:
+      gtk_text_search_set_text (search, g_value_get_string (value));
+      break;
+
+    case PROP_FLAGS:
+      gtk_text_search_set_flags (search, g_value_get_flags (value));
+      break;
+
+    case PROP_REGEX:
+      gtk_text_search_set_regex (search, g_value_get_boolean (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+gtk_text_search_get_property (GObject    *object,
+                              guint       prop_id,
+                              GValue     *value,
+                              GParamSpec *pspec)
+{
+  GtkTextSearch *search = GTK_TEXT_SEARCH (object);
+
+  switch (prop_id)
+    {
+    case PROP_BUFFER:
+      g_value_set_object (value, search->buffer);
+      break;
+
+    case PROP_TEXT:
+      g_value_set_string (value, search->text);
+      break;
+
+    case PROP_FLAGS:
+      g_value_set_flags (value, search->flags);
+      break;
+
+    case PROP_REGEX:
+      g_value_set_boolean (value, search->regex);
+      break;
+
+    case PROP_SCANNING:
+      g_value_set_boolean (value, search->scanning);
+      break;
+
+    case PROP_N_MATCHES:
+      g_value_set_uint (value, search->matches->len);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+gtk_text_search_class_init (GtkTextSearchClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->constructed = gtk_text_search_constructed;
+  object_class->dispose = gtk_text_search_dispose;
+  object_class->finalize = gtk_text_search_finalize;
+  object_class->set_property = gtk_text_search_set_property;
+  object_class->get_property = gtk_text_search_get_property;
+
+  search_props[PROP_BUFFER] =
+      g_param_spec_object ("buffer",
+                           P_("Buffer"),
+                           P_("The buffer that is searched"),
+                           GTK_TYPE_TEXT_BUFFER,
+                           GTK_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+
+  search_props[PROP_TEXT] =
+      g_param_spec_string ("text",
+                           P_("Text"),
+                           P_("The text or regular expression to search for"),
+                           NULL,
+                           GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
+  search_props[PROP_FLAGS] =
+      g_param_spec_flags ("flags",
+                          P_("Flags"),
+                          P_("Flags affecting how the search is done"),
+                          GTK_TYPE_TEXT_SEARCH_FLAGS,
+                          0,
+                          GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
+  search_props[PROP_REGEX] =
+      g_param_spec_boolean ("regex",
+                            P_("Regex"),
+                            P_("Whether the text is a regular expression"),
+                            FALSE,
+                            GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
+  search_props[PROP_SCANNING] =
+      g_param_spec_boolean ("scanning",
+                            P_("Scanning"),
+                            P_("Whether parts of the buffer still need to be searched"),
+                            FALSE,
+                            GTK_PARAM_READABLE);
+
+  search_props[PROP_N_MATCHES] =
+      g_param_spec_uint ("n-matches",
+                         P_("Number of matches"),
+                         P_("The number of matches found so far"),
+                         0, G_MAXUINT, 0,
+                         GTK_PARAM_READABLE);
+
+  g_object_class_install_properties (object_class, LAST_PROP, search_props);
+
+  /**
+   * GtkTextSearch::changed:
+   * @search: the object which received the signal
+   * @first_line: the first line with changed matches
+   * @n_lines: the number of lines with changed matches
+   *
+   * Emitted when the matches in a range of lines have changed, either
+   * because a part of the buffer has been scanned or because matches
+   * were removed by an edit of the buffer.
+   */
+  search_signals[CHANGED] =
+    g_signal_new (I_("changed"),
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST,
+                  0,
+                  NULL, NULL,
+                  _gtk_marshal_VOID__INT_INT,
+                  G_TYPE_NONE, 2, G_TYPE_INT, G_TYPE_INT);
+}
+
+/**
+ * gtk_text_search_new:
+ * @buffer: a #GtkTextBuffer
+ *
+ * Creates a new #GtkTextSearch for @buffer. Nothing is searched
+ * until a text has been set with gtk_text_search_set_text().
+ *
+ * Returns: a new #GtkTextSearch
+ */
+GtkTextSearch *
+gtk_text_search_new (GtkTextBuffer *buffer)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_BUFFER (buffer), NULL);
+
+  return g_object_new (GTK_TYPE_TEXT_SEARCH,
+                       "buffer", buffer,
+                       NULL);
+}
+
+/**
+ * gtk_text_search_get_buffer:
+ * @search: a #GtkTextSearch
+ *
+ * Gets the buffer that @search is bound to.
+ *
+ * Returns: (transfer none): the #GtkTextBuffer
+ */
+GtkTextBuffer *
+gtk_text_search_get_buffer (GtkTextSearch *search)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_SEARCH (search), NULL);
+
+  return search->buffer;
+}
+
+/**
+ * gtk_text_search_set_text:
+ * @search: a #GtkTextSearch
+ * @text: (allow-none): the text to search for, or %NULL
+ *
+ * Sets the text to search for. If #GtkTextSearch:regex is %TRUE,
+ * @text is a regular expression in the syntax of #GRegex.
+ *
+ * All matches are dropped and the buffer is scanned again.
+ */
+void
+gtk_text_search_set_text (GtkTextSearch *search,
+                          const gchar   *text)
+{
+  g_return_if_fail (GTK_IS_TEXT_SEARCH (search));
+
+  if (g_strcmp0 (search->text, text) == 0)
+    return;
+
+  g_free (search->text);
+  search->text = g_strdup (text);
+
+  gtk_text_search_restart (search);
+  g_object_notify_by_pspec (G_OBJECT (search), search_props[PROP_TEXT]);
+}
+
+/**
+ * gtk_text_search_get_text:
+ * @search: a #GtkTextSearch
+ *
+ * Gets the text that is searched for.
+ *
+ * Returns: (nullable): the search text
+ */
+const gchar *
+gtk_text_search_get_text (GtkTextSearch *search)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_SEARCH (search), NULL);
+
+  return search->text;
+}
+
+/**
+ * gtk_text_search_set_flags:
+ * @search: a #GtkTextSearch
+ * @flags: #GtkTextSearchFlags
+ *
+ * Sets the flags affecting the search. Only
+ * %GTK_TEXT_SEARCH_CASE_INSENSITIVE is supported.
+ */
+void
+gtk_text_search_set_flags (GtkTextSearch      *search,
+                           GtkTextSearchFlags  flags)
+{
+  g_return_if_fail (GTK_IS_TEXT_SEARCH (search));
+
+  if (search->flags == flags)
+    return;
+
+  search->flags = flags;
+
+  gtk_text_search_restart (search);
+  g_object_notify_by_pspec (G_OBJECT (search), search_props[PROP_FLAGS]);
+}
+
+/**
+ * gtk_text_search_get_flags:
+ * @search: a #GtkTextSearch
+ *
+ * Gets the flags set with gtk_text_search_set_flags().
+ *
+ * Returns: the search flags
+ */
+GtkTextSearchFlags
+gtk_text_search_get_flags (GtkTextSearch *search)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_SEARCH (search), 0);
+
+  return search->flags;
+}
+
+/**
+ * gtk_text_search_set_regex:
+ * @search: a #GtkTextSearch
+ * @regex: %TRUE to treat the search text as a regular expression
+ *
+ * Sets whether the search text is a regular expression. An
+ * expression that fails to compile has no matches.
+ */
+void
+gtk_text_search_set_regex (GtkTextSearch *search,
+                           gboolean       regex)
+{
+  g_return_if_fail (GTK_IS_TEXT_SEARCH (search));
+
+  regex = regex != FALSE;
+
+  if (search->regex == regex)
+    return;
+
+  search->regex = regex;
+
+  gtk_text_search_restart (search);
+  g_object_notify_by_pspec (G_OBJECT (search), search_props[PROP_REGEX]);
+}
+
+/**
+ * gtk_text_search_get_regex:
+ * @search: a #GtkTextSearch
+ *
+ * Gets whether the search text is a regular expression.
+ *
+ * Returns: %TRUE if the search text is a regular expression
+ */
+gboolean
+gtk_text_search_get_regex (GtkTextSearch *search)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_SEARCH (search), FALSE);
+
+  return search->regex;
+}
+
+/**
+ * gtk_text_search_get_scanning:
+ * @search: a #GtkTextSearch
+ *
+ * Gets whether parts of the buffer are still being searched.
+ * While this is %TRUE, the matches returned by @search may be
+ * incomplete.
+ *
+ * Returns: %TRUE if the search is not complete yet
+ */
+gboolean
+gtk_text_search_get_scanning (GtkTextSearch *search)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_SEARCH (search), FALSE);
+
+  return search->scanning;
+}
+
+/**
+ * gtk_text_search_get_n_matches:
+ * @search: a #GtkTextSearch
+ *
+ * Gets the number of matches found so far.
+ *
+ * Returns: the number of matches
+ */
+guint
+gtk_text_search_get_n_matches (GtkTextSearch *search)
+{
+  g_return_val_if_fail (GTK_IS_TEXT_SEARCH (search), 0);
+
+  return search->matches->len;
+}
+
+static void
+gtk_text_search_get_match (GtkTextSearch *search,
+                           guint          index,
+                           GtkTextIter   *match_start,
+                           GtkTextIter   *match_end)
+{
+  TextSearchMatch *match = &g_array_index (search->matches, TextSearchMatch, index);
+
+  if (match_start)
+    gtk_text_buffer_get_iter_at_line_index (search->buffer, match_start, match->line, match->start);
+  if (match_end)
+    gtk_text_buffer_get_iter_at_line_index (search->buffer, match_end, match->line, match->end);
+}
+
+/**
+ * gtk_text_search_forward:
+ * @search: a #GtkTextSearch
+ * @iter: start of search
+ * @match_start: (out caller-allocates) (allow-none): return location for start of match, or %NULL
+ * @match_end: (out caller-allocates) (allow-none): return location for end of match, or %NULL
+ *
+ * Finds the first match that starts at or after @iter. Unlike
+ * gtk_text_iter_forward_search(), this only looks at the matches
+ * found so far and does not scan the buffer.
+ *
+ * Returns: whether a match was found
+ */
+gboolean
+gtk_text_search_forward (GtkTextSearch     *search,
+                         const GtkTextIter *iter,
+                         GtkTextIter       *match_start,
+                         GtkTextIter       *match_end)
+{
+  gint line, index;
+  guint lo, hi, mid;
+
+  g_return_val_if_fail (GTK_IS_TEXT_SEARCH (search), FALSE);
+  g_return_val_if_fail (iter != NULL, FALSE);
+  g_return_val_if_fail (gtk_text_iter_get_buffer (iter) == search->buffer, FALSE);
+
+  line = gtk_text_iter_get_line (iter);
+  index = gtk_text_iter_get_line_index (iter);
+
+  lo = 0;
+  hi = search->matches->len;
+  while (lo < hi)
+    {
+      TextSearchMatch *match;
+
+      mid = (lo + hi) / 2;
+      match = &g_array_index (search->matches, TextSearchMatch, mid);
+      if (match->line < line || (match->line == line && match->start < index))
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  if (lo == search->matches->len)
+    return FALSE;
+
+  gtk_text_search_get_match (search, lo, match_start, match_end);
+
+  return TRUE;
+}
+
+/**
+ * gtk_text_search_backward:
+ * @search: a #GtkTextSearch
+ * @iter: start of search
+ * @match_start: (out caller-allocates) (allow-none): return location for start of match, or %NULL
+ * @match_end: (out caller-allocates) (allow-none): return location for end of match, or %NULL
+ *
+ * Finds the last match that ends at or before @iter. Like
+ * gtk_text_search_forward(), this only looks at the matches
+ * found so far.
+ *
+ * Returns: whether a match was found
+ */
+gboolean
+gtk_text_search_backward (GtkTextSearch     *search,
+                          const GtkTextIter *iter,
+                          GtkTextIter       *match_start,
+                          GtkTextIter       *match_end)
+{
+  gint line, index;
+  guint lo, hi, mid;
+
+  g_return_val_if_fail (GTK_IS_TEXT_SEARCH (search), FALSE);
+  g_return_val_if_fail (iter != NULL, FALSE);
+  g_return_val_if_fail (gtk_text_iter_get_buffer (iter) == search->buffer, FALSE);
+
+  line = gtk_text_iter_get_line (iter);
+  index = gtk_text_iter_get_line_index (iter);
+
+  /* Matches don't overlap, so they are ordered by their ends as well */
+  lo = 0;
+  hi = search->matches->len;
+  while (lo < hi)
+    {
+      TextSearchMatch *match;
+
+      mid = (lo + hi) / 2;
+      match = &g_array_index (search->matches, TextSearchMatch, mid);
+      if (match->line < line || (match->line == line && match->end <= index))
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  if (lo == 0)
+    return FALSE;
+
+  gtk_text_search_get_match (search, lo - 1, match_start, match_end);
+
+  return TRUE;
+}
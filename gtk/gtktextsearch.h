@@ -0,0 +1,74 @@
+/* GTK - The GIMP Toolkit
+ * gtktextsearch.h: Incremental search in a GtkTextBuffer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GTK_TEXT_SEARCH_H__
+#define __GTK_TEXT_SEARCH_H__
+
+#if !defined (__GTK_H_INSIDE__) && !defined (GTK_COMPILATION)
+#error "Only <gtk/gtk.h> can be included directly."
+#endif
+
+#include <gtk/gtktextbuffer.h>
+
+G_BEGIN_DECLS
+
+#define GTK_TYPE_TEXT_SEARCH             (gtk_text_search_get_type ())
+
+GDK_AVAILABLE_IN_ALL
+G_DECLARE_FINAL_TYPE (GtkTextSearch, gtk_text_search, GTK, TEXT_SEARCH, GObject)
+
+GDK_AVAILABLE_IN_ALL
+GtkTextSearch      *gtk_text_search_new          (GtkTextBuffer      *buffer);
+
+GDK_AVAILABLE_IN_ALL
+GtkTextBuffer      *gtk_text_search_get_buffer   (GtkTextSearch      *search);
+
+GDK_AVAILABLE_IN_ALL
+void                gtk_text_search_set_text     (GtkTextSearch      *search,
+                                                  const gchar        *text);
+GDK_AVAILABLE_IN_ALL
+const gchar        *gtk_text_search_get_text     (GtkTextSearch      *search);
+GDK_AVAILABLE_IN_ALL
+void                gtk_text_search_set_flags    (GtkTextSearch      *search,
+                                                  GtkTextSearchFlags  flags);
+GDK_AVAILABLE_IN_ALL
+GtkTextSearchFlags  gtk_text_search_get_flags    (GtkTextSearch      *search);
+GDK_AVAILABLE_IN_ALL
+void                gtk_text_search_set_regex    (GtkTextSearch      *search,
+                                                  gboolean            regex);
+GDK_AVAILABLE_IN_ALL
+gboolean            gtk_text_search_get_regex    (GtkTextSearch      *search);
+
+GDK_AVAILABLE_IN_ALL
+gboolean            gtk_text_search_get_scanning (GtkTextSearch      *search);
+GDK_AVAILABLE_IN_ALL
+guint               gtk_text_search_get_n_matches (GtkTextSearch     *search);
+
+GDK_AVAILABLE_IN_ALL
+gboolean            gtk_text_search_forward      (GtkTextSearch      *search,
+                                                  const GtkTextIter  *iter,
+                                                  GtkTextIter        *match_start,
+                                                  GtkTextIter        *match_end);
+GDK_AVAILABLE_IN_ALL
+gboolean            gtk_text_search_backward     (GtkTextSearch      *search,
+                                                  const GtkTextIter  *iter,
+                                                  GtkTextIter        *match_start,
+                                                  GtkTextIter        *match_end);
+
+G_END_DECLS
+
+#endif /* __GTK_TEXT_SEARCH_H__ */
@@ -49,6 +49,7 @@ struct _GtkTextTagInfo {
   GtkTextTag *tag;
   GtkTextBTreeNode *tag_root; /* highest-level node containing the tag */
   gint toggle_count;      /* total toggles of this tag below tag_root */
+  guint bit;              /* index of the tag in the node tag bitsets */
 };
 
 /* Body of a segment that toggles a tag on or off */
@@ -4335,6 +4335,7 @@ incremental_validate_callback (gpointer data)
 
   DV(g_print(G_STRLOC"\n"));
   
+  gtk_text_layout_estimate (text_view->priv->layout);
   gtk_text_layout_validate (text_view->priv->layout, 2000);
 
   gtk_text_view_update_adjustments (text_view);
@@ -7671,6 +7672,9 @@ gtk_text_view_destroy_layout (GtkTextView *text_view)
       gtk_text_view_stop_cursor_blink (text_view);
       gtk_text_view_end_selection_drag (text_view);
 
+      /* Stops the size estimation, which holds references on the layout */
+      gtk_text_layout_set_buffer (priv->layout, NULL);
+
       g_object_unref (priv->layout);
       priv->layout = NULL;
     }
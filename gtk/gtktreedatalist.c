@@ -464,6 +464,363 @@ _gtk_tree_data_list_compare_func (GtkTreeModel *model,
 }
 
 
+/* Sorting by key
+ *
+ * Instead of calling _gtk_tree_data_list_compare_func() O(n log n)
+ * times, which fetches two GValues and collates two strings every
+ * time, the values are fetched once per row into an array of keys.
+ * Strings are turned into collation keys, so comparing them is a
+ * strcmp(). Big arrays are split into chunks that are sorted in
+ * worker threads and merged afterwards.
+ */
+
+/* Below this, threads cost more than they save */
+#define SORT_MIN_ROWS_PER_THREAD 16384
+#define SORT_MAX_THREADS 8
+
+typedef enum {
+  SORT_KEY_SIGNED,
+  SORT_KEY_UNSIGNED,
+  SORT_KEY_DOUBLE,
+  SORT_KEY_STRING
+} SortKeyType;
+
+typedef struct {
+  union {
+    gint64   v_int64;
+    guint64  v_uint64;
+    gdouble  v_double;
+    gchar   *v_string;
+  } key;
+  gint index;
+} SortKey;
+
+typedef struct {
+  SortKeyType type;
+  gboolean descending;
+  gboolean borrowed_strings;  /* string keys are not owned by the keys */
+} SortKeyInfo;
+
+typedef struct {
+  SortKey *keys;
+  gint n_keys;
+  const SortKeyInfo *info;
+} SortChunk;
+
+static gboolean
+sort_key_type_for_column (GType        type,
+                          SortKeyType *key_type)
+{
+  switch (get_fundamental_type (type))
+    {
+    case G_TYPE_BOOLEAN:
+    case G_TYPE_CHAR:
+    case G_TYPE_INT:
+    case G_TYPE_LONG:
+    case G_TYPE_INT64:
+    case G_TYPE_ENUM:
+      *key_type = SORT_KEY_SIGNED;
+      return TRUE;
+    case G_TYPE_UCHAR:
+    case G_TYPE_UINT:
+    case G_TYPE_ULONG:
+    case G_TYPE_UINT64:
+    case G_TYPE_FLAGS:
+      *key_type = SORT_KEY_UNSIGNED;
+      return TRUE;
+    case G_TYPE_FLOAT:
+    case G_TYPE_DOUBLE:
+      *key_type = SORT_KEY_DOUBLE;
+      return TRUE;
+    case G_TYPE_STRING:
+      *key_type = SORT_KEY_STRING;
+      return TRUE;
+    default:
+      return FALSE;
+    }
+}
+
+static void
+sort_key_init (SortKey      *key,
+               const GValue *value)
+{
+  switch (get_fundamental_type (G_VALUE_TYPE (value)))
+    {
+    case G_TYPE_BOOLEAN:
+      key->key.v_int64 = g_value_get_boolean (value);
+      break;
+    case G_TYPE_CHAR:
+      key->key.v_int64 = g_value_get_schar (value);
+      break;
+    case G_TYPE_INT:
+      key->key.v_int64 = g_value_get_int (value);
+      break;
+    case G_TYPE_LONG:
+      key->key.v_int64 = g_value_get_long (value);
+      break;
+    case G_TYPE_INT64:
+      key->key.v_int64 = g_value_get_int64 (value);
+      break;
+    case G_TYPE_ENUM:
+      key->key.v_int64 = g_value_get_enum (value);
+      break;
+    case G_TYPE_UCHAR:
+      key->key.v_uint64 = g_value_get_uchar (value);
+      break;
+    case G_TYPE_UINT:
+      key->key.v_uint64 = g_value_get_uint (value);
+      break;
+    case G_TYPE_ULONG:
+      key->key.v_uint64 = g_value_get_ulong (value);
+      break;
+    case G_TYPE_UINT64:
+      key->key.v_uint64 = g_value_get_uint64 (value);
+      break;
+    case G_TYPE_FLAGS:
+      key->key.v_uint64 = g_value_get_flags (value);
+      break;
+    case G_TYPE_FLOAT:
+      key->key.v_double = g_value_get_float (value);
+      break;
+    case G_TYPE_DOUBLE:
+      key->key.v_double = g_value_get_double (value);
+      break;
+    case G_TYPE_STRING:
+      /* Turned into a collation key by sort_chunk() */
+      key->key.v_string = g_value_dup_string (value);
+      break;
+    default:
+      g_assert_not_reached ();
+    }
+}
+
+static gint
+sort_key_compare (gconstpointer a,
+                  gconstpointer b,
+                  gpointer      user_data)
+{
+  const SortKey *ka = a;
+  const SortKey *kb = b;
+  const SortKeyInfo *info = user_data;
+  gint retval;
+
+  switch (info->type)
+    {
+    case SORT_KEY_SIGNED:
+      retval = (ka->key.v_int64 > kb->key.v_int64) - (ka->key.v_int64 < kb->key.v_int64);
+      break;
+    case SORT_KEY_UNSIGNED:
+      retval = (ka->key.v_uint64 > kb->key.v_uint64) - (ka->key.v_uint64 < kb->key.v_uint64);
+      break;
+    case SORT_KEY_DOUBLE:
+      retval = (ka->key.v_double > kb->key.v_double) - (ka->key.v_double < kb->key.v_double);
+      break;
+    case SORT_KEY_STRING:
+      retval = strcmp (ka->key.v_string, kb->key.v_string);
+      break;
+    default:
+      g_assert_not_reached ();
+      retval = 0;
+    }
+
+  if (info->descending)
+    retval = -retval;
+
+  /* Keep equal rows in their current order */
+  if (retval == 0)
+    retval = (ka->index > kb->index) - (ka->index < kb->index);
+
+  return retval;
+}
+
+static gpointer
+sort_chunk (gpointer data)
+{
+  SortChunk *chunk = data;
+  gint i;
+
+  if (chunk->info->type == SORT_KEY_STRING)
+    {
+      for (i = 0; i < chunk->n_keys; i++)
+        {
+          gchar *str = chunk->keys[i].key.v_string;
+
+          /* Same as g_utf8_collate(), which is what
+           * _gtk_tree_data_list_compare_func() uses.
+           */
+          chunk->keys[i].key.v_string = g_utf8_collate_key (str ? str : "", -1);
+          if (!chunk->info->borrowed_strings)
+            g_free (str);
+        }
+    }
+
+  g_qsort_with_data (chunk->keys, chunk->n_keys, sizeof (SortKey),
+                     sort_key_compare, (gpointer) chunk->info);
+
+  return NULL;
+}
+
+static void
+sort_merge (const SortKey     *a,
+            gint               n_a,
+            const SortKey     *b,
+            gint               n_b,
+            SortKey           *out,
+            const SortKeyInfo *info)
+{
+  gint i = 0, j = 0, k = 0;
+
+  while (i < n_a && j < n_b)
+    {
+      if (sort_key_compare (&b[j], &a[i], (gpointer) info) < 0)
+        out[k++] = b[j++];
+      else
+        out[k++] = a[i++];
+    }
+
+  memcpy (out + k, a + i, (n_a - i) * sizeof (SortKey));
+  k += n_a - i;
+  memcpy (out + k, b + j, (n_b - j) * sizeof (SortKey));
+}
+
+static void
+sort_keys (SortKey           *keys,
+           gint               n_keys,
+           const SortKeyInfo *info)
+{
+  SortChunk chunks[SORT_MAX_THREADS];
+  GThread *threads[SORT_MAX_THREADS];
+  SortKey *tmp, *tmp_swap, *src, *dest;
+  gint n_chunks, i, width;
+
+  n_chunks = MIN (g_get_num_processors (), SORT_MAX_THREADS);
+  n_chunks = MIN (n_chunks, n_keys / SORT_MIN_ROWS_PER_THREAD);
+
+  if (n_chunks <= 1)
+    {
+      SortChunk chunk = { keys, n_keys, info };
+
+      sort_chunk (&chunk);
+      return;
+    }
+
+  for (i = 0; i < n_chunks; i++)
+    {
+      gint start = (gint64) n_keys * i / n_chunks;
+      gint end = (gint64) n_keys * (i + 1) / n_chunks;
+
+      chunks[i].keys = keys + start;
+      chunks[i].n_keys = end - start;
+      chunks[i].info = info;
+    }
+
+  /* The first chunk is sorted by this thread */
+  for (i = 1; i < n_chunks; i++)
+    threads[i] = g_thread_new ("gtk-sort", sort_chunk, &chunks[i]);
+  sort_chunk (&chunks[0]);
+  for (i = 1; i < n_chunks; i++)
+    g_thread_join (threads[i]);
+
+  /* Merge neighbouring chunks until only one is left */
+  tmp = g_new (SortKey, n_keys);
+  src = keys;
+  dest = tmp;
+  for (width = 1; width < n_chunks; width *= 2)
+    {
+      for (i = 0; i < n_chunks; i += 2 * width)
+        {
+          SortKey *a = src + (chunks[i].keys - keys);
+          gint n_a = 0, n_b = 0, j;
+
+          for (j = i; j < MIN (i + width, n_chunks); j++)
+            n_a += chunks[j].n_keys;
+          for (j = i + width; j < MIN (i + 2 * width, n_chunks); j++)
+            n_b += chunks[j].n_keys;
+
+          sort_merge (a, n_a, a + n_a, n_b, dest + (chunks[i].keys - keys), info);
+        }
+
+      tmp_swap = src;
+      src = dest;
+      dest = tmp_swap;
+    }
+
+  if (src != keys)
+    memcpy (keys, src, n_keys * sizeof (SortKey));
+  g_free (tmp);
+}
+
+/* Sorts @keys and frees them, returning the order */
+static gint *
+sort_keys_to_order (SortKey           *keys,
+                    gint               n_keys,
+                    const SortKeyInfo *info)
+{
+  gint *new_order;
+  gint i;
+
+  sort_keys (keys, n_keys, info);
+
+  new_order = g_new (gint, n_keys);
+  for (i = 0; i < n_keys; i++)
+    {
+      new_order[i] = keys[i].index;
+      if (info->type == SORT_KEY_STRING)
+        g_free (keys[i].key.v_string);
+    }
+  g_free (keys);
+
+  return new_order;
+}
+
+/*
+ * _gtk_tree_data_list_sort_by_key:
+ * @model: the model the rows belong to
+ * @column: the column to sort by
+ * @order: the sort order
+ * @iters: iters for the rows to sort
+ * @n_iters: the number of rows
+ *
+ * Sorts the rows in @iters the same way sorting with
+ * _gtk_tree_data_list_compare_func() and @column as user data would,
+ * keeping rows that compare equal in their current order.
+ *
+ * Returns: (nullable): a newly allocated array that contains the
+ *     index into @iters of each row in sorted order, or %NULL if the
+ *     type of @column can't be sorted by key
+ */
+gint *
+_gtk_tree_data_list_sort_by_key (GtkTreeModel *model,
+                                 gint          column,
+                                 GtkSortType   order,
+                                 GtkTreeIter  *iters,
+                                 gint          n_iters)
+{
+  SortKeyInfo info;
+  SortKey *keys;
+  gint i;
+
+  if (!sort_key_type_for_column (gtk_tree_model_get_column_type (model, column), &info.type))
+    return NULL;
+
+  info.descending = order == GTK_SORT_DESCENDING;
+  info.borrowed_strings = FALSE;
+
+  /* Models can only be used from this thread, so fetch all values first */
+  keys = g_new (SortKey, n_iters);
+  for (i = 0; i < n_iters; i++)
+    {
+      GValue value = G_VALUE_INIT;
+
+      gtk_tree_model_get_value (model, &iters[i], column, &value);
+      sort_key_init (&keys[i], &value);
+      keys[i].index = i;
+      g_value_unset (&value);
+    }
+
+  return sort_keys_to_order (keys, n_iters, &info);
+}
+
 GList *
 _gtk_tree_data_list_header_new (gint   n_columns,
 				GType *types)
@@ -570,3 +927,512 @@ _gtk_tree_data_list_set_header (GList                  *header_list,
 
   return header_list;
 }
+
+
+/* Column storage
+ *
+ * An alternative to a GtkTreeDataList per row: every column is one
+ * contiguous array of cells of its own type, indexed by row. Rows are
+ * handed out by _gtk_tree_data_columns_add_row() and recycled after
+ * _gtk_tree_data_columns_remove_row(), so the row number of a row
+ * never changes and the store can keep it in its GSequence.
+ *
+ * Strings are interned per GtkTreeDataColumns, so a column with many
+ * repeated values holds every distinct string only once.
+ */
+
+typedef struct
+{
+  GType type;
+  GType fundamental;
+  gsize cell_size;
+  guint8 *cells;
+} GtkTreeDataColumn;
+
+struct _GtkTreeDataColumns
+{
+  GtkTreeDataColumn *columns;
+  gint n_columns;
+
+  guint n_rows;         /* rows handed out so far, including free ones */
+  guint n_allocated;
+  GArray *free_rows;
+
+  GHashTable *strings;  /* interned string -> reference count */
+};
+
+#define COLUMN_CELL(column, row) ((gpointer) ((column)->cells + (gsize) (row) * (column)->cell_size))
+
+static gsize
+column_cell_size (GType fundamental)
+{
+  switch (fundamental)
+    {
+    case G_TYPE_BOOLEAN:
+    case G_TYPE_CHAR:
+    case G_TYPE_UCHAR:
+    case G_TYPE_INT:
+    case G_TYPE_UINT:
+    case G_TYPE_ENUM:
+    case G_TYPE_FLAGS:
+      return sizeof (gint);
+    case G_TYPE_LONG:
+    case G_TYPE_ULONG:
+      return sizeof (glong);
+    case G_TYPE_INT64:
+    case G_TYPE_UINT64:
+      return sizeof (gint64);
+    case G_TYPE_FLOAT:
+      return sizeof (gfloat);
+    case G_TYPE_DOUBLE:
+      return sizeof (gdouble);
+    default:
+      return sizeof (gpointer);
+    }
+}
+
+static const gchar *
+columns_intern_string (GtkTreeDataColumns *columns,
+                       const gchar        *str)
+{
+  gpointer key, count;
+
+  if (str == NULL)
+    return NULL;
+
+  if (g_hash_table_lookup_extended (columns->strings, str, &key, &count))
+    {
+      g_hash_table_insert (columns->strings, key, GUINT_TO_POINTER (GPOINTER_TO_UINT (count) + 1));
+      return key;
+    }
+
+  key = g_strdup (str);
+  g_hash_table_insert (columns->strings, key, GUINT_TO_POINTER (1));
+
+  return key;
+}
+
+static void
+columns_release_string (GtkTreeDataColumns *columns,
+                        const gchar        *str)
+{
+  guint count;
+
+  if (str == NULL)
+    return;
+
+  count = GPOINTER_TO_UINT (g_hash_table_lookup (columns->strings, str));
+  if (count > 1)
+    g_hash_table_insert (columns->strings, (gpointer) str, GUINT_TO_POINTER (count - 1));
+  else
+    g_hash_table_remove (columns->strings, str);
+}
+
+static void
+column_clear_cell (GtkTreeDataColumns *columns,
+                   GtkTreeDataColumn  *column,
+                   guint               row)
+{
+  gpointer cell = COLUMN_CELL (column, row);
+  gpointer p;
+
+  switch (column->fundamental)
+    {
+    case G_TYPE_STRING:
+      columns_release_string (columns, *(const gchar **) cell);
+      break;
+    case G_TYPE_OBJECT:
+      p = *(gpointer *) cell;
+      if (p)
+        g_object_unref (p);
+      break;
+    case G_TYPE_BOXED:
+      p = *(gpointer *) cell;
+      if (p)
+        g_boxed_free (column->type, p);
+      break;
+    case G_TYPE_VARIANT:
+      p = *(gpointer *) cell;
+      if (p)
+        g_variant_unref (p);
+      break;
+    default:
+      break;
+    }
+
+  memset (cell, 0, column->cell_size);
+}
+
+GtkTreeDataColumns *
+_gtk_tree_data_columns_new (gint   n_columns,
+                            GType *types)
+{
+  GtkTreeDataColumns *columns;
+  gint i;
+
+  columns = g_new0 (GtkTreeDataColumns, 1);
+  columns->n_columns = n_columns;
+  columns->columns = g_new0 (GtkTreeDataColumn, n_columns);
+  columns->free_rows = g_array_new (FALSE, FALSE, sizeof (guint));
+  columns->strings = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+  for (i = 0; i < n_columns; i++)
+    {
+      columns->columns[i].type = types[i];
+      columns->columns[i].fundamental = get_fundamental_type (types[i]);
+      columns->columns[i].cell_size = column_cell_size (columns->columns[i].fundamental);
+    }
+
+  return columns;
+}
+
+void
+_gtk_tree_data_columns_free (GtkTreeDataColumns *columns)
+{
+  guint row;
+  gint i;
+
+  for (i = 0; i < columns->n_columns; i++)
+    {
+      GtkTreeDataColumn *column = &columns->columns[i];
+
+      if (column->fundamental == G_TYPE_OBJECT ||
+          column->fundamental == G_TYPE_BOXED ||
+          column->fundamental == G_TYPE_VARIANT)
+        {
+          for (row = 0; row < columns->n_rows; row++)
+            column_clear_cell (columns, column, row);
+        }
+
+      g_free (column->cells);
+    }
+
+  /* all strings go at once */
+  g_hash_table_unref (columns->strings);
+  g_array_unref (columns->free_rows);
+  g_free (columns->columns);
+  g_free (columns);
+}
+
+guint
+_gtk_tree_data_columns_add_row (GtkTreeDataColumns *columns)
+{
+  gint i;
+
+  if (columns->free_rows->len > 0)
+    {
+      guint row = g_array_index (columns->free_rows, guint, columns->free_rows->len - 1);
+
+      g_array_set_size (columns->free_rows, columns->free_rows->len - 1);
+
+      return row;
+    }
+
+  if (columns->n_rows == columns->n_allocated)
+    {
+      guint n_allocated = MAX (64, columns->n_allocated * 2);
+
+      for (i = 0; i < columns->n_columns; i++)
+        {
+          GtkTreeDataColumn *column = &columns->columns[i];
+
+          column->cells = g_realloc_n (column->cells, n_allocated, column->cell_size);
+          memset (COLUMN_CELL (column, columns->n_allocated), 0,
+                  (n_allocated - columns->n_allocated) * column->cell_size);
+        }
+
+      columns->n_allocated = n_allocated;
+    }
+
+  return columns->n_rows++;
+}
+
+void
+_gtk_tree_data_columns_remove_row (GtkTreeDataColumns *columns,
+                                   guint               row)
+{
+  gint i;
+
+  g_return_if_fail (row < columns->n_rows);
+
+  for (i = 0; i < columns->n_columns; i++)
+    column_clear_cell (columns, &columns->columns[i], row);
+
+  g_array_append_val (columns->free_rows, row);
+}
+
+void
+_gtk_tree_data_columns_get_value (GtkTreeDataColumns *columns,
+                                  guint               row,
+                                  gint                column_id,
+                                  GValue             *value)
+{
+  GtkTreeDataColumn *column = &columns->columns[column_id];
+  gpointer cell = COLUMN_CELL (column, row);
+
+  g_value_init (value, column->type);
+
+  switch (column->fundamental)
+    {
+    case G_TYPE_BOOLEAN:
+      g_value_set_boolean (value, *(gint *) cell);
+      break;
+    case G_TYPE_CHAR:
+      g_value_set_schar (value, (gint8) *(gint *) cell);
+      break;
+    case G_TYPE_UCHAR:
+      g_value_set_uchar (value, (guchar) *(gint *) cell);
+      break;
+    case G_TYPE_INT:
+      g_value_set_int (value, *(gint *) cell);
+      break;
+    case G_TYPE_UINT:
+      g_value_set_uint (value, *(guint *) cell);
+      break;
+    case G_TYPE_LONG:
+      g_value_set_long (value, *(glong *) cell);
+      break;
+    case G_TYPE_ULONG:
+      g_value_set_ulong (value, *(gulong *) cell);
+      break;
+    case G_TYPE_INT64:
+      g_value_set_int64 (value, *(gint64 *) cell);
+      break;
+    case G_TYPE_UINT64:
+      g_value_set_uint64 (value, *(guint64 *) cell);
+      break;
+    case G_TYPE_ENUM:
+      g_value_set_enum (value, *(gint *) cell);
+      break;
+    case G_TYPE_FLAGS:
+      g_value_set_flags (value, *(guint *) cell);
+      break;
+    case G_TYPE_FLOAT:
+      g_value_set_float (value, *(gfloat *) cell);
+      break;
+    case G_TYPE_DOUBLE:
+      g_value_set_double (value, *(gdouble *) cell);
+      break;
+    case G_TYPE_STRING:
+      g_value_set_string (value, *(const gchar **) cell);
+      break;
+    case G_TYPE_POINTER:
+      g_value_set_pointer (value, *(gpointer *) cell);
+      break;
+    case G_TYPE_BOXED:
+      g_value_set_boxed (value, *(gpointer *) cell);
+      break;
+    case G_TYPE_VARIANT:
+      g_value_set_variant (value, *(gpointer *) cell);
+      break;
+    case G_TYPE_OBJECT:
+      g_value_set_object (value, *(gpointer *) cell);
+      break;
+    default:
+      g_warning ("%s: Unsupported type (%s) retrieved.", G_STRLOC, g_type_name (column->type));
+      break;
+    }
+}
+
+/* @value must hold the type of the column */
+void
+_gtk_tree_data_columns_set_value (GtkTreeDataColumns *columns,
+                                  guint               row,
+                                  gint                column_id,
+                                  GValue             *value)
+{
+  GtkTreeDataColumn *column = &columns->columns[column_id];
+  gpointer cell = COLUMN_CELL (column, row);
+
+  switch (column->fundamental)
+    {
+    case G_TYPE_BOOLEAN:
+      *(gint *) cell = g_value_get_boolean (value);
+      break;
+    case G_TYPE_CHAR:
+      *(gint *) cell = g_value_get_schar (value);
+      break;
+    case G_TYPE_UCHAR:
+      *(gint *) cell = g_value_get_uchar (value);
+      break;
+    case G_TYPE_INT:
+      *(gint *) cell = g_value_get_int (value);
+      break;
+    case G_TYPE_UINT:
+      *(guint *) cell = g_value_get_uint (value);
+      break;
+    case G_TYPE_LONG:
+      *(glong *) cell = g_value_get_long (value);
+      break;
+    case G_TYPE_ULONG:
+      *(gulong *) cell = g_value_get_ulong (value);
+      break;
+    case G_TYPE_INT64:
+      *(gint64 *) cell = g_value_get_int64 (value);
+      break;
+    case G_TYPE_UINT64:
+      *(guint64 *) cell = g_value_get_uint64 (value);
+      break;
+    case G_TYPE_ENUM:
+      *(gint *) cell = g_value_get_enum (value);
+      break;
+    case G_TYPE_FLAGS:
+      *(guint *) cell = g_value_get_flags (value);
+      break;
+    case G_TYPE_FLOAT:
+      *(gfloat *) cell = g_value_get_float (value);
+      break;
+    case G_TYPE_DOUBLE:
+      *(gdouble *) cell = g_value_get_double (value);
+      break;
+    case G_TYPE_POINTER:
+      *(gpointer *) cell = g_value_get_pointer (value);
+      break;
+    case G_TYPE_STRING:
+      {
+        /* intern first, the new string may be the old one */
+        const gchar *str = columns_intern_string (columns, g_value_get_string (value));
+
+        column_clear_cell (columns, column, row);
+        *(const gchar **) cell = str;
+      }
+      break;
+    case G_TYPE_OBJECT:
+      {
+        gpointer object = g_value_dup_object (value);
+
+        column_clear_cell (columns, column, row);
+        *(gpointer *) cell = object;
+      }
+      break;
+    case G_TYPE_BOXED:
+      {
+        gpointer boxed = g_value_dup_boxed (value);
+
+        column_clear_cell (columns, column, row);
+        *(gpointer *) cell = boxed;
+      }
+      break;
+    case G_TYPE_VARIANT:
+      {
+        gpointer variant = g_value_dup_variant (value);
+
+        column_clear_cell (columns, column, row);
+        *(gpointer *) cell = variant;
+      }
+      break;
+    default:
+      g_warning ("%s: Unsupported type (%s) stored.", G_STRLOC, g_type_name (G_VALUE_TYPE (value)));
+      break;
+    }
+}
+
+void
+_gtk_tree_data_columns_copy_row (GtkTreeDataColumns *columns,
+                                 guint               src_row,
+                                 guint               dest_row)
+{
+  GValue value = G_VALUE_INIT;
+  gint i;
+
+  for (i = 0; i < columns->n_columns; i++)
+    {
+      _gtk_tree_data_columns_get_value (columns, src_row, i, &value);
+      _gtk_tree_data_columns_set_value (columns, dest_row, i, &value);
+      g_value_unset (&value);
+    }
+}
+
+static void
+column_sort_key_init (GtkTreeDataColumn *column,
+                      guint              row,
+                      SortKey           *key)
+{
+  gpointer cell = COLUMN_CELL (column, row);
+
+  switch (column->fundamental)
+    {
+    case G_TYPE_BOOLEAN:
+    case G_TYPE_INT:
+    case G_TYPE_ENUM:
+      key->key.v_int64 = *(gint *) cell;
+      break;
+    case G_TYPE_CHAR:
+      key->key.v_int64 = (gint8) *(gint *) cell;
+      break;
+    case G_TYPE_LONG:
+      key->key.v_int64 = *(glong *) cell;
+      break;
+    case G_TYPE_INT64:
+      key->key.v_int64 = *(gint64 *) cell;
+      break;
+    case G_TYPE_UCHAR:
+      key->key.v_uint64 = (guchar) *(gint *) cell;
+      break;
+    case G_TYPE_UINT:
+    case G_TYPE_FLAGS:
+      key->key.v_uint64 = *(guint *) cell;
+      break;
+    case G_TYPE_ULONG:
+      key->key.v_uint64 = *(gulong *) cell;
+      break;
+    case G_TYPE_UINT64:
+      key->key.v_uint64 = *(guint64 *) cell;
+      break;
+    case G_TYPE_FLOAT:
+      key->key.v_double = *(gfloat *) cell;
+      break;
+    case G_TYPE_DOUBLE:
+      key->key.v_double = *(gdouble *) cell;
+      break;
+    case G_TYPE_STRING:
+      /* The interned string stays alive while sorting */
+      key->key.v_string = *(gchar **) cell;
+      break;
+    default:
+      g_assert_not_reached ();
+    }
+}
+
+/*
+ * _gtk_tree_data_columns_sort_by_key:
+ * @columns: the columns
+ * @column_id: the column to sort by
+ * @order: the sort order
+ * @rows: the rows to sort
+ * @n_rows: the number of rows
+ *
+ * Like _gtk_tree_data_list_sort_by_key(), but the keys are read
+ * from the column array directly instead of through GValues.
+ *
+ * Returns: (nullable): a newly allocated array that contains the
+ *     index into @rows of each row in sorted order, or %NULL if the
+ *     type of @column_id can't be sorted by key
+ */
+gint *
+_gtk_tree_data_columns_sort_by_key (GtkTreeDataColumns *columns,
+                                    gint                column_id,
+                                    GtkSortType         order,
+                                    const guint        *rows,
+                                    gint                n_rows)
+{
+  GtkTreeDataColumn *column = &columns->columns[column_id];
+  SortKeyInfo info;
+  SortKey *keys;
+  gint i;
+
+  if (!sort_key_type_for_column (column->type, &info.type))
+    return NULL;
+
+  info.descending = order == GTK_SORT_DESCENDING;
+  info.borrowed_strings = TRUE;
+
+  keys = g_new (SortKey, n_rows);
+  for (i = 0; i < n_rows; i++)
+    {
+      column_sort_key_init (column, rows[i], &keys[i]);
+      keys[i].index = i;
+    }
+
+  return sort_keys_to_order (keys, n_rows, &info);
+}
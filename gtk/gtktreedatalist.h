@@ -41,6 +41,8 @@ struct _GtkTreeDataList
   } data;
 };
 
+typedef struct _GtkTreeDataColumns GtkTreeDataColumns;
+
 typedef struct _GtkTreeDataSortHeader
 {
   gint sort_column_id;
@@ -67,6 +69,11 @@ gint                   _gtk_tree_data_list_compare_func (GtkTreeModel *model,
 							 GtkTreeIter  *a,
 							 GtkTreeIter  *b,
 							 gpointer      user_data);
+gint *                 _gtk_tree_data_list_sort_by_key  (GtkTreeModel *model,
+                                                         gint          column,
+                                                         GtkSortType   order,
+                                                         GtkTreeIter  *iters,
+                                                         gint          n_iters);
 GList *                _gtk_tree_data_list_header_new  (gint          n_columns,
 							GType        *types);
 void                   _gtk_tree_data_list_header_free (GList        *header_list);
@@ -78,4 +85,28 @@ GList                 *_gtk_tree_data_list_set_header  (GList                  *
 							gpointer                data,
 							GDestroyNotify          destroy);
 
+/* Column storage */
+GtkTreeDataColumns *_gtk_tree_data_columns_new        (gint                n_columns,
+                                                       GType              *types);
+void                _gtk_tree_data_columns_free       (GtkTreeDataColumns *columns);
+guint               _gtk_tree_data_columns_add_row    (GtkTreeDataColumns *columns);
+void                _gtk_tree_data_columns_remove_row (GtkTreeDataColumns *columns,
+                                                       guint               row);
+void                _gtk_tree_data_columns_get_value  (GtkTreeDataColumns *columns,
+                                                       guint               row,
+                                                       gint                column_id,
+                                                       GValue             *value);
+void                _gtk_tree_data_columns_set_value  (GtkTreeDataColumns *columns,
+                                                       guint               row,
+                                                       gint                column_id,
+                                                       GValue             *value);
+void                _gtk_tree_data_columns_copy_row   (GtkTreeDataColumns *columns,
+                                                       guint               src_row,
+                                                       guint               dest_row);
+gint *              _gtk_tree_data_columns_sort_by_key (GtkTreeDataColumns *columns,
+                                                        gint                column_id,
+                                                        GtkSortType         order,
+                                                        const guint        *rows,
+                                                        gint                n_rows);
+
 #endif /* __GTK_TREE_DATA_LIST_H__ */
@@ -247,6 +247,7 @@ enum {
   ROW_HAS_CHILD_TOGGLED,
   ROW_DELETED,
   ROWS_REORDERED,
+  ROWS_INSERTED,
   LAST_SIGNAL
 };
 
@@ -285,10 +286,17 @@ static void      rows_reordered_marshal     (GClosure          *closure,
                                              const GValue      *param_values,
                                              gpointer           invocation_hint,
                                              gpointer           marshal_data);
+static void      rows_inserted_marshal      (GClosure          *closure,
+                                             GValue /* out */  *return_value,
+                                             guint              n_param_value,
+                                             const GValue      *param_values,
+                                             gpointer           invocation_hint,
+                                             gpointer           marshal_data);
 
 static void      gtk_tree_row_ref_inserted  (RowRefList        *refs,
                                              GtkTreePath       *path,
-                                             GtkTreeIter       *iter);
+                                             GtkTreeIter       *iter,
+                                             gint               n_rows);
 static void      gtk_tree_row_ref_deleted   (RowRefList        *refs,
                                              GtkTreePath       *path);
 static void      gtk_tree_row_ref_reordered (RowRefList        *refs,
@@ -337,6 +345,7 @@ gtk_tree_model_base_init (gpointer g_class)
       GType row_inserted_params[2];
       GType row_deleted_params[1];
       GType rows_reordered_params[3];
+      GType rows_inserted_params[3];
 
       row_inserted_params[0] = GTK_TYPE_TREE_PATH | G_SIGNAL_TYPE_STATIC_SCOPE;
       row_inserted_params[1] = GTK_TYPE_TREE_ITER;
@@ -347,6 +356,10 @@ gtk_tree_model_base_init (gpointer g_class)
       rows_reordered_params[1] = GTK_TYPE_TREE_ITER;
       rows_reordered_params[2] = G_TYPE_POINTER;
 
+      rows_inserted_params[0] = GTK_TYPE_TREE_PATH | G_SIGNAL_TYPE_STATIC_SCOPE;
+      rows_inserted_params[1] = GTK_TYPE_TREE_ITER;
+      rows_inserted_params[2] = G_TYPE_INT;
+
       /**
        * GtkTreeModel::row-changed:
        * @tree_model: the #GtkTreeModel on which the signal is emitted
@@ -479,6 +492,41 @@ gtk_tree_model_base_init (gpointer g_class)
                        _gtk_marshal_VOID__BOXED_BOXED_POINTER,
                        G_TYPE_NONE, 3,
                        rows_reordered_params);
+
+      /**
+       * GtkTreeModel::rows-inserted:
+       * @tree_model: the #GtkTreeModel on which the signal is emitted
+       * @path: a #GtkTreePath-struct identifying the first new row
+       * @iter: a valid #GtkTreeIter-struct pointing to the first new row
+       * @n_rows: the number of new rows
+       *
+       * This signal is emitted when @n_rows consecutive rows without
+       * children have been inserted at @path in one go.
+       *
+       * Once the handlers of this signal have run, the default handler
+       * emits #GtkTreeModel::row-inserted for each of the new rows, for
+       * the benefit of code that does not know about this signal. This
+       * is skipped if all ::row-inserted handlers are blocked, so handlers
+       * that deal with all rows at once should block their ::row-inserted
+       * handler until the emission is over.
+       *
+       * Note that all new rows are in the model already when the first
+       * of those ::row-inserted signals is emitted. Code that builds its
+       * own view of the model when it gets ::row-inserted, such as
+       * #GtkTreeModelFilter and #GtkTreeModelSort, must handle this
+       * signal instead.
+       */
+      closure = g_closure_new_simple (sizeof (GClosure), NULL);
+      g_closure_set_marshal (closure, rows_inserted_marshal);
+      tree_model_signals[ROWS_INSERTED] =
+        g_signal_newv (I_("rows-inserted"),
+                       GTK_TYPE_TREE_MODEL,
+                       G_SIGNAL_RUN_LAST,
+                       closure,
+                       NULL, NULL,
+                       _gtk_marshal_VOID__BOXED_BOXED_INT,
+                       G_TYPE_NONE, 3,
+                       rows_inserted_params);
       initialized = TRUE;
     }
 }
@@ -503,7 +551,7 @@ row_inserted_marshal (GClosure          *closure,
 
   /* first, we need to update internal row references */
   gtk_tree_row_ref_inserted ((RowRefList *)g_object_get_data (model, ROW_REF_DATA_STRING),
-                             path, iter);
+                             path, iter, 1);
 
   /* fetch the interface ->row_inserted implementation */
   iface = GTK_TREE_MODEL_GET_IFACE (model);
@@ -579,6 +627,64 @@ rows_reordered_marshal (GClosure          *closure,
     rows_reordered_callback (GTK_TREE_MODEL (model), path, iter, new_order);
 }
 
+static void
+rows_inserted_marshal (GClosure          *closure,
+                       GValue /* out */  *return_value,
+                       guint              n_param_values,
+                       const GValue      *param_values,
+                       gpointer           invocation_hint,
+                       gpointer           marshal_data)
+{
+  GtkTreeModelIface *iface;
+  void (* rows_inserted_callback) (GtkTreeModel *tree_model,
+                                   GtkTreePath  *path,
+                                   GtkTreeIter  *iter,
+                                   gint          n_rows) = NULL;
+
+  GObject *model = g_value_get_object (param_values + 0);
+  GtkTreePath *path = (GtkTreePath *)g_value_get_boxed (param_values + 1);
+  GtkTreeIter *iter = (GtkTreeIter *)g_value_get_boxed (param_values + 2);
+  gint n_rows = g_value_get_int (param_values + 3);
+
+  iface = GTK_TREE_MODEL_GET_IFACE (model);
+  rows_inserted_callback = G_STRUCT_MEMBER (gpointer, iface,
+                              G_STRUCT_OFFSET (GtkTreeModelIface,
+                                               rows_inserted));
+
+  if (rows_inserted_callback)
+    rows_inserted_callback (GTK_TREE_MODEL (model), path, iter, n_rows);
+
+  /* Tell everybody who only listens to ::row-inserted about every row.
+   * The class closure of ::row-inserted then updates row references.
+   */
+  if (iface->row_inserted ||
+      g_signal_has_handler_pending (model, tree_model_signals[ROW_INSERTED], 0, FALSE))
+    {
+      GtkTreePath *row_path = gtk_tree_path_copy (path);
+      GtkTreeIter row_iter = *iter;
+      gint i;
+
+      for (i = 0; i < n_rows; i++)
+        {
+          if (i > 0)
+            {
+              gtk_tree_path_next (row_path);
+              if (!gtk_tree_model_iter_next (GTK_TREE_MODEL (model), &row_iter))
+                break;
+            }
+
+          g_signal_emit (model, tree_model_signals[ROW_INSERTED], 0, row_path, &row_iter);
+        }
+
+      gtk_tree_path_free (row_path);
+    }
+  else
+    {
+      gtk_tree_row_ref_inserted ((RowRefList *)g_object_get_data (model, ROW_REF_DATA_STRING),
+                                 path, iter, n_rows);
+    }
+}
+
 /**
  * gtk_tree_path_new:
  *
@@ -1845,6 +1951,33 @@ gtk_tree_model_row_inserted (GtkTreeModel *tree_model,
   g_signal_emit (tree_model, tree_model_signals[ROW_INSERTED], 0, path, iter);
 }
 
+/**
+ * gtk_tree_model_rows_inserted:
+ * @tree_model: a #GtkTreeModel
+ * @path: a #GtkTreePath-struct pointing to the first inserted row
+ * @iter: a valid #GtkTreeIter-struct pointing to the first inserted row
+ * @n_rows: the number of inserted rows
+ *
+ * Emits the #GtkTreeModel::rows-inserted signal on @tree_model.
+ *
+ * This should be called by models after inserting @n_rows consecutive
+ * rows without children, instead of calling gtk_tree_model_row_inserted()
+ * for each of them.
+ */
+void
+gtk_tree_model_rows_inserted (GtkTreeModel *tree_model,
+                              GtkTreePath  *path,
+                              GtkTreeIter  *iter,
+                              gint          n_rows)
+{
+  g_return_if_fail (GTK_IS_TREE_MODEL (tree_model));
+  g_return_if_fail (path != NULL);
+  g_return_if_fail (iter != NULL);
+  g_return_if_fail (n_rows > 0);
+
+  g_signal_emit (tree_model, tree_model_signals[ROWS_INSERTED], 0, path, iter, n_rows);
+}
+
 /**
  * gtk_tree_model_row_has_child_toggled:
  * @tree_model: a #GtkTreeModel
@@ -2074,7 +2207,8 @@ release_row_references (gpointer data)
 static void
 gtk_tree_row_ref_inserted (RowRefList  *refs,
                            GtkTreePath *path,
-                           GtkTreeIter *iter)
+                           GtkTreeIter *iter,
+                           gint         n_rows)
 {
   GSList *tmp_list;
 
@@ -2116,7 +2250,7 @@ gtk_tree_row_ref_inserted (RowRefList  *refs,
             goto done;
 
           if (path->indices[path->depth-1] <= reference->path->indices[path->depth-1])
-            reference->path->indices[path->depth-1] += 1;
+            reference->path->indices[path->depth-1] += n_rows;
         }
     done:
       tmp_list = tmp_list->next;
@@ -2515,7 +2649,7 @@ gtk_tree_row_reference_inserted (GObject     *proxy,
 {
   g_return_if_fail (G_IS_OBJECT (proxy));
 
-  gtk_tree_row_ref_inserted ((RowRefList *)g_object_get_data (proxy, ROW_REF_DATA_STRING), path, NULL);
+  gtk_tree_row_ref_inserted ((RowRefList *)g_object_get_data (proxy, ROW_REF_DATA_STRING), path, NULL, 1);
 }
 
 /**
@@ -108,6 +108,8 @@ struct _GtkTreeIter
  * @row_deleted: Signal emitted when a row has been deleted.
  * @rows_reordered: Signal emitted when the children of a node in the
  *    GtkTreeModel have been reordered.
+ * @rows_inserted: Signal emitted when several consecutive rows have
+ *    been inserted in the model at once.
  * @get_flags: Get #GtkTreeModelFlags supported by this interface.
  * @get_n_columns: Get the number of columns supported by the model.
  * @get_column_type: Get the type of the column.
@@ -150,6 +152,10 @@ struct _GtkTreeModelIface
 					  GtkTreePath  *path,
 					  GtkTreeIter  *iter,
 					  gint         *new_order);
+  void         (* rows_inserted)         (GtkTreeModel *tree_model,
+					  GtkTreePath  *path,
+					  GtkTreeIter  *iter,
+					  gint          n_rows);
 
   /* Virtual Table */
   GtkTreeModelFlags (* get_flags)  (GtkTreeModel *tree_model);
@@ -402,6 +408,11 @@ void gtk_tree_model_rows_reordered_with_length (GtkTreeModel *tree_model,
 						GtkTreeIter  *iter,
 						gint         *new_order,
 						gint          length);
+GDK_AVAILABLE_IN_ALL
+void gtk_tree_model_rows_inserted         (GtkTreeModel *tree_model,
+					   GtkTreePath  *path,
+					   GtkTreeIter  *iter,
+					   gint          n_rows);
 
 G_END_DECLS
 
@@ -237,6 +237,7 @@
 
 typedef struct _FilterElt FilterElt;
 typedef struct _FilterLevel FilterLevel;
+typedef struct _RefilterRow RefilterRow;
 
 struct _FilterElt
 {
@@ -288,9 +289,25 @@ struct _GtkTreeModelFilterPrivate
   guint in_row_deleted       : 1;
   guint virtual_root_deleted : 1;
 
+  /* incremental refilter */
+  guint visible_func_thread_safe : 1;
+  guint refilter_restart         : 1;
+  guint refilter_rows_stale      : 1;
+  guint refilter_idle_id;
+  GtkTreeIter refilter_iter;
+  GtkTreePath *refilter_path;
+  /* rows of the current batch, from refilter_next_row on they still
+   * wait for their signals
+   */
+  RefilterRow *refilter_rows;
+  gint refilter_n_rows;
+  gint refilter_next_row;
+
   /* signal ids */
   gulong changed_id;
   gulong inserted_id;
+  gulong rows_inserted_id;
+  gulong rows_inserted_after_id;
   gulong has_child_toggled_id;
   gulong deleted_id;
   gulong reordered_id;
@@ -321,6 +338,15 @@ enum
  */
 #undef MODEL_FILTER_DEBUG
 
+/* An incremental refilter evaluates rows in batches of this size between
+ * checks of its time budget. When the visible function is thread-safe,
+ * every worker thread gets REFILTER_THREAD_BATCH_SIZE rows per round.
+ */
+#define REFILTER_BATCH_SIZE        64
+#define REFILTER_THREAD_BATCH_SIZE 2048
+#define REFILTER_MAX_THREADS       8
+#define REFILTER_TIME_SLICE        4000 /* µs */
+
 #define FILTER_ELT(filter_elt) ((FilterElt *)filter_elt)
 #define FILTER_LEVEL(filter_level) ((FilterLevel *)filter_level)
 #define GET_ELT(siter) ((FilterElt*) (siter ? g_sequence_get (siter) : NULL))
@@ -347,6 +373,16 @@ static void         gtk_tree_model_filter_row_inserted                    (GtkTr
                                                                            GtkTreePath            *c_path,
                                                                            GtkTreeIter            *c_iter,
                                                                            gpointer                data);
+static void         gtk_tree_model_filter_rows_inserted                   (GtkTreeModel           *c_model,
+                                                                           GtkTreePath            *c_path,
+                                                                           GtkTreeIter            *c_iter,
+                                                                           gint                    n_rows,
+                                                                           gpointer                data);
+static void         gtk_tree_model_filter_rows_inserted_after             (GtkTreeModel           *c_model,
+                                                                           GtkTreePath            *c_path,
+                                                                           GtkTreeIter            *c_iter,
+                                                                           gint                    n_rows,
+                                                                           gpointer                data);
 static void         gtk_tree_model_filter_row_has_child_toggled           (GtkTreeModel           *c_model,
                                                                            GtkTreePath            *c_path,
                                                                            GtkTreeIter            *c_iter,
@@ -490,6 +526,14 @@ static void         gtk_tree_model_filter_emit_row_inserted_for_path      (GtkTr
                                                                            GtkTreeModel           *c_model,
                                                                            GtkTreePath            *c_path,
                                                                            GtkTreeIter            *c_iter);
+static void         gtk_tree_model_filter_cancel_refilter                 (GtkTreeModelFilter     *filter);
+static void         gtk_tree_model_filter_refilter_row_inserted           (GtkTreeModelFilter     *filter,
+                                                                           GtkTreePath            *c_path);
+static void         gtk_tree_model_filter_refilter_row_deleted            (GtkTreeModelFilter     *filter,
+                                                                           GtkTreePath            *c_path);
+static void         gtk_tree_model_filter_refilter_rows_reordered         (GtkTreeModelFilter     *filter,
+                                                                           GtkTreePath            *c_path,
+                                                                           gint                   *new_order);
 
 
 G_DEFINE_TYPE_WITH_CODE (GtkTreeModelFilter, gtk_tree_model_filter, G_TYPE_OBJECT,
@@ -1977,13 +2021,20 @@ gtk_tree_model_filter_emit_row_inserted_for_path (GtkTreeModelFilter *filter,
   gtk_tree_path_free (path);
 }
 
+/* Brings the row at @c_path in line with its visibility. If @evaluated
+ * is %FALSE, the visibility is determined here, and ::row-changed is
+ * propagated for rows that stay visible. Otherwise @requested_state is
+ * the outcome of a refilter, and only changes in visibility are acted
+ * upon.
+ */
 static void
-gtk_tree_model_filter_row_changed (GtkTreeModel *c_model,
-                                   GtkTreePath  *c_path,
-                                   GtkTreeIter  *c_iter,
-                                   gpointer      data)
+gtk_tree_model_filter_update_row (GtkTreeModelFilter *filter,
+                                  GtkTreeModel       *c_model,
+                                  GtkTreePath        *c_path,
+                                  GtkTreeIter        *c_iter,
+                                  gboolean            evaluated,
+                                  gboolean            requested_state)
 {
-  GtkTreeModelFilter *filter = GTK_TREE_MODEL_FILTER (data);
   GtkTreeIter iter;
   GtkTreeIter children;
   GtkTreeIter real_c_iter;
@@ -1993,7 +2044,6 @@ gtk_tree_model_filter_row_changed (GtkTreeModel *c_model,
   FilterElt *elt;
   FilterLevel *level;
 
-  gboolean requested_state;
   gboolean current_state;
   gboolean free_c_path = FALSE;
 
@@ -2023,7 +2073,8 @@ gtk_tree_model_filter_row_changed (GtkTreeModel *c_model,
     goto done;
 
   /* what's the requested state? */
-  requested_state = gtk_tree_model_filter_visible (filter, &real_c_iter);
+  if (!evaluated)
+    requested_state = gtk_tree_model_filter_visible (filter, &real_c_iter);
 
   /* now, let's see whether the item is there */
   path = gtk_real_tree_model_filter_convert_child_path_to_path (filter,
@@ -2058,6 +2109,10 @@ gtk_tree_model_filter_row_changed (GtkTreeModel *c_model,
 
   if (current_state == TRUE && requested_state == TRUE)
     {
+      /* nothing changed, the refilter visits the children itself */
+      if (evaluated)
+        goto done;
+
       level = FILTER_LEVEL (iter.user_data);
       elt = FILTER_ELT (iter.user_data2);
 
@@ -2105,6 +2160,21 @@ done:
     gtk_tree_path_free (c_path);
 }
 
+static void
+gtk_tree_model_filter_row_changed (GtkTreeModel *c_model,
+                                   GtkTreePath  *c_path,
+                                   GtkTreeIter  *c_iter,
+                                   gpointer      data)
+{
+  GtkTreeModelFilter *filter = GTK_TREE_MODEL_FILTER (data);
+
+  /* rows of a pending refilter batch need to be evaluated again */
+  filter->priv->refilter_rows_stale = TRUE;
+
+  gtk_tree_model_filter_update_row (filter, c_model, c_path, c_iter,
+                                    FALSE, FALSE);
+}
+
 static void
 gtk_tree_model_filter_row_inserted (GtkTreeModel *c_model,
                                     GtkTreePath  *c_path,
@@ -2135,6 +2205,8 @@ gtk_tree_model_filter_row_inserted (GtkTreeModel *c_model,
       free_c_path = TRUE;
     }
 
+  gtk_tree_model_filter_refilter_row_inserted (filter, c_path);
+
   if (c_iter)
     real_c_iter = *c_iter;
   else
@@ -2290,6 +2362,103 @@ done:
     gtk_tree_path_free (c_path);
 }
 
+/* Returns whether the level that a row inserted at @c_path goes into
+ * is not built yet. Building it picks up all rows the child model has.
+ */
+static gboolean
+gtk_tree_model_filter_level_is_missing (GtkTreeModelFilter *filter,
+                                        GtkTreePath        *c_path)
+{
+  GtkTreePath *real_path;
+  FilterLevel *parent_level;
+  FilterElt *elt;
+  gboolean missing;
+
+  if (filter->priv->virtual_root)
+    {
+      real_path = gtk_tree_model_filter_remove_root (c_path,
+                                                     filter->priv->virtual_root);
+      /* not our child */
+      if (!real_path)
+        return FALSE;
+    }
+  else
+    real_path = gtk_tree_path_copy (c_path);
+
+  if (!filter->priv->root)
+    missing = TRUE;
+  else if (gtk_tree_path_get_depth (real_path) > 1)
+    {
+      gtk_tree_path_up (real_path);
+      missing = !find_elt_with_offset (filter, real_path, &parent_level, &elt) ||
+                elt->children == NULL;
+    }
+  else
+    missing = FALSE;
+
+  gtk_tree_path_free (real_path);
+
+  return missing;
+}
+
+/* The rows after the first one are in the child model already when
+ * this runs, so they are handled one by one as if they were inserted
+ * in that order. The compat ::row-inserted emissions of the child model
+ * are blocked until gtk_tree_model_filter_rows_inserted_after().
+ */
+static void
+gtk_tree_model_filter_rows_inserted (GtkTreeModel *c_model,
+                                     GtkTreePath  *c_path,
+                                     GtkTreeIter  *c_iter,
+                                     gint          n_rows,
+                                     gpointer      data)
+{
+  GtkTreeModelFilter *filter = GTK_TREE_MODEL_FILTER (data);
+  GtkTreePath *row_path;
+  GtkTreeIter row_iter;
+  gboolean missing;
+  gint i;
+
+  g_signal_handler_block (c_model, filter->priv->inserted_id);
+
+  missing = gtk_tree_model_filter_level_is_missing (filter, c_path);
+
+  row_path = gtk_tree_path_copy (c_path);
+  row_iter = *c_iter;
+
+  for (i = 0; i < n_rows; i++)
+    {
+      if (i > 0)
+        {
+          gtk_tree_path_next (row_path);
+          if (!gtk_tree_model_iter_next (c_model, &row_iter))
+            break;
+        }
+
+      /* If the level gets built for the first row, it holds the other
+       * rows as well, and only a pending refilter needs to know.
+       */
+      if (i == 0 || !missing)
+        gtk_tree_model_filter_row_inserted (c_model, row_path, &row_iter, data);
+      else
+        gtk_tree_model_filter_refilter_row_inserted (filter, row_path);
+    }
+
+  gtk_tree_path_free (row_path);
+}
+
+static void
+gtk_tree_model_filter_rows_inserted_after (GtkTreeModel *c_model,
+                                           GtkTreePath  *c_path,
+                                           GtkTreeIter  *c_iter,
+                                           gint          n_rows,
+                                           gpointer      data)
+{
+  GtkTreeModelFilter *filter = GTK_TREE_MODEL_FILTER (data);
+
+  g_signal_handler_unblock (c_model, filter->priv->inserted_id);
+}
+
 static void
 gtk_tree_model_filter_row_has_child_toggled (GtkTreeModel *c_model,
                                              GtkTreePath  *c_path,
@@ -2540,6 +2709,8 @@ gtk_tree_model_filter_row_deleted (GtkTreeModel *c_model,
 
   g_return_if_fail (c_path != NULL);
 
+  gtk_tree_model_filter_refilter_row_deleted (filter, c_path);
+
   /* special case the deletion of an ancestor of the virtual root */
   if (filter->priv->virtual_root &&
       (gtk_tree_path_is_ancestor (c_path, filter->priv->virtual_root) ||
@@ -2724,6 +2895,8 @@ gtk_tree_model_filter_rows_reordered (GtkTreeModel *c_model,
 
   g_return_if_fail (new_order != NULL);
 
+  gtk_tree_model_filter_refilter_rows_reordered (filter, c_path, new_order);
+
   if (c_path == NULL || gtk_tree_path_get_depth (c_path) == 0)
     {
       length = gtk_tree_model_iter_n_children (c_model, NULL);
@@ -3635,10 +3808,16 @@ gtk_tree_model_filter_set_model (GtkTreeModelFilter *filter,
 
   if (filter->priv->child_model)
     {
+      gtk_tree_model_filter_cancel_refilter (filter);
+
       g_signal_handler_disconnect (filter->priv->child_model,
                                    filter->priv->changed_id);
       g_signal_handler_disconnect (filter->priv->child_model,
                                    filter->priv->inserted_id);
+      g_signal_handler_disconnect (filter->priv->child_model,
+                                   filter->priv->rows_inserted_id);
+      g_signal_handler_disconnect (filter->priv->child_model,
+                                   filter->priv->rows_inserted_after_id);
       g_signal_handler_disconnect (filter->priv->child_model,
                                    filter->priv->has_child_toggled_id);
       g_signal_handler_disconnect (filter->priv->child_model,
@@ -3671,6 +3850,14 @@ gtk_tree_model_filter_set_model (GtkTreeModelFilter *filter,
         g_signal_connect (child_model, "row-inserted",
                           G_CALLBACK (gtk_tree_model_filter_row_inserted),
                           filter);
+      filter->priv->rows_inserted_id =
+        g_signal_connect (child_model, "rows-inserted",
+                          G_CALLBACK (gtk_tree_model_filter_rows_inserted),
+                          filter);
+      filter->priv->rows_inserted_after_id =
+        g_signal_connect_after (child_model, "rows-inserted",
+                                G_CALLBACK (gtk_tree_model_filter_rows_inserted_after),
+                                filter);
       filter->priv->has_child_toggled_id =
         g_signal_connect (child_model, "row-has-child-toggled",
                           G_CALLBACK (gtk_tree_model_filter_row_has_child_toggled),
@@ -4228,6 +4415,590 @@ gtk_tree_model_filter_refilter_helper (GtkTreeModel *model,
   return FALSE;
 }
 
+/* incremental refilter */
+
+struct _RefilterRow
+{
+  GtkTreeIter c_iter;
+  GtkTreePath *c_path;
+  gboolean visible;
+};
+
+typedef struct
+{
+  GMutex mutex;
+  GCond cond;
+  gint n_pending;
+} RefilterBatch;
+
+typedef struct
+{
+  GtkTreeModelFilter *filter;
+  RefilterRow *rows;
+  gint n_rows;
+  RefilterBatch *batch;
+} RefilterChunk;
+
+static void
+gtk_tree_model_filter_cancel_refilter (GtkTreeModelFilter *filter)
+{
+  if (filter->priv->refilter_idle_id)
+    {
+      g_source_remove (filter->priv->refilter_idle_id);
+      filter->priv->refilter_idle_id = 0;
+    }
+
+  g_clear_pointer (&filter->priv->refilter_path, gtk_tree_path_free);
+  filter->priv->refilter_restart = FALSE;
+  filter->priv->refilter_rows = NULL;
+  filter->priv->refilter_n_rows = 0;
+  filter->priv->refilter_next_row = 0;
+}
+
+/* Moves the position of a pending refilter to the next row in the
+ * same order as gtk_tree_model_filter_refilter_next(), if the row at
+ * refilter_path does not exist.
+ */
+static void
+gtk_tree_model_filter_refilter_seek (GtkTreeModelFilter *filter)
+{
+  GtkTreeModelFilterPrivate *priv = filter->priv;
+  gint root_depth;
+
+  root_depth = priv->virtual_root ? gtk_tree_path_get_depth (priv->virtual_root) : 0;
+
+  while (!gtk_tree_model_get_iter (priv->child_model, &priv->refilter_iter, priv->refilter_path))
+    {
+      if (gtk_tree_path_get_depth (priv->refilter_path) <= root_depth + 1)
+        {
+          g_clear_pointer (&priv->refilter_path, gtk_tree_path_free);
+          return;
+        }
+
+      gtk_tree_path_up (priv->refilter_path);
+      gtk_tree_path_next (priv->refilter_path);
+    }
+}
+
+/* Checks if @path is in the level of @c_path or below it, and returns
+ * the index of the row in that level that @path is or is below of.
+ */
+static gint *
+refilter_path_get_level_index (GtkTreePath *path,
+                               GtkTreePath *c_path)
+{
+  gint *indices, *c_indices;
+  gint depth, i;
+
+  depth = gtk_tree_path_get_depth (c_path);
+  if (depth == 0 || depth > gtk_tree_path_get_depth (path))
+    return NULL;
+
+  indices = gtk_tree_path_get_indices (path);
+  c_indices = gtk_tree_path_get_indices (c_path);
+  for (i = 0; i < depth - 1; i++)
+    {
+      if (indices[i] != c_indices[i])
+        return NULL;
+    }
+
+  return &indices[depth - 1];
+}
+
+/* Returns %FALSE if the row at @path is @c_path or below it */
+static gboolean
+refilter_path_adjust (GtkTreePath *path,
+                      GtkTreePath *c_path,
+                      gboolean     inserted)
+{
+  gint *index;
+  gint c_index;
+
+  index = refilter_path_get_level_index (path, c_path);
+  if (index == NULL)
+    return TRUE;
+
+  c_index = gtk_tree_path_get_indices (c_path)[gtk_tree_path_get_depth (c_path) - 1];
+
+  if (inserted)
+    {
+      if (c_index <= *index)
+        (*index)++;
+    }
+  else
+    {
+      if (c_index == *index)
+        return FALSE;
+      if (c_index < *index)
+        (*index)--;
+    }
+
+  return TRUE;
+}
+
+/* The handlers below keep a pending refilter in line with structural
+ * changes of the child model, instead of starting it over. Rows that
+ * are inserted are filtered by the row-inserted handler, so it does
+ * not matter whether the refilter visits them.
+ */
+static void
+gtk_tree_model_filter_refilter_row_inserted (GtkTreeModelFilter *filter,
+                                             GtkTreePath        *c_path)
+{
+  GtkTreeModelFilterPrivate *priv = filter->priv;
+  gint i;
+
+  for (i = priv->refilter_next_row; i < priv->refilter_n_rows; i++)
+    {
+      if (priv->refilter_rows[i].c_path)
+        refilter_path_adjust (priv->refilter_rows[i].c_path, c_path, TRUE);
+    }
+  priv->refilter_rows_stale = TRUE;
+
+  if (priv->refilter_path)
+    {
+      refilter_path_adjust (priv->refilter_path, c_path, TRUE);
+      gtk_tree_model_get_iter (priv->child_model, &priv->refilter_iter, priv->refilter_path);
+    }
+}
+
+static void
+gtk_tree_model_filter_refilter_row_deleted (GtkTreeModelFilter *filter,
+                                            GtkTreePath        *c_path)
+{
+  GtkTreeModelFilterPrivate *priv = filter->priv;
+  gint i;
+
+  if (priv->virtual_root &&
+      (gtk_tree_path_is_ancestor (c_path, priv->virtual_root) ||
+       !gtk_tree_path_compare (c_path, priv->virtual_root)))
+    {
+      gtk_tree_model_filter_cancel_refilter (filter);
+      return;
+    }
+
+  for (i = priv->refilter_next_row; i < priv->refilter_n_rows; i++)
+    {
+      RefilterRow *row = &priv->refilter_rows[i];
+
+      if (row->c_path && !refilter_path_adjust (row->c_path, c_path, FALSE))
+        g_clear_pointer (&row->c_path, gtk_tree_path_free);
+    }
+  priv->refilter_rows_stale = TRUE;
+
+  if (priv->refilter_path)
+    {
+      /* If the next row or one of its ancestors was deleted, the row
+       * after it took its place.
+       */
+      if (!refilter_path_adjust (priv->refilter_path, c_path, FALSE))
+        {
+          while (gtk_tree_path_get_depth (priv->refilter_path) > gtk_tree_path_get_depth (c_path))
+            gtk_tree_path_up (priv->refilter_path);
+        }
+
+      gtk_tree_model_filter_refilter_seek (filter);
+    }
+}
+
+static void
+gtk_tree_model_filter_refilter_rows_reordered (GtkTreeModelFilter *filter,
+                                               GtkTreePath        *c_path,
+                                               gint               *new_order)
+{
+  GtkTreeModelFilterPrivate *priv = filter->priv;
+  GtkTreePath *level;
+  gint *index;
+  gint i, j, length;
+
+  if (priv->refilter_path == NULL && priv->refilter_next_row >= priv->refilter_n_rows)
+    return;
+
+  /* The path of the first row of the reordered level */
+  level = c_path ? gtk_tree_path_copy (c_path) : gtk_tree_path_new ();
+  gtk_tree_path_down (level);
+
+  if (gtk_tree_path_get_depth (level) > 1)
+    {
+      GtkTreeIter iter;
+
+      if (gtk_tree_model_get_iter (priv->child_model, &iter, c_path))
+        length = gtk_tree_model_iter_n_children (priv->child_model, &iter);
+      else
+        length = 0;
+    }
+  else
+    length = gtk_tree_model_iter_n_children (priv->child_model, NULL);
+
+  for (i = priv->refilter_next_row; i < priv->refilter_n_rows; i++)
+    {
+      RefilterRow *row = &priv->refilter_rows[i];
+
+      if (row->c_path == NULL)
+        continue;
+
+      index = refilter_path_get_level_index (row->c_path, level);
+      if (index == NULL)
+        continue;
+
+      for (j = 0; j < length; j++)
+        {
+          if (new_order[j] == *index)
+            {
+              *index = j;
+              break;
+            }
+        }
+    }
+  priv->refilter_rows_stale = TRUE;
+
+  /* The rows of the level that were not visited yet are not in one piece
+   * anymore, so the walk starts over at the beginning of the level.
+   */
+  if (priv->refilter_path)
+    {
+      index = refilter_path_get_level_index (priv->refilter_path, level);
+      if (index)
+        {
+          *index = 0;
+          while (gtk_tree_path_get_depth (priv->refilter_path) > gtk_tree_path_get_depth (level))
+            gtk_tree_path_up (priv->refilter_path);
+        }
+
+      gtk_tree_model_filter_refilter_seek (filter);
+    }
+
+  gtk_tree_path_free (level);
+}
+
+static void
+gtk_tree_model_filter_refilter_begin (GtkTreeModelFilter *filter)
+{
+  GtkTreeModelFilterPrivate *priv = filter->priv;
+  GtkTreeIter root;
+
+  g_clear_pointer (&priv->refilter_path, gtk_tree_path_free);
+
+  if (priv->virtual_root)
+    {
+      if (!gtk_tree_model_get_iter (priv->child_model, &root, priv->virtual_root) ||
+          !gtk_tree_model_iter_children (priv->child_model, &priv->refilter_iter, &root))
+        return;
+
+      priv->refilter_path = gtk_tree_path_copy (priv->virtual_root);
+      gtk_tree_path_down (priv->refilter_path);
+    }
+  else
+    {
+      if (!gtk_tree_model_get_iter_first (priv->child_model, &priv->refilter_iter))
+        return;
+
+      priv->refilter_path = gtk_tree_path_new_first ();
+    }
+}
+
+/* Moves to the next row in the same depth-first order as
+ * gtk_tree_model_foreach(), without leaving the virtual root.
+ */
+static gboolean
+gtk_tree_model_filter_refilter_next (GtkTreeModelFilter *filter)
+{
+  GtkTreeModelFilterPrivate *priv = filter->priv;
+  GtkTreeIter tmp;
+  gint root_depth;
+
+  if (gtk_tree_model_iter_children (priv->child_model, &tmp, &priv->refilter_iter))
+    {
+      priv->refilter_iter = tmp;
+      gtk_tree_path_down (priv->refilter_path);
+      return TRUE;
+    }
+
+  root_depth = priv->virtual_root ? gtk_tree_path_get_depth (priv->virtual_root) : 0;
+
+  while (TRUE)
+    {
+      tmp = priv->refilter_iter;
+      if (gtk_tree_model_iter_next (priv->child_model, &tmp))
+        {
+          priv->refilter_iter = tmp;
+          gtk_tree_path_next (priv->refilter_path);
+          return TRUE;
+        }
+
+      if (gtk_tree_path_get_depth (priv->refilter_path) <= root_depth + 1 ||
+          !gtk_tree_model_iter_parent (priv->child_model, &tmp, &priv->refilter_iter))
+        return FALSE;
+
+      priv->refilter_iter = tmp;
+      gtk_tree_path_up (priv->refilter_path);
+    }
+}
+
+static void
+gtk_tree_model_filter_refilter_chunk (RefilterChunk *chunk)
+{
+  gint i;
+
+  for (i = 0; i < chunk->n_rows; i++)
+    chunk->rows[i].visible = gtk_tree_model_filter_visible (chunk->filter,
+                                                            &chunk->rows[i].c_iter);
+}
+
+static void
+gtk_tree_model_filter_refilter_thread (gpointer data,
+                                       gpointer user_data)
+{
+  RefilterChunk *chunk = data;
+  RefilterBatch *batch = chunk->batch;
+
+  gtk_tree_model_filter_refilter_chunk (chunk);
+
+  g_mutex_lock (&batch->mutex);
+  batch->n_pending--;
+  if (batch->n_pending == 0)
+    g_cond_signal (&batch->cond);
+  g_mutex_unlock (&batch->mutex);
+}
+
+/* Evaluates the visible function for @rows. The chunks run on a thread
+ * pool that is shared by all filter models, and only while the main
+ * thread waits for them, so the child model cannot change underneath
+ * them.
+ */
+static void
+gtk_tree_model_filter_refilter_evaluate (GtkTreeModelFilter *filter,
+                                         RefilterRow        *rows,
+                                         gint                n_rows,
+                                         gint                n_threads)
+{
+  static GThreadPool *pool = NULL;
+  RefilterChunk chunks[REFILTER_MAX_THREADS];
+  RefilterBatch batch;
+  gint i, chunk_size;
+
+  if (pool == NULL)
+    pool = g_thread_pool_new (gtk_tree_model_filter_refilter_thread, NULL,
+                              REFILTER_MAX_THREADS - 1, FALSE, NULL);
+
+  n_threads = CLAMP ((n_rows + REFILTER_BATCH_SIZE - 1) / REFILTER_BATCH_SIZE, 1, n_threads);
+  chunk_size = (n_rows + n_threads - 1) / n_threads;
+
+  g_mutex_init (&batch.mutex);
+  g_cond_init (&batch.cond);
+  batch.n_pending = n_threads - 1;
+
+  for (i = 0; i < n_threads; i++)
+    {
+      chunks[i].filter = filter;
+      chunks[i].rows = rows + i * chunk_size;
+      chunks[i].n_rows = MIN (chunk_size, n_rows - i * chunk_size);
+      chunks[i].batch = &batch;
+    }
+
+  for (i = 1; i < n_threads; i++)
+    g_thread_pool_push (pool, &chunks[i], NULL);
+
+  gtk_tree_model_filter_refilter_chunk (&chunks[0]);
+
+  g_mutex_lock (&batch.mutex);
+  while (batch.n_pending > 0)
+    g_cond_wait (&batch.cond, &batch.mutex);
+  g_mutex_unlock (&batch.mutex);
+
+  g_mutex_clear (&batch.mutex);
+  g_cond_clear (&batch.cond);
+}
+
+static gboolean
+gtk_tree_model_filter_refilter_idle (gpointer data)
+{
+  GtkTreeModelFilter *filter = data;
+  GtkTreeModelFilterPrivate *priv = filter->priv;
+  RefilterRow *rows;
+  gint64 end_time;
+  gint n_threads, batch_size, n_rows, i;
+
+  end_time = g_get_monotonic_time () + REFILTER_TIME_SLICE;
+
+  if (priv->visible_func_thread_safe)
+    {
+      n_threads = MIN (g_get_num_processors (), REFILTER_MAX_THREADS);
+      batch_size = n_threads * REFILTER_THREAD_BATCH_SIZE;
+    }
+  else
+    {
+      n_threads = 1;
+      batch_size = REFILTER_BATCH_SIZE;
+    }
+
+  rows = g_new (RefilterRow, batch_size);
+
+  g_object_ref (filter);
+
+  do
+    {
+      if (priv->refilter_restart)
+        {
+          priv->refilter_restart = FALSE;
+          gtk_tree_model_filter_refilter_begin (filter);
+        }
+
+      n_rows = 0;
+      while (priv->refilter_path && n_rows < batch_size)
+        {
+          rows[n_rows].c_iter = priv->refilter_iter;
+          rows[n_rows].c_path = gtk_tree_path_copy (priv->refilter_path);
+          n_rows++;
+
+          if (!gtk_tree_model_filter_refilter_next (filter))
+            g_clear_pointer (&priv->refilter_path, gtk_tree_path_free);
+        }
+
+      if (n_threads > 1)
+        gtk_tree_model_filter_refilter_evaluate (filter, rows, n_rows, n_threads);
+      else
+        {
+          for (i = 0; i < n_rows; i++)
+            rows[i].visible = gtk_tree_model_filter_visible (filter, &rows[i].c_iter);
+        }
+
+      /* Rows only get signals if their visibility changed. Handlers
+       * of those signals may change the child model. The rows that
+       * still wait for their signals are kept in line with structural
+       * changes, and evaluated again after any change.
+       */
+      priv->refilter_rows = rows;
+      priv->refilter_n_rows = n_rows;
+      priv->refilter_rows_stale = FALSE;
+
+      for (i = 0; i < n_rows; i++)
+        {
+          priv->refilter_next_row = i + 1;
+
+          if (rows[i].c_path == NULL)
+            continue;
+
+          if (priv->refilter_rows == rows && !priv->refilter_restart)
+            {
+              if (priv->refilter_rows_stale)
+                {
+                  if (gtk_tree_model_get_iter (priv->child_model, &rows[i].c_iter, rows[i].c_path))
+                    rows[i].visible = gtk_tree_model_filter_visible (filter, &rows[i].c_iter);
+                  else
+                    g_clear_pointer (&rows[i].c_path, gtk_tree_path_free);
+                }
+
+              if (rows[i].c_path)
+                gtk_tree_model_filter_update_row (filter, priv->child_model,
+                                                  rows[i].c_path, &rows[i].c_iter,
+                                                  TRUE, rows[i].visible);
+            }
+
+          g_clear_pointer (&rows[i].c_path, gtk_tree_path_free);
+        }
+
+      if (priv->refilter_rows == rows)
+        {
+          priv->refilter_rows = NULL;
+          priv->refilter_n_rows = 0;
+          priv->refilter_next_row = 0;
+        }
+    }
+  while ((priv->refilter_path || priv->refilter_restart) &&
+         g_get_monotonic_time () < end_time);
+
+  g_free (rows);
+
+  if (priv->refilter_path || priv->refilter_restart)
+    {
+      g_object_unref (filter);
+      return G_SOURCE_CONTINUE;
+    }
+
+  /* a refilter that was queued after cancelling this one has its own source */
+  if (priv->refilter_idle_id == g_source_get_id (g_main_current_source ()))
+    priv->refilter_idle_id = 0;
+  g_object_unref (filter);
+
+  return G_SOURCE_REMOVE;
+}
+
+/**
+ * gtk_tree_model_filter_queue_refilter:
+ * @filter: A #GtkTreeModelFilter.
+ *
+ * Re-evaluates the visibility of all rows like gtk_tree_model_filter_refilter(),
+ * but does so incrementally from the main loop, in slices that take no
+ * more than a few milliseconds. Rows appear and disappear progressively,
+ * and signals are only emitted for rows whose visibility changed.
+ *
+ * If the visible function was declared thread-safe with
+ * gtk_tree_model_filter_set_visible_func_thread_safe(), it is run on
+ * multiple threads for each slice.
+ *
+ * Queueing a refilter while another one is pending restarts it, which
+ * makes this suitable to be called for every keystroke in a search entry.
+ */
+void
+gtk_tree_model_filter_queue_refilter (GtkTreeModelFilter *filter)
+{
+  g_return_if_fail (GTK_IS_TREE_MODEL_FILTER (filter));
+
+  if (filter->priv->child_model == NULL)
+    return;
+
+  filter->priv->refilter_restart = TRUE;
+
+  if (filter->priv->refilter_idle_id == 0)
+    {
+      filter->priv->refilter_idle_id =
+        g_idle_add_full (G_PRIORITY_DEFAULT_IDLE,
+                         gtk_tree_model_filter_refilter_idle,
+                         filter, NULL);
+      g_source_set_name_by_id (filter->priv->refilter_idle_id,
+                               "[gtk+] gtk_tree_model_filter_refilter_idle");
+    }
+}
+
+/**
+ * gtk_tree_model_filter_set_visible_func_thread_safe:
+ * @filter: A #GtkTreeModelFilter.
+ * @thread_safe: %TRUE if the visible function can be called from other threads
+ *
+ * Declares whether the visible function, and the accessors of the child
+ * model it uses, may be called from several threads at once. This lets
+ * gtk_tree_model_filter_queue_refilter() evaluate rows in parallel.
+ *
+ * The child model is not modified while the visible function runs
+ * on other threads.
+ */
+void
+gtk_tree_model_filter_set_visible_func_thread_safe (GtkTreeModelFilter *filter,
+                                                    gboolean            thread_safe)
+{
+  g_return_if_fail (GTK_IS_TREE_MODEL_FILTER (filter));
+
+  filter->priv->visible_func_thread_safe = thread_safe != FALSE;
+}
+
+/**
+ * gtk_tree_model_filter_get_visible_func_thread_safe:
+ * @filter: A #GtkTreeModelFilter.
+ *
+ * Returns whether the visible function was declared thread-safe
+ * with gtk_tree_model_filter_set_visible_func_thread_safe().
+ *
+ * Returns: %TRUE if the visible function is thread-safe
+ */
+gboolean
+gtk_tree_model_filter_get_visible_func_thread_safe (GtkTreeModelFilter *filter)
+{
+  g_return_val_if_fail (GTK_IS_TREE_MODEL_FILTER (filter), FALSE);
+
+  return filter->priv->visible_func_thread_safe;
+}
+
 /**
  * gtk_tree_model_filter_refilter:
  * @filter: A #GtkTreeModelFilter.
@@ -4240,6 +5011,9 @@ gtk_tree_model_filter_refilter (GtkTreeModelFilter *filter)
 {
   g_return_if_fail (GTK_IS_TREE_MODEL_FILTER (filter));
 
+  /* a synchronous refilter supersedes a queued one */
+  gtk_tree_model_filter_cancel_refilter (filter);
+
   /* S L O W */
   gtk_tree_model_foreach (filter->priv->child_model,
                           gtk_tree_model_filter_refilter_helper,
@@ -150,6 +150,13 @@ GDK_AVAILABLE_IN_ALL
 void          gtk_tree_model_filter_refilter                   (GtkTreeModelFilter           *filter);
 GDK_AVAILABLE_IN_ALL
 void          gtk_tree_model_filter_clear_cache                (GtkTreeModelFilter           *filter);
+GDK_AVAILABLE_IN_ALL
+void          gtk_tree_model_filter_queue_refilter             (GtkTreeModelFilter           *filter);
+GDK_AVAILABLE_IN_ALL
+void          gtk_tree_model_filter_set_visible_func_thread_safe (GtkTreeModelFilter         *filter,
+                                                                gboolean                      thread_safe);
+GDK_AVAILABLE_IN_ALL
+gboolean      gtk_tree_model_filter_get_visible_func_thread_safe (GtkTreeModelFilter         *filter);
 
 G_END_DECLS
 
@@ -276,6 +276,8 @@ struct _GtkTreeModelSortPrivate
   /* signal ids */
   gulong changed_id;
   gulong inserted_id;
+  gulong rows_inserted_id;
+  gulong rows_inserted_after_id;
   gulong has_child_toggled_id;
   gulong deleted_id;
   gulong reordered_id;
@@ -327,6 +329,16 @@ static void gtk_tree_model_sort_row_inserted          (GtkTreeModel          *mo
 						       GtkTreePath           *path,
 						       GtkTreeIter           *iter,
 						       gpointer               data);
+static void gtk_tree_model_sort_rows_inserted         (GtkTreeModel          *model,
+						       GtkTreePath           *path,
+						       GtkTreeIter           *iter,
+						       gint                   n_rows,
+						       gpointer               data);
+static void gtk_tree_model_sort_rows_inserted_after   (GtkTreeModel          *model,
+						       GtkTreePath           *path,
+						       GtkTreeIter           *iter,
+						       gint                   n_rows,
+						       gpointer               data);
 static void gtk_tree_model_sort_row_has_child_toggled (GtkTreeModel          *model,
 						       GtkTreePath           *path,
 						       GtkTreeIter           *iter,
@@ -995,6 +1007,118 @@ gtk_tree_model_sort_row_inserted (GtkTreeModel          *s_model,
   return;
 }
 
+/* Builds the root level like gtk_tree_model_sort_build_level() does,
+ * but leaves out the @n_rows rows from @offset on, so that they can be
+ * inserted one by one.
+ */
+static void
+gtk_tree_model_sort_build_root_without (GtkTreeModelSort *tree_model_sort,
+                                        gint              offset,
+                                        gint              n_rows)
+{
+  GtkTreeModelSortPrivate *priv = tree_model_sort->priv;
+  GtkTreeIter iter;
+  SortLevel *new_level;
+  gint i;
+
+  new_level = g_new (SortLevel, 1);
+  new_level->seq = g_sequence_new (sort_elt_free);
+  new_level->ref_count = 0;
+  new_level->parent_level = NULL;
+  new_level->parent_elt = NULL;
+
+  priv->root = new_level;
+
+  if (!gtk_tree_model_get_iter_first (priv->child_model, &iter))
+    return;
+
+  i = 0;
+  do
+    {
+      SortElt *sort_elt;
+
+      if (i >= offset && i < offset + n_rows)
+        {
+          i++;
+          continue;
+        }
+
+      sort_elt = sort_elt_new ();
+      sort_elt->offset = i < offset ? i : i - n_rows;
+      sort_elt->zero_ref_count = 0;
+      sort_elt->ref_count = 0;
+      sort_elt->children = NULL;
+
+      if (GTK_TREE_MODEL_SORT_CACHE_CHILD_ITERS (tree_model_sort))
+        sort_elt->iter = iter;
+
+      sort_elt->siter = g_sequence_append (new_level->seq, sort_elt);
+      i++;
+    }
+  while (gtk_tree_model_iter_next (priv->child_model, &iter));
+
+  if (g_sequence_get_length (new_level->seq) > 1)
+    gtk_tree_model_sort_sort_level (tree_model_sort, new_level, FALSE, FALSE);
+}
+
+/* The rows after the first one are in the child model already when
+ * this runs, so they are handled one by one as if they were inserted
+ * in that order. The compat ::row-inserted emissions of the child model
+ * are blocked until gtk_tree_model_sort_rows_inserted_after().
+ */
+static void
+gtk_tree_model_sort_rows_inserted (GtkTreeModel *s_model,
+                                   GtkTreePath  *s_path,
+                                   GtkTreeIter  *s_iter,
+                                   gint          n_rows,
+                                   gpointer      data)
+{
+  GtkTreeModelSort *tree_model_sort = GTK_TREE_MODEL_SORT (data);
+  GtkTreeModelSortPrivate *priv = tree_model_sort->priv;
+  GtkTreePath *row_path;
+  GtkTreeIter row_iter;
+  gint i;
+
+  g_signal_handler_block (s_model, priv->inserted_id);
+
+  /* Building the root level for the first row would pick up the
+   * other rows as well, so it is built without the new rows.
+   */
+  if (!priv->root && gtk_tree_path_get_depth (s_path) == 1)
+    gtk_tree_model_sort_build_root_without (tree_model_sort,
+                                            gtk_tree_path_get_indices (s_path)[0],
+                                            n_rows);
+
+  row_path = gtk_tree_path_copy (s_path);
+  row_iter = *s_iter;
+
+  for (i = 0; i < n_rows; i++)
+    {
+      if (i > 0)
+        {
+          gtk_tree_path_next (row_path);
+          if (!gtk_tree_model_iter_next (s_model, &row_iter))
+            break;
+        }
+
+      gtk_tree_model_sort_row_inserted (s_model, row_path, &row_iter, data);
+    }
+
+  gtk_tree_path_free (row_path);
+}
+
+static void
+gtk_tree_model_sort_rows_inserted_after (GtkTreeModel *s_model,
+                                         GtkTreePath  *s_path,
+                                         GtkTreeIter  *s_iter,
+                                         gint          n_rows,
+                                         gpointer      data)
+{
+  GtkTreeModelSort *tree_model_sort = GTK_TREE_MODEL_SORT (data);
+
+  g_signal_handler_unblock (s_model, tree_model_sort->priv->inserted_id);
+}
+
 static void
 gtk_tree_model_sort_row_has_child_toggled (GtkTreeModel *s_model,
 					   GtkTreePath  *s_path,
@@ -1884,6 +2008,64 @@ gtk_tree_model_sort_offset_compare_func (gconstpointer a,
   return retval;
 }
 
+/* Sorts @level with _gtk_tree_data_list_sort_by_key() if the builtin
+ * compare function is used, which fetches every value only once.
+ */
+static gboolean
+gtk_tree_model_sort_sort_level_by_key (GtkTreeModelSort *tree_model_sort,
+                                       SortLevel        *level,
+                                       SortData         *data)
+{
+  GtkTreeModelSortPrivate *priv = tree_model_sort->priv;
+  GSequenceIter *siter, *end_siter;
+  GtkTreeIter *iters;
+  SortElt **elts;
+  gint *new_order;
+  gint n, i;
+  gboolean sorted;
+
+  if (data->sort_func != _gtk_tree_data_list_compare_func)
+    return FALSE;
+
+  n = g_sequence_get_length (level->seq);
+  elts = g_new (SortElt *, n);
+  iters = g_new (GtkTreeIter, n);
+
+  end_siter = g_sequence_get_end_iter (level->seq);
+  for (siter = g_sequence_get_begin_iter (level->seq), i = 0;
+       siter != end_siter;
+       siter = g_sequence_iter_next (siter), i++)
+    {
+      elts[i] = g_sequence_get (siter);
+
+      if (GTK_TREE_MODEL_SORT_CACHE_CHILD_ITERS (tree_model_sort))
+        iters[i] = elts[i]->iter;
+      else
+        {
+          data->parent_path_indices [data->parent_path_depth-1] = elts[i]->offset;
+          gtk_tree_model_get_iter (GTK_TREE_MODEL (priv->child_model), &iters[i], data->parent_path);
+        }
+    }
+
+  new_order = _gtk_tree_data_list_sort_by_key (priv->child_model,
+                                               GPOINTER_TO_INT (data->sort_data),
+                                               priv->order,
+                                               iters, n);
+  g_free (iters);
+
+  sorted = new_order != NULL;
+  if (sorted)
+    {
+      for (i = 0; i < n; i++)
+        g_sequence_move (elts[new_order[i]]->siter, end_siter);
+      g_free (new_order);
+    }
+
+  g_free (elts);
+
+  return sorted;
+}
+
 static void
 gtk_tree_model_sort_sort_level (GtkTreeModelSort *tree_model_sort,
 				SortLevel        *level,
@@ -1932,7 +2114,7 @@ gtk_tree_model_sort_sort_level (GtkTreeModelSort *tree_model_sort,
   if (data.sort_func == NO_SORT_FUNC)
     g_sequence_sort (level->seq, gtk_tree_model_sort_offset_compare_func,
                      &data);
-  else
+  else if (!gtk_tree_model_sort_sort_level_by_key (tree_model_sort, level, &data))
     g_sequence_sort (level->seq, gtk_tree_model_sort_compare_func, &data);
 
   free_sort_data (&data);
@@ -2134,6 +2316,10 @@ gtk_tree_model_sort_set_model (GtkTreeModelSort *tree_model_sort,
                                    priv->changed_id);
       g_signal_handler_disconnect (priv->child_model,
                                    priv->inserted_id);
+      g_signal_handler_disconnect (priv->child_model,
+                                   priv->rows_inserted_id);
+      g_signal_handler_disconnect (priv->child_model,
+                                   priv->rows_inserted_after_id);
       g_signal_handler_disconnect (priv->child_model,
                                    priv->has_child_toggled_id);
       g_signal_handler_disconnect (priv->child_model,
@@ -2165,6 +2351,14 @@ gtk_tree_model_sort_set_model (GtkTreeModelSort *tree_model_sort,
         g_signal_connect (child_model, "row-inserted",
                           G_CALLBACK (gtk_tree_model_sort_row_inserted),
                           tree_model_sort);
+      priv->rows_inserted_id =
+        g_signal_connect (child_model, "rows-inserted",
+                          G_CALLBACK (gtk_tree_model_sort_rows_inserted),
+                          tree_model_sort);
+      priv->rows_inserted_after_id =
+        g_signal_connect_after (child_model, "rows-inserted",
+                                G_CALLBACK (gtk_tree_model_sort_rows_inserted_after),
+                                tree_model_sort);
       priv->has_child_toggled_id =
         g_signal_connect (child_model, "row-has-child-toggled",
                           G_CALLBACK (gtk_tree_model_sort_row_has_child_toggled),
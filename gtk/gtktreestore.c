@@ -148,6 +148,9 @@ static gboolean gtk_tree_store_row_drop_possible  (GtkTreeDragDest   *drag_dest,
 /* Sortable Interfaces */
 
 static void     gtk_tree_store_sort                    (GtkTreeStore           *tree_store);
+static void     gtk_tree_store_sort_helper             (GtkTreeStore           *tree_store,
+							GNode                  *parent,
+							gboolean                recurse);
 static void     gtk_tree_store_sort_iter_changed       (GtkTreeStore           *tree_store,
 							GtkTreeIter            *iter,
 							gint                    column,
@@ -1648,6 +1651,112 @@ gtk_tree_store_insert_with_valuesv (GtkTreeStore *tree_store,
   validate_tree ((GtkTreeStore *)tree_store);
 }
 
+/**
+ * gtk_tree_store_insert_rows_with_valuesv:
+ * @tree_store: A #GtkTreeStore
+ * @parent: (allow-none): A valid #GtkTreeIter, or %NULL
+ * @position: position to insert the new rows, or -1 to append them
+ * @n_rows: the number of rows to insert
+ * @columns: (array length=n_values): an array of column numbers
+ * @values: (array): an array of @n_rows times @n_values GValues,
+ *     holding the values of the first row, followed by those of the
+ *     second row, and so on
+ * @n_values: the length of the @columns array
+ *
+ * Inserts @n_rows children of @parent at @position, like calling
+ * gtk_tree_store_insert_with_valuesv() for every row, but emits a
+ * single #GtkTreeModel::rows-inserted signal for all of them.
+ *
+ * If @tree_store is sorted, the rows are appended and then sorted into
+ * place, which emits #GtkTreeModel::rows-reordered.
+ */
+void
+gtk_tree_store_insert_rows_with_valuesv (GtkTreeStore *tree_store,
+                                         GtkTreeIter  *parent,
+                                         gint          position,
+                                         gint          n_rows,
+                                         gint         *columns,
+                                         GValue       *values,
+                                         gint          n_values)
+{
+  GtkTreeStorePrivate *priv = tree_store->priv;
+  GtkTreePath *path;
+  GNode *parent_node;
+  GNode *prev_node;
+  GNode *new_node;
+  GtkTreeIter iter, first = { 0, };
+  gboolean had_children;
+  gboolean changed = FALSE;
+  gboolean maybe_need_sort = FALSE;
+  gint i;
+
+  g_return_if_fail (GTK_IS_TREE_STORE (tree_store));
+  g_return_if_fail (n_rows >= 0);
+  g_return_if_fail (n_values == 0 || (columns != NULL && values != NULL));
+
+  if (parent)
+    g_return_if_fail (VALID_ITER (parent, tree_store));
+
+  if (n_rows == 0)
+    return;
+
+  if (parent)
+    parent_node = parent->user_data;
+  else
+    parent_node = priv->root;
+
+  priv->columns_dirty = TRUE;
+
+  had_children = parent_node->children != NULL;
+
+  /* g_node_insert() walks the children for every row, so find
+   * the node to insert after once and chain the rows from there
+   */
+  if (position == 0)
+    prev_node = NULL;
+  else if (position < 0 || GTK_TREE_STORE_IS_SORTED (tree_store))
+    prev_node = g_node_last_child (parent_node);
+  else
+    {
+      prev_node = g_node_nth_child (parent_node, position - 1);
+      if (prev_node == NULL)
+        prev_node = g_node_last_child (parent_node);
+    }
+
+  iter.stamp = priv->stamp;
+  for (i = 0; i < n_rows; i++)
+    {
+      new_node = g_node_new (NULL);
+      g_node_insert_after (parent_node, prev_node, new_node);
+      prev_node = new_node;
+
+      iter.user_data = new_node;
+      if (i == 0)
+        first = iter;
+
+      gtk_tree_store_set_vector_internal (tree_store, &iter,
+                                          &changed, &maybe_need_sort,
+                                          columns, values + i * n_values,
+                                          n_values);
+    }
+
+  path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), &first);
+  gtk_tree_model_rows_inserted (GTK_TREE_MODEL (tree_store), path, &first, n_rows);
+
+  if (parent_node != priv->root && !had_children)
+    {
+      gtk_tree_path_up (path);
+      gtk_tree_model_row_has_child_toggled (GTK_TREE_MODEL (tree_store), path, parent);
+    }
+
+  gtk_tree_path_free (path);
+
+  if (GTK_TREE_STORE_IS_SORTED (tree_store))
+    gtk_tree_store_sort_helper (tree_store, parent_node, FALSE);
+
+  validate_tree ((GtkTreeStore *)tree_store);
+}
+
 /**
  * gtk_tree_store_prepend:
  * @tree_store: A #GtkTreeStore
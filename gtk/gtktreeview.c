@@ -418,6 +418,12 @@ struct _GtkTreeViewPrivate
   /* fixed height */
   gint fixed_height;
 
+  /* Heights of all rows validated so far, used to estimate the
+   * height of invalid rows when estimate_row_heights is set.
+   */
+  guint64 validated_height_sum;
+  guint n_validated_rows;
+
   GtkRBNode *rubber_band_start_node;
   GtkRBTree *rubber_band_start_tree;
 
@@ -473,6 +479,9 @@ struct _GtkTreeViewPrivate
   guint fixed_height_mode : 1;
   guint fixed_height_check : 1;
 
+  guint estimate_row_heights : 1;
+  guint estimated_height_applied : 1;
+
   guint activate_on_single_click : 1;
   guint reorderable : 1;
   guint header_has_focus : 1;
@@ -565,6 +574,7 @@ enum {
   PROP_ENABLE_TREE_LINES,
   PROP_TOOLTIP_COLUMN,
   PROP_ACTIVATE_ON_SINGLE_CLICK,
+  PROP_ESTIMATE_ROW_HEIGHTS,
   LAST_PROP,
   /* overridden */
   PROP_HADJUSTMENT = LAST_PROP,
@@ -676,6 +686,16 @@ static void gtk_tree_view_row_inserted                    (GtkTreeModel    *mode
 							   GtkTreePath     *path,
 							   GtkTreeIter     *iter,
 							   gpointer         data);
+static void gtk_tree_view_rows_inserted                   (GtkTreeModel    *model,
+							   GtkTreePath     *path,
+							   GtkTreeIter     *iter,
+							   gint             n_rows,
+							   gpointer         data);
+static void gtk_tree_view_rows_inserted_after             (GtkTreeModel    *model,
+							   GtkTreePath     *path,
+							   GtkTreeIter     *iter,
+							   gint             n_rows,
+							   gpointer         data);
 static void gtk_tree_view_row_has_child_toggled           (GtkTreeModel    *model,
 							   GtkTreePath     *path,
 							   GtkTreeIter     *iter,
@@ -1186,6 +1206,22 @@ gtk_tree_view_class_init (GtkTreeViewClass *class)
                             FALSE,
                             GTK_PARAM_READWRITE|G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * GtkTreeView:estimate-row-heights:
+   *
+   * Setting the ::estimate-row-heights property to %TRUE makes
+   * #GtkTreeView only measure the rows around the visible area and
+   * a scroll target, and use the average height of the measured rows
+   * for all other rows. Please see gtk_tree_view_set_estimate_row_heights()
+   * for more information on this option.
+   */
+  tree_view_props[PROP_ESTIMATE_ROW_HEIGHTS] =
+      g_param_spec_boolean ("estimate-row-heights",
+                            P_("Estimate Row Heights"),
+                            P_("Only measure visible rows and estimate the height of the others"),
+                            FALSE,
+                            GTK_PARAM_READWRITE|G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (o_class, LAST_PROP, tree_view_props);
 
   /* Signals */
@@ -1868,6 +1904,9 @@ gtk_tree_view_set_property (GObject         *object,
     case PROP_ACTIVATE_ON_SINGLE_CLICK:
       gtk_tree_view_set_activate_on_single_click (tree_view, g_value_get_boolean (value));
       break;
+    case PROP_ESTIMATE_ROW_HEIGHTS:
+      gtk_tree_view_set_estimate_row_heights (tree_view, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1949,6 +1988,9 @@ gtk_tree_view_get_property (GObject    *object,
     case PROP_ACTIVATE_ON_SINGLE_CLICK:
       g_value_set_boolean (value, tree_view->priv->activate_on_single_click);
       break;
+    case PROP_ESTIMATE_ROW_HEIGHTS:
+      g_value_set_boolean (value, tree_view->priv->estimate_row_heights);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -4481,6 +4523,10 @@ typedef enum {
   GTK_TREE_VIEW_FOREGROUND_LINE
 } GtkTreeViewLineType;
 
+/* Tree and grid lines are always horizontal or vertical, so they are
+ * emitted as color nodes instead of being stroked with cairo; dashed lines
+ * repeat a single on/off pixel pair.
+ */
 static void
 gtk_tree_view_snapshot_line (GtkTreeView         *tree_view,
                              GtkSnapshot         *snapshot,
@@ -4491,67 +4537,76 @@ gtk_tree_view_snapshot_line (GtkTreeView         *tree_view,
                              int                  y2)
 {
   GtkStyleContext *context;
-  cairo_t *cr;
+  GdkRGBA color;
+  graphene_rect_t bounds;
+  const double *dashes;
+  int line_width;
 
-  cr = gtk_snapshot_append_cairo (snapshot,
-                                  &GRAPHENE_RECT_INIT (
-                                     MIN (x1, x2),
-                                     MIN (y1, y2),
-                                     ABS (x2 - x1) + 1,
-                                     ABS (y2 - y1) + 1
-                                  ),
-                                  "TreeViewGridLine");
+  if (x1 != x2 && y1 != y2)
+    {
+      g_warn_if_reached ();
+      return;
+    }
 
   context = gtk_widget_get_style_context (GTK_WIDGET (tree_view));
 
   switch (type)
     {
     case GTK_TREE_VIEW_TREE_LINE:
-      {
-        const GdkRGBA *color;
-
-        color = _gtk_css_rgba_value_get_rgba (_gtk_style_context_peek_property (context, GTK_CSS_PROPERTY_BORDER_LEFT_COLOR));
-
-        gdk_cairo_set_source_rgba (cr, color);
-        cairo_set_line_width (cr, _TREE_VIEW_TREE_LINE_WIDTH);
-        if (tree_view->priv->tree_line_dashes[0])
-          cairo_set_dash (cr, tree_view->priv->tree_line_dashes, 2, 0.5);
-      }
+      color = *_gtk_css_rgba_value_get_rgba (_gtk_style_context_peek_property (context, GTK_CSS_PROPERTY_BORDER_LEFT_COLOR));
+      line_width = _TREE_VIEW_TREE_LINE_WIDTH;
+      dashes = tree_view->priv->tree_line_dashes;
       break;
 
     case GTK_TREE_VIEW_GRID_LINE:
-      {
-        const GdkRGBA *color;
-
-        color = _gtk_css_rgba_value_get_rgba (_gtk_style_context_peek_property (context, GTK_CSS_PROPERTY_BORDER_TOP_COLOR));
-
-        gdk_cairo_set_source_rgba (cr, color);
-        cairo_set_line_width (cr, _TREE_VIEW_GRID_LINE_WIDTH);
-        if (tree_view->priv->grid_line_dashes[0])
-          cairo_set_dash (cr, tree_view->priv->grid_line_dashes, 2, 0.5);
-      }
+      color = *_gtk_css_rgba_value_get_rgba (_gtk_style_context_peek_property (context, GTK_CSS_PROPERTY_BORDER_TOP_COLOR));
+      line_width = _TREE_VIEW_GRID_LINE_WIDTH;
+      dashes = tree_view->priv->grid_line_dashes;
       break;
 
     case GTK_TREE_VIEW_FOREGROUND_LINE:
-      {
-        GdkRGBA color;
-
-        cairo_set_line_width (cr, 1.0);
-        gtk_style_context_get_color (context, &color);
-        gdk_cairo_set_source_rgba (cr, &color);
-      }
+      gtk_style_context_get_color (context, &color);
+      line_width = 1;
+      dashes = NULL;
       break;
 
     default:
       g_assert_not_reached ();
-      break;
+      return;
     }
 
-  cairo_move_to (cr, x1 + 0.5, y1 + 0.5);
-  cairo_line_to (cr, x2 + 0.5, y2 + 0.5);
-  cairo_stroke (cr);
+  if (x1 == x2)
+    graphene_rect_init (&bounds, x1, MIN (y1, y2), line_width, ABS (y2 - y1) + 1);
+  else
+    graphene_rect_init (&bounds, MIN (x1, x2), y1, ABS (x2 - x1) + 1, line_width);
 
-  cairo_destroy (cr);
+  if (dashes && dashes[0])
+    {
+      graphene_rect_t child_bounds;
+
+      if (x1 == x2)
+        graphene_rect_init (&child_bounds,
+                            bounds.origin.x, bounds.origin.y,
+                            line_width, dashes[0] + dashes[1]);
+      else
+        graphene_rect_init (&child_bounds,
+                            bounds.origin.x, bounds.origin.y,
+                            dashes[0] + dashes[1], line_width);
+
+      gtk_snapshot_push_repeat (snapshot, &bounds, &child_bounds, "TreeViewDashedLine");
+
+      if (x1 == x2)
+        child_bounds.size.height = dashes[0];
+      else
+        child_bounds.size.width = dashes[0];
+
+      gtk_snapshot_append_color (snapshot, &color, &child_bounds, "TreeViewDash");
+      gtk_snapshot_pop (snapshot);
+    }
+  else
+    {
+      gtk_snapshot_append_color (snapshot, &color, &bounds, "TreeViewLine");
+    }
 }
                          
 static void
@@ -6003,6 +6058,12 @@ validate_row (GtkTreeView *tree_view,
   if (draw_hgrid_lines)
     height += _TREE_VIEW_GRID_LINE_WIDTH;
 
+  if (GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_INVALID) && !is_separator)
+    {
+      tree_view->priv->validated_height_sum += height;
+      tree_view->priv->n_validated_rows++;
+    }
+
   if (height != GTK_RBNODE_GET_HEIGHT (node))
     {
       retval = TRUE;
@@ -6015,6 +6076,43 @@ validate_row (GtkTreeView *tree_view,
 }
 
 
+/* Returns the height to use for rows that have not been validated,
+ * or 0 if they should not get a height.
+ */
+static gint
+gtk_tree_view_get_estimated_row_height (GtkTreeView *tree_view)
+{
+  if (!tree_view->priv->estimate_row_heights ||
+      tree_view->priv->n_validated_rows == 0)
+    return 0;
+
+  return MAX (1, tree_view->priv->validated_height_sum / tree_view->priv->n_validated_rows);
+}
+
+/* Gives all invalid rows the estimated height once one is known, so
+ * that the total height and the row offsets are close to their real
+ * values without measuring every row. The estimates get replaced by
+ * real heights as rows are validated, and the top row keeps its
+ * position on screen through gtk_tree_view_top_row_to_dy().
+ */
+static gboolean
+gtk_tree_view_apply_estimated_row_height (GtkTreeView *tree_view)
+{
+  gint height;
+
+  if (tree_view->priv->estimated_height_applied || tree_view->priv->tree == NULL)
+    return FALSE;
+
+  height = gtk_tree_view_get_estimated_row_height (tree_view);
+  if (height == 0)
+    return FALSE;
+
+  _gtk_rbtree_set_fixed_height (tree_view->priv->tree, height, FALSE);
+  tree_view->priv->estimated_height_applied = TRUE;
+
+  return TRUE;
+}
+
 static void
 validate_visible_area (GtkTreeView *tree_view)
 {
@@ -6455,6 +6553,19 @@ do_validate_rows (GtkTreeView *tree_view, gboolean queue_resize)
       return FALSE;
     }
 
+  /* With estimated heights, rows are only validated when they become
+   * visible. We still do one chunk up front to get initial column
+   * widths and a first estimate.
+   */
+  if (tree_view->priv->estimate_row_heights &&
+      tree_view->priv->n_validated_rows > 0)
+    {
+      if (gtk_tree_view_apply_estimated_row_height (tree_view) && queue_resize)
+        gtk_widget_queue_resize_no_redraw (GTK_WIDGET (tree_view));
+
+      return FALSE;
+    }
+
   timer = g_timer_new ();
   g_timer_start (timer);
 
@@ -6644,6 +6755,8 @@ do_presize_handler (GtkTreeView *tree_view)
       tree_view->priv->mark_rows_col_dirty = FALSE;
     }
   validate_visible_area (tree_view);
+  if (gtk_tree_view_apply_estimated_row_height (tree_view))
+    gtk_widget_queue_resize (GTK_WIDGET (tree_view));
   if (tree_view->priv->presize_handler_tick_cb != 0)
     {
       gtk_widget_remove_tick_callback (GTK_WIDGET (tree_view), tree_view->priv->presize_handler_tick_cb);
@@ -8059,6 +8172,69 @@ gtk_tree_view_get_fixed_height_mode (GtkTreeView *tree_view)
   return tree_view->priv->fixed_height_mode;
 }
 
+/**
+ * gtk_tree_view_set_estimate_row_heights:
+ * @tree_view: a #GtkTreeView
+ * @enable: %TRUE to estimate the height of rows that were not measured
+ *
+ * Enables or disables estimating row heights in @tree_view.
+ *
+ * Normally, #GtkTreeView measures every row of the model in the
+ * background to compute its exact height, which can take a long time
+ * for large models. With estimated row heights, only the rows around
+ * the visible area and around a row that is scrolled to are measured.
+ * All other rows are assumed to have the average height of the rows
+ * measured so far, and get their real height once they are displayed.
+ *
+ * This makes scrolling to any position of a large model instant, at
+ * the cost of a scrollbar that is only approximately right. Unlike
+ * gtk_tree_view_set_fixed_height_mode(), rows may have different heights.
+ **/
+void
+gtk_tree_view_set_estimate_row_heights (GtkTreeView *tree_view,
+                                        gboolean     enable)
+{
+  g_return_if_fail (GTK_IS_TREE_VIEW (tree_view));
+
+  enable = enable != FALSE;
+
+  if (enable == tree_view->priv->estimate_row_heights)
+    return;
+
+  tree_view->priv->estimate_row_heights = enable;
+  tree_view->priv->estimated_height_applied = FALSE;
+
+  if (enable)
+    {
+      if (gtk_tree_view_apply_estimated_row_height (tree_view))
+        gtk_widget_queue_resize (GTK_WIDGET (tree_view));
+    }
+  else
+    {
+      /* Validate everything again in the background */
+      install_presize_handler (tree_view);
+    }
+
+  g_object_notify_by_pspec (G_OBJECT (tree_view), tree_view_props[PROP_ESTIMATE_ROW_HEIGHTS]);
+}
+
+/**
+ * gtk_tree_view_get_estimate_row_heights:
+ * @tree_view: a #GtkTreeView
+ *
+ * Returns whether @tree_view estimates the height of rows that have
+ * not been measured, see gtk_tree_view_set_estimate_row_heights().
+ *
+ * Returns: %TRUE if row heights are estimated
+ **/
+gboolean
+gtk_tree_view_get_estimate_row_heights (GtkTreeView *tree_view)
+{
+  g_return_val_if_fail (GTK_IS_TREE_VIEW (tree_view), FALSE);
+
+  return tree_view->priv->estimate_row_heights;
+}
+
 /* Returns TRUE if the focus is within the headers, after the focus operation is
  * done
  */
@@ -8593,7 +8769,7 @@ gtk_tree_view_row_inserted (GtkTreeModel *model,
       && tree_view->priv->fixed_height >= 0)
     height = tree_view->priv->fixed_height;
   else
-    height = 0;
+    height = gtk_tree_view_get_estimated_row_height (tree_view);
 
   if (path == NULL)
     {
@@ -8685,6 +8861,137 @@ gtk_tree_view_row_inserted (GtkTreeModel *model,
     gtk_tree_path_free (path);
 }
 
+/* Bulk variant of gtk_tree_view_row_inserted(). The per-row handler is
+ * blocked until gtk_tree_view_rows_inserted_after() runs, so the
+ * compatibility row-inserted emissions of the model are not seen twice.
+ */
+static void
+gtk_tree_view_rows_inserted (GtkTreeModel *model,
+                             GtkTreePath  *path,
+                             GtkTreeIter  *iter,
+                             gint          n_rows,
+                             gpointer      data)
+{
+  GtkTreeView *tree_view = (GtkTreeView *) data;
+  GtkTreeIter row_iter;
+  GtkTreePath *row_path;
+  GtkRBTree *tree;
+  GtkRBNode *tmpnode = NULL;
+  gint *indices;
+  gint depth;
+  gint height;
+  gint i;
+
+  g_signal_handlers_block_by_func (model, gtk_tree_view_row_inserted, tree_view);
+
+  if (tree_view->priv->fixed_height_mode
+      && tree_view->priv->fixed_height >= 0)
+    height = tree_view->priv->fixed_height;
+  else
+    height = gtk_tree_view_get_estimated_row_height (tree_view);
+
+  if (tree_view->priv->tree == NULL)
+    tree_view->priv->tree = _gtk_rbtree_new ();
+
+  tree = tree_view->priv->tree;
+
+  /* Update all row-references */
+  row_path = gtk_tree_path_copy (path);
+  for (i = 0; i < n_rows; i++)
+    {
+      gtk_tree_row_reference_inserted (G_OBJECT (data), row_path);
+      gtk_tree_path_next (row_path);
+    }
+  gtk_tree_path_free (row_path);
+
+  depth = gtk_tree_path_get_depth (path);
+  indices = gtk_tree_path_get_indices (path);
+
+  /* First, find the parent tree */
+  for (i = 0; i < depth - 1 && tree != NULL; i++)
+    {
+      tmpnode = _gtk_rbtree_find_count (tree, indices[i] + 1);
+      if (tmpnode == NULL)
+	{
+	  g_warning ("Nodes were inserted with a parent that's not in the tree.\n" \
+		     "This possibly means that a GtkTreeModel inserted child nodes\n" \
+		     "before the parent was inserted.");
+          return;
+	}
+      else if (!GTK_RBNODE_FLAG_SET (tmpnode, GTK_RBNODE_IS_PARENT))
+	{
+	  GtkTreePath *tmppath = _gtk_tree_path_new_from_rbtree (tree, tmpnode);
+	  gtk_tree_view_row_has_child_toggled (model, tmppath, NULL, data);
+	  gtk_tree_path_free (tmppath);
+          return;
+	}
+
+      tree = tmpnode->children;
+    }
+
+  if (tree == NULL)
+    {
+      /* We aren't showing the nodes */
+      if (height > 0)
+        gtk_widget_queue_resize_no_redraw (GTK_WIDGET (tree_view));
+      else
+        install_presize_handler (tree_view);
+      return;
+    }
+
+  row_iter = *iter;
+
+  if (_gtk_rbtree_is_nil (tree->root))
+    {
+      GtkRBNode *next = _gtk_rbtree_insert_n (tree, n_rows, height, height > 0);
+
+      for (i = 0; i < n_rows; i++)
+        {
+          gtk_tree_model_ref_node (model, &row_iter);
+          _gtk_tree_view_accessible_add (tree_view, tree, next);
+          next = _gtk_rbtree_next (tree, next);
+          gtk_tree_model_iter_next (model, &row_iter);
+        }
+    }
+  else
+    {
+      for (i = 0; i < n_rows; i++)
+        {
+          gtk_tree_model_ref_node (model, &row_iter);
+
+          if (i > 0)
+            tmpnode = _gtk_rbtree_insert_after (tree, tmpnode, height, FALSE);
+          else if (indices[depth - 1] == 0)
+            tmpnode = _gtk_rbtree_insert_before (tree, _gtk_rbtree_find_count (tree, 1),
+                                                 height, FALSE);
+          else
+            tmpnode = _gtk_rbtree_insert_after (tree, _gtk_rbtree_find_count (tree, indices[depth - 1]),
+                                                height, FALSE);
+
+          if (height > 0)
+            _gtk_rbtree_node_mark_valid (tree, tmpnode);
+
+          _gtk_tree_view_accessible_add (tree_view, tree, tmpnode);
+          gtk_tree_model_iter_next (model, &row_iter);
+        }
+    }
+
+  if (height > 0)
+    gtk_widget_queue_resize (GTK_WIDGET (tree_view));
+  else
+    install_presize_handler (tree_view);
+}
+
+static void
+gtk_tree_view_rows_inserted_after (GtkTreeModel *model,
+                                   GtkTreePath  *path,
+                                   GtkTreeIter  *iter,
+                                   gint          n_rows,
+                                   gpointer      data)
+{
+  g_signal_handlers_unblock_by_func (model, gtk_tree_view_row_inserted, data);
+}
+
 static void
 gtk_tree_view_row_has_child_toggled (GtkTreeModel *model,
 				     GtkTreePath  *path,
@@ -9075,21 +9382,48 @@ gtk_tree_view_build_tree (GtkTreeView *tree_view,
 			  gboolean     recurse)
 {
   GtkRBNode *temp = NULL;
+  GtkRBNode *next = NULL;
   GtkTreePath *path = NULL;
+  gint height;
+  gboolean valid;
+
+  if (tree_view->priv->fixed_height > 0)
+    {
+      height = tree_view->priv->fixed_height;
+      valid = TRUE;
+    }
+  else
+    {
+      height = gtk_tree_view_get_estimated_row_height (tree_view);
+      valid = FALSE;
+    }
+
+  /* Create all nodes of a new level at once, that is much faster
+   * for large models than inserting them one by one.
+   */
+  if (_gtk_rbtree_is_nil (tree->root))
+    {
+      GtkTreeIter parent;
+      gint n_children;
+
+      if (gtk_tree_model_iter_parent (tree_view->priv->model, &parent, iter))
+        n_children = gtk_tree_model_iter_n_children (tree_view->priv->model, &parent);
+      else
+        n_children = gtk_tree_model_iter_n_children (tree_view->priv->model, NULL);
+
+      next = _gtk_rbtree_insert_n (tree, n_children, height, valid);
+    }
 
   do
     {
       gtk_tree_model_ref_node (tree_view->priv->model, iter);
-      temp = _gtk_rbtree_insert_after (tree, temp, 0, FALSE);
-
-      if (tree_view->priv->fixed_height > 0)
+      if (next)
         {
-          if (GTK_RBNODE_FLAG_SET (temp, GTK_RBNODE_INVALID))
-	    {
-              _gtk_rbtree_node_set_height (tree, temp, tree_view->priv->fixed_height);
-	      _gtk_rbtree_node_mark_valid (tree, temp);
-	    }
+          temp = next;
+          next = _gtk_rbtree_next (tree, temp);
         }
+      else
+        temp = _gtk_rbtree_insert_after (tree, temp, height, valid);
 
       if (tree_view->priv->is_list)
         continue;
@@ -10941,6 +11275,12 @@ gtk_tree_view_set_model (GtkTreeView  *tree_view,
       g_signal_handlers_disconnect_by_func (tree_view->priv->model,
 					    gtk_tree_view_row_inserted,
 					    tree_view);
+      g_signal_handlers_disconnect_by_func (tree_view->priv->model,
+					    gtk_tree_view_rows_inserted,
+					    tree_view);
+      g_signal_handlers_disconnect_by_func (tree_view->priv->model,
+					    gtk_tree_view_rows_inserted_after,
+					    tree_view);
       g_signal_handlers_disconnect_by_func (tree_view->priv->model,
 					    gtk_tree_view_row_has_child_toggled,
 					    tree_view);
@@ -10974,6 +11314,9 @@ gtk_tree_view_set_model (GtkTreeView  *tree_view,
       tree_view->priv->search_column = -1;
       tree_view->priv->fixed_height_check = 0;
       tree_view->priv->fixed_height = -1;
+      tree_view->priv->validated_height_sum = 0;
+      tree_view->priv->n_validated_rows = 0;
+      tree_view->priv->estimated_height_applied = FALSE;
       tree_view->priv->dy = tree_view->priv->top_row_dy = 0;
     }
 
@@ -11009,6 +11352,14 @@ gtk_tree_view_set_model (GtkTreeView  *tree_view,
 			"row-inserted",
 			G_CALLBACK (gtk_tree_view_row_inserted),
 			tree_view);
+      g_signal_connect (tree_view->priv->model,
+			"rows-inserted",
+			G_CALLBACK (gtk_tree_view_rows_inserted),
+			tree_view);
+      g_signal_connect_after (tree_view->priv->model,
+			      "rows-inserted",
+			      G_CALLBACK (gtk_tree_view_rows_inserted_after),
+			      tree_view);
       g_signal_connect (tree_view->priv->model,
 			"row-has-child-toggled",
 			G_CALLBACK (gtk_tree_view_row_has_child_toggled),
@@ -489,6 +489,11 @@ void     gtk_tree_view_set_fixed_height_mode (GtkTreeView          *tree_view,
 GDK_AVAILABLE_IN_ALL
 gboolean gtk_tree_view_get_fixed_height_mode (GtkTreeView          *tree_view);
 GDK_AVAILABLE_IN_ALL
+void     gtk_tree_view_set_estimate_row_heights (GtkTreeView       *tree_view,
+                                                 gboolean           enable);
+GDK_AVAILABLE_IN_ALL
+gboolean gtk_tree_view_get_estimate_row_heights (GtkTreeView       *tree_view);
+GDK_AVAILABLE_IN_ALL
 void     gtk_tree_view_set_hover_selection   (GtkTreeView          *tree_view,
 					      gboolean              hover);
 GDK_AVAILABLE_IN_ALL
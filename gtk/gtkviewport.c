@@ -31,10 +31,13 @@
 #include "gtkmarshalers.h"
 #include "gtkprivate.h"
 #include "gtkscrollable.h"
-#include "gtksnapshot.h"
+#include "gtksnapshotprivate.h"
 #include "gtktypebuiltins.h"
 #include "gtkwidgetprivate.h"
 
+#include "gdk/gdktextureprivate.h"
+#include "gsk/gskcairorendererprivate.h"
+
 
 /**
  * SECTION:gtkviewport
@@ -58,6 +61,10 @@
  * The GtkViewport will start scrolling content only if allocated less
  * than the child widget’s minimum size in a given orientation.
  *
+ * When rendering with cairo, GtkViewport keeps the last rendered contents
+ * of its child. As long as the child does not queue a redraw, scrolling
+ * copies these contents and only draws the newly exposed area.
+ *
  * # CSS nodes
  *
  * GtkViewport has a single CSS node with name viewport.
@@ -73,6 +80,19 @@ struct _GtkViewportPrivate
    * driving the scrollable adjustment values */
   guint hscroll_policy : 1;
   guint vscroll_policy : 1;
+
+  /* The rendered contents of the child, and the textures appended for
+   * them. The two are used in turn: scroll_front holds the last frame,
+   * at the child position scroll_x, scroll_y, and is valid while the
+   * child's content serial is unchanged. The other one is drawn next.
+   */
+  cairo_surface_t *scroll_surfaces[2];
+  GdkTexture      *scroll_textures[2];
+  guint            scroll_front;
+  GtkWidget       *scroll_child;
+  guint            scroll_serial;
+  int              scroll_x;
+  int              scroll_y;
 };
 
 enum {
@@ -94,6 +114,7 @@ static void gtk_viewport_get_property             (GObject         *object,
 						   GValue          *value,
 						   GParamSpec      *pspec);
 static void gtk_viewport_destroy                  (GtkWidget        *widget);
+static void gtk_viewport_unmap                    (GtkWidget        *widget);
 static void gtk_viewport_snapshot                 (GtkWidget        *widget,
 						   GtkSnapshot      *snapshot);
 static void gtk_viewport_size_allocate            (GtkWidget           *widget,
@@ -251,6 +272,7 @@ gtk_viewport_class_init (GtkViewportClass *class)
   gobject_class->get_property = gtk_viewport_get_property;
 
   widget_class->destroy = gtk_viewport_destroy;
+  widget_class->unmap = gtk_viewport_unmap;
   widget_class->snapshot = gtk_viewport_snapshot;
   widget_class->size_allocate = gtk_viewport_size_allocate;
   widget_class->measure = gtk_viewport_measure;
@@ -417,6 +439,20 @@ viewport_disconnect_adjustment (GtkViewport    *viewport,
     }
 }
 
+static void
+gtk_viewport_clear_scroll_cache (GtkViewport *viewport)
+{
+  GtkViewportPrivate *priv = viewport->priv;
+  int i;
+
+  for (i = 0; i < 2; i++)
+    {
+      g_clear_object (&priv->scroll_textures[i]);
+      g_clear_pointer (&priv->scroll_surfaces[i], cairo_surface_destroy);
+    }
+  priv->scroll_child = NULL;
+}
+
 static void
 gtk_viewport_destroy (GtkWidget *widget)
 {
@@ -425,9 +461,21 @@ gtk_viewport_destroy (GtkWidget *widget)
   viewport_disconnect_adjustment (viewport, GTK_ORIENTATION_HORIZONTAL);
   viewport_disconnect_adjustment (viewport, GTK_ORIENTATION_VERTICAL);
 
+  gtk_viewport_clear_scroll_cache (viewport);
+
   GTK_WIDGET_CLASS (gtk_viewport_parent_class)->destroy (widget);
 }
 
+static void
+gtk_viewport_unmap (GtkWidget *widget)
+{
+  GtkViewport *viewport = GTK_VIEWPORT (widget);
+
+  gtk_viewport_clear_scroll_cache (viewport);
+
+  GTK_WIDGET_CLASS (gtk_viewport_parent_class)->unmap (widget);
+}
+
 static void
 viewport_set_adjustment (GtkViewport    *viewport,
 			 GtkOrientation  orientation,
@@ -506,10 +554,144 @@ gtk_viewport_get_shadow_type (GtkViewport *viewport)
   return viewport->priv->shadow_type;
 }
 
+static void
+gtk_viewport_draw_child_area (GtkViewport                 *viewport,
+                              GtkWidget                   *child,
+                              GtkSnapshot                 *snapshot,
+                              cairo_t                     *cr,
+                              const cairo_rectangle_int_t *area)
+{
+  GskRenderNode *node;
+
+  /* Record only the part of the child inside @area, in our coordinates */
+  gtk_snapshot_push (snapshot, FALSE, "ViewportExposed");
+  gtk_snapshot_push_clip (snapshot,
+                          &GRAPHENE_RECT_INIT (area->x, area->y, area->width, area->height),
+                          "ViewportExposedClip");
+  gtk_widget_snapshot_child (GTK_WIDGET (viewport), child, snapshot);
+  gtk_snapshot_pop (snapshot);
+  node = gtk_snapshot_pop_collect (snapshot);
+
+  /* The surface may still hold an older frame here */
+  cairo_save (cr);
+  gdk_cairo_rectangle (cr, area);
+  cairo_clip (cr);
+  cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+  cairo_paint (cr);
+  cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
+  if (node != NULL)
+    {
+      gsk_render_node_draw (node, cr);
+      gsk_render_node_unref (node);
+    }
+  cairo_restore (cr);
+}
+
+/* Renders the child into an image and appends that. If the child only
+ * moved since the last frame, the previous image is copied to its new
+ * position and only the exposed strips are drawn again.
+ */
+static void
+gtk_viewport_snapshot_scrolled (GtkViewport *viewport,
+                                GtkWidget   *child,
+                                GtkSnapshot *snapshot)
+{
+  GtkViewportPrivate *priv = viewport->priv;
+  GtkWidget *widget = GTK_WIDGET (viewport);
+  GtkAllocation child_allocation;
+  cairo_rectangle_int_t rect;
+  cairo_surface_t *front, *surface;
+  cairo_region_t *exposed;
+  guint back;
+  cairo_t *cr;
+  int width, height, scale;
+  int i, n_rects;
+
+  width = gtk_widget_get_width (widget);
+  height = gtk_widget_get_height (widget);
+  scale = gtk_widget_get_scale_factor (widget);
+  _gtk_widget_get_allocation (child, &child_allocation);
+
+  front = priv->scroll_surfaces[priv->scroll_front];
+  back = 1 - priv->scroll_front;
+
+  /* The back texture was appended two frames ago. Its pixels can only be
+   * reused if that frame's nodes are gone by now; if anything else still
+   * holds on to the texture, it gets a new one.
+   */
+  surface = priv->scroll_surfaces[back];
+  if (surface == NULL ||
+      cairo_image_surface_get_width (surface) != width * scale ||
+      cairo_image_surface_get_height (surface) != height * scale ||
+      G_OBJECT (priv->scroll_textures[back])->ref_count > 1)
+    {
+      g_clear_object (&priv->scroll_textures[back]);
+      g_clear_pointer (&priv->scroll_surfaces[back], cairo_surface_destroy);
+
+      surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width * scale, height * scale);
+      cairo_surface_set_device_scale (surface, scale, scale);
+      priv->scroll_surfaces[back] = surface;
+      priv->scroll_textures[back] = gdk_texture_new_for_surface (surface);
+    }
+  else
+    {
+      gdk_texture_clear_render_data (priv->scroll_textures[back]);
+    }
+
+  cr = cairo_create (surface);
+
+  exposed = cairo_region_create_rectangle (&(cairo_rectangle_int_t) { 0, 0, width, height });
+
+  if (front != NULL &&
+      priv->scroll_child == child &&
+      priv->scroll_serial == _gtk_widget_get_content_serial (child) &&
+      cairo_image_surface_get_width (front) == width * scale &&
+      cairo_image_surface_get_height (front) == height * scale)
+    {
+      rect.x = child_allocation.x - priv->scroll_x;
+      rect.y = child_allocation.y - priv->scroll_y;
+      rect.width = width;
+      rect.height = height;
+
+      cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
+      cairo_set_source_surface (cr, front, rect.x, rect.y);
+      gdk_cairo_rectangle (cr, &rect);
+      cairo_fill (cr);
+      cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
+
+      cairo_region_subtract_rectangle (exposed, &rect);
+    }
+
+  n_rects = cairo_region_num_rectangles (exposed);
+  for (i = 0; i < n_rects; i++)
+    {
+      cairo_region_get_rectangle (exposed, i, &rect);
+      gtk_viewport_draw_child_area (viewport, child, snapshot, cr, &rect);
+    }
+
+  cairo_region_destroy (exposed);
+  cairo_destroy (cr);
+  cairo_surface_flush (surface);
+
+  gtk_snapshot_append_texture (snapshot,
+                               priv->scroll_textures[back],
+                               &GRAPHENE_RECT_INIT (0, 0, width, height),
+                               "ViewportContents");
+
+  priv->scroll_front = back;
+  priv->scroll_child = child;
+  priv->scroll_serial = _gtk_widget_get_content_serial (child);
+  priv->scroll_x = child_allocation.x;
+  priv->scroll_y = child_allocation.y;
+}
+
 static void
 gtk_viewport_snapshot (GtkWidget   *widget,
                        GtkSnapshot *snapshot)
 {
+  GtkViewport *viewport = GTK_VIEWPORT (widget);
+  GtkWidget *child;
+
   gtk_snapshot_push_clip (snapshot,
                           &GRAPHENE_RECT_INIT(
                             0, 0,
@@ -517,7 +699,22 @@ gtk_viewport_snapshot (GtkWidget   *widget,
                             gtk_widget_get_height (widget)),
                             "Viewport");
 
-  GTK_WIDGET_CLASS (gtk_viewport_parent_class)->snapshot (widget, snapshot);
+  /* Other renderers keep the child's nodes on the GPU and do not gain
+   * anything from redrawing only part of it.
+   */
+  child = gtk_bin_get_child (GTK_BIN (widget));
+  if (child != NULL &&
+      _gtk_widget_is_drawable (child) &&
+      GSK_IS_CAIRO_RENDERER (gtk_snapshot_get_renderer (snapshot)))
+    {
+      gtk_viewport_snapshot_scrolled (viewport, child, snapshot);
+    }
+  else
+    {
+      gtk_viewport_clear_scroll_cache (viewport);
+
+      GTK_WIDGET_CLASS (gtk_viewport_parent_class)->snapshot (widget, snapshot);
+    }
 
   gtk_snapshot_pop (snapshot);
 }
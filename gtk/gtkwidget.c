@@ -631,6 +631,7 @@ static void     	gtk_widget_update_pango_context		(GtkWidget	  *widget);
 static void             gtk_widget_propagate_state              (GtkWidget          *widget,
                                                                  const GtkStateData *data);
 static void             gtk_widget_update_alpha                 (GtkWidget        *widget);
+static void             gtk_widget_invalidate_content           (GtkWidget        *widget);
 
 static gint		gtk_widget_event_internal		(GtkWidget	  *widget,
                                                                  const GdkEvent   *event);
@@ -4053,6 +4054,8 @@ gtk_widget_queue_draw (GtkWidget *widget)
 
   g_return_if_fail (GTK_IS_WIDGET (widget));
 
+  gtk_widget_invalidate_content (widget);
+
   parent = _gtk_widget_get_parent (widget);
   rect = &widget->priv->clip;
 
@@ -4130,11 +4133,83 @@ gtk_widget_queue_resize_internal (GtkWidget *widget)
   else if (_gtk_widget_get_visible (widget))
     {
       GtkWidget *parent = _gtk_widget_get_parent (widget);
-      if (parent)
+
+      if (parent == NULL)
+        return;
+
+      if (parent->priv->layout_boundary && !parent->priv->resize_needed)
+        {
+          /* The size request of the parent does not change, so only
+           * the parent's subtree needs to be allocated again.
+           */
+          parent->priv->boundary_check_needed = TRUE;
+          gtk_widget_set_alloc_needed (parent);
+        }
+      else
         gtk_widget_queue_resize_internal (parent);
     }
 }
 
+/*
+ * gtk_widget_set_layout_boundary:
+ * @widget: a #GtkWidget
+ * @layout_boundary: whether @widget is a layout boundary
+ *
+ * Marks @widget as a widget whose size request does not depend on the
+ * size requests of its children, like a scrolled window that doesn't
+ * propagate the size of its content. Resizes queued on the children
+ * then stop at @widget and only reallocate its subtree, instead of
+ * measuring and allocating the whole toplevel again.
+ *
+ * Before the subtree is allocated, the size request of @widget is
+ * checked, and the resize is continued to the parent if it did change.
+ */
+void
+gtk_widget_set_layout_boundary (GtkWidget *widget,
+                                gboolean   layout_boundary)
+{
+  GtkWidgetPrivate *priv = widget->priv;
+
+  layout_boundary = !!layout_boundary;
+
+  if (priv->layout_boundary == layout_boundary)
+    return;
+
+  priv->layout_boundary = layout_boundary;
+  gtk_widget_queue_resize (widget);
+}
+
+/* Checks whether the size request of a layout boundary changed
+ * after a resize of one of its children stopped at it.
+ */
+static gboolean
+gtk_widget_layout_boundary_changed (GtkWidget *widget)
+{
+  SizeRequestCache *cache = &widget->priv->requests;
+  int old_min[2], old_nat[2];
+  int min, nat, dummy;
+  int i;
+
+  for (i = 0; i < 2; i++)
+    {
+      if (!_gtk_size_request_cache_lookup (cache, i, -1,
+                                           &old_min[i], &old_nat[i],
+                                           &dummy, &dummy))
+        return FALSE;
+    }
+
+  _gtk_size_request_cache_clear (cache);
+
+  for (i = 0; i < 2; i++)
+    {
+      gtk_widget_measure (widget, i, -1, &min, &nat, NULL, NULL);
+      if (min != old_min[i] || nat != old_nat[i])
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
 /**
  * gtk_widget_queue_resize:
  * @widget: a #GtkWidget
@@ -4302,6 +4377,8 @@ gtk_widget_queue_draw_region (GtkWidget            *widget,
   if (cairo_region_is_empty (region))
     return;
 
+  gtk_widget_invalidate_content (widget);
+
   /* Just return if the widget isn't mapped */
   if (!_gtk_widget_get_mapped (widget))
     return;
@@ -4630,6 +4707,13 @@ check_clip:
   position_changed |= (old_clip.x != priv->clip.x ||
                       old_clip.y != priv->clip.y);
 
+  /* The cached contents are in widget coordinates, so they survive moves */
+  if (size_changed || baseline_changed)
+    {
+      g_clear_pointer (&priv->content_node, gsk_render_node_unref);
+      priv->content_serial++;
+    }
+
   if (_gtk_widget_get_mapped (widget))
     {
       if (position_changed || size_changed || baseline_changed)
@@ -6150,6 +6234,10 @@ gtk_widget_real_style_updated (GtkWidget *widget)
     {
       const gboolean has_text = gtk_widget_peek_pango_context (widget) != NULL;
 
+      /* gtk_widget_update_alpha() took care of the redraw */
+      if (gtk_css_style_change_changes_only_property (change, GTK_CSS_PROPERTY_OPACITY))
+        return;
+
       if (has_text && gtk_css_style_change_affects (change, GTK_CSS_AFFECTS_TEXT))
         gtk_widget_update_pango_context (widget);
 
@@ -9041,6 +9129,8 @@ gtk_widget_finalize (GObject *object)
 
   _gtk_size_request_cache_free (&priv->requests);
 
+  g_clear_pointer (&priv->content_node, gsk_render_node_unref);
+
   for (l = priv->event_controllers; l; l = l->next)
     {
       EventControllerData *data = l->data;
@@ -9125,6 +9215,10 @@ gtk_widget_real_unmap (GtkWidget *widget)
       GtkWidget *child;
       priv->mapped = FALSE;
 
+      priv->cache_content = FALSE;
+      g_clear_pointer (&priv->content_node, gsk_render_node_unref);
+      priv->content_serial++;
+
       if (_gtk_widget_get_has_window (widget))
         gdk_window_hide (priv->window);
 
@@ -12224,10 +12318,24 @@ gtk_widget_update_alpha (GtkWidget *widget)
 
   if (_gtk_widget_get_realized (widget))
     {
+      GtkWidget *parent = _gtk_widget_get_parent (widget);
+
       if (_gtk_widget_is_toplevel (widget))
 	gdk_window_set_opacity (priv->window, priv->alpha / 255.0);
 
-      gtk_widget_queue_draw (widget);
+      if (parent != NULL && !_gtk_widget_get_has_window (widget))
+        {
+          /* Only the opacity changed, so keep our contents around and
+           * just redraw the area in the parent.
+           */
+          priv->cache_content = TRUE;
+          priv->content_serial++;
+          gtk_widget_queue_draw_area (parent,
+                                      priv->clip.x, priv->clip.y,
+                                      priv->clip.width, priv->clip.height);
+        }
+      else
+        gtk_widget_queue_draw (widget);
     }
 }
 
@@ -12448,6 +12556,17 @@ gtk_widget_ensure_allocate (GtkWidget *widget)
   if (!gtk_widget_needs_allocate (widget))
     return;
 
+  if (priv->boundary_check_needed)
+    {
+      priv->boundary_check_needed = FALSE;
+
+      if (!priv->resize_needed && gtk_widget_layout_boundary_changed (widget))
+        {
+          gtk_widget_queue_resize_internal (widget);
+          return;
+        }
+    }
+
   gtk_widget_ensure_resize (widget);
 
   /*  This code assumes that we only reach here if the previous
@@ -13772,6 +13891,122 @@ gtk_widget_maybe_add_debug_render_nodes (GtkWidget             *widget,
 #endif
 }
 
+static void
+gtk_widget_snapshot_content (GtkWidget   *widget,
+                             GtkSnapshot *snapshot)
+{
+  GtkWidgetClass *klass = GTK_WIDGET_GET_CLASS (widget);
+  GtkWidgetPrivate *priv = widget->priv;
+  GtkCssStyle *style;
+  GtkAllocation allocation;
+  GtkBorder margin, border, padding;
+
+  style = gtk_css_node_get_style (priv->cssnode);
+  get_box_margin (style, &margin);
+  get_box_border (style, &border);
+  get_box_padding (style, &padding);
+
+  _gtk_widget_get_allocation (widget, &allocation);
+
+  if (!GTK_IS_WINDOW (widget))
+    {
+      gtk_snapshot_offset (snapshot, margin.left, margin.top);
+      gtk_css_style_snapshot_background (style,
+                                         snapshot,
+                                         allocation.width - margin.left - margin.right,
+                                         allocation.height - margin.top - margin.bottom);
+      gtk_css_style_snapshot_border (style,
+                                     snapshot,
+                                     allocation.width - margin.left - margin.right,
+                                     allocation.height - margin.top - margin.bottom);
+      gtk_snapshot_offset (snapshot, - margin.left, - margin.top);
+    }
+
+  /* Offset to content allocation */
+  gtk_snapshot_offset (snapshot, margin.left + padding.left + border.left, margin.top + border.top + padding.top);
+  if (gtk_widget_get_width (widget) > 0 || gtk_widget_get_height (widget) > 0)
+    klass->snapshot (widget, snapshot);
+  gtk_snapshot_offset (snapshot, - (margin.left + padding.left + border.left), -(margin.top + border.top + padding.top));
+
+  if (g_signal_has_handler_pending (widget, widget_signals[DRAW], 0, FALSE))
+    {
+      /* Compatibility mode: if there's a ::draw signal handler, we add a
+       * child node with the contents of the handler
+       */
+      gboolean result;
+      cairo_t *cr;
+      graphene_rect_t bounds;
+
+      graphene_rect_init (&bounds,
+                          priv->clip.x - priv->allocation.x,
+                          priv->clip.y - priv->allocation.y,
+                          priv->clip.width,
+                          priv->clip.height);
+
+      cr = gtk_snapshot_append_cairo (snapshot,
+                                      &bounds,
+                                      "DrawSignalContents<%s>", G_OBJECT_TYPE_NAME (widget));
+      g_signal_emit (widget, widget_signals[DRAW], 0, cr, &result);
+      cairo_destroy (cr);
+    }
+
+  gtk_snapshot_offset (snapshot, margin.left, margin.top);
+  gtk_css_style_snapshot_outline (style,
+                                  snapshot,
+                                  allocation.width - margin.left - margin.right,
+                                  allocation.height - margin.top - margin.bottom);
+  gtk_snapshot_offset (snapshot, - margin.left, - margin.top);
+}
+
+/* Until the widget or one of its descendants queues a redraw, its contents
+ * stay the same. Record them once in widget coordinates and without any
+ * clip, so the node can be reused while the widget moves, while only its
+ * opacity changes (typically because of a CSS opacity transition) and
+ * while other parts of the window are redrawn. Only the ancestors of a
+ * widget that changed need to be snapshotted again.
+ *
+ * This keeps the render nodes of everything that was fully visible in the
+ * last frame alive between frames, including the surfaces of cairo nodes
+ * and the textures they use, instead of freeing them after rendering.
+ * The nodes of a child are shared with its ancestors' nodes, so this is
+ * one copy of the visible window contents, not one per level. The nodes
+ * are freed when the widget changes size, queues a redraw or is unmapped.
+ */
+static void
+gtk_widget_snapshot_cached_content (GtkWidget   *widget,
+                                    GtkSnapshot *snapshot)
+{
+  GtkWidgetPrivate *priv = widget->priv;
+  graphene_matrix_t identity;
+
+  if (priv->content_node == NULL)
+    {
+      gtk_snapshot_push (snapshot, FALSE, "Content<%s>", G_OBJECT_TYPE_NAME (widget));
+      gtk_widget_snapshot_content (widget, snapshot);
+      priv->content_node = gtk_snapshot_pop_collect (snapshot);
+
+      if (priv->content_node == NULL)
+        return;
+    }
+
+  /* The transform picks up the current offset of the snapshot */
+  graphene_matrix_init_identity (&identity);
+  gtk_snapshot_push_transform (snapshot, &identity, "CachedContent<%s>", G_OBJECT_TYPE_NAME (widget));
+  gtk_snapshot_append_node (snapshot, priv->content_node);
+  gtk_snapshot_pop (snapshot);
+}
+
+static void
+gtk_widget_invalidate_content (GtkWidget *widget)
+{
+  for (; widget != NULL; widget = _gtk_widget_get_parent (widget))
+    {
+      widget->priv->cache_content = FALSE;
+      g_clear_pointer (&widget->priv->content_node, gsk_render_node_unref);
+      widget->priv->content_serial++;
+    }
+}
+
 void
 gtk_widget_snapshot (GtkWidget   *widget,
                      GtkSnapshot *snapshot)
@@ -13782,9 +14017,6 @@ gtk_widget_snapshot (GtkWidget   *widget,
   RenderMode mode;
   double opacity;
   cairo_rectangle_int_t offset_clip;
-  GtkCssStyle *style;
-  GtkAllocation allocation;
-  GtkBorder margin, border, padding;
 
   if (!_gtk_widget_is_drawable (widget))
     return;
@@ -13818,13 +14050,6 @@ gtk_widget_snapshot (GtkWidget   *widget,
   filter_value = _gtk_style_context_peek_property (_gtk_widget_get_style_context (widget), GTK_CSS_PROPERTY_FILTER);
   gtk_css_filter_value_push_snapshot (filter_value, snapshot);
 
-  style = gtk_css_node_get_style (priv->cssnode);
-  get_box_margin (style, &margin);
-  get_box_border (style, &border);
-  get_box_padding (style, &padding);
-
-  _gtk_widget_get_allocation (widget, &allocation);
-
   if (mode == RENDER_DRAW)
     {
       cairo_t *cr;
@@ -13847,54 +14072,18 @@ gtk_widget_snapshot (GtkWidget   *widget,
       if (opacity < 1.0)
         gtk_snapshot_push_opacity (snapshot, opacity, "Opacity<%s,%f>", G_OBJECT_TYPE_NAME (widget), opacity);
 
-      if (!GTK_IS_WINDOW (widget))
-        {
-          gtk_snapshot_offset (snapshot, margin.left, margin.top);
-          gtk_css_style_snapshot_background (style,
-                                             snapshot,
-                                             allocation.width - margin.left - margin.right,
-                                             allocation.height - margin.top - margin.bottom);
-          gtk_css_style_snapshot_border (style,
-                                         snapshot,
-                                         allocation.width - margin.left - margin.right,
-                                         allocation.height - margin.top - margin.bottom);
-          gtk_snapshot_offset (snapshot, - margin.left, - margin.top);
-        }
-
-      /* Offset to content allocation */
-      gtk_snapshot_offset (snapshot, margin.left + padding.left + border.left, margin.top + border.top + padding.top);
-      if (gtk_widget_get_width (widget) > 0 || gtk_widget_get_height (widget) > 0)
-        klass->snapshot (widget, snapshot);
-      gtk_snapshot_offset (snapshot, - (margin.left + padding.left + border.left), -(margin.top + border.top + padding.top));
-
-      if (g_signal_has_handler_pending (widget, widget_signals[DRAW], 0, FALSE))
-        {
-          /* Compatibility mode: if there's a ::draw signal handler, we add a
-           * child node with the contents of the handler
-           */
-          gboolean result;
-          cairo_t *cr;
-          graphene_rect_t bounds;
-
-          graphene_rect_init (&bounds,
-                              offset_clip.x,
-                              offset_clip.y,
-                              offset_clip.width,
-                              offset_clip.height);
-
-          cr = gtk_snapshot_append_cairo (snapshot,
-                                          &bounds,
-                                          "DrawSignalContents<%s>", G_OBJECT_TYPE_NAME (widget));
-          g_signal_emit (widget, widget_signals[DRAW], 0, cr, &result);
-          cairo_destroy (cr);
-        }
-
-      gtk_snapshot_offset (snapshot, margin.left, margin.top);
-      gtk_css_style_snapshot_outline (style,
-                                      snapshot,
-                                      allocation.width - margin.left - margin.right,
-                                      allocation.height - margin.top - margin.bottom);
-      gtk_snapshot_offset (snapshot, - margin.left, - margin.top);
+      /* Recording without a clip gives up culling, so only start caching
+       * when none of the widget would be culled anyway. When recording
+       * names for the inspector, the nodes need to be recorded anew so
+       * that they carry them.
+       */
+      if (!snapshot->record_names &&
+          (priv->cache_content ||
+           priv->content_node != NULL ||
+           gtk_snapshot_contains_rect (snapshot, &offset_clip)))
+        gtk_widget_snapshot_cached_content (widget, snapshot);
+      else
+        gtk_widget_snapshot_content (widget, snapshot);
 
       if (opacity < 1.0)
         gtk_snapshot_pop (snapshot);
@@ -76,6 +76,8 @@ struct _GtkWidgetPrivate
   guint resize_needed         : 1; /* queue_resize() has been called but no get_preferred_size() yet */
   guint alloc_needed          : 1; /* this widget needs a size_allocate() call */
   guint alloc_needed_on_child : 1; /* 0 or more children - or this widget - need a size_allocate() call */
+  guint layout_boundary       : 1; /* size request does not depend on the children, see gtk_widget_set_layout_boundary() */
+  guint boundary_check_needed : 1; /* a resize of a child stopped here, verify the size request before allocating */
 
   /* Expand-related flags */
   guint need_compute_expand   : 1; /* Need to recompute computed_[hv]_expand */
@@ -90,6 +92,9 @@ struct _GtkWidgetPrivate
   /* SizeGroup related flags */
   guint have_size_groups      : 1;
 
+  /* Opacity changed without the contents changing, keep content_node */
+  guint cache_content         : 1;
+
   /* Alignment */
   guint   halign              : 4;
   guint   valign              : 4;
@@ -143,6 +148,18 @@ struct _GtkWidgetPrivate
   /* The widget's requested sizes */
   SizeRequestCache requests;
 
+  /* The widget's contents in widget coordinates, without opacity applied.
+   * Reused until the widget or a descendant queues a redraw or the size
+   * changes, see gtk_widget_snapshot_cached_content(). It stays alive
+   * between frames, along with any cairo surfaces and textures in it.
+   */
+  GskRenderNode *content_node;
+
+  /* Changed whenever what the widget draws, including its children and
+   * its opacity, may have changed. Moving the widget does not change it.
+   */
+  guint content_serial;
+
   /* The widget's window or its parent window if it does
    * not have a window. (Which will be indicated by the
    * no_window field being set).
@@ -179,7 +196,11 @@ void         _gtk_widget_set_shadowed       (GtkWidget *widget,
 gboolean     _gtk_widget_get_alloc_needed   (GtkWidget *widget);
 gboolean     gtk_widget_needs_allocate      (GtkWidget *widget);
 void         gtk_widget_ensure_resize       (GtkWidget *widget);
+void         gtk_widget_set_measure_valid_from (GtkWidget *widget,
+                                                int        for_size);
 void         gtk_widget_ensure_allocate     (GtkWidget *widget);
+void         gtk_widget_set_layout_boundary (GtkWidget *widget,
+                                             gboolean   layout_boundary);
 void          _gtk_widget_scale_changed     (GtkWidget *widget);
 
 
@@ -444,6 +465,12 @@ _gtk_widget_get_allocation (GtkWidget     *widget,
   *allocation = widget->priv->allocation;
 }
 
+static inline guint
+_gtk_widget_get_content_serial (GtkWidget *widget)
+{
+  return widget->priv->content_serial;
+}
+
 static inline GtkWidget *
 _gtk_widget_get_prev_sibling (GtkWidget *widget)
 {
@@ -469,6 +469,7 @@ static GtkWindowGeometryInfo* gtk_window_get_geometry_info         (GtkWindow
                                                                     gboolean      create);
 
 static void     gtk_window_move_resize               (GtkWindow    *window);
+static void     gtk_window_queue_move_resize         (GtkWindow    *window);
 static gboolean gtk_window_compare_hints             (GdkGeometry  *geometry_a,
                                                       guint         flags_a,
                                                       GdkGeometry  *geometry_b,
@@ -3111,7 +3112,7 @@ gtk_window_set_position (GtkWindow         *window,
        */
       info->position_constraints_changed = TRUE;
 
-      gtk_widget_queue_resize_no_redraw (GTK_WIDGET (window));
+      gtk_window_queue_move_resize (window);
     }
 
   if (priv->position != position)
@@ -5244,7 +5245,7 @@ gtk_window_set_default_size_internal (GtkWindow    *window,
   
   g_object_thaw_notify (G_OBJECT (window));
   
-  gtk_widget_queue_resize_no_redraw (GTK_WIDGET (window));
+  gtk_window_queue_move_resize (window);
 }
 
 /**
@@ -5375,7 +5376,7 @@ gtk_window_resize (GtkWindow *window,
   info->resize_width = width;
   info->resize_height = height;
 
-  gtk_widget_queue_resize_no_redraw (GTK_WIDGET (window));
+  gtk_window_queue_move_resize (window);
 }
 
 /**
@@ -5677,7 +5678,7 @@ gtk_window_move (GtkWindow *window,
   else
     {
       /* Save this position to apply on mapping */
-      gtk_widget_queue_resize (widget);
+      gtk_window_queue_move_resize (window);
       info->initial_x = x;
       info->initial_y = y;
       info->initial_pos_set = TRUE;
@@ -8636,6 +8637,17 @@ gtk_window_constrain_position (GtkWindow    *window,
     }
 }
 
+/* Changes to the window geometry, like its default size or position,
+ * don't change the size request of the window or its children, so only
+ * a new allocation is queued and the size request caches are kept.
+ */
+static void
+gtk_window_queue_move_resize (GtkWindow *window)
+{
+  gtk_widget_queue_allocate (GTK_WIDGET (window));
+  gtk_container_queue_resize_handler (GTK_CONTAINER (window));
+}
+
 static void
 gtk_window_move_resize (GtkWindow *window)
 {
@@ -9855,7 +9867,7 @@ gtk_window_set_gravity (GtkWindow *window,
 
       /* gtk_window_move_resize() will adapt gravity
        */
-      gtk_widget_queue_resize_no_redraw (GTK_WIDGET (window));
+      gtk_window_queue_move_resize (window);
 
       g_object_notify_by_pspec (G_OBJECT (window), window_props[PROP_GRAVITY]);
     }
@@ -30,6 +30,7 @@
 #include "gtkimage.h"
 #include "gtkadjustment.h"
 #include "gtkbox.h"
+#include "gtkpangolayoutcacheprivate.h"
 
 
 #ifdef GDK_WINDOWING_X11
@@ -66,6 +67,7 @@ struct _GtkInspectorGeneralPrivate
   GtkWidget *gl_box;
   GtkWidget *vulkan_box;
   GtkWidget *device_box;
+  GtkWidget *cache_box;
   GtkWidget *gtk_version;
   GtkWidget *gdk_backend;
   GtkWidget *gsk_renderer;
@@ -86,6 +88,7 @@ struct _GtkInspectorGeneralPrivate
   GtkWidget *display_composited;
   GtkSizeGroup *labels;
   GtkAdjustment *focus_adjustment;
+  guint update_caches_id;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (GtkInspectorGeneral, gtk_inspector_general, GTK_TYPE_SCROLLED_WINDOW)
@@ -783,6 +786,66 @@ init_device (GtkInspectorGeneral *gen)
   populate_seats (gen);
 }
 
+static gboolean
+populate_caches (gpointer data)
+{
+  GtkInspectorGeneral *gen = data;
+  GtkPangoLayoutCacheStats stats;
+  GList *list, *l;
+  guint64 lookups;
+  gchar *value;
+
+  list = gtk_container_get_children (GTK_CONTAINER (gen->priv->cache_box));
+  for (l = list; l; l = l->next)
+    gtk_widget_destroy (GTK_WIDGET (l->data));
+  g_list_free (list);
+
+  gtk_pango_layout_cache_get_stats (&stats);
+  lookups = stats.hits + stats.misses;
+
+  value = g_strdup_printf ("%u / %u", stats.n_entries, stats.max_entries);
+  add_label_row (gen, GTK_LIST_BOX (gen->priv->cache_box), "Cached text layouts", value, 0);
+  g_free (value);
+
+  value = g_strdup_printf ("%" G_GUINT64_FORMAT " (%.1f%%)",
+                           stats.hits,
+                           lookups ? 100.0 * stats.hits / lookups : 0.0);
+  add_label_row (gen, GTK_LIST_BOX (gen->priv->cache_box), "Hits", value, 10);
+  g_free (value);
+
+  value = g_strdup_printf ("%" G_GUINT64_FORMAT, stats.misses);
+  add_label_row (gen, GTK_LIST_BOX (gen->priv->cache_box), "Misses", value, 10);
+  g_free (value);
+
+  return G_SOURCE_CONTINUE;
+}
+
+static void
+gtk_inspector_general_map (GtkWidget *widget)
+{
+  GtkInspectorGeneral *gen = GTK_INSPECTOR_GENERAL (widget);
+
+  GTK_WIDGET_CLASS (gtk_inspector_general_parent_class)->map (widget);
+
+  populate_caches (gen);
+  gen->priv->update_caches_id = g_timeout_add_seconds (1, populate_caches, gen);
+  g_source_set_name_by_id (gen->priv->update_caches_id, "[gtk+] populate_caches");
+}
+
+static void
+gtk_inspector_general_unmap (GtkWidget *widget)
+{
+  GtkInspectorGeneral *gen = GTK_INSPECTOR_GENERAL (widget);
+
+  if (gen->priv->update_caches_id)
+    {
+      g_source_remove (gen->priv->update_caches_id);
+      gen->priv->update_caches_id = 0;
+    }
+
+  GTK_WIDGET_CLASS (gtk_inspector_general_parent_class)->unmap (widget);
+}
+
 static void
 gtk_inspector_general_init (GtkInspectorGeneral *gen)
 {
@@ -812,6 +875,10 @@ keynav_failed (GtkWidget *widget, GtkDirectionType direction, GtkInspectorGenera
     next = gen->priv->vulkan_box;
   else if (direction == GTK_DIR_DOWN && widget == gen->priv->vulkan_box)
     next = gen->priv->device_box;
+  else if (direction == GTK_DIR_DOWN && widget == gen->priv->device_box)
+    next = gen->priv->cache_box;
+  else if (direction == GTK_DIR_UP && widget == gen->priv->cache_box)
+    next = gen->priv->device_box;
   else if (direction == GTK_DIR_UP && widget == gen->priv->device_box)
     next = gen->priv->vulkan_box;
   else if (direction == GTK_DIR_UP && widget == gen->priv->vulkan_box)
@@ -867,6 +934,7 @@ gtk_inspector_general_constructed (GObject *object)
    g_signal_connect (gen->priv->gl_box, "keynav-failed", G_CALLBACK (keynav_failed), gen);
    g_signal_connect (gen->priv->vulkan_box, "keynav-failed", G_CALLBACK (keynav_failed), gen);
    g_signal_connect (gen->priv->device_box, "keynav-failed", G_CALLBACK (keynav_failed), gen);
+   g_signal_connect (gen->priv->cache_box, "keynav-failed", G_CALLBACK (keynav_failed), gen);
 }
 
 static void
@@ -877,6 +945,9 @@ gtk_inspector_general_class_init (GtkInspectorGeneralClass *klass)
 
   object_class->constructed = gtk_inspector_general_constructed;
 
+  widget_class->map = gtk_inspector_general_map;
+  widget_class->unmap = gtk_inspector_general_unmap;
+
   gtk_widget_class_set_template_from_resource (widget_class, "/org/gtk/libgtk/inspector/general.ui");
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorGeneral, version_box);
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorGeneral, env_box);
@@ -903,6 +974,7 @@ gtk_inspector_general_class_init (GtkInspectorGeneralClass *klass)
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorGeneral, display_composited);
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorGeneral, display_rgba);
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorGeneral, device_box);
+  gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorGeneral, cache_box);
 }
 
 // vim: set et sw=2 ts=2:
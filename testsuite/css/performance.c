@@ -0,0 +1,524 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Benchmarks for the CSS style machinery.
+ *
+ * The CSS nodes are created through widgets, as that is the only way to
+ * get nodes that take part in selector matching from outside of GTK.
+ * Boxes and labels are used, as their own styling code is negligible.
+ *
+ * Results are printed as a JSON object, with timings in milliseconds.
+ */
+
+#include <gtk/gtk.h>
+
+#define ADWAITA_RESOURCE "/org/gtk/libgtk/theme/Adwaita/gtk-contained.css"
+
+static int depth = 5;
+static int width = 4;
+static int n_classes = 2;
+static int n_rules = 2000;
+static int runs = 10;
+static int n_frames = 100;
+static gboolean no_animation = FALSE;
+static char *output = NULL;
+
+static GOptionEntry options[] = {
+  { "depth", 'd', 0, G_OPTION_ARG_INT, &depth, "Depth of the widget tree", "DEPTH" },
+  { "width", 'w', 0, G_OPTION_ARG_INT, &width, "Number of children per container", "WIDTH" },
+  { "classes", 'c', 0, G_OPTION_ARG_INT, &n_classes, "Number of style classes per widget", "CLASSES" },
+  { "rules", 'r', 0, G_OPTION_ARG_INT, &n_rules, "Number of rules in the synthetic stylesheet", "RULES" },
+  { "runs", 'n', 0, G_OPTION_ARG_INT, &runs, "Number of runs per benchmark", "RUNS" },
+  { "frames", 'f', 0, G_OPTION_ARG_INT, &n_frames, "Number of frames to animate", "FRAMES" },
+  { "no-animation", 0, 0, G_OPTION_ARG_NONE, &no_animation, "Skip the animation benchmark", NULL },
+  { "output", 'o', 0, G_OPTION_ARG_FILENAME, &output, "Write results to FILE instead of stdout", "FILE" },
+  { NULL }
+};
+
+/* Class names are drawn from a pool that is larger than what a single
+ * widget uses, so that most rules do not match most widgets - like
+ * in real themes.
+ */
+#define CLASS_POOL_SIZE 64
+
+typedef struct {
+  const char *name;
+  GArray *samples;
+} Benchmark;
+
+static GPtrArray *benchmarks;
+
+static Benchmark *
+benchmark_get (const char *name)
+{
+  Benchmark *bench;
+  guint i;
+
+  for (i = 0; i < benchmarks->len; i++)
+    {
+      bench = g_ptr_array_index (benchmarks, i);
+      if (g_str_equal (bench->name, name))
+        return bench;
+    }
+
+  bench = g_new (Benchmark, 1);
+  bench->name = name;
+  bench->samples = g_array_new (FALSE, FALSE, sizeof (gint64));
+  g_ptr_array_add (benchmarks, bench);
+
+  return bench;
+}
+
+static void
+benchmark_add_sample (const char *name,
+                      gint64      usecs)
+{
+  g_array_append_val (benchmark_get (name)->samples, usecs);
+}
+
+static void
+benchmark_free (gpointer data)
+{
+  Benchmark *bench = data;
+
+  g_array_free (bench->samples, TRUE);
+  g_free (bench);
+}
+
+static char *
+generate_stylesheet (GRand *rand)
+{
+  static const char *names[] = { "box", "label" };
+  static const char *states[] = { "", ":hover", ":active", ":backdrop", ":disabled" };
+  GString *css;
+  int i;
+
+  css = g_string_new ("@keyframes bench-pulse { from { opacity: 0.2; } to { opacity: 1; } }\n"
+                      ".bench-animated { animation: bench-pulse 1s infinite alternate; }\n");
+
+  for (i = 0; i < n_rules; i++)
+    {
+      int a = g_rand_int_range (rand, 0, CLASS_POOL_SIZE);
+      int b = g_rand_int_range (rand, 0, CLASS_POOL_SIZE);
+      const char *name = names[g_rand_int_range (rand, 0, G_N_ELEMENTS (names))];
+      const char *state = states[g_rand_int_range (rand, 0, G_N_ELEMENTS (states))];
+
+      switch (i % 5)
+        {
+        case 0:
+          g_string_append_printf (css, ".c%d%s", a, state);
+          break;
+        case 1:
+          g_string_append_printf (css, "%s.c%d%s", name, a, state);
+          break;
+        case 2:
+          g_string_append_printf (css, ".c%d %s%s", a, name, state);
+          break;
+        case 3:
+          g_string_append_printf (css, "box.c%d > .c%d%s", a, b, state);
+          break;
+        case 4:
+        default:
+          g_string_append_printf (css, ".c%d.c%d %s.c%d%s", a, b, name, a, state);
+          break;
+        }
+
+      g_string_append_printf (css, " { color: #%06x; padding: %dpx; border-width: %dpx; }\n",
+                              g_rand_int_range (rand, 0, 0xffffff),
+                              g_rand_int_range (rand, 0, 8),
+                              g_rand_int_range (rand, 0, 3));
+    }
+
+  return g_string_free (css, FALSE);
+}
+
+static void
+add_classes (GtkWidget *widget,
+             GRand     *rand)
+{
+  GtkStyleContext *context = gtk_widget_get_style_context (widget);
+  int i;
+
+  for (i = 0; i < n_classes; i++)
+    {
+      char name[16];
+
+      g_snprintf (name, sizeof (name), "c%d", g_rand_int_range (rand, 0, CLASS_POOL_SIZE));
+      gtk_style_context_add_class (context, name);
+    }
+}
+
+static GtkWidget *
+create_tree (GRand *rand,
+             int    level)
+{
+  GtkWidget *widget;
+  int i;
+
+  if (level == depth)
+    {
+      widget = gtk_label_new (NULL);
+    }
+  else
+    {
+      widget = gtk_box_new (level % 2 ? GTK_ORIENTATION_VERTICAL : GTK_ORIENTATION_HORIZONTAL, 0);
+      for (i = 0; i < width; i++)
+        gtk_container_add (GTK_CONTAINER (widget), create_tree (rand, level + 1));
+    }
+
+  add_classes (widget, rand);
+  gtk_widget_show (widget);
+
+  return widget;
+}
+
+static guint
+count_widgets (GtkWidget *widget)
+{
+  GtkWidget *child;
+  guint n = 1;
+
+  for (child = gtk_widget_get_first_child (widget);
+       child != NULL;
+       child = gtk_widget_get_next_sibling (child))
+    n += count_widgets (child);
+
+  return n;
+}
+
+/* Looking up a property makes sure the style of the widget is up to date */
+static void
+validate_tree (GtkWidget *widget)
+{
+  GtkWidget *child;
+  GdkRGBA color;
+
+  gtk_style_context_get_color (gtk_widget_get_style_context (widget), &color);
+
+  for (child = gtk_widget_get_first_child (widget);
+       child != NULL;
+       child = gtk_widget_get_next_sibling (child))
+    validate_tree (child);
+}
+
+static void
+collect_leaves (GtkWidget *widget,
+                GPtrArray *leaves)
+{
+  GtkWidget *child;
+
+  if (gtk_widget_get_first_child (widget) == NULL)
+    g_ptr_array_add (leaves, widget);
+
+  for (child = gtk_widget_get_first_child (widget);
+       child != NULL;
+       child = gtk_widget_get_next_sibling (child))
+    collect_leaves (child, leaves);
+}
+
+static GtkCssProvider *
+load_provider (const char *name,
+               const char *resource,
+               const char *data)
+{
+  GtkCssProvider *provider;
+  gint64 start;
+
+  provider = gtk_css_provider_new ();
+
+  start = g_get_monotonic_time ();
+  if (resource)
+    gtk_css_provider_load_from_resource (provider, resource);
+  else
+    gtk_css_provider_load_from_data (provider, data, -1);
+  benchmark_add_sample (name, g_get_monotonic_time () - start);
+
+  return provider;
+}
+
+static void
+bench_load (const char *css)
+{
+  int i;
+
+  for (i = 0; i < runs; i++)
+    {
+      g_object_unref (load_provider ("load_adwaita", ADWAITA_RESOURCE, NULL));
+      g_object_unref (load_provider ("load_synthetic", NULL, css));
+    }
+}
+
+static void
+bench_validate (void)
+{
+  GtkWidget *window, *tree;
+  GRand *rand;
+  gint64 start;
+  int i;
+
+  for (i = 0; i < runs; i++)
+    {
+      rand = g_rand_new_with_seed (42);
+      window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+      tree = create_tree (rand, 0);
+      gtk_container_add (GTK_CONTAINER (window), tree);
+
+      start = g_get_monotonic_time ();
+      validate_tree (window);
+      benchmark_add_sample ("validate_full", g_get_monotonic_time () - start);
+
+      gtk_widget_destroy (window);
+      g_rand_free (rand);
+    }
+}
+
+static void
+bench_state_change (void)
+{
+  GtkWidget *window, *tree;
+  GPtrArray *leaves;
+  GRand *rand;
+  gint64 start;
+  int i;
+
+  rand = g_rand_new_with_seed (42);
+  window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+  tree = create_tree (rand, 0);
+  gtk_container_add (GTK_CONTAINER (window), tree);
+  validate_tree (window);
+
+  leaves = g_ptr_array_new ();
+  collect_leaves (tree, leaves);
+
+  for (i = 0; i < runs; i++)
+    {
+      /* A single widget changing state, like the pointer moving */
+      GtkWidget *leaf = g_ptr_array_index (leaves, g_rand_int_range (rand, 0, leaves->len));
+
+      start = g_get_monotonic_time ();
+      gtk_widget_set_state_flags (leaf, GTK_STATE_FLAG_PRELIGHT, FALSE);
+      validate_tree (window);
+      gtk_widget_unset_state_flags (leaf, GTK_STATE_FLAG_PRELIGHT);
+      validate_tree (window);
+      benchmark_add_sample ("state_change_leaf", g_get_monotonic_time () - start);
+
+      /* A whole subtree changing state, like the toplevel losing focus */
+      start = g_get_monotonic_time ();
+      gtk_widget_set_state_flags (tree, GTK_STATE_FLAG_BACKDROP, FALSE);
+      validate_tree (window);
+      gtk_widget_unset_state_flags (tree, GTK_STATE_FLAG_BACKDROP);
+      validate_tree (window);
+      benchmark_add_sample ("state_change_root", g_get_monotonic_time () - start);
+    }
+
+  g_ptr_array_free (leaves, TRUE);
+  gtk_widget_destroy (window);
+  g_rand_free (rand);
+}
+
+/* The update phase of the frame clock is where CSS animations advance
+ * and styles get revalidated, so time from before-paint to layout.
+ */
+typedef struct {
+  GMainLoop *loop;
+  gint64 start;
+  int frames;
+} AnimationData;
+
+static void
+before_paint (GdkFrameClock *clock,
+              AnimationData *data)
+{
+  data->start = g_get_monotonic_time ();
+}
+
+static void
+layout (GdkFrameClock *clock,
+        AnimationData *data)
+{
+  if (data->start == 0)
+    return;
+
+  benchmark_add_sample ("animation_tick", g_get_monotonic_time () - data->start);
+  data->start = 0;
+
+  if (++data->frames >= n_frames)
+    g_main_loop_quit (data->loop);
+}
+
+static void
+bench_animation (void)
+{
+  AnimationData data = { NULL, 0, 0 };
+  GtkWidget *window, *tree;
+  GPtrArray *leaves;
+  GdkFrameClock *clock;
+  GRand *rand;
+  guint i;
+
+  rand = g_rand_new_with_seed (42);
+  window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+  tree = create_tree (rand, 0);
+  gtk_container_add (GTK_CONTAINER (window), tree);
+
+  leaves = g_ptr_array_new ();
+  collect_leaves (tree, leaves);
+  for (i = 0; i < leaves->len; i++)
+    gtk_style_context_add_class (gtk_widget_get_style_context (g_ptr_array_index (leaves, i)),
+                                 "bench-animated");
+  g_ptr_array_free (leaves, TRUE);
+
+  gtk_widget_show (window);
+
+  data.loop = g_main_loop_new (NULL, FALSE);
+  clock = gtk_widget_get_frame_clock (window);
+  g_signal_connect (clock, "before-paint", G_CALLBACK (before_paint), &data);
+  g_signal_connect (clock, "layout", G_CALLBACK (layout), &data);
+
+  g_main_loop_run (data.loop);
+
+  g_signal_handlers_disconnect_by_data (clock, &data);
+  g_main_loop_unref (data.loop);
+  gtk_widget_destroy (window);
+  g_rand_free (rand);
+}
+
+static int
+compare_samples (gconstpointer a,
+                 gconstpointer b)
+{
+  gint64 sa = *(const gint64 *) a;
+  gint64 sb = *(const gint64 *) b;
+
+  return sa < sb ? -1 : sa > sb;
+}
+
+static char *
+format_results (guint n_widgets)
+{
+  GString *json;
+  guint i, j;
+
+  json = g_string_new ("{\n");
+  g_string_append_printf (json,
+                          "  \"depth\": %d,\n"
+                          "  \"width\": %d,\n"
+                          "  \"classes\": %d,\n"
+                          "  \"rules\": %d,\n"
+                          "  \"widgets\": %u,\n"
+                          "  \"runs\": %d,\n"
+                          "  \"results\": {",
+                          depth, width, n_classes, n_rules, n_widgets, runs);
+
+  for (i = 0; i < benchmarks->len; i++)
+    {
+      Benchmark *bench = g_ptr_array_index (benchmarks, i);
+      GArray *samples = bench->samples;
+      gint64 total = 0;
+
+      g_array_sort (samples, compare_samples);
+      for (j = 0; j < samples->len; j++)
+        total += g_array_index (samples, gint64, j);
+
+      g_string_append_printf (json,
+                              "%s\n    \"%s\": { \"min\": %.3f, \"median\": %.3f, \"mean\": %.3f, \"max\": %.3f }",
+                              i > 0 ? "," : "",
+                              bench->name,
+                              g_array_index (samples, gint64, 0) / 1000.,
+                              g_array_index (samples, gint64, samples->len / 2) / 1000.,
+                              (double) total / samples->len / 1000.,
+                              g_array_index (samples, gint64, samples->len - 1) / 1000.);
+    }
+
+  g_string_append (json, "\n  }\n}\n");
+
+  return g_string_free (json, FALSE);
+}
+
+int
+main (int argc, char *argv[])
+{
+  GOptionContext *context;
+  GtkCssProvider *provider;
+  GError *error = NULL;
+  GtkWidget *tree;
+  GRand *rand;
+  char *css, *json;
+  guint n_widgets;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  if (depth < 0 || width < 1 || n_classes < 0 || n_rules < 0 || runs < 1 || n_frames < 1)
+    {
+      g_printerr ("Invalid arguments\n");
+      return 1;
+    }
+
+  gtk_init ();
+
+  benchmarks = g_ptr_array_new_with_free_func (benchmark_free);
+
+  rand = g_rand_new_with_seed (42);
+  css = generate_stylesheet (rand);
+  g_rand_free (rand);
+
+  bench_load (css);
+
+  /* Style the trees like an application does: the theme plus its own CSS */
+  provider = gtk_css_provider_new ();
+  gtk_css_provider_load_from_data (provider, css, -1);
+  gtk_style_context_add_provider_for_display (gdk_display_get_default (),
+                                              GTK_STYLE_PROVIDER (provider),
+                                              GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+
+  bench_validate ();
+  bench_state_change ();
+  if (!no_animation)
+    bench_animation ();
+
+  rand = g_rand_new_with_seed (42);
+  tree = g_object_ref_sink (create_tree (rand, 0));
+  n_widgets = count_widgets (tree);
+  g_object_unref (tree);
+  g_rand_free (rand);
+
+  json = format_results (n_widgets);
+  if (output)
+    {
+      if (!g_file_set_contents (output, json, -1, &error))
+        {
+          g_printerr ("Could not write results: %s\n", error->message);
+          return 1;
+        }
+    }
+  else
+    g_print ("%s", json);
+
+  gtk_style_context_remove_provider_for_display (gdk_display_get_default (),
+                                                 GTK_STYLE_PROVIDER (provider));
+  g_object_unref (provider);
+  g_ptr_array_free (benchmarks, TRUE);
+  g_free (json);
+  g_free (css);
+
+  return 0;
+}
@@ -33,6 +33,72 @@ test_section_load_nonexisting_file (void)
   g_object_unref (provider);
 }
 
+static void
+assert_color (GtkWidget  *widget,
+              const char *expected)
+{
+  GdkRGBA color, expected_color;
+
+  gdk_rgba_parse (&expected_color, expected);
+  gtk_style_context_get_color (gtk_widget_get_style_context (widget), &color);
+
+  g_assert_true (gdk_rgba_equal (&color, &expected_color));
+}
+
+static void
+test_incremental_reload (void)
+{
+  GtkCssProvider *provider;
+  GtkWidget *box, *a, *b;
+
+  provider = gtk_css_provider_new ();
+  gtk_css_provider_set_incremental_reload (provider, TRUE);
+  g_assert_true (gtk_css_provider_get_incremental_reload (provider));
+
+  box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
+  a = gtk_label_new ("a");
+  gtk_style_context_add_class (gtk_widget_get_style_context (a), "a");
+  gtk_container_add (GTK_CONTAINER (box), a);
+  b = gtk_label_new ("b");
+  gtk_style_context_add_class (gtk_widget_get_style_context (b), "b");
+  gtk_container_add (GTK_CONTAINER (box), b);
+  g_object_ref_sink (box);
+
+  gtk_css_provider_load_from_data (provider, ".a { color: red; } .b { color: red; }", -1);
+  gtk_style_context_add_provider_for_display (gdk_display_get_default (),
+                                              GTK_STYLE_PROVIDER (provider),
+                                              GTK_STYLE_PROVIDER_PRIORITY_USER);
+  assert_color (a, "red");
+  assert_color (b, "red");
+
+  /* changed rule */
+  gtk_css_provider_load_from_data (provider, ".a { color: blue; } .b { color: red; }", -1);
+  assert_color (a, "blue");
+  assert_color (b, "red");
+
+  /* added rule */
+  gtk_css_provider_load_from_data (provider, ".a { color: blue; } .b { color: red; } label.b { color: lime; }", -1);
+  assert_color (a, "blue");
+  assert_color (b, "lime");
+
+  /* reordered rules of the same specificity */
+  gtk_css_provider_load_from_data (provider, ".b { color: red; } .a { color: blue; } label.b { color: lime; } .a { color: yellow; }", -1);
+  assert_color (a, "yellow");
+  gtk_css_provider_load_from_data (provider, ".b { color: red; } .a { color: yellow; } label.b { color: lime; } .a { color: blue; }", -1);
+  assert_color (a, "blue");
+  assert_color (b, "lime");
+
+  /* rule without keys */
+  gtk_css_provider_load_from_data (provider, "* { color: green; }", -1);
+  assert_color (a, "green");
+  assert_color (b, "green");
+
+  gtk_style_context_remove_provider_for_display (gdk_display_get_default (),
+                                                 GTK_STYLE_PROVIDER (provider));
+  g_object_unref (box);
+  g_object_unref (provider);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -41,6 +107,7 @@ main (int argc, char *argv[])
 
   g_test_add_func ("/cssprovider/section-in-load-from-data", test_section_in_load_from_data);
   g_test_add_func ("/cssprovider/load-nonexisting-file", test_section_load_nonexisting_file);
+  g_test_add_func ("/cssprovider/incremental-reload", test_incremental_reload);
 
   return g_test_run ();
 }
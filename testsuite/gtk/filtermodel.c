@@ -6823,6 +6823,155 @@ test_row_changed (void)
   g_object_unref (store);
 }
 
+static int refilter_modulus;
+
+static gboolean
+refilter_visible_func (GtkTreeModel *model,
+                       GtkTreeIter  *iter,
+                       gpointer      data)
+{
+  int value;
+
+  gtk_tree_model_get (model, iter, 0, &value, -1);
+
+  return value % refilter_modulus == 0;
+}
+
+static void
+test_queue_refilter (void)
+{
+  GtkTreeModel *filter;
+  GtkTreeStore *store;
+  GtkTreeIter iter, child, fiter;
+  int deleted_count = 0;
+  int i;
+
+  store = gtk_tree_store_new (1, G_TYPE_INT);
+  for (i = 0; i < 1000; i++)
+    {
+      gtk_tree_store_insert_with_values (store, &iter, NULL, i, 0, i, -1);
+      if (i == 6)
+        gtk_tree_store_insert_with_values (store, &child, &iter, 0, 0, 7, -1);
+    }
+
+  refilter_modulus = 1;
+  filter = gtk_tree_model_filter_new (GTK_TREE_MODEL (store), NULL);
+  gtk_tree_model_filter_set_visible_func (GTK_TREE_MODEL_FILTER (filter),
+                                          refilter_visible_func, NULL, NULL);
+  gtk_tree_model_filter_set_visible_func_thread_safe (GTK_TREE_MODEL_FILTER (filter), TRUE);
+  g_assert (gtk_tree_model_filter_get_visible_func_thread_safe (GTK_TREE_MODEL_FILTER (filter)));
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), ==, 1000);
+
+  g_signal_connect (filter, "row-deleted", G_CALLBACK (row_changed), &deleted_count);
+
+  /* Nothing happens until the main loop runs */
+  refilter_modulus = 2;
+  gtk_tree_model_filter_queue_refilter (GTK_TREE_MODEL_FILTER (filter));
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), ==, 1000);
+
+  while (g_main_context_iteration (NULL, FALSE));
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), ==, 500);
+  g_assert_cmpint (deleted_count, ==, 500);
+
+  /* Queueing again restarts, and changes to the child model are picked up */
+  refilter_modulus = 3;
+  gtk_tree_model_filter_queue_refilter (GTK_TREE_MODEL_FILTER (filter));
+  gtk_tree_store_insert_with_values (store, &iter, NULL, 0, 0, 3000, -1);
+  gtk_tree_model_filter_queue_refilter (GTK_TREE_MODEL_FILTER (filter));
+
+  while (g_main_context_iteration (NULL, FALSE));
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), ==, 335);
+
+  /* Children are refiltered as well */
+  refilter_modulus = 6;
+  gtk_tree_model_filter_refilter (GTK_TREE_MODEL_FILTER (filter));
+  g_assert (gtk_tree_model_iter_nth_child (filter, &fiter, NULL, 2));
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, &fiter), ==, 0);
+
+  refilter_modulus = 1;
+  gtk_tree_model_filter_queue_refilter (GTK_TREE_MODEL_FILTER (filter));
+  while (g_main_context_iteration (NULL, FALSE));
+
+  g_assert (gtk_tree_model_iter_nth_child (filter, &fiter, NULL, 7));
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, &fiter), ==, 1);
+
+  /* A synchronous refilter cancels a queued one */
+  refilter_modulus = 2;
+  gtk_tree_model_filter_queue_refilter (GTK_TREE_MODEL_FILTER (filter));
+  refilter_modulus = 1;
+  gtk_tree_model_filter_refilter (GTK_TREE_MODEL_FILTER (filter));
+  refilter_modulus = 2;
+  while (g_main_context_iteration (NULL, FALSE));
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), ==, 1001);
+
+  g_object_unref (filter);
+  g_object_unref (store);
+}
+
+static int refilter_n_calls;
+
+static gboolean
+refilter_counting_visible_func (GtkTreeModel *model,
+                                GtkTreeIter  *iter,
+                                gpointer      data)
+{
+  refilter_n_calls++;
+
+  return refilter_visible_func (model, iter, data);
+}
+
+static void
+test_queue_refilter_changes (void)
+{
+  GtkTreeModel *filter;
+  GtkListStore *store;
+  GtkTreeIter iter;
+  int i, n_rows, n_even, n_changes;
+
+  store = gtk_list_store_new (1, G_TYPE_INT);
+  for (i = 0; i < 10000; i++)
+    gtk_list_store_insert_with_values (store, NULL, i, 0, i, -1);
+
+  refilter_modulus = 1;
+  filter = gtk_tree_model_filter_new (GTK_TREE_MODEL (store), NULL);
+  gtk_tree_model_filter_set_visible_func (GTK_TREE_MODEL_FILTER (filter),
+                                          refilter_counting_visible_func, NULL, NULL);
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), ==, 10000);
+
+  /* A model that keeps changing while the refilter runs doesn't make
+   * it start over, so every row is only evaluated once.
+   */
+  refilter_modulus = 2;
+  refilter_n_calls = 0;
+  n_changes = 0;
+  gtk_tree_model_filter_queue_refilter (GTK_TREE_MODEL_FILTER (filter));
+
+  while (g_main_context_iteration (NULL, FALSE))
+    {
+      gtk_list_store_insert_with_values (store, NULL, 0, 0, 2 * n_changes, -1);
+      n_rows = gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), NULL);
+      g_assert (gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (store), &iter, NULL, n_rows / 2));
+      gtk_list_store_remove (store, &iter);
+      n_changes++;
+    }
+
+  g_assert_cmpint (n_changes, >, 1);
+  g_assert_cmpint (refilter_n_calls, <=, 10000 + 2 * n_changes);
+
+  n_even = 0;
+  for (i = 0; gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (store), &iter, NULL, i); i++)
+    {
+      int value;
+
+      gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 0, &value, -1);
+      if (value % 2 == 0)
+        n_even++;
+    }
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), ==, n_even);
+
+  g_object_unref (filter);
+  g_object_unref (store);
+}
 
 /* main */
 
@@ -7187,4 +7336,7 @@ register_filter_model_tests (void)
                    specific_bug_679910);
 
   g_test_add_func ("/TreeModelFilter/signal/row-changed", test_row_changed);
+
+  g_test_add_func ("/TreeModelFilter/refilter/queue", test_queue_refilter);
+  g_test_add_func ("/TreeModelFilter/refilter/queue-changes", test_queue_refilter_changes);
 }
@@ -0,0 +1,290 @@
+#include <gtk/gtk.h>
+
+#define N_ITEMS 100000
+#define CELL_SIZE 50
+
+static GListModel *
+create_model (guint n_items)
+{
+  GListStore *store;
+  guint i;
+
+  store = g_list_store_new (G_TYPE_OBJECT);
+  for (i = 0; i < n_items; i++)
+    {
+      GObject *item = g_object_new (G_TYPE_OBJECT, NULL);
+      g_object_set_data (item, "position", GUINT_TO_POINTER (i));
+      g_list_store_append (store, item);
+      g_object_unref (item);
+    }
+
+  return G_LIST_MODEL (store);
+}
+
+static GtkWidget *
+create_cell (gpointer data)
+{
+  guint *n_created = data;
+  GtkWidget *cell;
+
+  (*n_created)++;
+
+  cell = gtk_label_new ("");
+  gtk_widget_set_size_request (cell, CELL_SIZE, CELL_SIZE);
+
+  return cell;
+}
+
+static void
+bind_cell (GtkWidget *cell,
+           gpointer   item,
+           gpointer   data)
+{
+  g_object_set_data (G_OBJECT (cell), "position",
+                     g_object_get_data (item, "position"));
+}
+
+static void
+allocate (GtkWidget *widget,
+          int        width,
+          int        height)
+{
+  GtkAllocation allocation = { 0, 0, width, height };
+  GtkAllocation clip;
+  int min, nat;
+
+  gtk_widget_measure (widget, GTK_ORIENTATION_HORIZONTAL, -1, &min, &nat, NULL, NULL);
+  gtk_widget_measure (widget, GTK_ORIENTATION_VERTICAL, width, &min, &nat, NULL, NULL);
+  gtk_widget_size_allocate (widget, &allocation, -1, &clip);
+}
+
+static guint
+count_visible_cells (GtkWidget *widget,
+                     gboolean   selected)
+{
+  GtkWidget *child;
+  guint n = 0;
+
+  for (child = gtk_widget_get_first_child (widget);
+       child != NULL;
+       child = gtk_widget_get_next_sibling (child))
+    {
+      if (!gtk_widget_get_child_visible (child))
+        continue;
+      if (selected && !(gtk_widget_get_state_flags (child) & GTK_STATE_FLAG_SELECTED))
+        continue;
+      n++;
+    }
+
+  return n;
+}
+
+static guint
+first_visible_position (GtkWidget *widget)
+{
+  GtkWidget *child;
+  guint position = G_MAXUINT;
+
+  for (child = gtk_widget_get_first_child (widget);
+       child != NULL;
+       child = gtk_widget_get_next_sibling (child))
+    {
+      if (!gtk_widget_get_child_visible (child))
+        continue;
+
+      position = MIN (position, GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (child), "position")));
+    }
+
+  return position;
+}
+
+static void
+test_recycling (void)
+{
+  GtkWidget *view;
+  GListModel *model;
+  GtkAdjustment *vadjustment;
+  guint n_created = 0;
+  guint n_after_first;
+
+  view = gtk_grid_view_new ();
+  g_object_ref_sink (view);
+  gtk_widget_show (view);
+  gtk_grid_view_set_max_columns (GTK_GRID_VIEW (view), 4);
+
+  model = create_model (N_ITEMS);
+  gtk_grid_view_bind_model (GTK_GRID_VIEW (view), model,
+                            create_cell, bind_cell, &n_created, NULL);
+  g_object_unref (model);
+
+  allocate (view, 400, 400);
+
+  /* 4 columns, and enough rows to fill the view and a bit more */
+  n_after_first = n_created;
+  g_assert_cmpuint (n_after_first, >, 0);
+  g_assert_cmpuint (n_after_first, <=, 4 * (2 * 400 / CELL_SIZE + 2));
+
+  vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (view));
+  g_assert_cmpfloat (gtk_adjustment_get_upper (vadjustment), >=, N_ITEMS / 4 * CELL_SIZE);
+
+  gtk_adjustment_set_value (vadjustment, N_ITEMS / 8 * CELL_SIZE);
+  allocate (view, 400, 400);
+  g_assert_cmpuint (n_created, <=, n_after_first + 1);
+
+  g_object_unref (view);
+}
+
+/* Scrolling rebinds the cells right away, so that allocating the view
+ * doesn't need to change its children.
+ */
+static void
+test_scroll (void)
+{
+  GtkWidget *view;
+  GListModel *model;
+  GtkAdjustment *vadjustment;
+  guint n_created = 0;
+  guint n_after_first;
+
+  view = gtk_grid_view_new ();
+  g_object_ref_sink (view);
+  gtk_widget_show (view);
+  gtk_grid_view_set_max_columns (GTK_GRID_VIEW (view), 4);
+
+  model = create_model (N_ITEMS);
+  gtk_grid_view_bind_model (GTK_GRID_VIEW (view), model,
+                            create_cell, bind_cell, &n_created, NULL);
+  g_object_unref (model);
+
+  allocate (view, 400, 400);
+  n_after_first = n_created;
+  g_assert_cmpuint (first_visible_position (view), ==, 0);
+
+  vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (view));
+  gtk_adjustment_set_value (vadjustment, 1000 * CELL_SIZE);
+
+  g_assert_cmpuint (first_visible_position (view), >, 4 * (1000 - 400 / CELL_SIZE));
+  g_assert_cmpuint (first_visible_position (view), <=, 4 * 1000);
+  g_assert_cmpuint (n_created, <=, n_after_first + 1);
+
+  g_object_unref (view);
+}
+
+static void
+test_selection (void)
+{
+  GtkWidget *view;
+  GListModel *model;
+  GObject *item;
+  guint n_created = 0;
+
+  view = gtk_grid_view_new ();
+  g_object_ref_sink (view);
+  gtk_widget_show (view);
+
+  model = create_model (N_ITEMS);
+  gtk_grid_view_bind_model (GTK_GRID_VIEW (view), model,
+                            create_cell, bind_cell, &n_created, NULL);
+
+  allocate (view, 400, 400);
+
+  /* Selecting items that are not displayed does not create cells */
+  n_created = 0;
+  gtk_grid_view_select_all (GTK_GRID_VIEW (view));
+  g_assert_cmpuint (n_created, ==, 0);
+  g_assert (gtk_grid_view_is_selected (GTK_GRID_VIEW (view), 0));
+  g_assert (gtk_grid_view_is_selected (GTK_GRID_VIEW (view), N_ITEMS - 1));
+  g_assert_cmpuint (count_visible_cells (view, TRUE), ==, count_visible_cells (view, FALSE));
+
+  gtk_grid_view_unselect_all (GTK_GRID_VIEW (view));
+  g_assert (!gtk_grid_view_is_selected (GTK_GRID_VIEW (view), 0));
+  g_assert_cmpuint (count_visible_cells (view, TRUE), ==, 0);
+
+  /* The selection follows the items */
+  gtk_grid_view_select_item (GTK_GRID_VIEW (view), 5);
+  item = g_object_new (G_TYPE_OBJECT, NULL);
+  g_list_store_insert (G_LIST_STORE (model), 0, item);
+  g_object_unref (item);
+  g_assert (!gtk_grid_view_is_selected (GTK_GRID_VIEW (view), 5));
+  g_assert (gtk_grid_view_is_selected (GTK_GRID_VIEW (view), 6));
+
+  g_list_store_remove (G_LIST_STORE (model), 6);
+  g_assert (!gtk_grid_view_is_selected (GTK_GRID_VIEW (view), 6));
+
+  /* Inserting into a selected range splits it */
+  gtk_grid_view_select_all (GTK_GRID_VIEW (view));
+  item = g_object_new (G_TYPE_OBJECT, NULL);
+  g_list_store_insert (G_LIST_STORE (model), 10, item);
+  g_object_unref (item);
+  g_assert (gtk_grid_view_is_selected (GTK_GRID_VIEW (view), 9));
+  g_assert (!gtk_grid_view_is_selected (GTK_GRID_VIEW (view), 10));
+  g_assert (gtk_grid_view_is_selected (GTK_GRID_VIEW (view), 11));
+  g_assert (gtk_grid_view_is_selected (GTK_GRID_VIEW (view), N_ITEMS));
+
+  /* and removing the unselected item joins it again */
+  g_list_store_remove (G_LIST_STORE (model), 10);
+  g_assert (gtk_grid_view_is_selected (GTK_GRID_VIEW (view), 9));
+  g_assert (gtk_grid_view_is_selected (GTK_GRID_VIEW (view), 10));
+  gtk_grid_view_unselect_item (GTK_GRID_VIEW (view), 10);
+  g_assert (gtk_grid_view_is_selected (GTK_GRID_VIEW (view), 9));
+  g_assert (!gtk_grid_view_is_selected (GTK_GRID_VIEW (view), 10));
+  g_assert (gtk_grid_view_is_selected (GTK_GRID_VIEW (view), 11));
+
+  g_object_unref (model);
+  g_object_unref (view);
+}
+
+/* All cells get the size of the first item, which is measured with a
+ * widget that is only bound when the first item changes.
+ */
+static void
+test_measure (void)
+{
+  GtkWidget *view;
+  GListModel *model;
+  GObject *item;
+  guint n_created = 0;
+  int min, nat;
+
+  view = gtk_grid_view_new ();
+  g_object_ref_sink (view);
+  gtk_widget_show (view);
+  gtk_grid_view_set_max_columns (GTK_GRID_VIEW (view), 4);
+
+  model = create_model (N_ITEMS);
+  gtk_grid_view_bind_model (GTK_GRID_VIEW (view), model,
+                            create_cell, bind_cell, &n_created, NULL);
+  g_assert_cmpuint (n_created, ==, 1);
+
+  gtk_widget_measure (view, GTK_ORIENTATION_HORIZONTAL, -1, &min, &nat, NULL, NULL);
+  g_assert_cmpint (min, ==, CELL_SIZE);
+  g_assert_cmpint (nat, ==, 4 * CELL_SIZE);
+  gtk_widget_measure (view, GTK_ORIENTATION_VERTICAL, 4 * CELL_SIZE, &min, &nat, NULL, NULL);
+  g_assert_cmpint (nat, ==, N_ITEMS / 4 * CELL_SIZE);
+  g_assert_cmpuint (n_created, ==, 1);
+
+  item = g_object_new (G_TYPE_OBJECT, NULL);
+  g_list_store_insert (G_LIST_STORE (model), 0, item);
+  g_object_unref (item);
+  g_assert_cmpuint (n_created, ==, 1);
+
+  g_list_store_remove_all (G_LIST_STORE (model));
+  gtk_widget_measure (view, GTK_ORIENTATION_HORIZONTAL, -1, &min, &nat, NULL, NULL);
+  g_assert_cmpint (nat, ==, 0);
+
+  g_object_unref (model);
+  g_object_unref (view);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/gridview/recycling", test_recycling);
+  g_test_add_func ("/gridview/scroll", test_scroll);
+  g_test_add_func ("/gridview/selection", test_selection);
+  g_test_add_func ("/gridview/measure", test_measure);
+
+  return g_test_run ();
+}
@@ -628,6 +628,343 @@ list_store_test_swap_end (ListStore     *fixture,
   check_model (fixture, new_order, -1);
 }
 
+static void
+check_sorted_large (GtkListStore *store,
+                    GtkSortType   order)
+{
+  GtkTreeModel *model = GTK_TREE_MODEL (store);
+  GtkTreeIter iter;
+  gchar *prev_str = NULL;
+  gint prev_index = -1;
+  gboolean valid;
+
+  for (valid = gtk_tree_model_get_iter_first (model, &iter);
+       valid;
+       valid = gtk_tree_model_iter_next (model, &iter))
+    {
+      gchar *str;
+      gint index;
+
+      gtk_tree_model_get (model, &iter, 0, &str, 1, &index, -1);
+
+      if (prev_str)
+        {
+          gint cmp = g_utf8_collate (prev_str, str);
+
+          if (order == GTK_SORT_DESCENDING)
+            cmp = -cmp;
+
+          g_assert_cmpint (cmp, <=, 0);
+          /* Equal rows keep their order */
+          if (cmp == 0)
+            g_assert_cmpint (prev_index, <, index);
+        }
+
+      g_free (prev_str);
+      prev_str = str;
+      prev_index = index;
+    }
+
+  g_free (prev_str);
+}
+
+static void
+list_store_test_sort_large (gconstpointer data)
+{
+  GtkListStore *store;
+  GtkTreeIter iter, kept;
+  gchar *str;
+  gint i, index;
+
+  store = gtk_list_store_new (2, G_TYPE_STRING, G_TYPE_INT);
+  gtk_list_store_set_columnar (store, GPOINTER_TO_INT (data));
+
+  for (i = 0; i < 50000; i++)
+    {
+      str = g_strdup_printf ("Row %d", (i * 7919) % 1000);
+      gtk_list_store_insert_with_values (store, &iter, i, 0, str, 1, i, -1);
+      g_free (str);
+    }
+  gtk_list_store_insert_with_values (store, &kept, -1, 0, NULL, 1, 50000, -1);
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store),
+                                        0, GTK_SORT_ASCENDING);
+  check_sorted_large (store, GTK_SORT_ASCENDING);
+
+  /* NULL sorts like "" */
+  g_assert (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (store), &iter));
+  g_assert (iters_equal (&iter, &kept));
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store),
+                                        0, GTK_SORT_DESCENDING);
+  check_sorted_large (store, GTK_SORT_DESCENDING);
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store),
+                                        1, GTK_SORT_ASCENDING);
+  for (i = 0; i <= 50000; i++)
+    {
+      g_assert (gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (store), &iter, NULL, i));
+      gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 1, &index, -1);
+      g_assert_cmpint (index, ==, i);
+    }
+
+  /* Iters stay valid while sorting */
+  g_assert (gtk_list_store_iter_is_valid (store, &kept));
+
+  g_object_unref (store);
+}
+
+static void
+count_rows_inserted (GtkTreeModel *model,
+                     GtkTreePath  *path,
+                     GtkTreeIter  *iter,
+                     gint          n_rows,
+                     gpointer      data)
+{
+  gint *count = data;
+
+  g_assert_cmpint (gtk_tree_path_get_indices (path)[0], ==, 1);
+  g_assert_cmpint (n_rows, ==, 3);
+  (*count)++;
+}
+
+static void
+count_row_inserted (GtkTreeModel *model,
+                    GtkTreePath  *path,
+                    GtkTreeIter  *iter,
+                    gpointer      data)
+{
+  gint *count = data;
+
+  (*count)++;
+}
+
+static void
+list_store_test_insert_rows (void)
+{
+  GtkListStore *store;
+  GtkTreeIter iter;
+  GValue values[6] = { G_VALUE_INIT, };
+  gint columns[2] = { 0, 1 };
+  gint bulk = 0, single = 0;
+  gchar *str;
+  gint i, n;
+
+  store = gtk_list_store_new (2, G_TYPE_INT, G_TYPE_STRING);
+  gtk_list_store_insert_with_values (store, NULL, 0, 0, 0, 1, "0", -1);
+  gtk_list_store_insert_with_values (store, NULL, 1, 0, 4, 1, "4", -1);
+
+  g_signal_connect (store, "rows-inserted",
+                    G_CALLBACK (count_rows_inserted), &bulk);
+  g_signal_connect (store, "row-inserted",
+                    G_CALLBACK (count_row_inserted), &single);
+
+  for (i = 0; i < 3; i++)
+    {
+      g_value_init (&values[2 * i], G_TYPE_INT);
+      g_value_set_int (&values[2 * i], i + 1);
+      g_value_init (&values[2 * i + 1], G_TYPE_STRING);
+      g_value_take_string (&values[2 * i + 1], g_strdup_printf ("%d", i + 1));
+    }
+
+  gtk_list_store_insert_rows_with_valuesv (store, 1, 3, columns, values, 2);
+
+  for (i = 0; i < 6; i++)
+    g_value_unset (&values[i]);
+
+  /* One bulk emission, and one row-inserted per row for old listeners */
+  g_assert_cmpint (bulk, ==, 1);
+  g_assert_cmpint (single, ==, 3);
+
+  g_assert_cmpint (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), NULL), ==, 5);
+  for (i = 0; i < 5; i++)
+    {
+      g_assert (gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (store), &iter, NULL, i));
+      gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 0, &n, 1, &str, -1);
+      g_assert_cmpint (n, ==, i);
+      g_assert_cmpint (str[0] - '0', ==, i);
+      g_free (str);
+    }
+
+  g_object_unref (store);
+}
+
+static void
+insert_int_rows (GtkListStore *store,
+                 gint          position,
+                 gint          first_value,
+                 gint          n_rows)
+{
+  GValue *values;
+  gint column = 0;
+  gint i;
+
+  values = g_new0 (GValue, n_rows);
+  for (i = 0; i < n_rows; i++)
+    {
+      g_value_init (&values[i], G_TYPE_INT);
+      g_value_set_int (&values[i], first_value + i);
+    }
+
+  gtk_list_store_insert_rows_with_valuesv (store, position, n_rows, &column, values, 1);
+
+  for (i = 0; i < n_rows; i++)
+    g_value_unset (&values[i]);
+  g_free (values);
+}
+
+static gboolean
+even_visible_func (GtkTreeModel *model,
+                   GtkTreeIter  *iter,
+                   gpointer      data)
+{
+  gint value;
+
+  gtk_tree_model_get (model, iter, 0, &value, -1);
+
+  return value % 2 == 0;
+}
+
+static void
+check_proxy_rows (GtkTreeModel *model,
+                  gint          n_rows,
+                  gint          step)
+{
+  GtkTreeIter iter;
+  gint i, value, prev = 0;
+
+  g_assert_cmpint (gtk_tree_model_iter_n_children (model, NULL), ==, n_rows);
+  for (i = 0; i < n_rows; i++)
+    {
+      g_assert (gtk_tree_model_iter_nth_child (model, &iter, NULL, i));
+      gtk_tree_model_get (model, &iter, 0, &value, -1);
+      if (i > 0)
+        g_assert_cmpint (value - prev, ==, step);
+      prev = value;
+    }
+}
+
+/* Filter and sort models see one row at a time, even though all rows
+ * are in the store before they are told about the first one.
+ */
+static void
+list_store_test_insert_rows_proxies (void)
+{
+  GtkListStore *store;
+  GtkTreeModel *filter, *sort;
+  gint filter_inserted = 0, sort_inserted = 0;
+
+  store = gtk_list_store_new (1, G_TYPE_INT);
+
+  filter = gtk_tree_model_filter_new (GTK_TREE_MODEL (store), NULL);
+  gtk_tree_model_filter_set_visible_func (GTK_TREE_MODEL_FILTER (filter),
+                                          even_visible_func, NULL, NULL);
+  sort = gtk_tree_model_sort_new_with_model (GTK_TREE_MODEL (store));
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (sort),
+                                        0, GTK_SORT_DESCENDING);
+
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), ==, 0);
+  g_assert_cmpint (gtk_tree_model_iter_n_children (sort, NULL), ==, 0);
+
+  g_signal_connect (filter, "row-inserted",
+                    G_CALLBACK (count_row_inserted), &filter_inserted);
+  g_signal_connect (sort, "row-inserted",
+                    G_CALLBACK (count_row_inserted), &sort_inserted);
+
+  /* Into the empty store, and after the existing rows */
+  insert_int_rows (store, 0, 0, 5);
+  insert_int_rows (store, 5, 5, 4);
+  check_proxy_rows (filter, 5, 2);
+  check_proxy_rows (sort, 9, -1);
+  g_assert_cmpint (filter_inserted, ==, 5);
+  g_assert_cmpint (sort_inserted, ==, 9);
+
+  /* Into the middle of the existing rows */
+  insert_int_rows (store, 4, 9, 10);
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), ==, 10);
+  check_proxy_rows (sort, 19, -1);
+  g_assert_cmpint (filter_inserted, ==, 10);
+  g_assert_cmpint (sort_inserted, ==, 19);
+
+  g_object_unref (filter);
+  g_object_unref (sort);
+  g_object_unref (store);
+}
+
+static void
+list_store_test_columnar (void)
+{
+  GtkListStore *store;
+  GtkTreeIter iter;
+  GObject *object, *value;
+  gchar *str;
+  gdouble d;
+  gint i, n;
+
+  store = gtk_list_store_new (4, G_TYPE_INT, G_TYPE_STRING, G_TYPE_DOUBLE, G_TYPE_OBJECT);
+  gtk_list_store_set_columnar (store, TRUE);
+  g_assert (gtk_list_store_get_columnar (store));
+
+  object = g_object_new (G_TYPE_OBJECT, NULL);
+  g_object_add_weak_pointer (object, (gpointer *) &object);
+
+  for (i = 0; i < 1000; i++)
+    {
+      str = g_strdup_printf ("Row %d", i % 10);
+      gtk_list_store_insert_with_values (store, NULL, i,
+                                         0, i,
+                                         1, str,
+                                         2, i / 2.0,
+                                         3, object,
+                                         -1);
+      g_free (str);
+    }
+  g_object_unref (object);
+  g_assert (object != NULL);
+
+  /* Rows that are never set read as empty */
+  gtk_list_store_append (store, &iter);
+  gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 0, &n, 1, &str, -1);
+  g_assert_cmpint (n, ==, 0);
+  g_assert_null (str);
+  gtk_list_store_remove (store, &iter);
+
+  /* Remove every other row, and reuse their space */
+  g_assert (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (store), &iter));
+  while (gtk_list_store_remove (store, &iter) &&
+         gtk_tree_model_iter_next (GTK_TREE_MODEL (store), &iter))
+    ;
+  g_assert_cmpint (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), NULL), ==, 500);
+
+  gtk_list_store_insert_with_values (store, &iter, 0, 0, -1, 1, "First", -1);
+  gtk_list_store_set (store, &iter, 1, "Still first", -1);
+
+  g_assert (gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (store), &iter, NULL, 0));
+  gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 0, &n, 1, &str, 3, &value, -1);
+  g_assert_cmpint (n, ==, -1);
+  g_assert_cmpstr (str, ==, "Still first");
+  g_assert_null (value);
+  g_free (str);
+
+  g_assert (gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (store), &iter, NULL, 250));
+  gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 0, &n, 1, &str, 2, &d, 3, &value, -1);
+  g_assert_cmpint (n, ==, 499);
+  g_assert_cmpstr (str, ==, "Row 9");
+  g_assert_cmpfloat (d, ==, 249.5);
+  g_assert (value == object);
+  g_free (str);
+  g_object_unref (value);
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store),
+                                        0, GTK_SORT_DESCENDING);
+  g_assert (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (store), &iter));
+  gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 0, &n, -1);
+  g_assert_cmpint (n, ==, 999);
+
+  g_object_unref (store);
+  g_assert_null (object);
+}
+
 static void
 list_store_test_swap_single (void)
 {
@@ -1136,4 +1473,20 @@ register_list_store_tests (void)
   g_test_add ("/ListStore/iter-parent-invalid", ListStore, NULL,
               list_store_setup, list_store_test_iter_parent_invalid,
               list_store_teardown);
+
+  /* sorting */
+  g_test_add_data_func ("/ListStore/sort-large", GINT_TO_POINTER (FALSE),
+                        list_store_test_sort_large);
+  g_test_add_data_func ("/ListStore/sort-large-columnar", GINT_TO_POINTER (TRUE),
+                        list_store_test_sort_large);
+
+  /* bulk insertion */
+  g_test_add_func ("/ListStore/insert-rows",
+                   list_store_test_insert_rows);
+  g_test_add_func ("/ListStore/insert-rows-proxies",
+                   list_store_test_insert_rows_proxies);
+
+  /* storage */
+  g_test_add_func ("/ListStore/columnar",
+                   list_store_test_columnar);
 }
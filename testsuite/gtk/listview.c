@@ -0,0 +1,224 @@
+#include <gtk/gtk.h>
+
+#define N_ITEMS 100000
+#define ROW_HEIGHT 20
+
+static GListModel *
+create_model (guint n_items)
+{
+  GListStore *store;
+  guint i;
+
+  store = g_list_store_new (G_TYPE_OBJECT);
+  for (i = 0; i < n_items; i++)
+    {
+      GObject *item = g_object_new (G_TYPE_OBJECT, NULL);
+      g_object_set_data (item, "position", GUINT_TO_POINTER (i));
+      g_list_store_append (store, item);
+      g_object_unref (item);
+    }
+
+  return G_LIST_MODEL (store);
+}
+
+static GtkWidget *
+create_row (gpointer data)
+{
+  guint *n_created = data;
+  GtkWidget *row;
+
+  (*n_created)++;
+
+  row = gtk_label_new ("");
+  gtk_widget_set_size_request (row, -1, ROW_HEIGHT);
+
+  return row;
+}
+
+static void
+bind_row (GtkWidget *row,
+          gpointer   item,
+          gpointer   data)
+{
+  g_object_set_data (G_OBJECT (row), "position",
+                     g_object_get_data (item, "position"));
+}
+
+static guint
+count_children (GtkWidget *widget)
+{
+  GtkWidget *child;
+  guint n = 0;
+
+  for (child = gtk_widget_get_first_child (widget);
+       child != NULL;
+       child = gtk_widget_get_next_sibling (child))
+    n++;
+
+  return n;
+}
+
+static void
+allocate (GtkWidget *widget,
+          int        width,
+          int        height)
+{
+  GtkAllocation allocation = { 0, 0, width, height };
+  GtkAllocation clip;
+  int min, nat;
+
+  gtk_widget_measure (widget, GTK_ORIENTATION_HORIZONTAL, -1, &min, &nat, NULL, NULL);
+  gtk_widget_measure (widget, GTK_ORIENTATION_VERTICAL, width, &min, &nat, NULL, NULL);
+  gtk_widget_size_allocate (widget, &allocation, -1, &clip);
+}
+
+static guint
+first_visible_position (GtkWidget *widget)
+{
+  GtkWidget *child;
+  guint position = G_MAXUINT;
+
+  for (child = gtk_widget_get_first_child (widget);
+       child != NULL;
+       child = gtk_widget_get_next_sibling (child))
+    {
+      if (!gtk_widget_get_child_visible (child))
+        continue;
+
+      position = MIN (position, GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (child), "position")));
+    }
+
+  return position;
+}
+
+static void
+test_recycling (void)
+{
+  GtkWidget *view;
+  GListModel *model;
+  GtkAdjustment *vadjustment;
+  guint n_created = 0;
+  guint n_after_first;
+
+  view = gtk_list_view_new ();
+  g_object_ref_sink (view);
+  gtk_widget_show (view);
+
+  model = create_model (N_ITEMS);
+  gtk_list_view_bind_model (GTK_LIST_VIEW (view), model,
+                            create_row, bind_row, &n_created, NULL);
+  g_assert (gtk_list_view_get_model (GTK_LIST_VIEW (view)) == model);
+  g_object_unref (model);
+
+  allocate (view, 200, 200);
+
+  /* Only enough rows to fill the view and a bit more */
+  n_after_first = n_created;
+  g_assert_cmpuint (n_after_first, >, 0);
+  g_assert_cmpuint (n_after_first, <, 4 * 200 / ROW_HEIGHT);
+  g_assert_cmpuint (count_children (view), <=, 2 * n_after_first);
+
+  vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (view));
+  g_assert_cmpfloat (gtk_adjustment_get_upper (vadjustment), >=, N_ITEMS * ROW_HEIGHT);
+
+  gtk_adjustment_set_value (vadjustment, N_ITEMS * ROW_HEIGHT / 2);
+  allocate (view, 200, 200);
+
+  /* Scrolling far away reuses the existing rows */
+  g_assert_cmpuint (n_created, ==, n_after_first);
+  g_assert_cmpuint (count_children (view), <=, 2 * n_after_first);
+  g_assert_cmpuint (first_visible_position (view), >, N_ITEMS / 2 - 200 / ROW_HEIGHT);
+  g_assert_cmpuint (first_visible_position (view), <=, N_ITEMS / 2);
+
+  gtk_adjustment_set_value (vadjustment, gtk_adjustment_get_value (vadjustment) + ROW_HEIGHT);
+  allocate (view, 200, 200);
+  g_assert_cmpuint (n_created, ==, n_after_first);
+
+  g_object_unref (view);
+}
+
+/* Scrolling rebinds the rows right away, so that allocating the view
+ * doesn't need to change its children.
+ */
+static void
+test_scroll (void)
+{
+  GtkWidget *view;
+  GListModel *model;
+  GtkAdjustment *vadjustment;
+  guint n_created = 0;
+  guint n_after_first;
+
+  view = gtk_list_view_new ();
+  g_object_ref_sink (view);
+  gtk_widget_show (view);
+
+  model = create_model (N_ITEMS);
+  gtk_list_view_bind_model (GTK_LIST_VIEW (view), model,
+                            create_row, bind_row, &n_created, NULL);
+  g_object_unref (model);
+
+  allocate (view, 200, 200);
+  n_after_first = n_created;
+  g_assert_cmpuint (first_visible_position (view), ==, 0);
+
+  vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (view));
+  gtk_adjustment_set_value (vadjustment, 1000 * ROW_HEIGHT);
+
+  g_assert_cmpuint (first_visible_position (view), >, 1000 - 200 / ROW_HEIGHT);
+  g_assert_cmpuint (first_visible_position (view), <=, 1000);
+  g_assert_cmpuint (n_created, ==, n_after_first);
+
+  g_object_unref (view);
+}
+
+static void
+test_items_changed (void)
+{
+  GtkWidget *view;
+  GListModel *model;
+  GObject *item;
+  guint n_created = 0;
+
+  view = gtk_list_view_new ();
+  g_object_ref_sink (view);
+  gtk_widget_show (view);
+
+  model = create_model (10);
+  gtk_list_view_bind_model (GTK_LIST_VIEW (view), model,
+                            create_row, bind_row, &n_created, NULL);
+
+  allocate (view, 200, 200);
+  g_assert_cmpuint (count_children (view), ==, 10);
+
+  item = g_object_new (G_TYPE_OBJECT, NULL);
+  g_object_set_data (item, "position", GUINT_TO_POINTER (100));
+  g_list_store_insert (G_LIST_STORE (model), 0, item);
+  g_object_unref (item);
+
+  allocate (view, 200, 200);
+  g_assert_cmpuint (first_visible_position (view), ==, 0);
+  g_assert_cmpuint (n_created, ==, 11);
+
+  g_list_store_remove_all (G_LIST_STORE (model));
+  allocate (view, 200, 200);
+  g_assert_cmpuint (first_visible_position (view), ==, G_MAXUINT);
+
+  gtk_list_view_bind_model (GTK_LIST_VIEW (view), NULL, NULL, NULL, NULL, NULL);
+  g_assert_cmpuint (count_children (view), ==, 0);
+
+  g_object_unref (model);
+  g_object_unref (view);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/listview/recycling", test_recycling);
+  g_test_add_func ("/listview/scroll", test_scroll);
+  g_test_add_func ("/listview/items-changed", test_items_changed);
+
+  return g_test_run ();
+}
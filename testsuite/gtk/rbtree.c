@@ -355,6 +355,71 @@ test_insert_after (void)
   _gtk_rbtree_free (tree);
 }
 
+static void
+test_insert_n (void)
+{
+  guint i, n;
+  GtkRBTree *tree;
+  GtkRBNode *node;
+
+  for (n = 1; n <= 100; n++)
+    {
+      tree = _gtk_rbtree_new ();
+
+      node = _gtk_rbtree_insert_n (tree, n, 2, TRUE);
+      _gtk_rbtree_test (tree);
+      g_assert (node == _gtk_rbtree_first (tree));
+      g_assert (tree->root->count == n);
+      g_assert (tree->root->total_count == n);
+      g_assert (tree->root->offset == 2 * n);
+
+      for (i = 0; i < n; i++)
+        {
+          g_assert (_gtk_rbtree_node_find_offset (tree, node) == 2 * i);
+          node = _gtk_rbtree_next (tree, node);
+        }
+      g_assert (node == NULL);
+
+      /* The tree keeps working like one built by inserting nodes */
+      node = _gtk_rbtree_insert_after (tree, _gtk_rbtree_first (tree), 3, FALSE);
+      _gtk_rbtree_test (tree);
+      g_assert (tree->root->offset == 2 * n + 3);
+
+      _gtk_rbtree_remove_node (tree, _gtk_rbtree_first (tree));
+      _gtk_rbtree_test (tree);
+      g_assert (tree->root->count == n);
+
+      _gtk_rbtree_free (tree);
+    }
+}
+
+/* Nodes removed from a block are reused for new nodes */
+static void
+test_insert_n_reuse (void)
+{
+  GtkRBTree *tree;
+  GtkRBNode *first, *node, *removed;
+  guint i;
+
+  tree = _gtk_rbtree_new ();
+  first = _gtk_rbtree_insert_n (tree, 100, 2, TRUE);
+
+  for (i = 0; i < 1000; i++)
+    {
+      removed = _gtk_rbtree_find_count (tree, 1 + i % 50);
+      _gtk_rbtree_remove_node (tree, removed);
+      _gtk_rbtree_test (tree);
+
+      node = _gtk_rbtree_insert_after (tree, _gtk_rbtree_first (tree), 2, TRUE);
+      _gtk_rbtree_test (tree);
+      g_assert (node == removed);
+      g_assert (node >= first && node < first + 100);
+      g_assert (tree->root->count == 100);
+    }
+
+  _gtk_rbtree_free (tree);
+}
+
 static void
 test_insert_before (void)
 {
@@ -519,6 +584,8 @@ main (int argc, char *argv[])
   g_test_add_func ("/rbtree/create", test_create);
   g_test_add_func ("/rbtree/insert_after", test_insert_after);
   g_test_add_func ("/rbtree/insert_before", test_insert_before);
+  g_test_add_func ("/rbtree/insert_n", test_insert_n);
+  g_test_add_func ("/rbtree/insert_n_reuse", test_insert_n_reuse);
   g_test_add_func ("/rbtree/remove_node", test_remove_node);
   g_test_add_func ("/rbtree/remove_root", test_remove_root);
   g_test_add_func ("/rbtree/reorder", test_reorder);
@@ -265,6 +265,232 @@ nonoverlay_always_height_min_max (void)
   test_size (FALSE, GTK_POLICY_ALWAYS, GTK_ORIENTATION_VERTICAL, MINIMUM_CONTENT | MAXIMUM_CONTENT);
 }
 
+/* CountingBox counts how often its size is measured */
+typedef struct {
+  GtkBox parent;
+
+  int n_measures;
+} CountingBox;
+
+typedef GtkBoxClass CountingBoxClass;
+
+G_DEFINE_TYPE (CountingBox, counting_box, GTK_TYPE_BOX)
+
+static void
+counting_box_measure (GtkWidget      *widget,
+                      GtkOrientation  orientation,
+                      int             for_size,
+                      int            *minimum,
+                      int            *natural,
+                      int            *minimum_baseline,
+                      int            *natural_baseline)
+{
+  ((CountingBox *) widget)->n_measures++;
+
+  GTK_WIDGET_CLASS (counting_box_parent_class)->measure (widget, orientation, for_size,
+                                                         minimum, natural,
+                                                         minimum_baseline, natural_baseline);
+}
+
+static void
+counting_box_class_init (CountingBoxClass *klass)
+{
+  GTK_WIDGET_CLASS (klass)->measure = counting_box_measure;
+}
+
+static void
+counting_box_init (CountingBox *self)
+{
+}
+
+/* A scrolled window that doesn't propagate the size of its child
+ * stops resizes of the child from reaching its parent, so the parent
+ * keeps its cached size request.
+ */
+static void
+layout_boundary (void)
+{
+  GtkWidget *box, *scrolledwindow, *child;
+  CountingBox *counting;
+  int width;
+
+  box = g_object_new (counting_box_get_type (),
+                      "orientation", GTK_ORIENTATION_VERTICAL,
+                      NULL);
+  g_object_ref_sink (box);
+  counting = (CountingBox *) box;
+  scrolledwindow = gtk_scrolled_window_new (NULL, NULL);
+  child = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  gtk_container_add (GTK_CONTAINER (scrolledwindow), child);
+  gtk_container_add (GTK_CONTAINER (box), scrolledwindow);
+
+  gtk_widget_measure (box, GTK_ORIENTATION_HORIZONTAL, -1,
+                      NULL, &width, NULL, NULL);
+  gtk_widget_measure (box, GTK_ORIENTATION_VERTICAL, -1,
+                      NULL, NULL, NULL, NULL);
+  g_assert_cmpint (counting->n_measures, >, 0);
+
+  counting->n_measures = 0;
+  gtk_widget_set_size_request (child, BOX_SIZE, BOX_SIZE);
+  gtk_widget_measure (box, GTK_ORIENTATION_HORIZONTAL, -1,
+                      NULL, &width, NULL, NULL);
+  gtk_widget_measure (box, GTK_ORIENTATION_VERTICAL, -1,
+                      NULL, NULL, NULL, NULL);
+  g_assert_cmpint (counting->n_measures, ==, 0);
+  g_assert_cmpint (width, <, BOX_SIZE);
+
+  /* Propagating the natural width makes the child's size matter again */
+  gtk_scrolled_window_set_propagate_natural_width (GTK_SCROLLED_WINDOW (scrolledwindow), TRUE);
+  gtk_widget_measure (box, GTK_ORIENTATION_HORIZONTAL, -1,
+                      NULL, &width, NULL, NULL);
+  g_assert_cmpint (counting->n_measures, >, 0);
+  g_assert_cmpint (width, >=, BOX_SIZE);
+
+  counting->n_measures = 0;
+  gtk_widget_set_size_request (child, 2 * BOX_SIZE, BOX_SIZE);
+  gtk_widget_measure (box, GTK_ORIENTATION_HORIZONTAL, -1,
+                      NULL, &width, NULL, NULL);
+  g_assert_cmpint (counting->n_measures, >, 0);
+  g_assert_cmpint (width, >=, 2 * BOX_SIZE);
+
+  g_object_unref (box);
+}
+
+static void
+stop_waiting (GdkFrameClock *clock,
+              gboolean      *done)
+{
+  *done = TRUE;
+}
+
+static void
+wait_for_paint (GtkWidget *widget)
+{
+  GdkFrameClock *clock = gtk_widget_get_frame_clock (widget);
+  gboolean done = FALSE;
+  gulong id;
+
+  id = g_signal_connect (clock, "after-paint", G_CALLBACK (stop_waiting), &done);
+  gdk_frame_clock_request_phase (clock, GDK_FRAME_CLOCK_PHASE_PAINT);
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+  g_signal_handler_disconnect (clock, id);
+}
+
+static cairo_surface_t *
+draw_widget (GtkWidget *widget)
+{
+  cairo_surface_t *surface;
+  cairo_t *cr;
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                        gtk_widget_get_allocated_width (widget),
+                                        gtk_widget_get_allocated_height (widget));
+  cr = cairo_create (surface);
+  gtk_widget_draw (widget, cr);
+  cairo_destroy (cr);
+  cairo_surface_flush (surface);
+
+  return surface;
+}
+
+/* Draws the viewport as it is, and again after making it render all of
+ * its child, and checks that the two look the same.
+ */
+static void
+assert_viewport_matches_uncached (GtkWidget *viewport)
+{
+  cairo_surface_t *cached, *uncached;
+  int y, width, height, stride;
+
+  cached = draw_widget (viewport);
+  gtk_widget_queue_draw (gtk_bin_get_child (GTK_BIN (viewport)));
+  uncached = draw_widget (viewport);
+
+  width = cairo_image_surface_get_width (cached);
+  height = cairo_image_surface_get_height (cached);
+  stride = cairo_image_surface_get_stride (cached);
+  g_assert_cmpint (width, ==, cairo_image_surface_get_width (uncached));
+  g_assert_cmpint (height, ==, cairo_image_surface_get_height (uncached));
+
+  for (y = 0; y < height; y++)
+    g_assert (memcmp (cairo_image_surface_get_data (cached) + y * stride,
+                      cairo_image_surface_get_data (uncached) + y * stride,
+                      width * 4) == 0);
+
+  cairo_surface_destroy (cached);
+  cairo_surface_destroy (uncached);
+}
+
+/* With the cairo renderer, a viewport reuses the contents it rendered
+ * in the last frame when its child only moved. Neither scrolling nor
+ * changes to the child may make it look different from a full redraw.
+ */
+static void
+viewport_scroll_cache (void)
+{
+  GtkCssProvider *provider;
+  GtkWidget *window, *viewport, *box;
+  GtkWidget *rows[30];
+  GtkAdjustment *vadjustment;
+  int i;
+
+  provider = gtk_css_provider_new ();
+  gtk_css_provider_load_from_data (provider,
+                                   ".scroll-row { background-color: white; min-height: 20px; }"
+                                   ".scroll-row:checked { background-color: red; }",
+                                   -1);
+  gtk_style_context_add_provider_for_display (gdk_display_get_default (),
+                                              GTK_STYLE_PROVIDER (provider),
+                                              GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+
+  window = gtk_window_new (GTK_WINDOW_POPUP);
+  viewport = gtk_viewport_new (NULL, NULL);
+  gtk_widget_set_size_request (viewport, 100, 100);
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  for (i = 0; i < G_N_ELEMENTS (rows); i++)
+    {
+      char *text = g_strdup_printf ("Row %d", i);
+
+      rows[i] = gtk_label_new (text);
+      gtk_style_context_add_class (gtk_widget_get_style_context (rows[i]), "scroll-row");
+      gtk_container_add (GTK_CONTAINER (box), rows[i]);
+      g_free (text);
+    }
+  gtk_container_add (GTK_CONTAINER (viewport), box);
+  gtk_container_add (GTK_CONTAINER (window), viewport);
+  gtk_widget_show (window);
+  wait_for_paint (window);
+
+  assert_viewport_matches_uncached (viewport);
+
+  /* Scrolling only copies the previous contents and draws the new rows */
+  vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (viewport));
+  gtk_adjustment_set_value (vadjustment, 30);
+  wait_for_paint (window);
+  assert_viewport_matches_uncached (viewport);
+
+  gtk_adjustment_set_value (vadjustment, 45);
+  wait_for_paint (window);
+  gtk_adjustment_set_value (vadjustment, 35);
+  wait_for_paint (window);
+  assert_viewport_matches_uncached (viewport);
+
+  /* A row that stays visible while scrolling changes its state */
+  gtk_adjustment_set_value (vadjustment, 60);
+  gtk_widget_set_state_flags (rows[4], GTK_STATE_FLAG_CHECKED, FALSE);
+  wait_for_paint (window);
+  assert_viewport_matches_uncached (viewport);
+
+  gtk_widget_unset_state_flags (rows[4], GTK_STATE_FLAG_CHECKED);
+  wait_for_paint (window);
+  assert_viewport_matches_uncached (viewport);
+
+  gtk_widget_destroy (window);
+  gtk_style_context_remove_provider_for_display (gdk_display_get_default (),
+                                                 GTK_STYLE_PROVIDER (provider));
+  g_object_unref (provider);
+}
 
 int
 main (int argc, char **argv)
@@ -300,5 +526,8 @@ main (int argc, char **argv)
   g_test_add_func ("/sizing/scrolledwindow/nonoverlay_always_width_min_max", nonoverlay_always_width_min_max);
   g_test_add_func ("/sizing/scrolledwindow/nonoverlay_always_height_min_max", nonoverlay_always_height_min_max);
 
+  g_test_add_func ("/sizing/scrolledwindow/layout_boundary", layout_boundary);
+  g_test_add_func ("/scrolledwindow/viewport/scroll-cache", viewport_scroll_cache);
+
   return g_test_run ();
 }
@@ -0,0 +1,97 @@
+#include <gtk/gtk.h>
+
+#define TEXT "The quick brown fox jumps over the lazy dog, " \
+             "and then it does it again, a little more slowly."
+
+static GtkWidget *
+wrapping_label_new (void)
+{
+  GtkWidget *label = gtk_label_new (TEXT);
+
+  gtk_label_set_line_wrap (GTK_LABEL (label), TRUE);
+  gtk_widget_set_margin_start (label, 3);
+  gtk_widget_set_margin_end (label, 5);
+
+  return g_object_ref_sink (label);
+}
+
+static void
+check_height_for_width (GtkWidget *label,
+                        int        width)
+{
+  GtkWidget *fresh;
+  int min, nat, fresh_min, fresh_nat;
+
+  gtk_widget_measure (label, GTK_ORIENTATION_VERTICAL, width,
+                      &min, &nat, NULL, NULL);
+
+  fresh = wrapping_label_new ();
+  gtk_widget_measure (fresh, GTK_ORIENTATION_VERTICAL, width,
+                      &fresh_min, &fresh_nat, NULL, NULL);
+  g_object_unref (fresh);
+
+  g_assert_cmpint (min, ==, fresh_min);
+  g_assert_cmpint (nat, ==, fresh_nat);
+}
+
+/* Shrinking a wrapping label reuses cached heights for widths that
+ * still fit its lines; those must match a freshly measured label.
+ */
+static void
+label_height_for_width (void)
+{
+  GtkWidget *label;
+  int width, i;
+
+  label = wrapping_label_new ();
+
+  for (width = 600; width > 10; width -= 7)
+    {
+      check_height_for_width (label, width);
+
+      /* The widths in between come from the range cached for a wider
+       * one. The range must be offset by the margins exactly, or the
+       * widths just below it get the height of the wider width.
+       */
+      for (i = 1; i < 7 && width - i > 10; i++)
+        check_height_for_width (label, width - i);
+    }
+
+  /* Widths measured before are still cached */
+  for (width = 11; width < 600; width += 5)
+    check_height_for_width (label, width);
+
+  g_object_unref (label);
+}
+
+/* Changing the text is a content change and drops the cache */
+static void
+label_text_changed (void)
+{
+  GtkWidget *label;
+  int before, after;
+
+  label = wrapping_label_new ();
+
+  gtk_widget_measure (label, GTK_ORIENTATION_VERTICAL, 100,
+                      &before, NULL, NULL, NULL);
+  gtk_label_set_text (GTK_LABEL (label), "Short");
+  gtk_widget_measure (label, GTK_ORIENTATION_VERTICAL, 100,
+                      &after, NULL, NULL, NULL);
+
+  g_assert_cmpint (after, <, before);
+
+  g_object_unref (label);
+}
+
+int
+main (int argc, char **argv)
+{
+  gtk_init ();
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/sizerequest/label-height-for-width", label_height_for_width);
+  g_test_add_func ("/sizerequest/label-text-changed", label_text_changed);
+
+  return g_test_run ();
+}
@@ -0,0 +1,677 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Frame benchmarks for synthetic user interfaces.
+ *
+ * Each scenario is put into a window and driven through a fixed number of
+ * frames. Every frame scrolls the content and changes the state of one
+ * widget, and every few frames the content is resized. The phases of each
+ * frame are timed separately:
+ *
+ * - measure, allocate and snapshot are timed around the calls that the
+ *   BenchBin wrapper makes for the scenario content
+ * - css is the rest of the update and layout phases of the frame clock,
+ *   which is dominated by style validation
+ * - render is the rest of the paint phase, which renders the snapshot with
+ *   GskCairoRenderer and presents it
+ *
+ * Results are printed as a JSON object, with timings in milliseconds.
+ */
+
+#include <gtk/gtk.h>
+#include <string.h>
+
+static int n_frames = 200;
+static int warmup_frames = 10;
+static int resize_interval = 10;
+static int n_rows = 10000;
+static char *scenario_name = NULL;
+static char *output = NULL;
+
+static GOptionEntry options[] = {
+  { "frames", 'f', 0, G_OPTION_ARG_INT, &n_frames, "Number of frames per scenario", "FRAMES" },
+  { "warmup", 'w', 0, G_OPTION_ARG_INT, &warmup_frames, "Number of frames to run before measuring", "FRAMES" },
+  { "resize-interval", 'i', 0, G_OPTION_ARG_INT, &resize_interval, "Resize the content every N frames", "N" },
+  { "rows", 'r', 0, G_OPTION_ARG_INT, &n_rows, "Number of rows in the list scenario", "ROWS" },
+  { "scenario", 's', 0, G_OPTION_ARG_STRING, &scenario_name, "Only run the given scenario", "NAME" },
+  { "output", 'o', 0, G_OPTION_ARG_FILENAME, &output, "Write results to FILE instead of stdout", "FILE" },
+  { NULL }
+};
+
+enum {
+  PHASE_CSS,
+  PHASE_MEASURE,
+  PHASE_ALLOCATE,
+  PHASE_SNAPSHOT,
+  PHASE_RENDER,
+  PHASE_FRAME,
+  N_PHASES
+};
+
+static const char *phase_names[N_PHASES] = {
+  "css",
+  "measure",
+  "allocate",
+  "snapshot",
+  "render",
+  "frame"
+};
+
+/* Timings of the current frame, in microseconds */
+static gint64 frame_times[N_PHASES];
+
+/* BenchBin gives its child a scripted size, independent of the window
+ * size, and times the work done for the child.
+ */
+typedef struct {
+  GtkBin parent;
+
+  int width;
+  int height;
+} BenchBin;
+
+typedef GtkBinClass BenchBinClass;
+
+G_DEFINE_TYPE (BenchBin, bench_bin, GTK_TYPE_BIN)
+
+static void
+bench_bin_measure (GtkWidget      *widget,
+                   GtkOrientation  orientation,
+                   int             for_size,
+                   int            *minimum,
+                   int            *natural,
+                   int            *minimum_baseline,
+                   int            *natural_baseline)
+{
+  BenchBin *self = (BenchBin *) widget;
+
+  if (orientation == GTK_ORIENTATION_HORIZONTAL)
+    *minimum = *natural = self->width;
+  else
+    *minimum = *natural = self->height;
+}
+
+static void
+bench_bin_size_allocate (GtkWidget           *widget,
+                         const GtkAllocation *allocation,
+                         int                  baseline,
+                         GtkAllocation       *out_clip)
+{
+  GtkWidget *child = gtk_bin_get_child (GTK_BIN (widget));
+  GtkAllocation child_allocation, child_clip;
+  int min, nat;
+  gint64 start;
+
+  if (child == NULL || !gtk_widget_get_visible (child))
+    return;
+
+  start = g_get_monotonic_time ();
+  gtk_widget_measure (child, GTK_ORIENTATION_HORIZONTAL, -1, &min, &nat, NULL, NULL);
+  gtk_widget_measure (child, GTK_ORIENTATION_VERTICAL, allocation->width, &min, &nat, NULL, NULL);
+  frame_times[PHASE_MEASURE] += g_get_monotonic_time () - start;
+
+  child_allocation.x = 0;
+  child_allocation.y = 0;
+  child_allocation.width = allocation->width;
+  child_allocation.height = allocation->height;
+
+  start = g_get_monotonic_time ();
+  gtk_widget_size_allocate (child, &child_allocation, -1, &child_clip);
+  frame_times[PHASE_ALLOCATE] += g_get_monotonic_time () - start;
+}
+
+static void
+bench_bin_snapshot (GtkWidget   *widget,
+                    GtkSnapshot *snapshot)
+{
+  GtkWidget *child = gtk_bin_get_child (GTK_BIN (widget));
+  gint64 start;
+
+  if (child == NULL)
+    return;
+
+  start = g_get_monotonic_time ();
+  gtk_widget_snapshot_child (widget, child, snapshot);
+  frame_times[PHASE_SNAPSHOT] += g_get_monotonic_time () - start;
+}
+
+static void
+bench_bin_class_init (BenchBinClass *class)
+{
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (class);
+
+  widget_class->measure = bench_bin_measure;
+  widget_class->size_allocate = bench_bin_size_allocate;
+  widget_class->snapshot = bench_bin_snapshot;
+}
+
+static void
+bench_bin_init (BenchBin *self)
+{
+  gtk_widget_set_has_window (GTK_WIDGET (self), FALSE);
+}
+
+/* Scenarios */
+
+static const char *icon_names[] = {
+  "folder",
+  "text-x-generic",
+  "image-x-generic",
+  "audio-x-generic",
+  "video-x-generic",
+  "application-x-executable"
+};
+
+static const char *words[] = {
+  "lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing",
+  "elit", "sed", "do", "eiusmod", "tempor", "incididunt", "ut", "labore",
+  "et", "dolore", "magna", "aliqua"
+};
+
+static char *
+generate_sentence (GRand *rand,
+                   int    n_words)
+{
+  GString *str = g_string_new (NULL);
+  int i;
+
+  for (i = 0; i < n_words; i++)
+    {
+      if (i > 0)
+        g_string_append_c (str, ' ');
+      g_string_append (str, words[g_rand_int_range (rand, 0, G_N_ELEMENTS (words))]);
+    }
+
+  return g_string_free (str, FALSE);
+}
+
+static GtkWidget *
+create_form (GRand *rand)
+{
+  GtkWidget *grid;
+  int i;
+
+  grid = gtk_grid_new ();
+  gtk_grid_set_row_spacing (GTK_GRID (grid), 6);
+  gtk_grid_set_column_spacing (GTK_GRID (grid), 12);
+
+  for (i = 0; i < 200; i++)
+    {
+      GtkWidget *widget;
+      char *text;
+
+      text = generate_sentence (rand, 2);
+      widget = gtk_label_new (text);
+      gtk_widget_set_halign (widget, GTK_ALIGN_END);
+      gtk_grid_attach (GTK_GRID (grid), widget, 0, i, 1, 1);
+      g_free (text);
+
+      text = generate_sentence (rand, 4);
+      widget = gtk_entry_new ();
+      gtk_entry_set_text (GTK_ENTRY (widget), text);
+      gtk_widget_set_hexpand (widget, TRUE);
+      gtk_grid_attach (GTK_GRID (grid), widget, 1, i, 1, 1);
+      g_free (text);
+
+      widget = gtk_check_button_new_with_label ("Enabled");
+      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (widget), i % 3 == 0);
+      gtk_grid_attach (GTK_GRID (grid), widget, 2, i, 1, 1);
+
+      widget = gtk_switch_new ();
+      gtk_grid_attach (GTK_GRID (grid), widget, 3, i, 1, 1);
+    }
+
+  return grid;
+}
+
+static GtkWidget *
+create_nested_box (GRand *rand,
+                   int    level)
+{
+  GtkWidget *box;
+  int i;
+
+  if (level == 10)
+    {
+      char *text = generate_sentence (rand, 1);
+      GtkWidget *button = gtk_button_new_with_label (text);
+
+      g_free (text);
+
+      return button;
+    }
+
+  box = gtk_box_new (level % 2 ? GTK_ORIENTATION_VERTICAL : GTK_ORIENTATION_HORIZONTAL, 2);
+  for (i = 0; i < 2; i++)
+    gtk_container_add (GTK_CONTAINER (box), create_nested_box (rand, level + 1));
+
+  return box;
+}
+
+static GtkWidget *
+create_nested (GRand *rand)
+{
+  return create_nested_box (rand, 0);
+}
+
+static GtkWidget *
+create_list (GRand *rand)
+{
+  GtkListStore *store;
+  GtkWidget *view;
+  int i;
+
+  store = gtk_list_store_new (3, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_INT);
+  for (i = 0; i < n_rows; i++)
+    {
+      char *text = generate_sentence (rand, 5);
+
+      gtk_list_store_insert_with_values (store, NULL, -1,
+                                         0, icon_names[i % G_N_ELEMENTS (icon_names)],
+                                         1, text,
+                                         2, g_rand_int_range (rand, 0, 100000),
+                                         -1);
+      g_free (text);
+    }
+
+  view = gtk_tree_view_new_with_model (GTK_TREE_MODEL (store));
+  gtk_tree_view_insert_column_with_attributes (GTK_TREE_VIEW (view), -1, "Icon",
+                                               gtk_cell_renderer_pixbuf_new (),
+                                               "icon-name", 0,
+                                               NULL);
+  gtk_tree_view_insert_column_with_attributes (GTK_TREE_VIEW (view), -1, "Text",
+                                               gtk_cell_renderer_text_new (),
+                                               "text", 1,
+                                               NULL);
+  gtk_tree_view_insert_column_with_attributes (GTK_TREE_VIEW (view), -1, "Value",
+                                               gtk_cell_renderer_text_new (),
+                                               "text", 2,
+                                               NULL);
+  g_object_unref (store);
+
+  return view;
+}
+
+static GtkWidget *
+create_text (GRand *rand)
+{
+  GtkTextBuffer *buffer;
+  GtkTextIter end;
+  GtkWidget *view;
+  int i;
+
+  view = gtk_text_view_new ();
+  gtk_text_view_set_wrap_mode (GTK_TEXT_VIEW (view), GTK_WRAP_WORD);
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (view));
+
+  for (i = 0; i < 5000; i++)
+    {
+      char *text = generate_sentence (rand, g_rand_int_range (rand, 0, 30));
+
+      gtk_text_buffer_get_end_iter (buffer, &end);
+      gtk_text_buffer_insert (buffer, &end, text, -1);
+      gtk_text_buffer_insert (buffer, &end, "\n", 1);
+      g_free (text);
+    }
+
+  return view;
+}
+
+static GtkWidget *
+create_icons (GRand *rand)
+{
+  GtkWidget *flow_box;
+  int i;
+
+  flow_box = gtk_flow_box_new ();
+  gtk_flow_box_set_max_children_per_line (GTK_FLOW_BOX (flow_box), 100);
+  gtk_flow_box_set_selection_mode (GTK_FLOW_BOX (flow_box), GTK_SELECTION_NONE);
+
+  for (i = 0; i < 1000; i++)
+    {
+      GtkWidget *box, *image, *label;
+      char *text;
+
+      box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 4);
+      image = gtk_image_new_from_icon_name (icon_names[g_rand_int_range (rand, 0, G_N_ELEMENTS (icon_names))]);
+      gtk_image_set_pixel_size (GTK_IMAGE (image), 48);
+      gtk_container_add (GTK_CONTAINER (box), image);
+
+      text = generate_sentence (rand, 1);
+      label = gtk_label_new (text);
+      gtk_container_add (GTK_CONTAINER (box), label);
+      g_free (text);
+
+      gtk_container_add (GTK_CONTAINER (flow_box), box);
+    }
+
+  return flow_box;
+}
+
+typedef struct {
+  const char *name;
+  GtkWidget * (* create) (GRand *rand);
+} Scenario;
+
+static const Scenario scenarios[] = {
+  { "form", create_form },
+  { "nested", create_nested },
+  { "list", create_list },
+  { "text", create_text },
+  { "icons", create_icons }
+};
+
+/* Running frames */
+
+typedef struct {
+  GMainLoop *loop;
+  gint64 frame_start;
+  gint64 layout_end;
+  gboolean done;
+} FrameData;
+
+static void
+before_paint (GdkFrameClock *clock,
+              FrameData     *data)
+{
+  memset (frame_times, 0, sizeof (frame_times));
+  data->frame_start = g_get_monotonic_time ();
+  /* A frame may skip the layout phase, which then took no time */
+  data->layout_end = data->frame_start;
+}
+
+static void
+after_layout (GdkFrameClock *clock,
+              FrameData     *data)
+{
+  data->layout_end = g_get_monotonic_time ();
+}
+
+static void
+after_paint (GdkFrameClock *clock,
+             FrameData     *data)
+{
+  gint64 now = g_get_monotonic_time ();
+
+  if (data->frame_start == 0)
+    return;
+
+  frame_times[PHASE_CSS] = data->layout_end - data->frame_start
+                           - frame_times[PHASE_MEASURE] - frame_times[PHASE_ALLOCATE];
+  frame_times[PHASE_RENDER] = now - data->layout_end - frame_times[PHASE_SNAPSHOT];
+  frame_times[PHASE_FRAME] = now - data->frame_start;
+
+  data->frame_start = 0;
+  data->done = TRUE;
+  g_main_loop_quit (data->loop);
+}
+
+static void
+collect_leaves (GtkWidget *widget,
+                GPtrArray *leaves)
+{
+  GtkWidget *child;
+
+  if (gtk_widget_get_first_child (widget) == NULL)
+    g_ptr_array_add (leaves, widget);
+
+  for (child = gtk_widget_get_first_child (widget);
+       child != NULL;
+       child = gtk_widget_get_next_sibling (child))
+    collect_leaves (child, leaves);
+}
+
+static guint
+count_widgets (GtkWidget *widget)
+{
+  GtkWidget *child;
+  guint n = 1;
+
+  for (child = gtk_widget_get_first_child (widget);
+       child != NULL;
+       child = gtk_widget_get_next_sibling (child))
+    n += count_widgets (child);
+
+  return n;
+}
+
+/* Scrolls by a fixed step, turning around at either end */
+static void
+scroll_step (GtkAdjustment *adjustment,
+             double        *step)
+{
+  double value = gtk_adjustment_get_value (adjustment) + *step;
+  double lower = gtk_adjustment_get_lower (adjustment);
+  double upper = gtk_adjustment_get_upper (adjustment) - gtk_adjustment_get_page_size (adjustment);
+
+  if (value > upper || value < lower)
+    {
+      *step = - *step;
+      value = CLAMP (value, lower, upper);
+    }
+
+  gtk_adjustment_set_value (adjustment, value);
+}
+
+static int
+compare_samples (gconstpointer a,
+                 gconstpointer b)
+{
+  gint64 sa = *(const gint64 *) a;
+  gint64 sb = *(const gint64 *) b;
+
+  return sa < sb ? -1 : sa > sb;
+}
+
+static void
+append_stats (GString    *json,
+              const char *name,
+              GArray     *samples)
+{
+  gint64 total = 0;
+  guint i;
+
+  g_array_sort (samples, compare_samples);
+  for (i = 0; i < samples->len; i++)
+    total += g_array_index (samples, gint64, i);
+
+  g_string_append_printf (json,
+                          ",\n      \"%s\": { \"min\": %.3f, \"median\": %.3f, \"mean\": %.3f, \"max\": %.3f }",
+                          name,
+                          g_array_index (samples, gint64, 0) / 1000.,
+                          g_array_index (samples, gint64, samples->len / 2) / 1000.,
+                          (double) total / samples->len / 1000.,
+                          g_array_index (samples, gint64, samples->len - 1) / 1000.);
+}
+
+static void
+run_scenario (const Scenario *scenario,
+              GString        *json)
+{
+  FrameData data = { NULL, 0, 0, FALSE };
+  GtkWidget *window, *bin, *scrolled, *content;
+  GtkAdjustment *adjustment;
+  GdkFrameClock *clock;
+  GArray *samples[N_PHASES];
+  GPtrArray *leaves;
+  GtkWidget *hovered = NULL;
+  GRand *rand;
+  double step = 40;
+  guint n_widgets;
+  int i, frame;
+
+  rand = g_rand_new_with_seed (42);
+
+  window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+  gtk_window_set_default_size (GTK_WINDOW (window), 1000, 800);
+
+  bin = g_object_new (bench_bin_get_type (), NULL);
+  ((BenchBin *) bin)->width = 800;
+  ((BenchBin *) bin)->height = 600;
+  gtk_widget_set_halign (bin, GTK_ALIGN_START);
+  gtk_widget_set_valign (bin, GTK_ALIGN_START);
+  gtk_container_add (GTK_CONTAINER (window), bin);
+
+  scrolled = gtk_scrolled_window_new (NULL, NULL);
+  gtk_container_add (GTK_CONTAINER (bin), scrolled);
+
+  content = scenario->create (rand);
+  gtk_container_add (GTK_CONTAINER (scrolled), content);
+  adjustment = gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (scrolled));
+
+  leaves = g_ptr_array_new ();
+  collect_leaves (content, leaves);
+  n_widgets = count_widgets (bin);
+
+  for (i = 0; i < N_PHASES; i++)
+    samples[i] = g_array_new (FALSE, FALSE, sizeof (gint64));
+
+  gtk_widget_show (window);
+
+  data.loop = g_main_loop_new (NULL, FALSE);
+  clock = gtk_widget_get_frame_clock (window);
+  g_signal_connect (clock, "before-paint", G_CALLBACK (before_paint), &data);
+  g_signal_connect_after (clock, "layout", G_CALLBACK (after_layout), &data);
+  g_signal_connect_after (clock, "after-paint", G_CALLBACK (after_paint), &data);
+
+  for (frame = 0; frame < warmup_frames + n_frames; frame++)
+    {
+      /* Scripted changes for this frame */
+      scroll_step (adjustment, &step);
+
+      if (hovered)
+        gtk_widget_unset_state_flags (hovered, GTK_STATE_FLAG_PRELIGHT);
+      hovered = g_ptr_array_index (leaves, g_rand_int_range (rand, 0, leaves->len));
+      gtk_widget_set_state_flags (hovered, GTK_STATE_FLAG_PRELIGHT, FALSE);
+
+      if (resize_interval > 0 && frame % resize_interval == resize_interval - 1)
+        {
+          BenchBin *self = (BenchBin *) bin;
+
+          self->width = self->width == 800 ? 640 : 800;
+          self->height = self->height == 600 ? 480 : 600;
+          gtk_widget_queue_resize (bin);
+        }
+
+      gtk_widget_queue_draw (bin);
+
+      data.done = FALSE;
+      while (!data.done)
+        g_main_loop_run (data.loop);
+
+      if (frame < warmup_frames)
+        continue;
+
+      for (i = 0; i < N_PHASES; i++)
+        g_array_append_val (samples[i], frame_times[i]);
+    }
+
+  g_signal_handlers_disconnect_by_data (clock, &data);
+  g_main_loop_unref (data.loop);
+
+  g_string_append_printf (json, "\n    \"%s\": {\n      \"widgets\": %u", scenario->name, n_widgets);
+  for (i = 0; i < N_PHASES; i++)
+    {
+      append_stats (json, phase_names[i], samples[i]);
+      g_array_free (samples[i], TRUE);
+    }
+  g_string_append (json, "\n    }");
+
+  g_ptr_array_free (leaves, TRUE);
+  gtk_widget_destroy (window);
+  g_rand_free (rand);
+}
+
+int
+main (int argc, char *argv[])
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  GString *json;
+  gboolean first = TRUE;
+  guint i;
+
+  context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (context, options, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("Option parsing failed: %s\n", error->message);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  if (n_frames < 1 || warmup_frames < 0 || resize_interval < 0 || n_rows < 1)
+    {
+      g_printerr ("Invalid arguments\n");
+      return 1;
+    }
+
+  /* The render phase is meant to measure the cairo renderer */
+  g_setenv ("GSK_RENDERER", "cairo", TRUE);
+
+  gtk_init ();
+
+  /* Only the scripted changes should cause redraws */
+  g_object_set (gtk_settings_get_default (),
+                "gtk-cursor-blink", FALSE,
+                "gtk-enable-animations", FALSE,
+                NULL);
+
+  json = g_string_new ("{\n");
+  g_string_append_printf (json,
+                          "  \"frames\": %d,\n"
+                          "  \"warmup\": %d,\n"
+                          "  \"resize-interval\": %d,\n"
+                          "  \"rows\": %d,\n"
+                          "  \"renderer\": \"cairo\",\n"
+                          "  \"results\": {",
+                          n_frames, warmup_frames, resize_interval, n_rows);
+
+  for (i = 0; i < G_N_ELEMENTS (scenarios); i++)
+    {
+      if (scenario_name && !g_str_equal (scenario_name, scenarios[i].name))
+        continue;
+
+      if (!first)
+        g_string_append_c (json, ',');
+      first = FALSE;
+
+      run_scenario (&scenarios[i], json);
+    }
+
+  if (first)
+    {
+      g_printerr ("No scenario named %s\n", scenario_name);
+      g_string_free (json, TRUE);
+      return 1;
+    }
+
+  g_string_append (json, "\n  }\n}\n");
+
+  if (output)
+    {
+      if (!g_file_set_contents (output, json->str, json->len, &error))
+        {
+          g_printerr ("Could not write results: %s\n", error->message);
+          return 1;
+        }
+    }
+  else
+    g_print ("%s", json->str);
+
+  g_string_free (json, TRUE);
+
+  return 0;
+}
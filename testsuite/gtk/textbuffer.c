@@ -1580,6 +1580,455 @@ test_get_iter (void)
   g_object_unref (buffer);
 }
 
+typedef struct {
+  gboolean done;
+  gboolean result;
+  GError *error;
+  guint n_progress;
+  gboolean progress_freed;
+} InsertStreamResult;
+
+static void
+insert_stream_progress (goffset  current,
+                        goffset  total,
+                        gpointer data)
+{
+  InsertStreamResult *res = data;
+
+  g_assert (!res->done);
+  g_assert (!res->progress_freed);
+  res->n_progress++;
+}
+
+static void
+insert_stream_progress_free (gpointer data)
+{
+  InsertStreamResult *res = data;
+
+  res->progress_freed = TRUE;
+}
+
+static void
+insert_stream_done (GObject      *source,
+                    GAsyncResult *result,
+                    gpointer      data)
+{
+  InsertStreamResult *res = data;
+
+  res->result = gtk_text_buffer_insert_stream_finish (GTK_TEXT_BUFFER (source),
+                                                      result, &res->error);
+  res->done = TRUE;
+}
+
+static gboolean
+insert_stream (GtkTextBuffer *buffer,
+               const gchar   *text,
+               gsize          len,
+               guint         *n_progress,
+               GError       **error)
+{
+  InsertStreamResult res = { FALSE, FALSE, NULL, 0, FALSE };
+  GInputStream *stream;
+  GtkTextIter iter;
+
+  stream = g_memory_input_stream_new_from_data (text, len, NULL);
+
+  gtk_text_buffer_get_end_iter (buffer, &iter);
+  gtk_text_buffer_insert_stream_async (buffer, &iter, stream, G_PRIORITY_DEFAULT,
+                                       NULL,
+                                       insert_stream_progress, &res, insert_stream_progress_free,
+                                       insert_stream_done, &res);
+  /* The progress data is freed along with the operation */
+  while (!res.done || !res.progress_freed)
+    g_main_context_iteration (NULL, TRUE);
+
+  if (n_progress)
+    *n_progress = res.n_progress;
+
+  g_object_unref (stream);
+
+  if (res.error)
+    g_propagate_error (error, res.error);
+
+  return res.result;
+}
+
+static void
+test_insert_stream (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextIter start, end;
+  GString *text;
+  GError *error = NULL;
+  gchar *result;
+  guint n_progress;
+  gint i;
+
+  /* Large enough to be read in several chunks */
+  text = g_string_new ("");
+  for (i = 0; i < 40000; i++)
+    g_string_append_printf (text, "Zeile \xc3\x9f %d\r\n", i);
+
+  buffer = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer, "Start\n", -1);
+
+  g_assert (insert_stream (buffer, text->str, text->len, &n_progress, &error));
+  g_assert_no_error (error);
+  g_assert_cmpuint (n_progress, >, 1);
+
+  g_assert_cmpint (gtk_text_buffer_get_line_count (buffer), ==, 40002);
+
+  gtk_text_buffer_get_iter_at_line (buffer, &start, 1);
+  gtk_text_buffer_get_end_iter (buffer, &end);
+  result = gtk_text_buffer_get_text (buffer, &start, &end, TRUE);
+  g_assert_cmpstr (result, ==, text->str);
+  g_free (result);
+
+  /* Invalid UTF-8 is reported */
+  g_assert (!insert_stream (buffer, "abc\xff", 4, NULL, &error));
+  g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+  g_clear_error (&error);
+
+  g_string_free (text, TRUE);
+  g_object_unref (buffer);
+}
+
+static gpointer
+snapshot_get_text (gpointer data)
+{
+  return gtk_text_buffer_snapshot_get_text (data, 0, -1);
+}
+
+static gpointer
+snapshot_unref_thread (gpointer data)
+{
+  gtk_text_buffer_snapshot_unref (data);
+
+  return NULL;
+}
+
+static void
+check_snapshot_text (GtkTextBuffer         *buffer,
+                     GtkTextBufferSnapshot *snapshot)
+{
+  GtkTextIter start, end;
+  gchar *text, *snapshot_text;
+
+  gtk_text_buffer_get_bounds (buffer, &start, &end);
+  text = gtk_text_buffer_get_slice (buffer, &start, &end, TRUE);
+  snapshot_text = gtk_text_buffer_snapshot_get_text (snapshot, 0, -1);
+  g_assert_cmpstr (snapshot_text, ==, text);
+  g_free (snapshot_text);
+  g_free (text);
+}
+
+static void
+test_snapshot (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextBufferSnapshot *snapshot, *snapshot2;
+  GtkTextIter start, end;
+  GString *text;
+  const gchar *line;
+  gchar *result;
+  gsize len;
+  gint i;
+
+  text = g_string_new ("");
+  for (i = 0; i < 1000; i++)
+    g_string_append_printf (text, "line %d\r\n", i);
+
+  buffer = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer, text->str, -1);
+
+  snapshot = gtk_text_buffer_create_snapshot (buffer);
+  g_assert_cmpuint (gtk_text_buffer_snapshot_get_version (snapshot), ==, gtk_text_buffer_get_version (buffer));
+  g_assert_cmpint (gtk_text_buffer_snapshot_get_line_count (snapshot), ==, 1001);
+
+  line = gtk_text_buffer_snapshot_get_line (snapshot, 500, &len);
+  g_assert_cmpint (len, ==, strlen ("line 500"));
+  g_assert (strncmp (line, "line 500\r\n", len + 2) == 0);
+
+  /* An unchanged buffer hands out the same snapshot */
+  snapshot2 = gtk_text_buffer_create_snapshot (buffer);
+  g_assert (snapshot2 == snapshot);
+  gtk_text_buffer_snapshot_unref (snapshot2);
+
+  /* Snapshots can be read from other threads */
+  result = g_thread_join (g_thread_new ("snapshot", snapshot_get_text, snapshot));
+  g_assert_cmpstr (result, ==, text->str);
+  g_free (result);
+
+  gtk_text_buffer_get_iter_at_line (buffer, &start, 500);
+  gtk_text_buffer_insert (buffer, &start, "new\nlines\n", -1);
+  gtk_text_buffer_get_iter_at_line (buffer, &start, 10);
+  gtk_text_buffer_get_iter_at_line (buffer, &end, 20);
+  gtk_text_buffer_delete (buffer, &start, &end);
+  g_assert_cmpuint (gtk_text_buffer_snapshot_get_version (snapshot), !=, gtk_text_buffer_get_version (buffer));
+
+  /* The old snapshot is not affected by the edits */
+  result = gtk_text_buffer_snapshot_get_text (snapshot, 0, -1);
+  g_assert_cmpstr (result, ==, text->str);
+  g_free (result);
+
+  snapshot2 = gtk_text_buffer_create_snapshot (buffer);
+  g_assert_cmpint (gtk_text_buffer_snapshot_get_line_count (snapshot2), ==, 1001 + 2 - 10);
+  line = gtk_text_buffer_snapshot_get_line (snapshot2, 490, &len);
+  g_assert_cmpint (len, ==, strlen ("new"));
+  g_assert (strncmp (line, "new", len) == 0);
+
+  check_snapshot_text (buffer, snapshot2);
+
+  /* The buffer lets go of the shared lines with its last snapshot,
+   * and copies all of the text for the next one
+   */
+  gtk_text_buffer_snapshot_unref (snapshot);
+  gtk_text_buffer_snapshot_unref (snapshot2);
+  gtk_text_buffer_insert_at_cursor (buffer, "more\n", -1);
+  snapshot = gtk_text_buffer_create_snapshot (buffer);
+  check_snapshot_text (buffer, snapshot);
+
+  /* also when it is released in another thread */
+  g_thread_join (g_thread_new ("snapshot", snapshot_unref_thread, snapshot));
+  gtk_text_buffer_get_iter_at_line (buffer, &start, 100);
+  gtk_text_buffer_insert (buffer, &start, "even more\n", -1);
+  snapshot = gtk_text_buffer_create_snapshot (buffer);
+  check_snapshot_text (buffer, snapshot);
+
+  gtk_text_buffer_snapshot_unref (snapshot);
+  g_string_free (text, TRUE);
+  g_object_unref (buffer);
+}
+
+static void
+wait_for_search (GtkTextSearch *search)
+{
+  while (gtk_text_search_get_scanning (search))
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+check_search_match (GtkTextSearch *search,
+                    gboolean       forward,
+                    gint           offset,
+                    gint           match_start,
+                    gint           match_end)
+{
+  GtkTextBuffer *buffer;
+  GtkTextIter iter, start, end;
+
+  buffer = gtk_text_search_get_buffer (search);
+  if (offset < 0)
+    gtk_text_buffer_get_end_iter (buffer, &iter);
+  else
+    gtk_text_buffer_get_iter_at_offset (buffer, &iter, offset);
+
+  if (forward)
+    g_assert (gtk_text_search_forward (search, &iter, &start, &end));
+  else
+    g_assert (gtk_text_search_backward (search, &iter, &start, &end));
+
+  g_assert_cmpint (gtk_text_iter_get_offset (&start), ==, match_start);
+  g_assert_cmpint (gtk_text_iter_get_offset (&end), ==, match_end);
+}
+
+static void
+test_search (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextSearch *search;
+  GtkTextIter start, end;
+  GString *text;
+  gint i;
+
+  buffer = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer, "foo bar\nbar foo foo\n\nFOO\r\nbaz", -1);
+
+  search = gtk_text_search_new (buffer);
+  g_assert (!gtk_text_search_get_scanning (search));
+  gtk_text_search_set_text (search, "foo");
+  wait_for_search (search);
+
+  g_assert_cmpuint (gtk_text_search_get_n_matches (search), ==, 3);
+  check_search_match (search, TRUE, 0, 0, 3);
+  check_search_match (search, TRUE, 3, 12, 15);
+  check_search_match (search, FALSE, 15, 12, 15);
+  check_search_match (search, FALSE, 14, 0, 3);
+
+  gtk_text_search_set_flags (search, GTK_TEXT_SEARCH_CASE_INSENSITIVE);
+  wait_for_search (search);
+  g_assert_cmpuint (gtk_text_search_get_n_matches (search), ==, 4);
+  check_search_match (search, FALSE, -1, 21, 24);
+
+  /* Edits only rescan the changed lines, later matches move along */
+  gtk_text_buffer_get_start_iter (buffer, &start);
+  gtk_text_buffer_insert (buffer, &start, "foo\n", -1);
+  wait_for_search (search);
+  g_assert_cmpuint (gtk_text_search_get_n_matches (search), ==, 5);
+  check_search_match (search, FALSE, -1, 25, 28);
+
+  gtk_text_buffer_get_iter_at_line (buffer, &start, 2);
+  gtk_text_buffer_get_iter_at_line (buffer, &end, 3);
+  gtk_text_buffer_delete (buffer, &start, &end);
+  wait_for_search (search);
+  g_assert_cmpuint (gtk_text_search_get_n_matches (search), ==, 3);
+  check_search_match (search, TRUE, 1, 4, 7);
+  check_search_match (search, FALSE, -1, 13, 16);
+
+  gtk_text_search_set_regex (search, TRUE);
+  gtk_text_search_set_text (search, "ba[rz]");
+  wait_for_search (search);
+  g_assert_cmpuint (gtk_text_search_get_n_matches (search), ==, 2);
+  check_search_match (search, TRUE, 0, 8, 11);
+  check_search_match (search, TRUE, 11, 18, 21);
+
+  /* An invalid expression has no matches */
+  gtk_text_search_set_text (search, "ba[");
+  wait_for_search (search);
+  g_assert_cmpuint (gtk_text_search_get_n_matches (search), ==, 0);
+
+  /* Several chunks, edited while they are scanned */
+  text = g_string_new ("");
+  for (i = 0; i < 10000; i++)
+    g_string_append (text, "a needle\n");
+  gtk_text_buffer_set_text (buffer, text->str, -1);
+  g_string_free (text, TRUE);
+
+  gtk_text_search_set_regex (search, FALSE);
+  gtk_text_search_set_flags (search, 0);
+  gtk_text_search_set_text (search, "needle");
+  g_assert (gtk_text_search_get_scanning (search));
+
+  gtk_text_buffer_get_iter_at_line (buffer, &start, 5000);
+  gtk_text_buffer_insert (buffer, &start, "needle needle\n", -1);
+  gtk_text_buffer_get_iter_at_line (buffer, &start, 10);
+  gtk_text_buffer_get_iter_at_line (buffer, &end, 20);
+  gtk_text_buffer_delete (buffer, &start, &end);
+  wait_for_search (search);
+
+  g_assert_cmpuint (gtk_text_search_get_n_matches (search), ==, 10000 + 2 - 10);
+  check_search_match (search, FALSE, -1, 10000 * 9 + 14 - 10 * 9 - 7, 10000 * 9 + 14 - 10 * 9 - 1);
+
+  g_object_unref (search);
+  g_object_unref (buffer);
+}
+
+static void
+check_same_tags (GtkTextBuffer *buffer1,
+                 GtkTextBuffer *buffer2,
+                 GtkTextTag    *tag1,
+                 GtkTextTag    *tag2)
+{
+  GtkTextIter iter1, iter2;
+
+  gtk_text_buffer_get_start_iter (buffer1, &iter1);
+  gtk_text_buffer_get_start_iter (buffer2, &iter2);
+
+  do
+    {
+      g_assert_cmpint (gtk_text_iter_get_offset (&iter1), ==, gtk_text_iter_get_offset (&iter2));
+      g_assert_cmpint (gtk_text_iter_has_tag (&iter1, tag1), ==, gtk_text_iter_has_tag (&iter2, tag2));
+      g_assert_cmpint (gtk_text_iter_toggles_tag (&iter1, tag1), ==, gtk_text_iter_toggles_tag (&iter2, tag2));
+    }
+  while (gtk_text_iter_forward_char (&iter1) && gtk_text_iter_forward_char (&iter2));
+}
+
+static void
+count_emissions (GtkTextBuffer *buffer,
+                 GtkTextTag    *tag,
+                 GtkTextIter   *start,
+                 GtkTextIter   *end,
+                 gint          *count)
+{
+  (*count)++;
+}
+
+static void
+test_tag_ranges (void)
+{
+  GtkTextBuffer *buffer1, *buffer2;
+  GtkTextTag *tags1[2], *tags2[2];
+  GtkTextTagRange ranges[300];
+  GtkTextIter start, end;
+  GString *text;
+  gint n_chars;
+  gint count;
+  gint i;
+
+  text = g_string_new ("");
+  for (i = 0; i < 200; i++)
+    g_string_append_printf (text, "line %d with some words\n", i);
+
+  buffer1 = gtk_text_buffer_new (NULL);
+  buffer2 = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer1, text->str, -1);
+  gtk_text_buffer_set_text (buffer2, text->str, -1);
+  n_chars = gtk_text_buffer_get_char_count (buffer1);
+
+  for (i = 0; i < 2; i++)
+    {
+      tags1[i] = gtk_text_buffer_create_tag (buffer1, NULL, NULL);
+      tags2[i] = gtk_text_buffer_create_tag (buffer2, NULL, NULL);
+    }
+
+  /* Random, unordered and overlapping ranges of two tags */
+  for (i = 0; i < G_N_ELEMENTS (ranges); i++)
+    {
+      gint tag = g_test_rand_int_range (0, 2);
+
+      ranges[i].start = g_test_rand_int_range (-5, n_chars + 5);
+      ranges[i].end = ranges[i].start + g_test_rand_int_range (-20, 20);
+      ranges[i].tag = tags2[tag];
+
+      gtk_text_buffer_get_iter_at_offset (buffer1, &start, ranges[i].start);
+      gtk_text_buffer_get_iter_at_offset (buffer1, &end, ranges[i].end);
+      gtk_text_buffer_apply_tag (buffer1, tags1[tag], &start, &end);
+    }
+  gtk_text_buffer_apply_tag_ranges (buffer2, ranges, G_N_ELEMENTS (ranges));
+
+  for (i = 0; i < 2; i++)
+    check_same_tags (buffer1, buffer2, tags1[i], tags2[i]);
+
+  for (i = 0; i < G_N_ELEMENTS (ranges) / 2; i++)
+    {
+      gint tag = g_test_rand_int_range (0, 2);
+
+      ranges[i].start = g_test_rand_int_range (0, n_chars);
+      ranges[i].end = ranges[i].start + g_test_rand_int_range (0, 50);
+      ranges[i].tag = tags2[tag];
+
+      gtk_text_buffer_get_iter_at_offset (buffer1, &start, ranges[i].start);
+      gtk_text_buffer_get_iter_at_offset (buffer1, &end, ranges[i].end);
+      gtk_text_buffer_remove_tag (buffer1, tags1[tag], &start, &end);
+    }
+  gtk_text_buffer_remove_tag_ranges (buffer2, ranges, G_N_ELEMENTS (ranges) / 2);
+
+  for (i = 0; i < 2; i++)
+    check_same_tags (buffer1, buffer2, tags1[i], tags2[i]);
+
+  /* With a handler connected, ranges are merged before emission */
+  count = 0;
+  g_signal_connect (buffer2, "apply-tag", G_CALLBACK (count_emissions), &count);
+
+  ranges[0] = (GtkTextTagRange) { tags2[0], 10, 0 };
+  ranges[1] = (GtkTextTagRange) { tags2[0], 5, 15 };
+  ranges[2] = (GtkTextTagRange) { tags2[0], 15, 20 };
+  ranges[3] = (GtkTextTagRange) { tags2[0], 30, 30 };
+  ranges[4] = (GtkTextTagRange) { tags2[1], 40, 50 };
+  gtk_text_buffer_apply_tag_ranges (buffer2, ranges, 5);
+  g_assert_cmpint (count, ==, 2);
+
+  gtk_text_buffer_get_iter_at_offset (buffer2, &start, 0);
+  gtk_text_buffer_get_iter_at_offset (buffer2, &end, 20);
+  g_assert_true (gtk_text_iter_has_tag (&start, tags2[0]));
+  g_assert_true (gtk_text_iter_forward_to_tag_toggle (&start, tags2[0]));
+  g_assert_cmpint (gtk_text_iter_compare (&start, &end), >=, 0);
+
+  g_string_free (text, TRUE);
+  g_object_unref (buffer1);
+  g_object_unref (buffer2);
+}
+
 int
 main (int argc, char** argv)
 {
@@ -1599,6 +2048,10 @@ main (int argc, char** argv)
   g_test_add_func ("/TextBuffer/Tag", test_tag);
   g_test_add_func ("/TextBuffer/Clipboard", test_clipboard);
   g_test_add_func ("/TextBuffer/Get iter", test_get_iter);
+  g_test_add_func ("/TextBuffer/Insert stream", test_insert_stream);
+  g_test_add_func ("/TextBuffer/Snapshot", test_snapshot);
+  g_test_add_func ("/TextBuffer/Search", test_search);
+  g_test_add_func ("/TextBuffer/Tag ranges", test_tag_ranges);
 
   return g_test_run();
 }
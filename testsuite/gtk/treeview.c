@@ -228,6 +228,85 @@ test_row_separator_height (void)
   gtk_widget_destroy (tree_view);
 }
 
+static void
+get_row_area (GtkTreeView  *tree_view,
+              gint          index,
+              GdkRectangle *area)
+{
+  GtkTreePath *path;
+
+  path = gtk_tree_path_new_from_indices (index, -1);
+  gtk_tree_view_get_background_area (tree_view, path, NULL, area);
+  gtk_tree_path_free (path);
+}
+
+static void
+test_estimate_row_heights (void)
+{
+  GtkTreeIter iter;
+  GtkListStore *store;
+  GtkWidget *window;
+  GtkWidget *tree_view;
+  GdkRectangle short_row, tall_row, far_short, far_tall;
+  gint i, tx, ty;
+
+  /* Rows alternate between one and three lines */
+  store = gtk_list_store_new (1, G_TYPE_STRING);
+  for (i = 0; i < 100000; i++)
+    gtk_list_store_insert_with_values (store, &iter, i,
+                                       0, i % 2 ? "Row\ncontent\nhere" : "Row content",
+                                       -1);
+
+  window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+  gtk_window_set_default_size (GTK_WINDOW (window), 200, 200);
+
+  tree_view = gtk_tree_view_new ();
+  gtk_tree_view_set_estimate_row_heights (GTK_TREE_VIEW (tree_view), TRUE);
+  g_assert (gtk_tree_view_get_estimate_row_heights (GTK_TREE_VIEW (tree_view)));
+  gtk_tree_view_set_model (GTK_TREE_VIEW (tree_view), GTK_TREE_MODEL (store));
+  gtk_tree_view_insert_column_with_attributes (GTK_TREE_VIEW (tree_view),
+                                               0,
+                                               "Test",
+                                               gtk_cell_renderer_text_new (),
+                                               "text", 0,
+                                               NULL);
+
+  gtk_container_add (GTK_CONTAINER (window), tree_view);
+  gtk_widget_show (window);
+
+  gtk_test_widget_wait_for_draw (window);
+
+  get_row_area (GTK_TREE_VIEW (tree_view), 0, &short_row);
+  get_row_area (GTK_TREE_VIEW (tree_view), 1, &tall_row);
+  g_assert_cmpint (short_row.height, >, 0);
+  g_assert_cmpint (tall_row.height, >, short_row.height);
+
+  /* Rows far below the visible area were not measured. They still get
+   * a position, from the average height of the rows that were.
+   */
+  get_row_area (GTK_TREE_VIEW (tree_view), 99998, &far_short);
+  get_row_area (GTK_TREE_VIEW (tree_view), 99999, &far_tall);
+  g_assert_cmpint (far_short.height, ==, far_tall.height);
+  g_assert_cmpint (far_tall.height, >, short_row.height);
+  g_assert_cmpint (far_tall.height, <, tall_row.height);
+
+  gtk_tree_view_convert_bin_window_to_tree_coords (GTK_TREE_VIEW (tree_view),
+                                                   far_tall.x, far_tall.y, &tx, &ty);
+  g_assert_cmpint (ty, >, short_row.height * 99999);
+
+  /* Rows are measured once they are scrolled to */
+  gtk_tree_view_scroll_to_point (GTK_TREE_VIEW (tree_view), -1, ty);
+  gtk_test_widget_wait_for_draw (window);
+
+  get_row_area (GTK_TREE_VIEW (tree_view), 99998, &far_short);
+  get_row_area (GTK_TREE_VIEW (tree_view), 99999, &far_tall);
+  g_assert_cmpint (far_short.height, ==, short_row.height);
+  g_assert_cmpint (far_tall.height, ==, tall_row.height);
+
+  gtk_widget_destroy (window);
+  g_object_unref (store);
+}
+
 static void
 test_selection_count (void)
 {
@@ -335,6 +414,102 @@ test_selection_empty (void)
   gtk_widget_destroy (view);
 }
 
+static GdkTexture *
+get_renderer_texture (GtkCellRenderer *renderer)
+{
+  GdkTexture *texture;
+
+  g_object_get (renderer, "texture", &texture, NULL);
+  g_object_unref (texture);
+
+  return texture;
+}
+
+static guint32
+get_texture_pixel (GdkTexture *texture)
+{
+  guint32 pixel;
+
+  gdk_texture_download (texture, (guchar *) &pixel, 4);
+
+  return pixel;
+}
+
+static GdkPixbuf *
+create_pixbuf (guint32 color)
+{
+  GdkPixbuf *pixbuf;
+
+  pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, TRUE, 8, 1, 1);
+  gdk_pixbuf_fill (pixbuf, color);
+
+  return pixbuf;
+}
+
+/* The pixbuf renderer reuses the textures of the pixbufs it was given
+ * recently, as long as the pixbufs are alive and there are not too many.
+ */
+static void
+test_pixbuf_renderer_texture (void)
+{
+  GtkCellRenderer *renderer;
+  GdkPixbuf *red, *blue, *pixbufs[200];
+  GdkTexture *red_texture, *blue_texture, *texture;
+  guint i;
+
+  red = create_pixbuf (0xff0000ff);
+  blue = create_pixbuf (0x0000ffff);
+
+  renderer = gtk_cell_renderer_pixbuf_new ();
+  g_object_ref_sink (renderer);
+
+  g_object_set (renderer, "pixbuf", red, NULL);
+  red_texture = get_renderer_texture (renderer);
+  g_assert_cmphex (get_texture_pixel (red_texture), ==, 0xffff0000);
+  g_object_set (renderer, "pixbuf", blue, NULL);
+  blue_texture = get_renderer_texture (renderer);
+  g_assert_cmphex (get_texture_pixel (blue_texture), ==, 0xff0000ff);
+  g_object_add_weak_pointer (G_OBJECT (red_texture), (gpointer *) &red_texture);
+  g_object_add_weak_pointer (G_OBJECT (blue_texture), (gpointer *) &blue_texture);
+
+  /* Rows alternating between two icons reuse both textures */
+  for (i = 0; i < 10; i++)
+    {
+      g_object_set (renderer, "pixbuf", red, NULL);
+      g_assert (get_renderer_texture (renderer) == red_texture);
+      g_object_set (renderer, "pixbuf", blue, NULL);
+      g_assert (get_renderer_texture (renderer) == blue_texture);
+    }
+
+  /* A texture goes away with its pixbuf */
+  g_object_unref (red);
+  g_assert_null (red_texture);
+
+  /* Only a limited number of textures is kept */
+  for (i = 0; i < G_N_ELEMENTS (pixbufs); i++)
+    {
+      pixbufs[i] = create_pixbuf (i << 8 | 0xff);
+      g_object_set (renderer, "pixbuf", pixbufs[i], NULL);
+    }
+  g_assert_null (blue_texture);
+
+  g_object_set (renderer, "pixbuf", blue, NULL);
+  blue_texture = get_renderer_texture (renderer);
+  g_object_add_weak_pointer (G_OBJECT (blue_texture), (gpointer *) &blue_texture);
+  g_object_set (renderer, "pixbuf", pixbufs[0], NULL);
+  texture = get_renderer_texture (renderer);
+  g_object_add_weak_pointer (G_OBJECT (texture), (gpointer *) &texture);
+
+  /* and all of them go away with the renderer */
+  g_object_unref (renderer);
+  g_assert_null (blue_texture);
+  g_assert_null (texture);
+
+  for (i = 0; i < G_N_ELEMENTS (pixbufs); i++)
+    g_object_unref (pixbufs[i]);
+  g_object_unref (blue);
+}
+
 int
 main (int    argc,
       char **argv)
@@ -348,8 +523,12 @@ main (int    argc,
                    test_select_collapsed_row);
   g_test_add_func ("/TreeView/sizing/row-separator-height",
                    test_row_separator_height);
+  g_test_add_func ("/TreeView/sizing/estimate-row-heights",
+                   test_estimate_row_heights);
   g_test_add_func ("/TreeView/selection/count", test_selection_count);
   g_test_add_func ("/TreeView/selection/empty", test_selection_empty);
+  g_test_add_func ("/TreeView/renderer/pixbuf-texture",
+                   test_pixbuf_renderer_texture);
 
   return g_test_run ();
 }
@@ -0,0 +1,153 @@
+#include <gtk/gtk.h>
+
+/* CountingWidget counts how often its snapshot vfunc is called */
+typedef struct {
+  GtkWidget parent;
+
+  int n_snapshots;
+} CountingWidget;
+
+typedef GtkWidgetClass CountingWidgetClass;
+
+G_DEFINE_TYPE (CountingWidget, counting_widget, GTK_TYPE_WIDGET)
+
+static void
+counting_widget_snapshot (GtkWidget   *widget,
+                          GtkSnapshot *snapshot)
+{
+  ((CountingWidget *) widget)->n_snapshots++;
+
+  GTK_WIDGET_CLASS (counting_widget_parent_class)->snapshot (widget, snapshot);
+}
+
+static void
+counting_widget_class_init (CountingWidgetClass *klass)
+{
+  GTK_WIDGET_CLASS (klass)->snapshot = counting_widget_snapshot;
+}
+
+static void
+counting_widget_init (CountingWidget *self)
+{
+  gtk_widget_set_has_window (GTK_WIDGET (self), FALSE);
+  gtk_style_context_add_class (gtk_widget_get_style_context (GTK_WIDGET (self)), "counting");
+}
+
+static void
+stop_waiting (GdkFrameClock *clock,
+              gboolean      *done)
+{
+  *done = TRUE;
+}
+
+static void
+wait_for_paint (GtkWidget *widget)
+{
+  GdkFrameClock *clock = gtk_widget_get_frame_clock (widget);
+  gboolean done = FALSE;
+  gulong id;
+
+  id = g_signal_connect (clock, "after-paint", G_CALLBACK (stop_waiting), &done);
+  gdk_frame_clock_request_phase (clock, GDK_FRAME_CLOCK_PHASE_PAINT);
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+  g_signal_handler_disconnect (clock, id);
+}
+
+static void
+reset_counts (CountingWidget **widgets,
+              guint            n_widgets)
+{
+  guint i;
+
+  for (i = 0; i < n_widgets; i++)
+    widgets[i]->n_snapshots = 0;
+}
+
+/* Widgets keep their recorded contents until they change, so redrawing
+ * one widget does not snapshot its siblings again.
+ */
+static void
+cached_content (void)
+{
+  GtkCssProvider *provider;
+  GtkWidget *window, *box;
+  CountingWidget *widgets[3];
+  guint i;
+
+  provider = gtk_css_provider_new ();
+  gtk_css_provider_load_from_data (provider,
+                                   ".counting { background-color: white; min-width: 20px; min-height: 20px; }"
+                                   ".counting:checked { background-color: red; }"
+                                   ".counting.highlight { background-color: blue; }",
+                                   -1);
+  gtk_style_context_add_provider_for_display (gdk_display_get_default (),
+                                              GTK_STYLE_PROVIDER (provider),
+                                              GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+
+  window = gtk_window_new (GTK_WINDOW_POPUP);
+  box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
+  for (i = 0; i < G_N_ELEMENTS (widgets); i++)
+    {
+      widgets[i] = g_object_new (counting_widget_get_type (), NULL);
+      gtk_container_add (GTK_CONTAINER (box), GTK_WIDGET (widgets[i]));
+    }
+  gtk_container_add (GTK_CONTAINER (window), box);
+  gtk_widget_show (window);
+  wait_for_paint (window);
+
+  for (i = 0; i < G_N_ELEMENTS (widgets); i++)
+    g_assert_cmpint (widgets[i]->n_snapshots, >, 0);
+
+  /* Nothing changed, so nothing is snapshotted again */
+  reset_counts (widgets, G_N_ELEMENTS (widgets));
+  gtk_widget_queue_draw (box);
+  wait_for_paint (window);
+  g_assert_cmpint (widgets[0]->n_snapshots, ==, 0);
+  g_assert_cmpint (widgets[1]->n_snapshots, ==, 0);
+  g_assert_cmpint (widgets[2]->n_snapshots, ==, 0);
+
+  /* A redraw of one widget only snapshots that widget */
+  reset_counts (widgets, G_N_ELEMENTS (widgets));
+  gtk_widget_queue_draw (GTK_WIDGET (widgets[0]));
+  wait_for_paint (window);
+  g_assert_cmpint (widgets[0]->n_snapshots, ==, 1);
+  g_assert_cmpint (widgets[1]->n_snapshots, ==, 0);
+  g_assert_cmpint (widgets[2]->n_snapshots, ==, 0);
+
+  /* State changes */
+  reset_counts (widgets, G_N_ELEMENTS (widgets));
+  gtk_widget_set_state_flags (GTK_WIDGET (widgets[1]), GTK_STATE_FLAG_CHECKED, FALSE);
+  wait_for_paint (window);
+  g_assert_cmpint (widgets[0]->n_snapshots, ==, 0);
+  g_assert_cmpint (widgets[1]->n_snapshots, ==, 1);
+  g_assert_cmpint (widgets[2]->n_snapshots, ==, 0);
+
+  /* and style changes snapshot the changed widget again */
+  reset_counts (widgets, G_N_ELEMENTS (widgets));
+  gtk_style_context_add_class (gtk_widget_get_style_context (GTK_WIDGET (widgets[2])), "highlight");
+  wait_for_paint (window);
+  g_assert_cmpint (widgets[0]->n_snapshots, ==, 0);
+  g_assert_cmpint (widgets[1]->n_snapshots, ==, 0);
+  g_assert_cmpint (widgets[2]->n_snapshots, ==, 1);
+
+  gtk_widget_destroy (window);
+  gtk_style_context_remove_provider_for_display (gdk_display_get_default (),
+                                                 GTK_STYLE_PROVIDER (provider));
+  g_object_unref (provider);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  /* Only the changes made by the tests should cause redraws */
+  g_object_set (gtk_settings_get_default (),
+                "gtk-enable-animations", FALSE,
+                NULL);
+
+  g_test_add_func ("/widget/snapshot/cached-content", cached_content);
+
+  return g_test_run ();
+}